@@ -0,0 +1,100 @@
+/// @file bench_algebra.cpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Benchmarks of the kernels of the state algebra.
+
+#include "common.hpp"
+
+#include <numint/detail/it_algebra.hpp>
+#include <numint/vec_expr.hpp>
+
+#include <functional>
+
+namespace bench
+{
+
+/// @brief Reports the bytes moved by a kernel.
+/// @param state The state of the benchmark.
+/// @param size The number of elements of the states.
+/// @param vectors The number of states read or written by the kernel.
+inline void report_bytes(benchmark::State &state, std::size_t size, std::size_t vectors)
+{
+    const auto items = static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(size);
+    state.SetItemsProcessed(items);
+    state.SetBytesProcessed(items * static_cast<int64_t>(vectors * sizeof(double)));
+}
+
+/// @brief Benchmarks `sum_operation` with three terms: y = x + a * k1 + b * k2.
+/// @tparam State The state vector type.
+/// @param state The state of the benchmark.
+template <class State>
+void sum_operation(benchmark::State &state)
+{
+    const State x = make_state<State>(state_size<State>(state));
+    State k1 = x, k2 = x, y = x;
+    for (auto _ : state) {
+        numint::detail::it_algebra::sum_operation(
+            y.begin(), y.end(), std::multiplies<>(), 1.0, x.begin(), 0.5, k1.begin(), 0.25, k2.begin());
+        benchmark::DoNotOptimize(y.data());
+        benchmark::ClobberMemory();
+    }
+    report_bytes(state, x.size(), 4);
+}
+
+/// @brief Benchmarks `accumulate_operation` with two terms: y += a * k1 + b * k2.
+/// @tparam State The state vector type.
+/// @param state The state of the benchmark.
+template <class State>
+void accumulate_operation(benchmark::State &state)
+{
+    const State x = make_state<State>(state_size<State>(state));
+    State k1 = x, y = x;
+    for (auto _ : state) {
+        numint::detail::it_algebra::accumulate_operation(
+            y.begin(), y.end(), std::multiplies<>(), 1e-9, x.begin(), -1e-9, k1.begin());
+        benchmark::DoNotOptimize(y.data());
+        benchmark::ClobberMemory();
+    }
+    report_bytes(state, x.size(), 4);
+}
+
+/// @brief Benchmarks `max_abs_diff`, the error norm of the step doubling.
+/// @tparam State The state vector type.
+/// @param state The state of the benchmark.
+template <class State>
+void max_abs_diff(benchmark::State &state)
+{
+    const State x = make_state<State>(state_size<State>(state));
+    const State y = x;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(
+            numint::detail::it_algebra::max_abs_diff<double>(x.begin(), x.end(), y.begin(), y.end()));
+    }
+    report_bytes(state, x.size(), 2);
+}
+
+/// @brief Benchmarks the expression templates, with the same sum as `sum_operation`.
+/// @tparam State The state vector type.
+/// @param state The state of the benchmark.
+template <class State>
+void vec_expr_assign(benchmark::State &state)
+{
+    const State x = make_state<State>(state_size<State>(state));
+    State k1 = x, k2 = x, y = x;
+    for (auto _ : state) {
+        numint::assign(y, numint::vec(x) + 0.5 * numint::vec(k1) + 0.25 * numint::vec(k2));
+        benchmark::DoNotOptimize(y.data());
+        benchmark::ClobberMemory();
+    }
+    report_bytes(state, x.size(), 4);
+}
+
+BENCHMARK_TEMPLATE(sum_operation, State16)->Name("algebra/sum_operation/array16");
+BENCHMARK_TEMPLATE(sum_operation, StateN)->Name("algebra/sum_operation/vector")->Apply(large_sizes);
+BENCHMARK_TEMPLATE(accumulate_operation, State16)->Name("algebra/accumulate_operation/array16");
+BENCHMARK_TEMPLATE(accumulate_operation, StateN)->Name("algebra/accumulate_operation/vector")->Apply(large_sizes);
+BENCHMARK_TEMPLATE(max_abs_diff, State16)->Name("algebra/max_abs_diff/array16");
+BENCHMARK_TEMPLATE(max_abs_diff, StateN)->Name("algebra/max_abs_diff/vector")->Apply(large_sizes);
+BENCHMARK_TEMPLATE(vec_expr_assign, State16)->Name("algebra/vec_expr_assign/array16");
+BENCHMARK_TEMPLATE(vec_expr_assign, StateN)->Name("algebra/vec_expr_assign/vector")->Apply(large_sizes);
+
+} // namespace bench
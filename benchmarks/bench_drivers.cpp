@@ -0,0 +1,98 @@
+/// @file bench_drivers.cpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Benchmarks of the integration drivers, fixed-step against adaptive.
+
+#include "common.hpp"
+
+#include <numint/solver.hpp>
+#include <numint/stepper/stepper_adaptive.hpp>
+#include <numint/stepper/stepper_dopri5.hpp>
+#include <numint/stepper/stepper_rk4.hpp>
+
+#include <vector>
+
+namespace bench
+{
+
+/// The duration of the integrations.
+constexpr Time duration = 10.;
+
+/// @brief Benchmarks `integrate_fixed`, with the Runge-Kutta 4th order stepper.
+/// @tparam State The state vector type.
+/// @param state The state of the benchmark.
+template <class State>
+void fixed(benchmark::State &state)
+{
+    Oscillators model;
+    const State initial = make_state<State>(state_size<State>(state));
+    numint::stepper_rk4<State, Time> stepper;
+    State x = initial;
+    numint::detail::allocation_scope scope;
+    for (auto _ : state) {
+        x = initial;
+        numint::integrate_fixed(stepper, [](const State &, Time) {}, model, x, 0., duration, 1e-2);
+        benchmark::DoNotOptimize(x.data());
+    }
+    report(state, stepper.steps(), model.evaluations, scope);
+}
+
+/// @brief Benchmarks `integrate_adaptive`, with the embedded Dormand-Prince stepper.
+/// @tparam State The state vector type.
+/// @param state The state of the benchmark.
+template <class State>
+void adaptive(benchmark::State &state)
+{
+    Oscillators model;
+    const State initial = make_state<State>(state_size<State>(state));
+    numint::stepper_adaptive<numint::stepper_dopri5<State, Time>> stepper;
+    stepper.set_tollerance(1e-6);
+    stepper.set_min_delta(1e-6);
+    stepper.set_max_delta(1.);
+    State x = initial;
+    numint::detail::allocation_scope scope;
+    for (auto _ : state) {
+        x = initial;
+        numint::integrate_adaptive(stepper, [](const State &, Time) {}, model, x, 0., duration, 1e-2);
+        benchmark::DoNotOptimize(x.data());
+    }
+    report(state, stepper.steps(), model.evaluations, scope);
+}
+
+/// @brief Benchmarks `integrate_times`, with the embedded Dormand-Prince stepper.
+/// @tparam State The state vector type.
+/// @param state The state of the benchmark.
+template <class State>
+void times(benchmark::State &state)
+{
+    Oscillators model;
+    const State initial = make_state<State>(state_size<State>(state));
+    numint::stepper_adaptive<numint::stepper_dopri5<State, Time>> stepper;
+    stepper.set_tollerance(1e-6);
+    stepper.set_min_delta(1e-6);
+    stepper.set_max_delta(1.);
+    std::vector<Time> grid(1001);
+    for (std::size_t i = 0; i < grid.size(); ++i) {
+        grid[i] = duration * static_cast<Time>(i) / static_cast<Time>(grid.size() - 1);
+    }
+    State x = initial;
+    numint::detail::allocation_scope scope;
+    for (auto _ : state) {
+        x = initial;
+        numint::integrate_times(
+            stepper, [](const State &, Time) {}, model, x, grid.begin(), grid.end(), 1e-2);
+        benchmark::DoNotOptimize(x.data());
+    }
+    report(state, stepper.steps(), model.evaluations, scope);
+}
+
+BENCHMARK_TEMPLATE(fixed, State2)->Name("driver/fixed/array2");
+BENCHMARK_TEMPLATE(fixed, State16)->Name("driver/fixed/array16");
+BENCHMARK_TEMPLATE(fixed, StateN)->Name("driver/fixed/vector")->Apply(medium_sizes);
+BENCHMARK_TEMPLATE(adaptive, State2)->Name("driver/adaptive/array2");
+BENCHMARK_TEMPLATE(adaptive, State16)->Name("driver/adaptive/array16");
+BENCHMARK_TEMPLATE(adaptive, StateN)->Name("driver/adaptive/vector")->Apply(medium_sizes);
+BENCHMARK_TEMPLATE(times, State2)->Name("driver/times/array2");
+BENCHMARK_TEMPLATE(times, State16)->Name("driver/times/array16");
+BENCHMARK_TEMPLATE(times, StateN)->Name("driver/times/vector")->Apply(medium_sizes);
+
+} // namespace bench
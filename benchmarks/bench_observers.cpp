@@ -0,0 +1,90 @@
+/// @file bench_observers.cpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Benchmarks of the overhead of the observers.
+
+#include "common.hpp"
+
+#include <numint/observer.hpp>
+#include <numint/solver.hpp>
+#include <numint/stepper/stepper_rk4.hpp>
+
+#include <string>
+#include <type_traits>
+
+namespace bench
+{
+
+/// The duration of the integrations.
+constexpr Time observed_duration = 10.;
+
+/// The step-size of the integrations.
+constexpr Time observed_delta = 1e-3;
+
+/// The number of samples produced by the integrations.
+constexpr std::size_t observed_samples = 10001;
+
+/// @brief Benchmarks `integrate_fixed` with the Runge-Kutta 4th order stepper, and the given observer.
+/// @details The observer is created by each integration, so that the memory
+/// it allocates is reported as well.
+/// @tparam State The state vector type.
+/// @tparam MakeObserver The type of the factory of the observer.
+/// @param state The state of the benchmark.
+/// @param make_observer Creates the observer, called as `make_observer(x)`.
+template <class State, class MakeObserver>
+void observe(benchmark::State &state, MakeObserver make_observer)
+{
+    Oscillators model;
+    const State initial = make_state<State>(state_size<State>(state));
+    numint::stepper_rk4<State, Time> stepper;
+    State x = initial;
+    numint::detail::allocation_scope scope;
+    for (auto _ : state) {
+        auto observer = make_observer(initial);
+        x             = initial;
+        numint::integrate_fixed(stepper, observer, model, x, 0., observed_duration, observed_delta);
+        benchmark::DoNotOptimize(x.data());
+    }
+    report(state, stepper.steps(), model.evaluations, scope);
+}
+
+/// @brief Registers the benchmarks of an observer, for all the states.
+/// @tparam MakeObserver The type of the factory of the observer.
+/// @param name The name of the observer.
+/// @param make_observer Creates the observer, called as `make_observer(x)`.
+template <class MakeObserver>
+void register_observer(const std::string &name, MakeObserver make_observer)
+{
+    const std::string prefix = "observer/" + name;
+    benchmark::RegisterBenchmark((prefix + "/array2").c_str(), observe<State2, MakeObserver>, make_observer);
+    benchmark::RegisterBenchmark((prefix + "/array16").c_str(), observe<State16, MakeObserver>, make_observer);
+    benchmark::RegisterBenchmark((prefix + "/vector").c_str(), observe<StateN, MakeObserver>, make_observer)
+        ->RangeMultiplier(16)
+        ->Range(16, 1024);
+}
+
+/// @brief Registers the benchmarks of all the observers.
+/// @return always zero.
+auto register_observers() -> int
+{
+    register_observer("none", [](const auto &) { return [](const auto &, Time) {}; });
+    register_observer("callback", [](const auto &) {
+        return numint::make_observer_callback([](const auto &x, Time) { benchmark::DoNotOptimize(x[0]); });
+    });
+    register_observer("decimate", [](const auto &) {
+        return numint::observer_decimate<10>() |
+               numint::make_observer_callback([](const auto &x, Time) { benchmark::DoNotOptimize(x[0]); });
+    });
+    register_observer("recorder", [](const auto &x) {
+        return numint::observer_recorder<std::decay_t<decltype(x)>, Time>(observed_samples, x);
+    });
+    register_observer("minmax", [](const auto &x) { return numint::observer_minmax<std::decay_t<decltype(x)>>(x); });
+    register_observer("trajectory", [](const auto &x) {
+        return numint::observer_trajectory<std::decay_t<decltype(x)>, Time>(x.size(), observed_samples);
+    });
+    return 0;
+}
+
+/// Registers the benchmarks at start-up.
+const int registered_observers = register_observers();
+
+} // namespace bench
@@ -0,0 +1,82 @@
+/// @file bench_realtime.cpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Benchmarks of the latency of the real-time stepping.
+
+#include "common.hpp"
+
+#include <numint/realtime.hpp>
+#include <numint/stepper/stepper_dopri5.hpp>
+#include <numint/stepper/stepper_rk4.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+namespace bench
+{
+
+/// The period of the control loop, of 10 kHz.
+constexpr Time realtime_period = 1e-4;
+
+/// @brief Returns the given percentile of the samples, reordering them.
+/// @param samples The samples.
+/// @param percentile The percentile, between 0 and 1.
+/// @return the value of the percentile.
+inline auto percentile(std::vector<double> &samples, double percentile) -> double
+{
+    if (samples.empty()) {
+        return 0.;
+    }
+    const auto index = static_cast<std::size_t>(percentile * static_cast<double>(samples.size() - 1));
+    std::nth_element(samples.begin(), samples.begin() + static_cast<std::ptrdiff_t>(index), samples.end());
+    return samples[index];
+}
+
+/// @brief Benchmarks the latency of `realtime_stepper::step_until`, executing one step per period of the loop.
+/// @details Each iteration is a period of the loop, whose duration is
+/// measured, and the percentiles of the durations are reported, in
+/// nanoseconds, as `p50_ns`, `p99_ns`, and `max_ns`.
+/// @tparam Stepper The type of the stepper.
+/// @param state The state of the benchmark.
+template <class Stepper>
+void step_until(benchmark::State &state)
+{
+    using State = typename Stepper::state_type;
+    using clock = std::chrono::steady_clock;
+
+    Oscillators model;
+    State x = make_state<State>(state_size<State>(state));
+    numint::realtime_stepper<Stepper> stepper(realtime_period, 1);
+    stepper.start(x, 0.);
+    std::vector<double> samples;
+    samples.reserve(static_cast<std::size_t>(state.max_iterations));
+    std::size_t steps = 0;
+    Time deadline     = 0.;
+    numint::detail::allocation_scope scope;
+    for (auto _ : state) {
+        deadline += realtime_period;
+        const auto start  = clock::now();
+        const auto status = stepper.step_until(model, x, deadline);
+        const auto end    = clock::now();
+        samples.push_back(
+            static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()));
+        steps += status.steps;
+        benchmark::DoNotOptimize(x.data());
+    }
+    report(state, steps, model.evaluations, scope);
+    state.counters["p50_ns"]   = percentile(samples, 0.50);
+    state.counters["p99_ns"]   = percentile(samples, 0.99);
+    state.counters["max_ns"]   = percentile(samples, 1.00);
+    state.counters["overruns"] = static_cast<double>(stepper.overruns());
+}
+
+BENCHMARK_TEMPLATE(step_until, numint::stepper_rk4<State2, Time>)->Name("realtime/rk4/array2");
+BENCHMARK_TEMPLATE(step_until, numint::stepper_rk4<State16, Time>)->Name("realtime/rk4/array16");
+BENCHMARK_TEMPLATE(step_until, numint::stepper_rk4<StateN, Time>)->Name("realtime/rk4/vector")->Apply(small_sizes);
+BENCHMARK_TEMPLATE(step_until, numint::stepper_dopri5<State2, Time>)->Name("realtime/dopri5/array2");
+BENCHMARK_TEMPLATE(step_until, numint::stepper_dopri5<State16, Time>)->Name("realtime/dopri5/array16");
+BENCHMARK_TEMPLATE(step_until, numint::stepper_dopri5<StateN, Time>)
+    ->Name("realtime/dopri5/vector")
+    ->Apply(small_sizes);
+
+} // namespace bench
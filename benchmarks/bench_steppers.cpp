@@ -0,0 +1,178 @@
+/// @file bench_steppers.cpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Benchmarks of the single steps of every stepper, across state sizes.
+
+#include "common.hpp"
+
+#include <numint/stepper/stepper_abm.hpp>
+#include <numint/stepper/stepper_adams_bashforth.hpp>
+#include <numint/stepper/stepper_adaptive.hpp>
+#include <numint/stepper/stepper_bdf.hpp>
+#include <numint/stepper/stepper_bs32.hpp>
+#include <numint/stepper/stepper_cash_karp.hpp>
+#include <numint/stepper/stepper_dopri5.hpp>
+#include <numint/stepper/stepper_euler.hpp>
+#include <numint/stepper/stepper_explicit_rk.hpp>
+#include <numint/stepper/stepper_implicit_euler.hpp>
+#include <numint/stepper/stepper_implicit_trapezoidal.hpp>
+#include <numint/stepper/stepper_improved_euler.hpp>
+#include <numint/stepper/stepper_midpoint.hpp>
+#include <numint/stepper/stepper_rk4.hpp>
+#include <numint/stepper/stepper_ros34pw2.hpp>
+#include <numint/stepper/stepper_simpsons.hpp>
+#include <numint/stepper/stepper_symplectic.hpp>
+#include <numint/stepper/stepper_trapezoidal.hpp>
+
+#include <string>
+
+namespace bench
+{
+
+/// @brief The Adams-Bashforth stepper with four steps.
+template <class State, class Time>
+using stepper_ab4 = numint::stepper_adams_bashforth<State, Time, 4>;
+
+/// @brief The Adams-Bashforth-Moulton stepper with four steps.
+template <class State, class Time>
+using stepper_abm4 = numint::stepper_abm<State, Time, 4>;
+
+/// @brief The adaptive Adams-Bashforth-Moulton stepper, up to eight steps.
+template <class State, class Time>
+using stepper_adaptive_abm8 = numint::stepper_adaptive_abm<State, Time, 8>;
+
+/// @brief The Runge-Kutta 4th order stepper wrapped by the adaptive stepper (step doubling).
+template <class State, class Time>
+using stepper_adaptive_rk4 = numint::stepper_adaptive<numint::stepper_rk4<State, Time>>;
+
+/// @brief The Dormand-Prince stepper wrapped by the adaptive stepper (embedded pair).
+template <class State, class Time>
+using stepper_adaptive_dopri5 = numint::stepper_adaptive<numint::stepper_dopri5<State, Time>>;
+
+/// @brief The Dormand-Prince stepper wrapped by the adaptive stepper, with the weighted error norm.
+template <class State, class Time>
+using stepper_adaptive_weighted_dopri5 =
+    numint::stepper_adaptive<numint::stepper_dopri5<State, Time>, 2, numint::ErrorFormula::Weighted>;
+
+/// @brief The implicit Euler stepper.
+template <class State, class Time>
+using stepper_implicit_euler = numint::stepper_implicit_euler<State, Time>;
+
+/// @brief The implicit trapezoidal stepper.
+template <class State, class Time>
+using stepper_implicit_trapezoidal = numint::stepper_implicit_trapezoidal<State, Time>;
+
+/// @brief The ROS34PW2 stepper wrapped by the adaptive stepper.
+template <class State, class Time>
+using stepper_adaptive_ros34pw2 = numint::stepper_adaptive<numint::stepper_ros34pw2<State, Time>>;
+
+/// @brief The BDF stepper.
+template <class State, class Time>
+using stepper_bdf = numint::stepper_bdf<State, Time>;
+
+/// @brief Benchmarks the steps of a stepper, on the chain of oscillators.
+/// @tparam Stepper The stepper.
+/// @param state The state of the benchmark.
+template <class Stepper>
+void step(benchmark::State &state)
+{
+    using state_type = typename Stepper::state_type;
+    using time_type  = typename Stepper::time_type;
+    using value_type = typename state_type::value_type;
+
+    Oscillators model;
+    state_type x = make_state<state_type>(state_size<state_type>(state));
+    Stepper stepper;
+    if constexpr (Stepper::is_adaptive_stepper) {
+        stepper.set_tollerance(value_type(1e-6));
+        stepper.set_min_delta(value_type(1e-6));
+        stepper.set_max_delta(value_type(1e-1));
+    }
+    stepper.adjust_size(x);
+
+    time_type t = 0, dt = time_type(1e-3);
+    numint::detail::allocation_scope scope;
+    for (auto _ : state) {
+        stepper.do_step(model, x, t, dt);
+        if constexpr (Stepper::is_adaptive_stepper) {
+            t += stepper.get_last_time_delta();
+            dt = stepper.get_time_delta();
+        } else {
+            t += dt;
+        }
+        benchmark::DoNotOptimize(x.data());
+        benchmark::ClobberMemory();
+    }
+    report(state, static_cast<std::size_t>(state.iterations()), model.evaluations, scope);
+}
+
+/// @brief Registers the benchmarks of a stepper, for all the states.
+/// @tparam Stepper The stepper.
+/// @param name The name of the stepper.
+/// @param sizes The sizes of the states of variable size.
+template <template <class, class> class Stepper>
+void register_stepper(const std::string &name, void (*sizes)(benchmark::internal::Benchmark *) = large_sizes)
+{
+    benchmark::RegisterBenchmark(("step/" + name + "/array2").c_str(), step<Stepper<State2, Time>>);
+    benchmark::RegisterBenchmark(("step/" + name + "/array16").c_str(), step<Stepper<State16, Time>>);
+    benchmark::RegisterBenchmark(("step/" + name + "/vector").c_str(), step<Stepper<StateN, Time>>)->Apply(sizes);
+}
+
+/// @brief Registers the benchmarks of a stepper, for the states of variable size in single precision.
+/// @tparam Stepper The stepper.
+/// @param name The name of the stepper.
+/// @param sizes The sizes of the states.
+template <template <class, class> class Stepper>
+void register_stepper_float(const std::string &name, void (*sizes)(benchmark::internal::Benchmark *) = large_sizes)
+{
+    benchmark::RegisterBenchmark(("step/" + name + "/vector_float").c_str(), step<Stepper<StateNf, float>>)
+        ->Apply(sizes);
+}
+
+/// @brief Registers the benchmarks of all the steppers.
+/// @return always zero.
+auto register_steppers() -> int
+{
+    // The basic steppers.
+    register_stepper<numint::stepper_euler>("euler");
+    register_stepper<numint::stepper_improved_euler>("improved_euler");
+    register_stepper<numint::stepper_midpoint>("midpoint");
+    register_stepper<numint::stepper_rk4>("rk4");
+    register_stepper<numint::stepper_simpsons>("simpsons");
+    register_stepper<numint::stepper_trapezoidal>("trapezoidal");
+    // The embedded pairs.
+    register_stepper<numint::stepper_dopri5>("dopri5");
+    register_stepper<numint::stepper_cash_karp>("cash_karp");
+    register_stepper<numint::stepper_bs32>("bs32");
+    // The generic explicit Runge-Kutta stepper.
+    register_stepper<numint::stepper_explicit_rk4>("explicit_rk4");
+    register_stepper<numint::stepper_explicit_dopri5>("explicit_dopri5");
+    // The multistep steppers.
+    register_stepper<stepper_ab4>("adams_bashforth4");
+    register_stepper<stepper_abm4>("abm4");
+    register_stepper<stepper_adaptive_abm8>("adaptive_abm");
+    // The symplectic steppers.
+    register_stepper<numint::stepper_symplectic_euler>("symplectic_euler");
+    register_stepper<numint::stepper_velocity_verlet>("velocity_verlet");
+    register_stepper<numint::stepper_yoshida4>("yoshida4");
+    register_stepper<numint::stepper_yoshida6>("yoshida6");
+    // The adaptive stepper.
+    register_stepper<stepper_adaptive_rk4>("adaptive_rk4");
+    register_stepper<stepper_adaptive_dopri5>("adaptive_dopri5");
+    register_stepper<stepper_adaptive_weighted_dopri5>("adaptive_weighted_dopri5");
+    // The implicit steppers factorize a dense Jacobian, hence the smaller states.
+    register_stepper<stepper_implicit_euler>("implicit_euler", small_sizes);
+    register_stepper<stepper_implicit_trapezoidal>("implicit_trapezoidal", small_sizes);
+    register_stepper<stepper_adaptive_ros34pw2>("adaptive_ros34pw2", small_sizes);
+    register_stepper<stepper_bdf>("bdf", small_sizes);
+    // The single precision states, which can be vectorized over twice the elements.
+    register_stepper_float<numint::stepper_rk4>("rk4");
+    register_stepper_float<numint::stepper_dopri5>("dopri5");
+    register_stepper_float<stepper_adaptive_dopri5>("adaptive_dopri5");
+    register_stepper_float<stepper_adaptive_weighted_dopri5>("adaptive_weighted_dopri5");
+    return 0;
+}
+
+/// Registers the benchmarks at start-up.
+const int registered_steppers = register_steppers();
+
+} // namespace bench
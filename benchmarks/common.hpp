@@ -0,0 +1,160 @@
+/// @file common.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Models and helpers shared by the benchmarks.
+
+#pragma once
+
+#include <benchmark/benchmark.h>
+
+#include <numint/detail/allocation_counter.hpp>
+#include <numint/detail/type_traits.hpp>
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+namespace bench
+{
+
+/// The time is a continuous time value.
+using Time = double;
+
+/// The small state, whose size is known at compile time.
+using State2 = std::array<double, 2>;
+
+/// The medium state, whose size is known at compile time.
+using State16 = std::array<double, 16>;
+
+/// The state whose size is chosen at run-time.
+using StateN = std::vector<double>;
+
+/// The state whose size is chosen at run-time, in single precision.
+using StateNf = std::vector<float>;
+
+/// @brief A chain of coupled harmonic oscillators, with fixed ends.
+///
+/// @details The state holds the positions in its first half, and the
+/// velocities in its second half, so that it can be integrated by the
+/// symplectic steppers as well. The model counts its evaluations.
+class Oscillators
+{
+public:
+    /// @brief Evaluates the system.
+    /// @param x The state.
+    /// @param dxdt The derivative of the state.
+    /// @param t The time.
+    template <class State, class T>
+    void operator()(const State &x, State &dxdt, T t) noexcept
+    {
+        using value_type = typename State::value_type;
+        (void)t;
+        const std::size_t half = x.size() / 2;
+        for (std::size_t i = 0; i < half; ++i) {
+            const value_type left  = (i > 0) ? x[i - 1] : value_type(0);
+            const value_type right = (i + 1 < half) ? x[i + 1] : value_type(0);
+            dxdt[i]                = x[half + i];
+            dxdt[half + i]         = left - 2 * x[i] + right;
+        }
+        ++evaluations;
+    }
+
+    /// @brief Evaluates the Jacobian of the system.
+    /// @param x The state.
+    /// @param J The Jacobian.
+    /// @param t The time.
+    template <class State, class Matrix, class T>
+    void jacobian(const State &x, Matrix &J, T t) noexcept
+    {
+        (void)t;
+        const std::size_t half = x.size() / 2;
+        J.fill(0.);
+        for (std::size_t i = 0; i < half; ++i) {
+            J(i, half + i) = 1.;
+            J(half + i, i) = -2.;
+            if (i > 0) {
+                J(half + i, i - 1) = 1.;
+            }
+            if (i + 1 < half) {
+                J(half + i, i + 1) = 1.;
+            }
+        }
+    }
+
+    /// The number of evaluations of the system.
+    std::size_t evaluations{};
+};
+
+/// @brief Creates the initial state of the oscillators.
+/// @tparam State The state vector type.
+/// @param size The number of elements, ignored for states of fixed size.
+/// @return the initial state, with the positions displaced and at rest.
+template <class State>
+auto make_state(std::size_t size) -> State
+{
+    State x{};
+    if constexpr (numint::detail::has_resize_v<State>) {
+        x.resize(size < 2 ? 2 : size);
+    }
+    const std::size_t half = x.size() / 2;
+    for (std::size_t i = 0; i < half; ++i) {
+        x[i] = static_cast<typename State::value_type>(std::sin(static_cast<double>(i + 1)));
+    }
+    return x;
+}
+
+/// @brief Returns the size of the state to benchmark.
+/// @tparam State The state vector type.
+/// @param state The state of the benchmark.
+/// @return the size passed as argument, for the states of variable size, or zero.
+template <class State>
+auto state_size(const benchmark::State &state) -> std::size_t
+{
+    if constexpr (numint::detail::has_resize_v<State>) {
+        return static_cast<std::size_t>(state.range(0));
+    } else {
+        return 0;
+    }
+}
+
+/// @brief Reports the counters shared by the benchmarks.
+/// @param state The state of the benchmark.
+/// @param steps The number of integration steps executed.
+/// @param evaluations The number of evaluations of the system.
+/// @param scope The allocations executed during the benchmark.
+inline void report(
+    benchmark::State &state,
+    std::size_t steps,
+    std::size_t evaluations,
+    const numint::detail::allocation_scope &scope)
+{
+    using benchmark::Counter;
+    state.counters["steps/s"]      = Counter(static_cast<double>(steps), Counter::kIsRate);
+    state.counters["rhs/s"]        = Counter(static_cast<double>(evaluations), Counter::kIsRate);
+    state.counters["bytes_alloc"]  = Counter(static_cast<double>(scope.bytes()), Counter::kAvgIterations);
+    state.counters["allocs"]       = Counter(static_cast<double>(scope.allocations()), Counter::kAvgIterations);
+    state.counters["rhs_per_step"] = static_cast<double>(evaluations) / static_cast<double>(steps ? steps : 1);
+}
+
+/// @brief Benchmarks the states of variable size from 2 up to 2^20 elements.
+/// @param benchmark The benchmark.
+inline void large_sizes(benchmark::internal::Benchmark *benchmark)
+{
+    benchmark->RangeMultiplier(16)->Range(2, 1L << 20);
+}
+
+/// @brief Benchmarks the states of variable size from 2 up to 2^16 elements.
+/// @param benchmark The benchmark.
+inline void medium_sizes(benchmark::internal::Benchmark *benchmark)
+{
+    benchmark->RangeMultiplier(16)->Range(2, 1L << 16);
+}
+
+/// @brief Benchmarks the states of variable size from 2 up to 256 elements.
+/// @param benchmark The benchmark.
+inline void small_sizes(benchmark::internal::Benchmark *benchmark)
+{
+    benchmark->RangeMultiplier(4)->Range(2, 256);
+}
+
+} // namespace bench
@@ -0,0 +1,14 @@
+/// @file main.cpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Entry point of the benchmarks.
+///
+/// @details The allocations are counted by replacing the global allocation
+/// functions, which must happen in exactly one translation unit.
+
+#include <benchmark/benchmark.h>
+
+#include <numint/detail/allocation_counter.hpp>
+
+NUMINT_DEFINE_ALLOCATION_COUNTER
+
+BENCHMARK_MAIN();
@@ -18,6 +18,9 @@
 #include <numint/detail/observer.hpp>
 #include <numint/solver.hpp>
 #include <numint/stepper/stepper_adaptive.hpp>
+#include <numint/stepper/stepper_bs32.hpp>
+#include <numint/stepper/stepper_cash_karp.hpp>
+#include <numint/stepper/stepper_dopri5.hpp>
 #include <numint/stepper/stepper_euler.hpp>
 #include <numint/stepper/stepper_improved_euler.hpp>
 #include <numint/stepper/stepper_midpoint.hpp>
@@ -147,6 +150,9 @@ int main(int, char **)
     numint::stepper_adaptive<numint::stepper_trapezoidal<State, Time>, Iterations, Error> trapezoidal;
     numint::stepper_adaptive<numint::stepper_simpsons<State, Time>, Iterations, Error> simpsons;
     numint::stepper_adaptive<numint::stepper_rk4<State, Time>, Iterations, Error> rk4;
+    numint::stepper_adaptive<numint::stepper_bs32<State, Time>, Iterations, Error> bs32;
+    numint::stepper_adaptive<numint::stepper_cash_karp<State, Time>, Iterations, Error> cash_karp;
+    numint::stepper_adaptive<numint::stepper_dopri5<State, Time>, Iterations, Error> dopri5;
     numint::stepper_adaptive<numint::stepper_rk4<State, Time>, Iterations, Error> reference;
 
     // Setup the observers.
@@ -161,6 +167,9 @@ int main(int, char **)
     Observer obs_trapezoidal;
     Observer obs_simpsons;
     Observer obs_rk4;
+    Observer obs_bs32;
+    Observer obs_cash_karp;
+    Observer obs_dopri5;
     Observer obs_reference;
 
     // Run the integration.
@@ -174,6 +183,9 @@ int main(int, char **)
     run_test_adaptive_step("trapezoidal", trapezoidal, obs_trapezoidal, model, x0, start_time, end_time, delta_time);
     run_test_adaptive_step("simpsons", simpsons, obs_simpsons, model, x0, start_time, end_time, delta_time);
     run_test_adaptive_step("rk4", rk4, obs_rk4, model, x0, start_time, end_time, delta_time);
+    run_test_adaptive_step("bs32", bs32, obs_bs32, model, x0, start_time, end_time, delta_time);
+    run_test_adaptive_step("cash_karp", cash_karp, obs_cash_karp, model, x0, start_time, end_time, delta_time);
+    run_test_adaptive_step("dopri5", dopri5, obs_dopri5, model, x0, start_time, end_time, delta_time);
     run_test_adaptive_step("reference", reference, obs_reference, model, x0, start_time, end_time, 5e-04);
 
 #ifdef ENABLE_PLOT
@@ -224,6 +236,12 @@ int main(int, char **)
         .set_line_type(gpcpp::line_type_t::solid) // Line style: solid ("-")
         .plot_xy(obs_rk4.time, obs_rk4.angle, "rk4.angle");
 
+    // Plot Dormand-Prince method
+    gnuplot.set_line_width(2)
+        .set_plot_type(gpcpp::plot_type_t::lines)  // Line style: lines
+        .set_line_type(gpcpp::line_type_t::dashed) // Line style: dashed ("--")
+        .plot_xy(obs_dopri5.time, obs_dopri5.angle, "dopri5.angle");
+
     // Plot Reference method
     gnuplot.set_line_width(2)
         .set_plot_type(gpcpp::plot_type_t::lines) // Line style: lines
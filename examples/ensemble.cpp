@@ -0,0 +1,156 @@
+/// @file ensemble.cpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Sweeps the damping of a spring-mass-damper, by integrating each
+/// configuration separately, and then all of them together as an ensemble.
+
+#include <cmath>
+#include <exception>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include <timelib/stopwatch.hpp>
+
+#include "defines.hpp"
+
+#include <numint/detail/observer.hpp>
+#include <numint/ensemble.hpp>
+#include <numint/solver.hpp>
+#include <numint/stepper/stepper_rk4.hpp>
+
+namespace ensemble
+{
+
+/// @brief Number of variables of a single system.
+constexpr std::size_t Variables = 2;
+
+/// @brief State of a single system.
+///     x[0] : Position.
+///     x[1] : Velocity.
+using State = std::array<Variable, Variables>;
+
+/// @brief State of the whole ensemble.
+using EnsembleState = numint::ensemble_state<Variable, Variables>;
+
+/// @brief Parameters of our model.
+struct Parameter {
+    /// @brief Mass [kg].
+    Variable m = 5.0;
+    /// @brief Spring stiffness [N/m].
+    Variable k = 40.0;
+};
+
+/// @brief A single spring-mass-damper, with the given damping.
+struct Model : public Parameter {
+    Model(Variable _c)
+        : c(_c)
+    {
+        // Nothing to do.
+    }
+
+    /// @brief Spring-mass-damper behaviour.
+    /// @param x the current state.
+    /// @param dxdt the final state.
+    /// @param t the current time.
+    inline void operator()(const State &x, State &dxdt, Time t) noexcept
+    {
+        (void)t;
+        dxdt[0] = x[1];
+        dxdt[1] = -c / m * x[1] - k / m * x[0];
+    }
+
+    /// @brief Damping constant.
+    Variable c;
+};
+
+/// @brief All the spring-mass-dampers, each with its own damping.
+struct EnsembleModel : public Parameter {
+    EnsembleModel(std::vector<Variable> _c)
+        : c(std::move(_c))
+    {
+        // Nothing to do.
+    }
+
+    /// @brief Spring-mass-damper behaviour, for all the members at once.
+    /// @param x the current state.
+    /// @param dxdt the final state.
+    /// @param t the current time.
+    inline void operator()(const EnsembleState &x, EnsembleState &dxdt, Time t) noexcept
+    {
+        (void)t;
+        const Variable *position = x.variable(0);
+        const Variable *velocity = x.variable(1);
+        Variable *dposition      = dxdt.variable(0);
+        Variable *dvelocity      = dxdt.variable(1);
+        for (std::size_t i = 0; i < x.members(); ++i) {
+            dposition[i] = velocity[i];
+            dvelocity[i] = -c[i] / m * velocity[i] - k / m * position[i];
+        }
+    }
+
+    /// @brief Damping constants, one for each member.
+    std::vector<Variable> c;
+};
+
+} // namespace ensemble
+
+int main(int, char **)
+{
+    using namespace ensemble;
+
+    // Simulation parameters.
+    const std::size_t members = 1024;
+    const Time time_start     = 0.0;
+    const Time time_end       = 10.0;
+    const Time time_delta     = 1e-03;
+    // The initial state, shared by all the members.
+    const State x0{1.0, 0.0};
+
+    // The damping of each member.
+    std::vector<Variable> damping(members);
+    for (std::size_t i = 0; i < members; ++i) {
+        damping[i] = 10.0 * static_cast<Variable>(i) / static_cast<Variable>(members);
+    }
+
+    // Instantiate the stopwatch.
+    timelib::Stopwatch sw;
+    std::cout << std::fixed;
+    std::cout << "Simulating...\n";
+
+    // Integrate each member on its own.
+    std::vector<State> x_single(members, x0);
+    sw.start();
+    for (std::size_t i = 0; i < members; ++i) {
+        numint::stepper_rk4<State, Time> solver;
+        numint::detail::Observer<State, Time> observer;
+        numint::integrate_fixed(solver, observer, Model(damping[i]), x_single[i], time_start, time_end, time_delta);
+    }
+    sw.round();
+
+    // Integrate all the members together.
+    EnsembleState x_ensemble(members);
+    for (std::size_t i = 0; i < members; ++i) {
+        x_ensemble.set_member(i, x0);
+    }
+    numint::stepper_rk4<EnsembleState, Time> solver;
+    numint::detail::Observer<EnsembleState, Time> observer;
+    numint::integrate_ensemble(solver, observer, EnsembleModel(damping), x_ensemble, time_start, time_end, time_delta);
+    sw.round();
+
+    // Compare the results.
+    Variable max_diff = 0;
+    for (std::size_t i = 0; i < members; ++i) {
+        State x;
+        x_ensemble.get_member(i, x);
+        for (std::size_t j = 0; j < Variables; ++j) {
+            max_diff = std::max(max_diff, std::abs(x[j] - x_single[i][j]));
+        }
+    }
+
+    std::cout << "\n";
+    std::cout << "Elapsed times for " << members << " members:\n";
+    std::cout << "    One at a time : " << sw[0] << "\n";
+    std::cout << "    Ensemble      : " << sw[1] << "\n";
+    std::cout << "Maximum difference between the two : " << std::scientific << max_diff << "\n";
+    return 0;
+}
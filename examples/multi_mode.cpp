@@ -16,6 +16,7 @@
 #include "defines.hpp"
 
 #include <numint/detail/observer.hpp>
+#include <numint/event.hpp>
 #include <numint/solver.hpp>
 #include <numint/stepper/stepper_adaptive.hpp>
 #include <numint/stepper/stepper_euler.hpp>
@@ -164,9 +165,15 @@ int main(int, char **)
     timelib::Stopwatch sw;
     x = x0;
     sw.start();
-    numint::integrate_adaptive(stepper, observer, model, x, time_start, time_end / 2, time_delta);
-    model.Gr = 10;
-    numint::integrate_adaptive(stepper, observer, model, x, time_end / 2, time_end, time_delta);
+    // Switch the gear ratio half-way through the simulation.
+    std::vector<numint::event<State, Time>> events{
+        {[time_end](const State &, Time t) { return t - time_end / 2; }, numint::event_direction::rising,
+         [&model](State &, Time) {
+             model.Gr = 10;
+             return numint::event_action::reset;
+         }},
+    };
+    numint::integrate_events(stepper, observer, model, x, time_start, time_end, time_delta, events);
     sw.round();
     std::cout << "Integration took " << std::setw(12) << stepper.steps() << " steps, for a total of " << sw.last_round()
               << "\n";
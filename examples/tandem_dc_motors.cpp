@@ -16,6 +16,7 @@
 #include "defines.hpp"
 
 #include <numint/detail/observer.hpp>
+#include <numint/piecewise.hpp>
 #include <numint/solver.hpp>
 #include <numint/stepper/stepper_adaptive.hpp>
 #include <numint/stepper/stepper_euler.hpp>
@@ -408,20 +409,17 @@ int main(int, char **)
     Sequence sequence = {
         Step{mode_0, 150.}, Step{mode_1, 150.}, Step{mode_2, 150.}, Step{mode_3, 150.}, Step{mode_4, 150.}};
 
+    // Turn the sequence into the segments of the integration, each one setting its mode.
+    std::vector<numint::segment<State, Time>> segments;
+    for (const Step &step : sequence) {
+        segments.push_back({step.duration, [&model, mode = step.mode](State &, Time) { model.mode = mode; }});
+    }
+
     // Set the initial state.
     x = x0;
     // Start the simulation.
     sw.start();
-    for (std::size_t i = 0; i < sequence.size(); ++i) {
-        // Set the mode.
-        model.mode    = sequence[i].mode;
-        // Get the duration.
-        Time duration = sequence[i].duration;
-        // Run the solver.
-        numint::integrate_adaptive(solver, obs, model, x, time, time + duration, time_delta);
-        // Advance time.
-        time += duration;
-    }
+    numint::integrate_piecewise(solver, obs, model, x, time, segments, time_delta);
     // Get the elapsed time.
     sw.round();
 
@@ -0,0 +1,125 @@
+/// @file zero_allocations.cpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Checks that the steppers do not allocate memory while integrating,
+/// once they were sized for the state, and fails otherwise.
+
+// Count the allocations, also in the optimized builds.
+#ifndef NUMINT_ENABLE_ALLOCATION_COUNTER
+#define NUMINT_ENABLE_ALLOCATION_COUNTER
+#endif
+
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "defines.hpp"
+
+#include <numint/detail/allocation_counter.hpp>
+#include <numint/stepper/stepper_abm.hpp>
+#include <numint/stepper/stepper_adams_bashforth.hpp>
+#include <numint/stepper/stepper_adaptive.hpp>
+#include <numint/stepper/stepper_bdf.hpp>
+#include <numint/stepper/stepper_bs32.hpp>
+#include <numint/stepper/stepper_dopri5.hpp>
+#include <numint/stepper/stepper_euler.hpp>
+#include <numint/stepper/stepper_explicit_rk.hpp>
+#include <numint/stepper/stepper_implicit_euler.hpp>
+#include <numint/stepper/stepper_rk4.hpp>
+
+NUMINT_DEFINE_ALLOCATION_COUNTER
+
+namespace zero_allocations
+{
+
+/// @brief State of the system, stored on the heap, so that any copy of it allocates.
+/// x[0] : Position
+/// x[1] : Speed
+using State = std::vector<Variable>;
+
+/// @brief The Van der Pol oscillator, whose stiffness makes the adaptive steppers change their step-size.
+class Model
+{
+public:
+    inline void operator()(const State &x, State &dxdt, Time t) const noexcept
+    {
+        (void)t;
+        dxdt[0] = x[1];
+        dxdt[1] = 5. * (1. - x[0] * x[0]) * x[1] - x[0];
+    }
+};
+
+/// @brief Integrates the model, and counts the allocations of the steps taken after the first ones.
+/// @param name The name of the stepper.
+/// @param stepper The stepper.
+/// @return true if the stepper did not allocate memory.
+template <class Stepper>
+inline bool check(const std::string &name, Stepper &stepper)
+{
+    // The steps counted, and the first steps, which can fill the history of the multistep methods.
+    const unsigned warm_up = 20, steps = 2000;
+    Model model;
+    State x{2., 0.};
+    Time t = 0., dt = 0.01;
+    stepper.adjust_size(x);
+    std::size_t allocations = 0, bytes = 0;
+    for (unsigned step = 0; step < warm_up + steps; ++step) {
+        numint::detail::allocation_scope scope;
+        stepper.do_step(model, x, t, dt);
+        if constexpr (Stepper::is_adaptive_stepper) {
+            t += stepper.get_last_time_delta();
+            dt = stepper.get_time_delta();
+        } else {
+            t += dt;
+        }
+        if (step >= warm_up) {
+            allocations += scope.allocations();
+            bytes += scope.bytes();
+        }
+    }
+    std::cout << "    " << std::setw(24) << std::left << name << std::right;
+    std::cout << std::setw(8) << allocations << " allocations, ";
+    std::cout << std::setw(8) << bytes << " bytes, in " << steps << " steps\n";
+    return allocations == 0;
+}
+
+} // namespace zero_allocations
+
+int main(int, char **)
+{
+    using namespace zero_allocations;
+
+    // Instantiate the steppers.
+    numint::stepper_euler<State, Time> euler;
+    numint::stepper_rk4<State, Time> rk4;
+    numint::stepper_explicit_rk4<State, Time> explicit_rk4;
+    numint::stepper_adams_bashforth<State, Time, 4> adams_bashforth;
+    numint::stepper_abm<State, Time, 4> abm;
+    numint::stepper_implicit_euler<State, Time> implicit_euler;
+    numint::stepper_adaptive<numint::stepper_rk4<State, Time>> adaptive_rk4;
+    numint::stepper_adaptive<numint::stepper_dopri5<State, Time>> adaptive_dopri5;
+    numint::stepper_adaptive<numint::stepper_bs32<State, Time>> adaptive_bs32;
+    numint::stepper_adaptive_abm<State, Time, 5> adaptive_abm;
+    numint::stepper_bdf<State, Time> bdf;
+
+    std::cout << "Allocations of the steps, once the steppers are sized for the state:\n";
+    bool success = true;
+    success &= check("euler", euler);
+    success &= check("rk4", rk4);
+    success &= check("explicit_rk4", explicit_rk4);
+    success &= check("adams_bashforth", adams_bashforth);
+    success &= check("abm", abm);
+    success &= check("implicit_euler", implicit_euler);
+    success &= check("adaptive<rk4>", adaptive_rk4);
+    success &= check("adaptive<dopri5>", adaptive_dopri5);
+    success &= check("adaptive<bs32>", adaptive_bs32);
+    success &= check("adaptive_abm", adaptive_abm);
+    success &= check("bdf", bdf);
+
+    if (!success) {
+        std::cerr << "Some steppers allocated memory while integrating.\n";
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,173 @@
+/// @file cached_system.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief A system remembering its last evaluation, so that the steppers and
+/// the observers evaluating it again at the same point reuse the derivative.
+
+#pragma once
+
+#include "numint/detail/device.hpp"
+#include "numint/detail/type_traits.hpp"
+
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <type_traits>
+#include <utility>
+
+namespace numint
+{
+
+/// @brief Remembers the last evaluations of a system, keyed by the state and
+/// the time, and reuses them when the system is evaluated again at the same point.
+///
+/// @details The points evaluated more than once are, for instance, the
+/// beginning of an adaptive step with step doubling (where the main and the
+/// tuning steppers both start from the same state), the beginning of the
+/// retries after a rejected step, the end of the steps of the FSAL steppers
+/// (e.g., `stepper_dopri5`), when the observer needs the derivative there,
+/// and the observers asking for the derivative at a point the stepper already
+/// evaluated (e.g., to log the torque of a motor). Observers can call
+/// `derivative(x, t)`, which evaluates the system only if it was not just
+/// evaluated at (x, t) by one of its last `Entries` evaluations. With step
+/// doubling, the tuning stepper starts from the point evaluated by the main
+/// stepper as many evaluations before as the stages of the method, which
+/// should not exceed `Entries`.
+///
+/// A point is the same when the time and every element of the state are
+/// equal. The times are compared first, then the states of the entries with
+/// the same time, and a miss copies the state into the oldest entry: the
+/// cache pays off for the systems whose evaluation is expensive compared to
+/// copying their state. The system must be a pure function of the state and
+/// the time, hence the systems which update their own parameters at each
+/// evaluation (e.g., the resistance of a motor heating up, compounded call
+/// after call) must not be wrapped, since a reused evaluation changes their
+/// trajectory. The cache must be discarded by `invalidate` whenever the
+/// system changes (e.g., its inputs or parameters). The support states
+/// are allocated by the first evaluation. The Jacobian of the system, if any,
+/// is forwarded unchanged.
+///
+/// @tparam System The type of the system.
+/// @tparam State The state vector type.
+/// @tparam Time The datatype used to hold time.
+/// @tparam Entries The number of evaluations remembered.
+template <class System, class State, class Time, std::size_t Entries = 4>
+class cached_system
+{
+public:
+    /// @brief Wraps the system.
+    /// @param system The system.
+    template <class S>
+    explicit cached_system(S &&system)
+        : m_system(std::forward<S>(system))
+    {
+        // Nothing to do.
+    }
+
+    /// @brief Evaluates the system, or copies the derivative of its last evaluation at the same point.
+    /// @param x The state.
+    /// @param dxdt The derivative of the state.
+    /// @param t The time.
+    void operator()(const State &x, State &dxdt, Time t)
+    {
+        const State &derivative = this->derivative(x, t);
+        detail::copy_state(derivative, dxdt);
+    }
+
+    /// @brief Returns the derivative at the given point, evaluating the system only if needed.
+    /// @param x The state.
+    /// @param t The time.
+    /// @return a reference to the derivative, valid until the next evaluation.
+    auto derivative(const State &x, Time t) -> const State &
+    {
+        for (const entry &e : m_entries) {
+            if (e.valid && std::equal_to<>{}(t, e.t) && (x.size() == e.x.size()) && detail::equal_states(x, e.x)) {
+                ++m_hits;
+                return e.dxdt;
+            }
+        }
+        // Replace the oldest entry.
+        entry &e = m_entries[m_next];
+        m_next   = (m_next + 1) % Entries;
+        if constexpr (detail::has_resize_v<State>) {
+            e.x.resize(x.size());
+            e.dxdt.resize(x.size());
+        }
+        m_system(x, e.dxdt, t);
+        detail::copy_state(x, e.x);
+        e.t     = t;
+        e.valid = true;
+        ++m_evaluations;
+        return e.dxdt;
+    }
+
+    /// @brief Evaluates the Jacobian of the system, when the system provides it.
+    /// @param x The state.
+    /// @param J The matrix receiving the Jacobian.
+    /// @param t The time.
+    template <class Matrix, class S = System>
+    auto jacobian(const State &x, Matrix &J, Time t)
+        -> decltype(std::declval<std::remove_reference_t<S> &>().jacobian(x, J, t))
+    {
+        return m_system.jacobian(x, J, t);
+    }
+
+    /// @brief Discards the last evaluations, e.g., after the system changed.
+    void invalidate() noexcept
+    {
+        for (entry &e : m_entries) {
+            e.valid = false;
+        }
+    }
+
+    /// @brief Provides access to the system.
+    /// @return A reference to the system.
+    constexpr auto system() -> std::remove_reference_t<System> & { return m_system; }
+
+    /// @brief Returns the number of evaluations of the system.
+    /// @return the number of evaluations.
+    constexpr auto evaluations() const noexcept -> std::size_t { return m_evaluations; }
+
+    /// @brief Returns the number of evaluations reused from the cache.
+    /// @return the number of reused evaluations.
+    constexpr auto hits() const noexcept -> std::size_t { return m_hits; }
+
+private:
+    static_assert(Entries > 0, "The cache must remember at least one evaluation.");
+
+    /// @brief An evaluation of the system.
+    struct entry {
+        /// The state.
+        State x{};
+        /// The time.
+        Time t{};
+        /// The derivative.
+        State dxdt{};
+        /// Whether the evaluation is valid.
+        bool valid{};
+    };
+
+    /// The system.
+    System m_system;
+    /// The last evaluations.
+    std::array<entry, Entries> m_entries{};
+    /// The entry replaced by the next miss.
+    std::size_t m_next{};
+    /// The number of evaluations of the system.
+    std::size_t m_evaluations{};
+    /// The number of evaluations reused from the cache.
+    std::size_t m_hits{};
+};
+
+/// @brief Wraps a system, so that it is not evaluated again at the same point.
+/// @details Objects passed as lvalues are kept by reference, temporaries are moved inside the wrapper.
+/// @tparam State The state vector type.
+/// @tparam Time The datatype used to hold time.
+/// @param system The system.
+/// @return The system, remembering its last evaluation.
+template <class State, class Time, class System>
+auto with_cache(System &&system)
+{
+    return cached_system<System, State, Time>(std::forward<System>(system));
+}
+
+} // namespace numint
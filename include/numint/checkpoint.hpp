@@ -0,0 +1,397 @@
+/// @file checkpoint.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Checkpoints of an integration, i.e., compact binary snapshots of the
+/// state and of the stepper, from which the integration can be restarted.
+///
+/// @details A checkpoint holds the state, the time, the step-size, and the
+/// data carried by the stepper between the steps (e.g., the history of the
+/// multistep steppers, the FSAL derivative, or the history of the controller),
+/// saved by the `serialize` member function of the stepper:
+///
+///     template <class Archive>
+///     void serialize(Archive &archive) { archive(m_steps, m_history, ...); }
+///
+/// which is used both to save and to restore the stepper. The archive accepts
+/// arithmetic values, containers of them (including nested ones), and objects
+/// providing their own `serialize`.
+///
+/// Restoring a checkpoint into a stepper of the same type, and continuing the
+/// integration with `resume_adaptive` or `resume_fixed` (see `solver.hpp`),
+/// produces the same results as continuing it with the stepper which saved the
+/// checkpoint, bit for bit.
+/// The implicit steppers do not save their Jacobian, which is evaluated again
+/// by the first step after the restore, hence their results may differ within
+/// the tolerance of the Newton iterations.
+///
+/// The data is written in the byte order of the machine, and a checkpoint can
+/// only be restored on a machine with the same byte order, and by a program
+/// using the same types.
+
+#pragma once
+
+#include "numint/detail/type_traits.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace numint
+{
+
+namespace detail
+{
+
+/// @brief Checks if a type provides its own `serialize` member function.
+/// @tparam T The type.
+/// @tparam Archive The type of the archive.
+template <class T, class Archive, class = void>
+struct has_serialize : std::false_type {
+};
+
+/// @brief Checks if a type provides its own `serialize` member function.
+/// @tparam T The type.
+/// @tparam Archive The type of the archive.
+template <class T, class Archive>
+struct has_serialize<T, Archive, std::void_t<decltype(std::declval<T &>().serialize(std::declval<Archive &>()))>>
+    : std::true_type {
+};
+
+/// @brief Helper variable template to check if a type provides its own `serialize` member function.
+template <class T, class Archive>
+constexpr inline bool has_serialize_v = has_serialize<T, Archive>::value;
+
+/// @brief Checks if a container stores its arithmetic elements contiguously.
+/// @tparam T The type of the container.
+template <class T, class = void>
+struct is_contiguous_arithmetic : std::false_type {
+};
+
+/// @brief Checks if a container stores its arithmetic elements contiguously.
+/// @tparam T The type of the container.
+template <class T>
+struct is_contiguous_arithmetic<T, std::void_t<decltype(std::declval<T &>().data())>>
+    : std::is_arithmetic<std::remove_pointer_t<decltype(std::declval<T &>().data())>> {
+};
+
+/// @brief The first bytes of every checkpoint.
+constexpr inline char checkpoint_magic[8] = {'N', 'U', 'M', 'I', 'N', 'T', 'C', 'K'};
+
+/// @brief The version of the format of the checkpoints.
+constexpr inline std::uint32_t checkpoint_version = 1;
+
+/// @brief Returns the byte order of the machine.
+/// @return 1 for little-endian machines, 0 for big-endian ones.
+inline auto checkpoint_byte_order() noexcept -> std::uint8_t
+{
+    const std::uint16_t probe = 1;
+    std::uint8_t first        = 0;
+    std::memcpy(&first, &probe, 1);
+    return first;
+}
+
+} // namespace detail
+
+/// @brief Archive writing the serialized objects into a buffer of bytes.
+class checkpoint_writer
+{
+public:
+    /// @brief Writes the given objects, in order.
+    /// @param values The objects.
+    template <class... Ts>
+    void operator()(Ts &...values)
+    {
+        (this->write(values), ...);
+    }
+
+    /// @brief Provides access to the bytes written up until now.
+    /// @return a reference to the bytes.
+    auto data() const noexcept -> const std::vector<unsigned char> & { return m_data; }
+
+    /// @brief Moves out the bytes written up until now.
+    /// @return the bytes.
+    auto release() noexcept -> std::vector<unsigned char> { return std::move(m_data); }
+
+private:
+    /// @brief Writes the raw bytes.
+    /// @param source The address of the bytes.
+    /// @param size The number of bytes.
+    void write_bytes(const void *source, std::size_t size)
+    {
+        const auto *bytes = static_cast<const unsigned char *>(source);
+        m_data.insert(m_data.end(), bytes, bytes + size);
+    }
+
+    /// @brief Writes a single object.
+    /// @param value The object.
+    template <class T>
+    void write(T &value)
+    {
+        using type = std::remove_cv_t<T>;
+        if constexpr (std::is_arithmetic_v<type> || std::is_enum_v<type>) {
+            this->write_bytes(&value, sizeof(type));
+        } else if constexpr (detail::has_serialize_v<type, checkpoint_writer>) {
+            value.serialize(*this);
+        } else if constexpr (std::is_array_v<type>) {
+            // Arrays have a fixed size.
+            for (auto &element : value) {
+                this->write(element);
+            }
+        } else {
+            // Containers are preceded by their size.
+            auto size = static_cast<std::uint64_t>(value.size());
+            this->write(size);
+            if constexpr (detail::is_contiguous_arithmetic<type>::value) {
+                this->write_bytes(value.data(), value.size() * sizeof(*value.data()));
+            } else {
+                for (auto &element : value) {
+                    this->write(element);
+                }
+            }
+        }
+    }
+
+    /// The bytes written up until now.
+    std::vector<unsigned char> m_data;
+};
+
+/// @brief Archive reading the serialized objects from a buffer of bytes.
+///
+/// @details Containers which can be resized take the size they had when they
+/// were written, the others must already have it. Reading beyond the end of
+/// the buffer, or into a container of a different size, throws a
+/// `std::runtime_error`.
+class checkpoint_reader
+{
+public:
+    /// @brief Reads from the given bytes, which must outlive the reader.
+    /// @param data The address of the bytes.
+    /// @param size The number of bytes.
+    checkpoint_reader(const unsigned char *data, std::size_t size) noexcept
+        : m_data(data)
+        , m_size(size)
+        , m_position()
+    {
+        // Nothing to do.
+    }
+
+    /// @brief Reads the given objects, in order.
+    /// @param values The objects.
+    template <class... Ts>
+    void operator()(Ts &...values)
+    {
+        (this->read(values), ...);
+    }
+
+    /// @brief Returns the number of bytes which were not read yet.
+    /// @return the number of bytes.
+    auto remaining() const noexcept -> std::size_t { return m_size - m_position; }
+
+private:
+    /// @brief Reads the raw bytes.
+    /// @param destination The address receiving the bytes.
+    /// @param size The number of bytes.
+    void read_bytes(void *destination, std::size_t size)
+    {
+        if (size > this->remaining()) {
+            throw std::runtime_error("The checkpoint is truncated.");
+        }
+        if (size > 0) {
+            std::memcpy(destination, m_data + m_position, size);
+        }
+        m_position += size;
+    }
+
+    /// @brief Reads a single object.
+    /// @param value The object.
+    template <class T>
+    void read(T &value)
+    {
+        if constexpr (std::is_arithmetic_v<T> || std::is_enum_v<T>) {
+            this->read_bytes(&value, sizeof(T));
+        } else if constexpr (detail::has_serialize_v<T, checkpoint_reader>) {
+            value.serialize(*this);
+        } else if constexpr (std::is_array_v<T>) {
+            // Arrays have a fixed size.
+            for (auto &element : value) {
+                this->read(element);
+            }
+        } else {
+            // Containers are preceded by their size.
+            std::uint64_t size = 0;
+            this->read(size);
+            if constexpr (detail::has_resize_v<T>) {
+                value.resize(static_cast<std::size_t>(size));
+            }
+            if (size != static_cast<std::uint64_t>(value.size())) {
+                throw std::runtime_error("The checkpoint does not match the size of the container.");
+            }
+            if constexpr (detail::is_contiguous_arithmetic<T>::value) {
+                this->read_bytes(value.data(), value.size() * sizeof(*value.data()));
+            } else {
+                for (auto &element : value) {
+                    this->read(element);
+                }
+            }
+        }
+    }
+
+    /// The address of the bytes.
+    const unsigned char *m_data;
+    /// The number of bytes.
+    std::size_t m_size;
+    /// The number of bytes read up until now.
+    std::size_t m_position;
+};
+
+/// @brief Saves a checkpoint of the integration.
+///
+/// @tparam Stepper The type of the integration stepper.
+///
+/// @param stepper The stepper, providing `serialize`.
+/// @param state The current state of the system.
+/// @param time The current time.
+/// @param time_delta The step-size of the next step (e.g., `stepper.get_time_delta()`, for adaptive steppers).
+///
+/// @return The bytes of the checkpoint.
+template <class Stepper>
+auto save_checkpoint(
+    Stepper &stepper,
+    const typename Stepper::state_type &state,
+    typename Stepper::time_type time,
+    typename Stepper::time_type time_delta) -> std::vector<unsigned char>
+{
+    checkpoint_writer writer;
+    char magic[sizeof(detail::checkpoint_magic)];
+    std::memcpy(magic, detail::checkpoint_magic, sizeof(magic));
+    std::uint32_t version   = detail::checkpoint_version;
+    std::uint8_t byte_order = detail::checkpoint_byte_order();
+    writer(magic, version, byte_order);
+    writer(state, time, time_delta);
+    stepper.serialize(writer);
+    return writer.release();
+}
+
+/// @brief Restores a checkpoint of the integration.
+///
+/// @details The stepper is sized on the restored state, and then it takes
+/// the data it had when the checkpoint was saved. The integration continues
+/// from the restored state and time with `resume_adaptive` or `resume_fixed`,
+/// which do not discard the data of the stepper.
+///
+/// @tparam Stepper The type of the integration stepper.
+///
+/// @param data The bytes of the checkpoint.
+/// @param stepper The stepper, of the same type of the one which saved the checkpoint.
+/// @param state Receives the state of the system.
+/// @param time Receives the time.
+/// @param time_delta Receives the step-size of the next step.
+///
+/// @throws std::runtime_error if the bytes are not a valid checkpoint for the stepper.
+template <class Stepper>
+void load_checkpoint(
+    const std::vector<unsigned char> &data,
+    Stepper &stepper,
+    typename Stepper::state_type &state,
+    typename Stepper::time_type &time,
+    typename Stepper::time_type &time_delta)
+{
+    checkpoint_reader reader(data.data(), data.size());
+    char magic[sizeof(detail::checkpoint_magic)];
+    std::uint32_t version   = 0;
+    std::uint8_t byte_order = 0;
+    reader(magic, version, byte_order);
+    if (std::memcmp(magic, detail::checkpoint_magic, sizeof(magic)) != 0) {
+        throw std::runtime_error("The data is not a checkpoint.");
+    }
+    if (version != detail::checkpoint_version) {
+        throw std::runtime_error("The checkpoint was saved with a different version of the format.");
+    }
+    if (byte_order != detail::checkpoint_byte_order()) {
+        throw std::runtime_error("The checkpoint was saved on a machine with a different byte order.");
+    }
+    reader(state, time, time_delta);
+    stepper.adjust_size(state);
+    stepper.serialize(reader);
+    if (reader.remaining() > 0) {
+        throw std::runtime_error("The checkpoint was saved by a different stepper.");
+    }
+}
+
+/// @brief Saves a checkpoint of the integration into a file.
+///
+/// @details The checkpoint is written into a temporary file, next to the
+/// given one, which then replaces it, so that an interrupted save never
+/// leaves a partial checkpoint behind.
+///
+/// @tparam Stepper The type of the integration stepper.
+///
+/// @param path The path of the file.
+/// @param stepper The stepper, providing `serialize`.
+/// @param state The current state of the system.
+/// @param time The current time.
+/// @param time_delta The step-size of the next step.
+///
+/// @throws std::runtime_error if the file cannot be written.
+template <class Stepper>
+void save_checkpoint_file(
+    const std::string &path,
+    Stepper &stepper,
+    const typename Stepper::state_type &state,
+    typename Stepper::time_type time,
+    typename Stepper::time_type time_delta)
+{
+    const std::vector<unsigned char> data = save_checkpoint(stepper, state, time, time_delta);
+    const std::string temporary           = path + ".tmp";
+    {
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char *>(data.data()), static_cast<std::streamsize>(data.size()));
+        file.close();
+        if (!file) {
+            std::remove(temporary.c_str());
+            throw std::runtime_error("Cannot write the checkpoint file `" + temporary + "`.");
+        }
+    }
+    // Some platforms do not replace an existing file.
+    if ((std::rename(temporary.c_str(), path.c_str()) != 0) &&
+        ((std::remove(path.c_str()) != 0) || (std::rename(temporary.c_str(), path.c_str()) != 0))) {
+        throw std::runtime_error("Cannot replace the checkpoint file `" + path + "`.");
+    }
+}
+
+/// @brief Restores a checkpoint of the integration from a file.
+///
+/// @tparam Stepper The type of the integration stepper.
+///
+/// @param path The path of the file.
+/// @param stepper The stepper, of the same type of the one which saved the checkpoint.
+/// @param state Receives the state of the system.
+/// @param time Receives the time.
+/// @param time_delta Receives the step-size of the next step.
+///
+/// @throws std::runtime_error if the file cannot be read, or it is not a valid checkpoint for the stepper.
+template <class Stepper>
+void load_checkpoint_file(
+    const std::string &path,
+    Stepper &stepper,
+    typename Stepper::state_type &state,
+    typename Stepper::time_type &time,
+    typename Stepper::time_type &time_delta)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        throw std::runtime_error("Cannot open the checkpoint file `" + path + "`.");
+    }
+    const std::vector<unsigned char> data(
+        (std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    load_checkpoint(data, stepper, state, time, time_delta);
+}
+
+} // namespace numint
@@ -0,0 +1,248 @@
+/// @file controller.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Step-size controllers used by the adaptive stepper.
+///
+/// @details A controller receives the ratio between the estimated truncation
+/// error and the tolerance (values below 1 mean that the step is accepted),
+/// and the order of the error estimate. It returns the factor by which the
+/// step-size must be multiplied. The safety factor and the limits on the
+/// factor are applied by the adaptive stepper.
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+
+namespace numint
+{
+
+namespace detail
+{
+
+/// @brief Computes the k-th root of a value, avoiding std::pow for small k.
+/// @param value The value, must be positive.
+/// @param k The degree of the root.
+/// @return The k-th root of the value.
+template <class T>
+inline auto root(T value, unsigned k) -> T
+{
+    switch (k) {
+    case 1:
+        return value;
+    case 2:
+        return std::sqrt(value);
+    case 3:
+        return std::cbrt(value);
+    case 4:
+        return std::sqrt(std::sqrt(value));
+    case 6:
+        return std::sqrt(std::cbrt(value));
+    default:
+        return std::pow(value, T(1) / static_cast<T>(k));
+    }
+}
+
+/// @brief Bounds the logarithm of an error ratio that is stored in the history
+/// of a controller, so that a step with an almost null error, or a step that was
+/// accepted with an infinite one (e.g., a failed implicit step at the minimum
+/// step-size), does not dominate the following ones.
+/// @param log_ratio The logarithm of the ratio between the error and the tolerance.
+/// @return The logarithm, bounded to [log(1e-4), log(1e4)].
+template <class T>
+constexpr auto bound_log_ratio(T log_ratio) -> T
+{
+    return std::min(std::max(log_ratio, T(-9.210340371976184)), T(9.210340371976184));
+}
+
+} // namespace detail
+
+/// @brief Elementary (integral) controller.
+///
+/// @details Computes the factor as:
+///     factor = (1 / r_n)^(1 / k)
+/// where r_n is the current error ratio, and k is the order of the error
+/// estimate plus one.
+///
+/// @tparam T The type used for the computations.
+template <class T>
+class controller_i
+{
+public:
+    /// @brief The type used for the computations.
+    using value_type = T;
+
+    /// @brief Computes the factor for an accepted step.
+    /// @param ratio The ratio between the error and the tolerance.
+    /// @param k The order of the error estimate plus one.
+    /// @return The factor by which the step-size is multiplied.
+    auto accept(value_type ratio, unsigned k) -> value_type { return detail::root(value_type(1) / ratio, k); }
+
+    /// @brief Computes the factor for a rejected step.
+    /// @param ratio The ratio between the error and the tolerance.
+    /// @param k The order of the error estimate plus one.
+    /// @return The factor by which the step-size is multiplied.
+    auto reject(value_type ratio, unsigned k) -> value_type { return detail::root(value_type(1) / ratio, k); }
+
+    /// @brief Resets the history of the controller.
+    void reset()
+    {
+        // Nothing to do.
+    }
+
+    /// @brief Saves, or restores, the history of the controller (see `numint/checkpoint.hpp`).
+    /// @tparam Archive The type of the archive.
+    /// @param archive The archive.
+    template <class Archive>
+    void serialize(Archive &archive)
+    {
+        (void)archive;
+        // Nothing to do.
+    }
+};
+
+/// @brief Proportional-integral controller (Gustafsson).
+///
+/// @details Computes the factor as:
+///     factor = (1 / r_n)^(alpha / k) * (r_{n-1})^(beta / k)
+/// where r_n and r_{n-1} are the error ratios of the current and of the
+/// previous accepted steps. The two powers are combined into a single
+/// exponential, and the logarithm of the previous ratio is kept, so that a
+/// step costs one logarithm and one exponential. Rejected steps fall back to
+/// the elementary controller.
+///
+/// @tparam T The type used for the computations.
+template <class T>
+class controller_pi
+{
+public:
+    /// @brief The type used for the computations.
+    using value_type = T;
+
+    /// @brief Creates a new controller.
+    /// @param alpha The gain applied to the current error ratio.
+    /// @param beta The gain applied to the previous error ratio.
+    explicit controller_pi(value_type alpha = value_type(0.7), value_type beta = value_type(0.4))
+        : m_alpha(alpha)
+        , m_beta(beta)
+    {
+        // Nothing to do.
+    }
+
+    /// @brief Computes the factor for an accepted step, and updates the history.
+    /// @param ratio The ratio between the error and the tolerance.
+    /// @param k The order of the error estimate plus one.
+    /// @return The factor by which the step-size is multiplied.
+    auto accept(value_type ratio, unsigned k) -> value_type
+    {
+        const value_type log_ratio = std::log(ratio);
+        const value_type factor    = std::exp((m_beta * m_log_ratio1 - m_alpha * log_ratio) / static_cast<T>(k));
+        m_log_ratio1               = detail::bound_log_ratio(log_ratio);
+        return factor;
+    }
+
+    /// @brief Computes the factor for a rejected step.
+    /// @param ratio The ratio between the error and the tolerance.
+    /// @param k The order of the error estimate plus one.
+    /// @return The factor by which the step-size is multiplied.
+    auto reject(value_type ratio, unsigned k) -> value_type { return detail::root(value_type(1) / ratio, k); }
+
+    /// @brief Resets the history of the controller.
+    void reset() { m_log_ratio1 = 0; }
+
+    /// @brief Saves, or restores, the history of the controller (see `numint/checkpoint.hpp`).
+    /// @tparam Archive The type of the archive.
+    /// @param archive The archive.
+    template <class Archive>
+    void serialize(Archive &archive)
+    {
+        archive(m_log_ratio1);
+    }
+
+private:
+    /// The gain applied to the current error ratio.
+    value_type m_alpha;
+    /// The gain applied to the previous error ratio.
+    value_type m_beta;
+    /// The logarithm of the previous error ratio.
+    value_type m_log_ratio1{};
+};
+
+/// @brief Proportional-integral-derivative controller (Soderlind).
+///
+/// @details Computes the factor as:
+///     factor = (1 / r_n)^(beta1 / k) * (1 / r_{n-1})^(beta2 / k) * (1 / r_{n-2})^(beta3 / k)
+/// where r_n, r_{n-1} and r_{n-2} are the error ratios of the last three
+/// accepted steps. The default gains are those of the H312PID digital
+/// filter, which produces very smooth step-size sequences. As for the PI
+/// controller, the powers are combined into a single exponential, and
+/// rejected steps fall back to the elementary controller.
+///
+/// @tparam T The type used for the computations.
+template <class T>
+class controller_pid
+{
+public:
+    /// @brief The type used for the computations.
+    using value_type = T;
+
+    /// @brief Creates a new controller.
+    /// @param beta1 The gain applied to the current error ratio.
+    /// @param beta2 The gain applied to the previous error ratio.
+    /// @param beta3 The gain applied to the error ratio before the previous one.
+    explicit controller_pid(
+        value_type beta1 = value_type(1) / 18,
+        value_type beta2 = value_type(1) / 9,
+        value_type beta3 = value_type(1) / 18)
+        : m_beta1(beta1)
+        , m_beta2(beta2)
+        , m_beta3(beta3)
+    {
+        // Nothing to do.
+    }
+
+    /// @brief Computes the factor for an accepted step, and updates the history.
+    /// @param ratio The ratio between the error and the tolerance.
+    /// @param k The order of the error estimate plus one.
+    /// @return The factor by which the step-size is multiplied.
+    auto accept(value_type ratio, unsigned k) -> value_type
+    {
+        const value_type log_ratio = std::log(ratio);
+        const value_type factor    = std::exp(
+            -(m_beta1 * log_ratio + m_beta2 * m_log_ratio1 + m_beta3 * m_log_ratio2) / static_cast<T>(k));
+        m_log_ratio2 = m_log_ratio1;
+        m_log_ratio1 = detail::bound_log_ratio(log_ratio);
+        return factor;
+    }
+
+    /// @brief Computes the factor for a rejected step.
+    /// @param ratio The ratio between the error and the tolerance.
+    /// @param k The order of the error estimate plus one.
+    /// @return The factor by which the step-size is multiplied.
+    auto reject(value_type ratio, unsigned k) -> value_type { return detail::root(value_type(1) / ratio, k); }
+
+    /// @brief Resets the history of the controller.
+    void reset() { m_log_ratio1 = m_log_ratio2 = 0; }
+
+    /// @brief Saves, or restores, the history of the controller (see `numint/checkpoint.hpp`).
+    /// @tparam Archive The type of the archive.
+    /// @param archive The archive.
+    template <class Archive>
+    void serialize(Archive &archive)
+    {
+        archive(m_log_ratio1, m_log_ratio2);
+    }
+
+private:
+    /// The gain applied to the current error ratio.
+    value_type m_beta1;
+    /// The gain applied to the previous error ratio.
+    value_type m_beta2;
+    /// The gain applied to the error ratio before the previous one.
+    value_type m_beta3;
+    /// The logarithm of the previous error ratio.
+    value_type m_log_ratio1{};
+    /// The logarithm of the error ratio before the previous one.
+    value_type m_log_ratio2{};
+};
+
+} // namespace numint
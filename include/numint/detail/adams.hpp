@@ -0,0 +1,131 @@
+/// @file adams.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Weights and error constants of the Adams formulas, used by the multistep steppers.
+
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+
+namespace numint::detail
+{
+
+/// @brief The error constants of the Adams-Bashforth formulas, by order.
+constexpr std::array<double, 9> adams_bashforth_error = {
+    0.,
+    1. / 2.,
+    5. / 12.,
+    3. / 8.,
+    251. / 720.,
+    95. / 288.,
+    19087. / 60480.,
+    5257. / 17280.,
+    1070017. / 3628800.,
+};
+
+/// @brief The error constants of the Adams-Moulton formulas, by order.
+constexpr std::array<double, 9> adams_moulton_error = {
+    0.,
+    -1. / 2.,
+    -1. / 12.,
+    -1. / 24.,
+    -19. / 720.,
+    -3. / 160.,
+    -863. / 60480.,
+    -275. / 24192.,
+    -33953. / 3628800.,
+};
+
+/// @brief Computes the weights of an Adams formula, for arbitrary nodes.
+///
+/// @details The weights integrate, over the step [0, 1], the polynomial
+/// interpolating the derivatives at the nodes, so that the formula is:
+///
+///     x(t + dt) = x(t) + dt * sum_j weights[j] * f(t + nodes[j] * dt)
+///
+/// The nodes are given in units of the step-size, relative to the beginning of
+/// the step: the Adams-Bashforth formulas use the nodes 0, -1, -2, ... (for
+/// constant step-sizes), while the Adams-Moulton formulas use 1, 0, -1, ...
+/// Since the weights are obtained from the actual nodes, the formulas keep
+/// their order when the step-size changes.
+///
+/// @tparam N The maximum number of nodes.
+/// @param nodes The nodes.
+/// @param count The number of nodes.
+/// @param weights Receives the weights.
+template <std::size_t N>
+constexpr void adams_weights(const std::array<double, N> &nodes, std::size_t count, std::array<double, N> &weights)
+{
+    for (std::size_t j = 0; j < count; ++j) {
+        // Build the Lagrange polynomial of the node, by increasing powers.
+        std::array<double, N> polynomial{};
+        polynomial[0]      = 1;
+        std::size_t degree = 0;
+        double denominator = 1;
+        // A single node has the constant polynomial, and skipping the loop
+        // also keeps GCC from warning about the bounds of the polynomial.
+        if constexpr (N > 1) {
+            for (std::size_t m = 0; m < count; ++m) {
+                if (m == j) {
+                    continue;
+                }
+                for (std::size_t i = ++degree; i > 0; --i) {
+                    polynomial[i] = polynomial[i - 1] - nodes[m] * polynomial[i];
+                }
+                polynomial[0] *= -nodes[m];
+                denominator *= nodes[j] - nodes[m];
+            }
+        }
+        // Integrate it over the step.
+        double integral = 0;
+        for (std::size_t i = 0; i <= degree; ++i) {
+            integral += polynomial[i] / static_cast<double>(i + 1);
+        }
+        weights[j] = integral / denominator;
+    }
+}
+
+/// @brief The weights of an Adams formula, computed again only when the nodes change.
+/// @tparam N The maximum number of nodes.
+template <std::size_t N>
+class adams_formula
+{
+public:
+    /// @brief Returns the weights of the formula for the given nodes (see `adams_weights`).
+    /// @param nodes The nodes.
+    /// @param count The number of nodes.
+    /// @return the weights.
+    auto weights(const std::array<double, N> &nodes, std::size_t count) -> const std::array<double, N> &
+    {
+        bool changed = (count != m_count);
+        for (std::size_t j = 0; (j < count) && !changed; ++j) {
+            changed = std::abs(nodes[j] - m_nodes[j]) > 1e-12;
+        }
+        if (changed) {
+            m_nodes = nodes;
+            m_count = count;
+            adams_weights(m_nodes, m_count, m_weights);
+        }
+        return m_weights;
+    }
+
+    /// @brief Saves, or restores, the weights and their nodes (see `numint/checkpoint.hpp`).
+    /// @tparam Archive The type of the archive.
+    /// @param archive The archive.
+    template <class Archive>
+    void serialize(Archive &archive)
+    {
+        archive(m_nodes, m_weights, m_count);
+    }
+
+private:
+    /// The nodes of the weights.
+    std::array<double, N> m_nodes{};
+    /// The weights.
+    std::array<double, N> m_weights{};
+    /// The number of nodes.
+    std::size_t m_count{};
+};
+
+} // namespace numint::detail
@@ -0,0 +1,131 @@
+/// @file allocation_counter.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Debug hook counting the heap allocations, used to check that the
+/// steppers do not allocate memory while integrating.
+///
+/// @details The counter is updated only by the global allocation functions
+/// defined by `NUMINT_DEFINE_ALLOCATION_COUNTER`, which must be expanded, at
+/// global scope, in exactly one translation unit of the program:
+///
+///     NUMINT_DEFINE_ALLOCATION_COUNTER
+///
+///     int main() {
+///         stepper.adjust_size(x);
+///         numint::detail::allocation_scope scope;
+///         stepper.do_step(system, x, t, dt);
+///         assert(scope.allocations() == 0);
+///     }
+///
+/// When `NDEBUG` is defined the macro expands to nothing, the allocation
+/// functions of the standard library are left untouched, and the counter
+/// always reports zero allocations, unless `NUMINT_ENABLE_ALLOCATION_COUNTER`
+/// is defined as well (e.g., by the benchmarks, which are built optimized).
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+namespace numint::detail
+{
+
+/// @brief Global counter of the heap allocations.
+class allocation_counter
+{
+public:
+    /// @brief Indicates whether the allocations are actually counted.
+#if defined(NDEBUG) && !defined(NUMINT_ENABLE_ALLOCATION_COUNTER)
+    static constexpr bool enabled = false;
+#else
+    static constexpr bool enabled = true;
+#endif
+
+    /// @brief Registers a new allocation.
+    /// @param size the number of bytes allocated.
+    static void increment(std::size_t size = 0) noexcept
+    {
+        counter().fetch_add(1, std::memory_order_relaxed);
+        bytes_counter().fetch_add(size, std::memory_order_relaxed);
+    }
+
+    /// @brief Returns the number of allocations executed so far.
+    /// @return the number of allocations.
+    static auto count() noexcept -> std::size_t { return counter().load(std::memory_order_relaxed); }
+
+    /// @brief Returns the number of bytes allocated so far.
+    /// @return the number of bytes.
+    static auto bytes() noexcept -> std::size_t { return bytes_counter().load(std::memory_order_relaxed); }
+
+private:
+    /// @brief Provides the storage of the counter.
+    /// @return a reference to the counter.
+    static auto counter() noexcept -> std::atomic<std::size_t> &
+    {
+        static std::atomic<std::size_t> value{0};
+        return value;
+    }
+
+    /// @brief Provides the storage of the counter of the bytes.
+    /// @return a reference to the counter.
+    static auto bytes_counter() noexcept -> std::atomic<std::size_t> &
+    {
+        static std::atomic<std::size_t> value{0};
+        return value;
+    }
+};
+
+/// @brief Counts the allocations executed during its lifetime.
+class allocation_scope
+{
+public:
+    /// @brief Starts counting the allocations.
+    allocation_scope()
+        : m_start(allocation_counter::count())
+        , m_start_bytes(allocation_counter::bytes())
+    {
+        // Nothing to do.
+    }
+
+    /// @brief Returns the number of allocations executed since the construction.
+    /// @return the number of allocations.
+    auto allocations() const noexcept -> std::size_t { return allocation_counter::count() - m_start; }
+
+    /// @brief Returns the number of bytes allocated since the construction.
+    /// @return the number of bytes.
+    auto bytes() const noexcept -> std::size_t { return allocation_counter::bytes() - m_start_bytes; }
+
+private:
+    /// The value of the counter at construction.
+    std::size_t m_start;
+    /// The value of the counter of the bytes at construction.
+    std::size_t m_start_bytes;
+};
+
+/// @brief Allocates memory, and registers the allocation.
+/// @param size the number of bytes to allocate.
+/// @return a pointer to the allocated memory.
+inline auto counted_allocate(std::size_t size) -> void *
+{
+    allocation_counter::increment(size);
+    if (void *ptr = std::malloc(size ? size : 1)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+} // namespace numint::detail
+
+#if defined(NDEBUG) && !defined(NUMINT_ENABLE_ALLOCATION_COUNTER)
+#define NUMINT_DEFINE_ALLOCATION_COUNTER
+#else
+/// @brief Replaces the global allocation functions with counting ones.
+#define NUMINT_DEFINE_ALLOCATION_COUNTER                                                                               \
+    void *operator new(std::size_t size) { return numint::detail::counted_allocate(size); }                             \
+    void *operator new[](std::size_t size) { return numint::detail::counted_allocate(size); }                           \
+    void operator delete(void *ptr) noexcept { std::free(ptr); }                                                       \
+    void operator delete[](void *ptr) noexcept { std::free(ptr); }                                                     \
+    void operator delete(void *ptr, std::size_t) noexcept { std::free(ptr); }                                          \
+    void operator delete[](void *ptr, std::size_t) noexcept { std::free(ptr); }
+#endif
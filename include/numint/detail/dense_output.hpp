@@ -0,0 +1,116 @@
+/// @file dense_output.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Interpolation of the last step of a stepper, used by `integrate_times`
+/// and by the event detection.
+
+#pragma once
+
+#include "numint/detail/hermite.hpp"
+#include "numint/detail/type_traits.hpp"
+
+#include <algorithm>
+#include <utility>
+
+namespace numint::detail
+{
+
+/// @brief Keeps what is needed to interpolate the last step of a stepper.
+///
+/// @details Steppers providing their own interpolant (see `has_dense_output`)
+/// are asked to interpolate the step, at no additional cost. For the others,
+/// the cubic Hermite interpolant is used, and the derivatives at both ends of
+/// the step are evaluated the first time they are needed. The derivative at
+/// the end of a step is reused at the beginning of the next one.
+///
+/// @tparam Stepper The type of the integration stepper.
+template <class Stepper>
+class dense_output
+{
+public:
+    /// @brief The state vector type.
+    using state_type = typename Stepper::state_type;
+    /// @brief Type used to keep track of time.
+    using time_type  = typename Stepper::time_type;
+
+    /// @brief Allocates the internal state vectors.
+    /// @param reference A reference state vector used for size adjustment.
+    explicit dense_output(const state_type &reference)
+        : m_x0(reference)
+        , m_dxdt0(reference)
+        , m_dxdt1(reference)
+    {
+        // Nothing to do.
+    }
+
+    /// @brief Marks the beginning of a step.
+    /// @param x The state at the beginning of the step.
+    /// @param t The time at the beginning of the step.
+    void begin_step(const state_type &x, time_type t)
+    {
+        std::copy(x.begin(), x.end(), m_x0.begin());
+        // The derivative at the end of the previous step is the one at the beginning of this one.
+        using std::swap;
+        swap(m_dxdt0, m_dxdt1);
+        m_has_dxdt0 = m_has_dxdt1;
+        m_has_dxdt1 = false;
+        m_t0        = t;
+    }
+
+    /// @brief Marks the end of a step.
+    /// @param t The time at the end of the step.
+    /// @param dt The step-size that was actually used.
+    void end_step(time_type t, time_type dt)
+    {
+        m_t1 = t;
+        m_dt = dt;
+    }
+
+    /// @brief Discards the derivatives, e.g., because the state or the system were changed between two steps.
+    void discard() { m_has_dxdt0 = m_has_dxdt1 = false; }
+
+    /// @brief Returns the state at the beginning of the step.
+    /// @return the state at the beginning of the step.
+    auto initial_state() const -> const state_type & { return m_x0; }
+
+    /// @brief Interpolates the step.
+    /// @tparam System The type of the system being integrated.
+    /// @param stepper The stepper which took the step.
+    /// @param system The system being integrated.
+    /// @param x1 The state at the end of the step.
+    /// @param t The time inside the step.
+    /// @param x Receives the interpolated state.
+    template <class System>
+    void interpolate(const Stepper &stepper, System &&system, const state_type &x1, time_type t, state_type &x)
+    {
+        const time_type theta = (t - m_t0) / m_dt;
+        if constexpr (has_dense_output_v<Stepper>) {
+            (void)system;
+            stepper.interpolate(m_x0, x1, m_dt, theta, x);
+        } else {
+            (void)stepper;
+            if (!m_has_dxdt0) {
+                std::forward<System>(system)(m_x0, m_dxdt0, m_t0);
+                m_has_dxdt0 = true;
+            }
+            if (!m_has_dxdt1) {
+                std::forward<System>(system)(x1, m_dxdt1, m_t1);
+                m_has_dxdt1 = true;
+            }
+            hermite_interpolate(m_x0, m_dxdt0, x1, m_dxdt1, m_dt, theta, x);
+        }
+    }
+
+private:
+    /// The state at the beginning of the step.
+    state_type m_x0;
+    /// The derivatives at both ends of the step.
+    state_type m_dxdt0, m_dxdt1;
+    /// The times at both ends of the step.
+    time_type m_t0{}, m_t1{};
+    /// The step-size.
+    time_type m_dt{};
+    /// Whether the derivatives were evaluated.
+    bool m_has_dxdt0{false}, m_has_dxdt1{false};
+};
+
+} // namespace numint::detail
@@ -0,0 +1,64 @@
+/// @file device.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Macros marking the functions which are also compiled for GPU devices
+/// (CUDA or HIP), and helpers on the states which can run on them.
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+
+#if defined(__CUDACC__)
+/// @brief Defined when the library is compiled by the CUDA compiler.
+#define NUMINT_DEVICE_BACKEND_CUDA
+#elif defined(__HIPCC__)
+#include <hip/hip_runtime.h>
+/// @brief Defined when the library is compiled by the HIP compiler.
+#define NUMINT_DEVICE_BACKEND_HIP
+#endif
+
+#if defined(NUMINT_DEVICE_BACKEND_CUDA) || defined(NUMINT_DEVICE_BACKEND_HIP)
+/// @brief Defined when the library is compiled for a GPU device.
+#define NUMINT_DEVICE_ENABLED
+/// @brief Marks a function which is compiled both for the host and for the device.
+#define NUMINT_HOST_DEVICE __host__ __device__
+#else
+/// @brief Marks a function which is compiled both for the host and for the
+/// device, it expands to nothing when no device compiler is used.
+#define NUMINT_HOST_DEVICE
+#endif
+
+namespace numint::detail
+{
+
+/// @brief Checks if two states hold the same values.
+/// @details Unlike `std::equal`, it can be called from device code.
+/// @tparam State The state vector type.
+/// @param a The first state.
+/// @param b The second state, with the same size of the first one.
+/// @return true if all the elements are equal.
+template <class State>
+NUMINT_HOST_DEVICE constexpr auto equal_states(const State &a, const State &b) -> bool
+{
+    for (std::size_t i = 0; i < a.size(); ++i) {
+        if (!std::equal_to<>{}(a[i], b[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/// @brief Copies the values of a state into another one.
+/// @details Unlike `std::copy`, it can be called from device code.
+/// @tparam State The state vector type.
+/// @param from The source state.
+/// @param to The destination state, with the same size of the source one.
+template <class State>
+NUMINT_HOST_DEVICE constexpr void copy_state(const State &from, State &to)
+{
+    for (std::size_t i = 0; i < from.size(); ++i) {
+        to[i] = from[i];
+    }
+}
+
+} // namespace numint::detail
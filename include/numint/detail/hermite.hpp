@@ -0,0 +1,50 @@
+/// @file hermite.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Cubic Hermite interpolation of a step, used for dense output.
+
+#pragma once
+
+#include <cstddef>
+
+namespace numint::detail
+{
+
+/// @brief Interpolates a step with the cubic Hermite polynomial matching the
+/// states, and the derivatives, at both ends of the step.
+///
+/// @details The interpolant is accurate to the third order, and it is
+/// continuous, with its first derivative, across the steps:
+///     x(t0 + theta * dt) = (1 - theta) * x0 + theta * x1
+///         + theta * (theta - 1) * ((1 - 2 * theta) * (x1 - x0) + (theta - 1) * dt * f0 + theta * dt * f1)
+///
+/// @tparam State The state vector type.
+/// @tparam Time The datatype used to hold time.
+/// @param x0 The state at the beginning of the step.
+/// @param f0 The derivative at the beginning of the step.
+/// @param x1 The state at the end of the step.
+/// @param f1 The derivative at the end of the step.
+/// @param dt The step-size.
+/// @param theta The position inside the step, between 0 and 1.
+/// @param x Receives the interpolated state.
+template <class State, class Time>
+inline void hermite_interpolate(
+    const State &x0,
+    const State &f0,
+    const State &x1,
+    const State &f1,
+    Time dt,
+    Time theta,
+    State &x)
+{
+    using value_type = typename State::value_type;
+
+    const auto th = static_cast<value_type>(theta);
+    const auto h  = static_cast<value_type>(dt);
+    const auto c  = th * (th - 1);
+    for (std::size_t i = 0; i < x.size(); ++i) {
+        const value_type difference = x1[i] - x0[i];
+        x[i] = x0[i] + th * difference + c * ((1 - 2 * th) * difference + (th - 1) * h * f0[i] + th * h * f1[i]);
+    }
+}
+
+} // namespace numint::detail
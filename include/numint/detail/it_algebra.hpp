@@ -8,13 +8,150 @@
 
 #pragma once
 
+#include "numint/detail/type_traits.hpp"
+
+#include <algorithm>
+#include <array>
 #include <cmath>
+#include <cstddef>
 #include <functional>
+#include <iterator>
 #include <limits>
+#include <type_traits>
+#include <vector>
+
+/// @brief Tells the compiler that the iterations of the following loop do not
+/// depend on each other, so that it can be vectorized without runtime checks.
+/// The element-wise operations only read and write the same position across
+/// the ranges, hence the ranges might be the same, but must not partially overlap.
+#if defined(__clang__)
+#define NUMINT_IVDEP _Pragma("clang loop vectorize(enable) interleave(enable)")
+#elif defined(__GNUC__)
+#define NUMINT_IVDEP _Pragma("GCC ivdep")
+#elif defined(_MSC_VER)
+#define NUMINT_IVDEP __pragma(loop(ivdep))
+#else
+#define NUMINT_IVDEP
+#endif
 
 namespace numint::detail::it_algebra
 {
 
+namespace detail
+{
+
+/// @brief Checks if an iterator points to elements stored contiguously in memory.
+/// @details Raw pointers, and the iterators of `std::vector` (except for
+/// `std::vector<bool>`) and `std::array` are contiguous.
+/// @tparam It The iterator to check.
+template <class It, class = void>
+struct is_contiguous_iterator : std::is_pointer<It> {
+};
+
+/// @brief Checks if an iterator points to elements stored contiguously in memory.
+/// @tparam It The iterator to check.
+template <class It>
+struct is_contiguous_iterator<
+    It,
+    std::enable_if_t<!std::is_pointer_v<It>, std::void_t<typename std::iterator_traits<It>::value_type>>>
+    : std::bool_constant<
+          !std::is_same_v<typename std::iterator_traits<It>::value_type, bool> &&
+          (std::is_same_v<It, typename std::vector<typename std::iterator_traits<It>::value_type>::iterator> ||
+           std::is_same_v<It, typename std::vector<typename std::iterator_traits<It>::value_type>::const_iterator> ||
+           std::is_same_v<It, typename std::array<typename std::iterator_traits<It>::value_type, 1>::iterator> ||
+           std::is_same_v<It, typename std::array<typename std::iterator_traits<It>::value_type, 1>::const_iterator>)> {
+};
+
+/// @brief Checks if all the iterators among the arguments are contiguous, scalars are skipped.
+/// @tparam Args The types of the arguments.
+template <class... Args>
+constexpr inline bool all_contiguous_v =
+    std::conjunction_v<std::disjunction<std::is_arithmetic<Args>, is_contiguous_iterator<Args>>...>;
+
+/// @brief Converts a contiguous iterator to a raw pointer, scalars are returned as they are.
+/// @param arg The iterator or the scalar.
+/// @return The raw pointer, or the scalar.
+template <class Arg>
+constexpr auto to_pointer(Arg arg) noexcept
+{
+    if constexpr (std::is_arithmetic_v<Arg> || std::is_pointer_v<Arg>) {
+        return arg;
+    } else {
+        return &*arg;
+    }
+}
+
+/// @brief Base case for the recursive variadic function that adds scaled terms at a given position.
+/// @param ... Unused parameters for recursion termination.
+template <class... Args>
+constexpr void add_at(const Args &.../*unused*/) noexcept
+{
+    // Base case: Do nothing, recursion stops here.
+}
+
+/// @brief Adds the scaled terms at the given position, from left to right.
+/// @param y The value to accumulate the scaled terms into.
+/// @param i The position inside the ranges.
+/// @param op Operation to perform on the scalar and the element.
+/// @param a Scalar value to scale the current term.
+/// @param x Pointer to the first element of the current range.
+/// @param args Remaining scalars and pointers.
+template <class V, class T, class P, class Op, class... Args>
+constexpr void add_at(V &y, std::size_t i, Op op, T a, P x, Args... args) noexcept
+{
+    y += op(a, x[i]);
+    add_at(y, i, op, args...);
+}
+
+/// @brief Computes the element-wise sum of multiple scaled ranges, on contiguous memory.
+/// @param y Pointer to the first element of the output range.
+/// @param n The number of elements.
+/// @param op Operation to apply for element-wise computation.
+/// @param a First scalar value to scale the first range.
+/// @param x Pointer to the first element of the first range.
+/// @param args Remaining scalars and pointers.
+template <bool Accumulate, class V, class T, class P, class Op, class... Args>
+constexpr void contiguous_sum(V *y, std::size_t n, Op op, T a, P x, Args... args) noexcept
+{
+    // Each element is computed inside a local value, and stored once, so that
+    // the compiler does not need to reload it after every term.
+    NUMINT_IVDEP
+    for (std::size_t i = 0; i < n; ++i) {
+        V value = Accumulate ? y[i] + op(a, x[i]) : op(a, x[i]);
+        add_at(value, i, op, args...);
+        y[i] = value;
+    }
+}
+
+/// @brief Computes the maximum of an element-wise difference, on contiguous memory.
+/// @details The maximum is computed with four independent partial maxima,
+/// which breaks the dependency between consecutive iterations.
+/// @param a0 Pointer to the first element of range 1.
+/// @param a1 Pointer to the first element of range 2.
+/// @param n The number of elements.
+/// @param diff The difference between two elements.
+/// @return Maximum difference, at least epsilon.
+template <class T, class P, class Diff>
+constexpr auto contiguous_max_diff(P a0, P a1, std::size_t n, Diff diff) noexcept -> T
+{
+    T r0(std::numeric_limits<T>::epsilon()), r1(r0), r2(r0), r3(r0);
+    // The bound of the unrolled loop is computed once, so that the tail loop
+    // has a known trip count, below four.
+    const std::size_t n4 = n & ~std::size_t(3);
+    for (std::size_t i = 0; i < n4; i += 4) {
+        r0 = std::max(r0, static_cast<T>(diff(a0[i + 0], a1[i + 0])));
+        r1 = std::max(r1, static_cast<T>(diff(a0[i + 1], a1[i + 1])));
+        r2 = std::max(r2, static_cast<T>(diff(a0[i + 2], a1[i + 2])));
+        r3 = std::max(r3, static_cast<T>(diff(a0[i + 3], a1[i + 3])));
+    }
+    for (std::size_t i = n4; i < n; ++i) {
+        r0 = std::max(r0, static_cast<T>(diff(a0[i], a1[i])));
+    }
+    return std::max(std::max(r0, r1), std::max(r2, r3));
+}
+
+} // namespace detail
+
 /// @brief Computes the maximum absolute difference between elements in two ranges.
 /// @param a0_first Iterator to the first element of range 1.
 /// @param a0_last Iterator to the last element of range 1.
@@ -24,6 +161,14 @@ namespace numint::detail::it_algebra
 template <class T, class It>
 constexpr auto max_abs_diff(It a0_first, It a0_last, It a1_first, It a1_last) noexcept -> T
 {
+    // Use the contiguous kernel, when possible.
+    if constexpr (detail::is_contiguous_iterator<It>::value) {
+        const auto n = static_cast<std::size_t>(std::min(a0_last - a0_first, a1_last - a1_first));
+        return n ? detail::contiguous_max_diff<T>(
+                       detail::to_pointer(a0_first), detail::to_pointer(a1_first), n,
+                       [](auto v0, auto v1) { return std::abs(v0 - v1); })
+                 : std::numeric_limits<T>::epsilon();
+    }
     // Initialize the value to epsilon, to prevent small truncation error when
     // using the returned value.
     T ret(std::numeric_limits<T>::epsilon());
@@ -36,6 +181,7 @@ constexpr auto max_abs_diff(It a0_first, It a0_last, It a1_first, It a1_last) no
 }
 
 /// @brief Computes the maximum relative difference between elements in two ranges.
+/// @details The difference is taken as absolute where the element of range 1 is zero.
 /// @param a0_first Iterator to the first element of range 1.
 /// @param a0_last Iterator to the last element of range 1.
 /// @param a1_first Iterator to the first element of range 2.
@@ -44,18 +190,28 @@ constexpr auto max_abs_diff(It a0_first, It a0_last, It a1_first, It a1_last) no
 template <class T, class It>
 constexpr auto max_rel_diff(It a0_first, It a0_last, It a1_first, It a1_last) noexcept -> T
 {
+    // Use the contiguous kernel, when possible.
+    if constexpr (detail::is_contiguous_iterator<It>::value) {
+        const auto n = static_cast<std::size_t>(std::min(a0_last - a0_first, a1_last - a1_first));
+        return n ? detail::contiguous_max_diff<T>(
+                       detail::to_pointer(a0_first), detail::to_pointer(a1_first), n,
+                       [](auto v0, auto v1) { return std::abs(v0) > 0 ? std::abs((v0 - v1) / v0) : std::abs(v0 - v1); })
+                 : std::numeric_limits<T>::epsilon();
+    }
     // Initialize the value to epsilon, to prevent small truncation error when
     // using the returned value.
     T ret(std::numeric_limits<T>::epsilon());
     // Find the max difference.
     while ((a0_first != a0_last) && (a1_first != a1_last)) {
-        ret = std::max(ret, std::abs((*a0_first - *a1_first) / *a0_first));
+        const T diff = std::abs(*a0_first - *a1_first);
+        ret          = std::max(ret, std::abs(*a0_first) > 0 ? diff / std::abs(*a0_first) : diff);
         ++a0_first, ++a1_first;
     }
     return ret;
 }
 
 /// @brief Computes the maximum of absolute and relative differences between two ranges.
+/// @details The relative difference is skipped where the element of range 1 is zero.
 /// @param a0_first Iterator to the first element of range 1.
 /// @param a0_last Iterator to the last element of range 1.
 /// @param a1_first Iterator to the first element of range 2.
@@ -64,24 +220,85 @@ constexpr auto max_rel_diff(It a0_first, It a0_last, It a1_first, It a1_last) no
 template <class T, class It>
 constexpr auto max_comb_diff(It a0_first, It a0_last, It a1_first, It a1_last) noexcept -> T
 {
+    // Use the contiguous kernel, when possible.
+    if constexpr (detail::is_contiguous_iterator<It>::value) {
+        const auto n = static_cast<std::size_t>(std::min(a0_last - a0_first, a1_last - a1_first));
+        return n ? detail::contiguous_max_diff<T>(
+                       detail::to_pointer(a0_first), detail::to_pointer(a1_first), n,
+                       [](auto v0, auto v1) {
+                           const auto diff = std::abs(v0 - v1);
+                           return std::abs(v0) > 0 ? std::max(diff / std::abs(v0), diff) : diff;
+                       })
+                 : std::numeric_limits<T>::epsilon();
+    }
     // Initialize the value to epsilon, to prevent small truncation error when
     // using the returned value.
     T ret(std::numeric_limits<T>::epsilon());
     // Find the max difference.
     while ((a0_first != a0_last) && (a1_first != a1_last)) {
-        ret = std::max(std::max(ret, std::abs((*a0_first - *a1_first) / *a0_first)), std::abs(*a0_first - *a1_first));
+        const T diff = std::abs(*a0_first - *a1_first);
+        ret          = std::max(ret, std::abs(*a0_first) > 0 ? std::max(diff / std::abs(*a0_first), diff) : diff);
         ++a0_first, ++a1_first;
     }
     return ret;
 }
 
+/// @brief Computes the weighted root mean square of the difference between elements in two ranges.
+///
+/// @details Each difference is scaled by the absolute tolerance, plus the
+/// relative tolerance times the largest magnitude between the element of
+/// range 1 and the one of the reference range (e.g., the state at the
+/// beginning of the step):
+///     sqrt(sum(((a0_i - a1_i) / (atol_i + rtol_i * max(|a0_i|, |x_i|)))^2) / n)
+/// hence values below 1 mean that the difference is within the tolerances.
+/// The scale never drops below the smallest normal value, so that elements
+/// which stay at zero with a zero absolute tolerance do not yield 0 / 0. The
+/// squares are accumulated in higher precision for single precision values
+/// (see `accumulator_t`).
+///
+/// @param a0_first Iterator to the first element of range 1.
+/// @param a0_last Iterator to the last element of range 1.
+/// @param a1_first Iterator to the first element of range 2.
+/// @param x_first Iterator to the first element of the reference range.
+/// @param atol_first Iterator to the first absolute tolerance.
+/// @param rtol_first Iterator to the first relative tolerance.
+/// @return Weighted root mean square of the difference, at least epsilon.
+template <class T, class It, class RefIt, class TolIt>
+constexpr auto rms_weighted_diff(
+    It a0_first,
+    It a0_last,
+    It a1_first,
+    RefIt x_first,
+    TolIt atol_first,
+    TolIt rtol_first) noexcept -> T
+{
+    using accumulator_type = numint::detail::accumulator_t<T>;
+    accumulator_type sum(0);
+    std::size_t n = 0;
+    while (a0_first != a0_last) {
+        const auto magnitude = std::max(std::abs(*a0_first), std::abs(*x_first));
+        const auto scale     = std::max(
+            static_cast<accumulator_type>(*atol_first + *rtol_first * magnitude),
+            static_cast<accumulator_type>(std::numeric_limits<T>::min()));
+        const auto ratio = static_cast<accumulator_type>(*a0_first - *a1_first) / scale;
+        sum += ratio * ratio;
+        ++a0_first, ++a1_first, ++x_first, ++atol_first, ++rtol_first, ++n;
+    }
+    if (n == 0) {
+        return std::numeric_limits<T>::epsilon();
+    }
+    const auto rms = static_cast<T>(std::sqrt(sum / static_cast<accumulator_type>(n)));
+    return std::max(rms, std::numeric_limits<T>::epsilon());
+}
+
 namespace detail
 {
 
 /// @brief Base case for the recursive variadic function that adds scaled terms.
 /// @param ... Unused parameters for recursion termination.
 /// @note When there are no more scalars or iterators, the recursion stops.
-constexpr void add_helper(...) noexcept
+template <class... Args>
+constexpr void add_helper(const Args &.../*unused*/) noexcept
 {
     // Base case: Do nothing, recursion stops here.
 }
@@ -112,9 +329,19 @@ constexpr void add_helper(T &y, Op op, T a, It &x, Args &...args) noexcept
 /// @param x Iterator corresponding to the first scalar.
 /// @param args Variadic template to accept additional scalars and iterators for further ranges.
 /// @note This function uses variadic templates to accept any number of scalars and corresponding iterators.
+/// When all the iterators are contiguous, the operation runs over raw pointers, and it can be vectorized.
 template <class OutIt, class T, class InIt, class Op, class... Args>
 constexpr void sum_operation(OutIt y_first, OutIt y_last, Op op, T a, InIt x, Args... args) noexcept
 {
+    // Use the contiguous kernel, when possible.
+    if constexpr (detail::all_contiguous_v<OutIt, InIt, Args...>) {
+        if (y_first != y_last) {
+            detail::contiguous_sum<false>(
+                detail::to_pointer(y_first), static_cast<std::size_t>(y_last - y_first), op, a, detail::to_pointer(x),
+                detail::to_pointer(args)...);
+        }
+        return;
+    }
     while (y_first != y_last) {
         // Add the current scaled term.
         *y_first = op(a, *x++);
@@ -133,9 +360,19 @@ constexpr void sum_operation(OutIt y_first, OutIt y_last, Op op, T a, InIt x, Ar
 /// @param x Iterator corresponding to the first scalar.
 /// @param args Variadic template to accept additional scalars and iterators for further ranges.
 /// @note This function uses variadic templates to accept any number of scalars and corresponding iterators.
+/// When all the iterators are contiguous, the operation runs over raw pointers, and it can be vectorized.
 template <class OutIt, class T, class InIt, class Op, class... Args>
 constexpr void accumulate_operation(OutIt y_first, OutIt y_last, Op op, T a, InIt x, Args... args) noexcept
 {
+    // Use the contiguous kernel, when possible.
+    if constexpr (detail::all_contiguous_v<OutIt, InIt, Args...>) {
+        if (y_first != y_last) {
+            detail::contiguous_sum<true>(
+                detail::to_pointer(y_first), static_cast<std::size_t>(y_last - y_first), op, a, detail::to_pointer(x),
+                detail::to_pointer(args)...);
+        }
+        return;
+    }
     while (y_first != y_last) {
         // Add the current scaled term.
         *y_first += op(a, *x++);
@@ -5,6 +5,8 @@
 
 #pragma once
 
+#include <algorithm>
+
 namespace numint::detail
 {
 
@@ -38,4 +40,19 @@ inline auto less_eq_with_sign(T value1, T value2, T direction) -> bool
     return (direction > 0) ? value1 <= value2 : value2 <= value1;
 }
 
+/// @brief Bounds the magnitude of a step-size, keeping its sign.
+///
+/// @details The bounds are positive, so that the same bounds apply to the
+/// integration forward in time, and to the one backward in time.
+///
+/// @param value The step-size.
+/// @param min The minimum magnitude.
+/// @param max The maximum magnitude.
+/// @return The step-size, whose magnitude is within [min, max].
+template <typename T>
+inline constexpr auto clamp_with_sign(T value, T min, T max) -> T
+{
+    return (value < 0) ? -std::min(std::max(-value, min), max) : std::min(std::max(value, min), max);
+}
+
 } // namespace numint::detail
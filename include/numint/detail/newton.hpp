@@ -0,0 +1,192 @@
+/// @file newton.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Simplified Newton iterations, used by the implicit one-step methods.
+
+#pragma once
+
+#include "numint/detail/type_traits.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+
+namespace numint::detail
+{
+
+/// @brief Solves the implicit equation
+///     y = b + c * f(y, t)
+/// by means of simplified Newton iterations, i.e., with the Jacobian of f
+/// evaluated once, and reused for as long as the iterations converge.
+///
+/// @details The Jacobian and its factorization are kept between the calls.
+/// The factorization is updated when c changes, the Jacobian is updated only
+/// when the iterations fail to converge with the current one.
+///
+/// @tparam State The state vector type.
+/// @tparam Time The datatype used to hold time.
+/// @tparam LinearSolver The linear solver (e.g., `dense_lu_solver`).
+template <class State, class Time, class LinearSolver>
+class newton_solver
+{
+public:
+    /// @brief The state vector type.
+    using state_type         = State;
+    /// @brief Type used to keep track of time.
+    using time_type          = Time;
+    /// @brief Type of value contained in the state vector.
+    using value_type         = typename state_type::value_type;
+    /// @brief Type of the linear solver.
+    using linear_solver_type = LinearSolver;
+
+    /// @brief Sets the tolerance on the Newton corrections, relative to (1 + |y|).
+    /// @param tollerance The tolerance.
+    constexpr void set_tollerance(value_type tollerance) { m_tollerance = tollerance; }
+
+    /// @brief Sets the maximum number of iterations.
+    /// @param max_iterations The maximum number of iterations.
+    constexpr void set_max_iterations(unsigned max_iterations) { m_max_iterations = max_iterations; }
+
+    /// @brief Provides access to the linear solver.
+    /// @return a reference to the linear solver.
+    constexpr auto linear_solver() -> linear_solver_type & { return m_linear_solver; }
+
+    /// @brief Returns the number of Newton iterations executed so far.
+    /// @return the number of iterations.
+    constexpr auto iterations() const { return m_iterations; }
+
+    /// @brief Adjusts the size of the internal state vectors based on a reference.
+    /// @details It also discards the Jacobian, since it might refer to a different system.
+    /// @param reference A reference state vector used for size adjustment.
+    void adjust_size(const state_type &reference)
+    {
+        m_linear_solver.adjust_size(reference);
+        if constexpr (detail::has_resize<state_type>::value) {
+            m_y0.resize(reference.size());
+            m_f.resize(reference.size());
+            m_delta.resize(reference.size());
+        }
+        m_jacobian_valid = false;
+        m_factorized     = false;
+    }
+
+    /// @brief Discards the Jacobian, which is evaluated again by the next solve.
+    void reset()
+    {
+        m_jacobian_valid = false;
+        m_factorized     = false;
+    }
+
+    /// @brief Solves the implicit equation.
+    /// @tparam System The type of the system.
+    /// @param system The system.
+    /// @param y The initial guess, replaced with the solution.
+    /// @param b The constant term of the equation.
+    /// @param c The coefficient of f in the equation.
+    /// @param t The time where f is evaluated.
+    /// @param x0 The state where the Jacobian is evaluated, when needed.
+    /// @param t0 The time where the Jacobian is evaluated, when needed.
+    /// @return true if the iterations converged, false otherwise (y holds the last iterate).
+    template <class System>
+    auto solve(
+        System &&system,
+        state_type &y,
+        const state_type &b,
+        time_type c,
+        time_type t,
+        const state_type &x0,
+        time_type t0) -> bool
+    {
+        std::copy(y.begin(), y.end(), m_y0.begin());
+        for (bool fresh = false;;) {
+            // Update the Jacobian, if we do not have a valid one.
+            if (!m_jacobian_valid) {
+                system(x0, m_f, t0);
+                m_linear_solver.update_jacobian(system, x0, m_f, t0);
+                m_jacobian_valid = true;
+                m_factorized     = false;
+                fresh            = true;
+            }
+            // Factorize (1 / c) * I - J, if c has changed.
+            if (!m_factorized || (std::abs(c - m_c) > 0)) {
+                m_factorized = m_linear_solver.factorize(static_cast<value_type>(1 / c));
+                m_c          = c;
+            }
+            if (m_factorized && this->iterate(system, y, b, c, t)) {
+                return true;
+            }
+            // The fresh Jacobian did not help, give up.
+            if (fresh) {
+                return false;
+            }
+            // Retry with a fresh Jacobian, from the initial guess.
+            m_jacobian_valid = false;
+            std::copy(m_y0.begin(), m_y0.end(), y.begin());
+        }
+    }
+
+private:
+    /// @brief Executes the iterations, with the current factorization.
+    /// @tparam System The type of the system.
+    /// @param system The system.
+    /// @param y The initial guess, replaced with the solution.
+    /// @param b The constant term of the equation.
+    /// @param c The coefficient of f in the equation.
+    /// @param t The time where f is evaluated.
+    /// @return true if the iterations converged, false otherwise.
+    template <class System>
+    auto iterate(System &&system, state_type &y, const state_type &b, time_type c, time_type t) -> bool
+    {
+        value_type norm_old = 0;
+        for (unsigned k = 0; k < m_max_iterations; ++k) {
+            ++m_iterations;
+            system(y, m_f, t);
+            // Compute the residual, divided by c:
+            //      delta = (b + c * f(y) - y) / c
+            for (std::size_t i = 0; i < y.size(); ++i) {
+                m_delta[i] = (b[i] - y[i]) / static_cast<value_type>(c) + m_f[i];
+            }
+            // Solve ((1 / c) * I - J) * delta = residual / c.
+            m_linear_solver.solve(m_delta);
+            // Apply the correction, and measure it.
+            value_type norm = 0;
+            for (std::size_t i = 0; i < y.size(); ++i) {
+                y[i] += m_delta[i];
+                norm = std::max(norm, std::abs(m_delta[i]) / (1 + std::abs(y[i])));
+            }
+            if (!std::isfinite(norm)) {
+                return false;
+            }
+            if (norm <= m_tollerance) {
+                return true;
+            }
+            // Stop if the iterations are diverging.
+            if ((k > 0) && (norm >= norm_old)) {
+                return false;
+            }
+            norm_old = norm;
+        }
+        return false;
+    }
+
+    /// The linear solver.
+    linear_solver_type m_linear_solver;
+    /// Copy of the initial guess.
+    state_type m_y0;
+    /// Support vectors for the derivative and for the corrections.
+    state_type m_f, m_delta;
+    /// The coefficient of f used for the last factorization.
+    time_type m_c{};
+    /// The tolerance on the Newton corrections, which must stay above the precision of the values.
+    value_type m_tollerance{std::max(value_type(1e-10), 100 * std::numeric_limits<value_type>::epsilon())};
+    /// The maximum number of iterations.
+    unsigned m_max_iterations{10};
+    /// Whether the Jacobian is valid.
+    bool m_jacobian_valid{false};
+    /// Whether the factorization is valid.
+    bool m_factorized{false};
+    /// The number of iterations executed so far.
+    unsigned long m_iterations{};
+};
+
+} // namespace numint::detail
@@ -6,6 +6,7 @@
 #pragma once
 
 #include <array>
+#include <cassert>
 #include <cstddef>
 
 namespace numint::detail
@@ -31,12 +32,12 @@ public:
     auto size() const -> std::size_t { return dimension; }
 
     /// @brief Get the element at the given index.
-    /// @param index the index.
+    /// @param index the index, smaller than the size of the buffer.
     /// @return The element at the given index.
     auto operator[](std::size_t index) -> value_type & { return m_data[get_index(index)]; }
 
     /// @brief Get the element at the given index.
-    /// @param index the index.
+    /// @param index the index, smaller than the size of the buffer.
     /// @return The element at the given index.
     auto operator[](std::size_t index) const -> const value_type & { return m_data[get_index(index)]; }
 
@@ -50,14 +51,29 @@ public:
         }
     }
 
+    /// @brief Saves, or restores, the elements and their rotation (see `numint/checkpoint.hpp`).
+    /// @tparam Archive The type of the archive.
+    /// @param archive The archive.
+    template <class Archive>
+    void serialize(Archive &archive)
+    {
+        archive(m_data, m_first);
+    }
+
 private:
     /// @brief The data.
     std::array<value_type, N> m_data;
 
     /// @brief Returns the correct index of the element at the given index.
-    /// @param index the index.
+    /// @param index the index, smaller than the size of the buffer.
     /// @return The correct index of the element at the given index.
-    auto get_index(std::size_t index) const -> std::size_t { return ((index + m_first) % dimension); }
+    auto get_index(std::size_t index) const -> std::size_t
+    {
+        // The index is smaller than the dimension, so a subtraction replaces the modulo.
+        assert(index < dimension);
+        const std::size_t position = index + m_first;
+        return (position < dimension) ? position : position - dimension;
+    }
 
     /// @brief The first element.
     std::size_t m_first{0};
@@ -0,0 +1,163 @@
+/// @file sparse_jacobian.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Evaluation of sparse Jacobians, shared by the sparse linear solvers.
+
+#pragma once
+
+#include "numint/detail/type_traits.hpp"
+#include "numint/jacobian.hpp"
+#include "numint/linear/sparse_matrix.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+namespace numint::detail
+{
+
+/// @brief Evaluates the sparse Jacobian of a system, provided by the system
+/// itself or approximated by finite differences.
+///
+/// @details The finite differences perturb together the columns which do not
+/// share any row (see `sparse_pattern::color_columns`), hence they cost one
+/// evaluation of the system per group of columns.
+///
+/// @tparam State The state vector type.
+template <class State>
+class sparse_jacobian
+{
+public:
+    /// @brief The state vector type.
+    using state_type  = State;
+    /// @brief Type of value contained in the state vector.
+    using value_type  = typename state_type::value_type;
+    /// @brief Type of matrix holding the Jacobian.
+    using matrix_type = sparse_matrix<value_type>;
+
+    /// @brief Sets the pattern of the Jacobian, and groups its columns.
+    /// @param pattern The pattern.
+    void assign(const sparse_pattern &pattern)
+    {
+        m_jacobian.assign(pattern);
+        const std::size_t n = pattern.size();
+        // Group the columns, and sort them by group.
+        const std::vector<std::size_t> colors = pattern.color_columns();
+        m_groups = n ? (*std::max_element(colors.begin(), colors.end()) + 1) : 0;
+        m_group_begin.assign(m_groups + 1, 0);
+        for (std::size_t color : colors) {
+            ++m_group_begin[color + 1];
+        }
+        for (std::size_t g = 0; g < m_groups; ++g) {
+            m_group_begin[g + 1] += m_group_begin[g];
+        }
+        m_group_columns.resize(n);
+        std::vector<std::size_t> next(m_group_begin.begin(), m_group_begin.end() - 1);
+        for (std::size_t j = 0; j < n; ++j) {
+            m_group_columns[next[colors[j]]++] = j;
+        }
+        // Collect the elements of each column, by rows.
+        const auto &row_begin = pattern.row_begin();
+        const auto &columns   = pattern.columns();
+        m_col_begin.assign(n + 1, 0);
+        for (std::size_t col : columns) {
+            ++m_col_begin[col + 1];
+        }
+        for (std::size_t j = 0; j < n; ++j) {
+            m_col_begin[j + 1] += m_col_begin[j];
+        }
+        m_col_rows.resize(columns.size());
+        m_col_elements.resize(columns.size());
+        next.assign(m_col_begin.begin(), m_col_begin.end() - 1);
+        for (std::size_t i = 0; i < n; ++i) {
+            for (std::size_t k = row_begin[i]; k < row_begin[i + 1]; ++k) {
+                const std::size_t slot = next[columns[k]]++;
+                m_col_rows[slot]       = i;
+                m_col_elements[slot]   = k;
+            }
+        }
+        m_delta.resize(n);
+        if constexpr (has_resize<state_type>::value) {
+            m_x.resize(n);
+            m_dxdt.resize(n);
+        }
+    }
+
+    /// @brief Evaluates the Jacobian of the system.
+    /// @tparam System The type of the system.
+    /// @tparam Time The datatype used to hold time.
+    /// @param system The system.
+    /// @param x The state where the Jacobian is evaluated.
+    /// @param dxdt The derivative of the system at (x, t).
+    /// @param t The time where the Jacobian is evaluated.
+    template <class System, class Time>
+    void update(System &&system, const state_type &x, const state_type &dxdt, Time t)
+    {
+        ++m_evaluations;
+        if constexpr (has_jacobian_v<System, state_type, matrix_type, Time>) {
+            (void)dxdt;
+            m_jacobian.fill(value_type(0));
+            system.jacobian(x, m_jacobian, t);
+        } else {
+            const value_type sqrt_eps = std::sqrt(std::numeric_limits<value_type>::epsilon());
+            auto &values              = m_jacobian.values();
+            std::copy(x.begin(), x.end(), m_x.begin());
+            for (std::size_t g = 0; g < m_groups; ++g) {
+                // Perturb all the columns of the group.
+                for (std::size_t c = m_group_begin[g]; c < m_group_begin[g + 1]; ++c) {
+                    const std::size_t j = m_group_columns[c];
+                    m_x[j]              = x[j] + sqrt_eps * std::max(value_type(1), std::abs(x[j]));
+                    // Use the actual perturbation, which is exactly representable.
+                    m_delta[j]          = m_x[j] - x[j];
+                }
+                system(m_x, m_dxdt, t);
+                // No row is shared by two columns of the group.
+                for (std::size_t c = m_group_begin[g]; c < m_group_begin[g + 1]; ++c) {
+                    const std::size_t j = m_group_columns[c];
+                    for (std::size_t k = m_col_begin[j]; k < m_col_begin[j + 1]; ++k) {
+                        const std::size_t i       = m_col_rows[k];
+                        values[m_col_elements[k]] = (m_dxdt[i] - dxdt[i]) / m_delta[j];
+                    }
+                    m_x[j] = x[j];
+                }
+            }
+        }
+    }
+
+    /// @brief Provides access to the last evaluated Jacobian.
+    /// @return a reference to the Jacobian.
+    auto jacobian() const noexcept -> const matrix_type & { return m_jacobian; }
+
+    /// @brief Returns the number of groups of columns, i.e., the evaluations of the system per finite differences.
+    /// @return the number of groups.
+    auto groups() const noexcept { return m_groups; }
+
+    /// @brief Returns the number of times the Jacobian was evaluated.
+    /// @return the number of Jacobian evaluations.
+    auto evaluations() const noexcept { return m_evaluations; }
+
+private:
+    /// The Jacobian of the system.
+    matrix_type m_jacobian;
+    /// The number of groups of columns.
+    std::size_t m_groups{};
+    /// The index of the first column of each group, inside `m_group_columns`.
+    std::vector<std::size_t> m_group_begin;
+    /// The columns, sorted by group.
+    std::vector<std::size_t> m_group_columns;
+    /// The index of the first element of each column, inside `m_col_rows` and `m_col_elements`.
+    std::vector<std::size_t> m_col_begin;
+    /// The row of the elements of each column.
+    std::vector<std::size_t> m_col_rows;
+    /// The index of the elements of each column, inside the values of the Jacobian.
+    std::vector<std::size_t> m_col_elements;
+    /// The perturbation of each variable.
+    std::vector<value_type> m_delta;
+    /// Support vectors for the finite differences.
+    state_type m_x, m_dxdt;
+    /// The number of Jacobian evaluations.
+    unsigned long m_evaluations{};
+};
+
+} // namespace numint::detail
@@ -0,0 +1,283 @@
+/// @file sparse_lu.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Sparse LU factorization of (alpha * I - J), shared by the sparse
+/// linear solvers.
+
+#pragma once
+
+#include "numint/linear/sparse_matrix.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <vector>
+
+namespace numint::detail
+{
+
+/// @brief The LU factorization of (alpha * I - J), with J sparse.
+///
+/// @details The pattern of the factors is computed once, by `analyze`, and
+/// reused by all the factorizations. Either the complete factorization is
+/// computed, on the rows and columns reordered by the reverse Cuthill-McKee
+/// algorithm to limit the fill-in, or the incomplete one (ILU(0)), which keeps
+/// only the elements of the pattern of J, and serves as preconditioner.
+///
+/// The factorization does not pivot, the diagonal of (alpha * I - J) being
+/// dominant for the small step-sizes of the implicit steppers; a vanishing
+/// pivot makes the factorization fail, and the steppers reduce the step-size.
+///
+/// @tparam T The type of the elements.
+template <class T>
+class sparse_lu
+{
+public:
+    /// @brief Type of the elements.
+    using value_type = T;
+
+    /// @brief Computes the pattern of the factors.
+    /// @param pattern The pattern of J.
+    /// @param complete Whether the complete factorization is computed, or the incomplete one.
+    void analyze(const sparse_pattern &pattern, bool complete)
+    {
+        const std::size_t n = pattern.size();
+        // Choose the order of the rows (and columns).
+        m_order.resize(n);
+        if (complete) {
+            this->reverse_cuthill_mckee(pattern);
+        } else {
+            for (std::size_t i = 0; i < n; ++i) {
+                m_order[i] = i;
+            }
+        }
+        std::vector<std::size_t> position(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            position[m_order[i]] = i;
+        }
+        // Compute the pattern of the factors, one row at a time.
+        const auto &row_begin = pattern.row_begin();
+        const auto &columns   = pattern.columns();
+        m_row_begin.assign(1, 0);
+        m_columns.clear();
+        m_diagonal.resize(n);
+        std::vector<std::size_t> marker(n, n), row, pending;
+        for (std::size_t i = 0; i < n; ++i) {
+            row.clear();
+            pending.clear();
+            const std::size_t source = m_order[i];
+            for (std::size_t k = row_begin[source]; k < row_begin[source + 1]; ++k) {
+                const std::size_t j = position[columns[k]];
+                marker[j]           = i;
+                row.push_back(j);
+                if (j < i) {
+                    pending.push_back(j);
+                }
+            }
+            if (complete) {
+                // Eliminating the column k fills the row with the upper part of the row k.
+                std::make_heap(pending.begin(), pending.end(), std::greater<>());
+                while (!pending.empty()) {
+                    std::pop_heap(pending.begin(), pending.end(), std::greater<>());
+                    const std::size_t k = pending.back();
+                    pending.pop_back();
+                    for (std::size_t l = m_diagonal[k] + 1; l < m_row_begin[k + 1]; ++l) {
+                        const std::size_t j = m_columns[l];
+                        if (marker[j] != i) {
+                            marker[j] = i;
+                            row.push_back(j);
+                            if (j < i) {
+                                pending.push_back(j);
+                                std::push_heap(pending.begin(), pending.end(), std::greater<>());
+                            }
+                        }
+                    }
+                }
+            }
+            std::sort(row.begin(), row.end());
+            const auto diagonal = std::lower_bound(row.begin(), row.end(), i);
+            m_diagonal[i]       = m_columns.size() + static_cast<std::size_t>(diagonal - row.begin());
+            m_columns.insert(m_columns.end(), row.begin(), row.end());
+            m_row_begin.push_back(m_columns.size());
+        }
+        // Find where each element of J lands inside the factors.
+        m_scatter.resize(columns.size());
+        std::vector<std::size_t> &slot = marker;
+        for (std::size_t i = 0; i < n; ++i) {
+            for (std::size_t l = m_row_begin[i]; l < m_row_begin[i + 1]; ++l) {
+                slot[m_columns[l]] = l;
+            }
+            const std::size_t source = m_order[i];
+            for (std::size_t k = row_begin[source]; k < row_begin[source + 1]; ++k) {
+                m_scatter[k] = slot[position[columns[k]]];
+            }
+        }
+        m_values.resize(m_columns.size());
+        m_slot.assign(n, npos);
+        m_work.resize(n);
+    }
+
+    /// @brief Factorizes the matrix (alpha * I - J).
+    /// @param jacobian The Jacobian J, with the pattern given to `analyze`.
+    /// @param alpha The coefficient of the identity matrix.
+    /// @return true if the factorization succeeded, false if a pivot vanished.
+    auto factorize(const sparse_matrix<value_type> &jacobian, value_type alpha) -> bool
+    {
+        const std::size_t n = m_diagonal.size();
+        const auto &values  = jacobian.values();
+        // Build the matrix.
+        std::fill(m_values.begin(), m_values.end(), value_type(0));
+        for (std::size_t k = 0; k < values.size(); ++k) {
+            m_values[m_scatter[k]] = -values[k];
+        }
+        for (std::size_t i = 0; i < n; ++i) {
+            m_values[m_diagonal[i]] += alpha;
+        }
+        // Factorize it in place, one row at a time.
+        bool success = true;
+        for (std::size_t i = 0; success && (i < n); ++i) {
+            for (std::size_t l = m_row_begin[i]; l < m_row_begin[i + 1]; ++l) {
+                m_slot[m_columns[l]] = l;
+            }
+            for (std::size_t l = m_row_begin[i]; l < m_diagonal[i]; ++l) {
+                const std::size_t k     = m_columns[l];
+                const value_type factor = (m_values[l] /= m_values[m_diagonal[k]]);
+                for (std::size_t u = m_diagonal[k] + 1; u < m_row_begin[k + 1]; ++u) {
+                    // The elements outside the pattern are dropped (incomplete factorization only).
+                    const std::size_t target = m_slot[m_columns[u]];
+                    if (target != npos) {
+                        m_values[target] -= factor * m_values[u];
+                    }
+                }
+            }
+            for (std::size_t l = m_row_begin[i]; l < m_row_begin[i + 1]; ++l) {
+                m_slot[m_columns[l]] = npos;
+            }
+            const value_type pivot = m_values[m_diagonal[i]];
+            success                = (std::abs(pivot) > value_type(0)) && std::isfinite(pivot);
+        }
+        return success;
+    }
+
+    /// @brief Solves the linear system, using the last factorization.
+    /// @tparam Vector The type of the vector.
+    /// @param b The right-hand side, replaced with the solution.
+    template <class Vector>
+    void solve(Vector &b)
+    {
+        const std::size_t n = m_diagonal.size();
+        // Apply the permutation, and the forward substitution.
+        for (std::size_t i = 0; i < n; ++i) {
+            value_type sum = b[m_order[i]];
+            for (std::size_t l = m_row_begin[i]; l < m_diagonal[i]; ++l) {
+                sum -= m_values[l] * m_work[m_columns[l]];
+            }
+            m_work[i] = sum;
+        }
+        // Apply the backward substitution, and restore the order.
+        for (std::size_t i = n; i-- > 0;) {
+            value_type sum = m_work[i];
+            for (std::size_t l = m_diagonal[i] + 1; l < m_row_begin[i + 1]; ++l) {
+                sum -= m_values[l] * m_work[m_columns[l]];
+            }
+            m_work[i]     = sum / m_values[m_diagonal[i]];
+            b[m_order[i]] = m_work[i];
+        }
+    }
+
+    /// @brief Returns the number of elements of the factors, i.e., the elements of J plus the fill-in.
+    /// @return the number of elements.
+    auto non_zeros() const noexcept -> std::size_t { return m_columns.size(); }
+
+private:
+    /// Marks the columns outside the row being factorized.
+    static constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+
+    /// @brief Orders the rows (and columns) by the reverse Cuthill-McKee algorithm.
+    /// @details The variables are visited breadth-first on the structure of
+    /// (J + J^T), each component starting from a variable of minimum degree,
+    /// and the neighbours by increasing degree, which clusters the elements
+    /// around the diagonal.
+    /// @param pattern The pattern of J.
+    void reverse_cuthill_mckee(const sparse_pattern &pattern)
+    {
+        const std::size_t n   = pattern.size();
+        const auto &row_begin = pattern.row_begin();
+        const auto &columns   = pattern.columns();
+        // The structure of (J + J^T), without the diagonal.
+        std::vector<std::size_t> begin(n + 1), neighbours;
+        for (std::size_t i = 0; i < n; ++i) {
+            for (std::size_t k = row_begin[i]; k < row_begin[i + 1]; ++k) {
+                if (columns[k] != i) {
+                    ++begin[i + 1];
+                    ++begin[columns[k] + 1];
+                }
+            }
+        }
+        for (std::size_t i = 0; i < n; ++i) {
+            begin[i + 1] += begin[i];
+        }
+        neighbours.resize(begin[n]);
+        std::vector<std::size_t> next(begin.begin(), begin.end() - 1);
+        for (std::size_t i = 0; i < n; ++i) {
+            for (std::size_t k = row_begin[i]; k < row_begin[i + 1]; ++k) {
+                if (columns[k] != i) {
+                    neighbours[next[i]++]          = columns[k];
+                    neighbours[next[columns[k]]++] = i;
+                }
+            }
+        }
+        // The duplicated neighbours only affect the degrees, not the visit.
+        auto degree    = [&begin](std::size_t i) { return begin[i + 1] - begin[i]; };
+        auto by_degree = [&degree](std::size_t a, std::size_t b) { return degree(a) < degree(b); };
+        // Sort the variables by degree, to start each component from the minimum one.
+        std::vector<std::size_t> candidates(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            candidates[i] = i;
+        }
+        std::stable_sort(candidates.begin(), candidates.end(), by_degree);
+        std::vector<bool> visited(n, false);
+        std::size_t count = 0;
+        for (std::size_t start : candidates) {
+            if (visited[start]) {
+                continue;
+            }
+            visited[start]   = true;
+            m_order[count++] = start;
+            for (std::size_t head = count - 1; head < count; ++head) {
+                const std::size_t i     = m_order[head];
+                const std::size_t first = count;
+                for (std::size_t k = begin[i]; k < begin[i + 1]; ++k) {
+                    if (!visited[neighbours[k]]) {
+                        visited[neighbours[k]] = true;
+                        m_order[count++]       = neighbours[k];
+                    }
+                }
+                std::stable_sort(
+                    m_order.begin() + static_cast<std::ptrdiff_t>(first),
+                    m_order.begin() + static_cast<std::ptrdiff_t>(count), by_degree);
+            }
+        }
+        std::reverse(m_order.begin(), m_order.end());
+    }
+
+    /// The original variable of each row (and column) of the factors.
+    std::vector<std::size_t> m_order;
+    /// The index of the first element of each row of the factors.
+    std::vector<std::size_t> m_row_begin;
+    /// The column of each element of the factors.
+    std::vector<std::size_t> m_columns;
+    /// The index of the diagonal element of each row.
+    std::vector<std::size_t> m_diagonal;
+    /// The index, inside the factors, of each element of J.
+    std::vector<std::size_t> m_scatter;
+    /// The elements of both factors, the unit diagonal of L being implicit.
+    std::vector<value_type> m_values;
+    /// The index of the elements of the row being factorized, by column.
+    std::vector<std::size_t> m_slot;
+    /// Support vector for the substitutions.
+    std::vector<value_type> m_work;
+};
+
+} // namespace numint::detail
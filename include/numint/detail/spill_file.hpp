@@ -0,0 +1,250 @@
+/// @file spill_file.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief File holding data which does not fit in memory, accessed through
+/// memory mappings of fixed-size chunks.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#define NUMINT_HAS_MMAP 1
+#else
+#define NUMINT_HAS_MMAP 0
+#endif
+
+namespace numint::detail
+{
+
+/// @brief A file split in chunks of the same size, which are memory mapped one at a time.
+///
+/// @details Memory mappings are only available on POSIX systems, elsewhere
+/// opening the file throws an exception.
+class spill_file
+{
+public:
+    /// @brief Memory mapping of a chunk, unmapped when destroyed.
+    class mapping
+    {
+    public:
+        /// @brief Creates an empty mapping.
+        mapping() = default;
+
+        /// @brief Takes ownership of a mapping.
+        /// @param data The address of the mapping.
+        /// @param size The size of the mapping.
+        mapping(unsigned char *data, std::size_t size)
+            : m_data(data)
+            , m_size(size)
+        {
+            // Nothing to do.
+        }
+
+        /// @brief Destructor, which unmaps the chunk.
+        ~mapping() { this->reset(); }
+
+        /// @brief Copy constructor.
+        /// @param other The logger instance to copy from.
+        mapping(const mapping &other) = delete;
+
+        /// @brief Move constructor.
+        /// @param other The logger instance to move from.
+        mapping(mapping &&other) noexcept
+            : m_data(std::exchange(other.m_data, nullptr))
+            , m_size(std::exchange(other.m_size, 0))
+        {
+            // Nothing to do.
+        }
+
+        /// @brief Copy assignment operator.
+        /// @param other The logger instance to copy from.
+        /// @return Reference to the logger instance.
+        auto operator=(const mapping &other) -> mapping & = delete;
+
+        /// @brief Move assignment operator.
+        /// @param other The logger instance to move from.
+        /// @return Reference to the logger instance.
+        auto operator=(mapping &&other) noexcept -> mapping &
+        {
+            if (this != &other) {
+                this->reset();
+                m_data = std::exchange(other.m_data, nullptr);
+                m_size = std::exchange(other.m_size, 0);
+            }
+            return *this;
+        }
+
+        /// @brief Returns the address of the mapping.
+        /// @return the address of the mapping, nullptr if empty.
+        auto data() const noexcept -> unsigned char * { return m_data; }
+
+        /// @brief Unmaps the chunk.
+        void reset() noexcept
+        {
+#if NUMINT_HAS_MMAP
+            if (m_data != nullptr) {
+                ::munmap(m_data, m_size);
+            }
+#endif
+            m_data = nullptr;
+            m_size = 0;
+        }
+
+    private:
+        /// The address of the mapping.
+        unsigned char *m_data{};
+        /// The size of the mapping.
+        std::size_t m_size{};
+    };
+
+    /// @brief Creates a closed file.
+    spill_file() = default;
+
+    /// @brief Destructor, which closes the file.
+    ~spill_file() { this->close(); }
+
+    /// @brief Copy constructor.
+    /// @param other The logger instance to copy from.
+    spill_file(const spill_file &other) = delete;
+
+    /// @brief Move constructor.
+    /// @param other The logger instance to move from.
+    spill_file(spill_file &&other) noexcept
+        : m_fd(std::exchange(other.m_fd, -1))
+        , m_stride(std::exchange(other.m_stride, 0))
+        , m_chunks(std::exchange(other.m_chunks, 0))
+    {
+        // Nothing to do.
+    }
+
+    /// @brief Copy assignment operator.
+    /// @param other The logger instance to copy from.
+    /// @return Reference to the logger instance.
+    auto operator=(const spill_file &other) -> spill_file & = delete;
+
+    /// @brief Move assignment operator.
+    /// @param other The logger instance to move from.
+    /// @return Reference to the logger instance.
+    auto operator=(spill_file &&other) noexcept -> spill_file &
+    {
+        if (this != &other) {
+            this->close();
+            m_fd     = std::exchange(other.m_fd, -1);
+            m_stride = std::exchange(other.m_stride, 0);
+            m_chunks = std::exchange(other.m_chunks, 0);
+        }
+        return *this;
+    }
+
+    /// @brief Opens the file.
+    /// @param path The path of the file, if empty an anonymous temporary file
+    /// is created, which is removed when closed.
+    /// @param chunk_size The size of each chunk, in bytes, rounded up to the size of the memory pages.
+    void open(const std::string &path, std::size_t chunk_size)
+    {
+#if NUMINT_HAS_MMAP
+        this->close();
+        if (path.empty()) {
+            const char *directory = std::getenv("TMPDIR");
+            std::string name      = std::string((directory != nullptr) ? directory : "/tmp") + "/numint-XXXXXX";
+            m_fd                  = ::mkstemp(name.data());
+            if (m_fd >= 0) {
+                ::unlink(name.c_str());
+            }
+        } else {
+            m_fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        }
+        if (m_fd < 0) {
+            throw std::runtime_error("Cannot open the spill file `" + path + "`.");
+        }
+        const auto page = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+        m_stride        = ((chunk_size + page - 1) / page) * page;
+        m_chunks        = 0;
+#else
+        (void)path, (void)chunk_size;
+        throw std::runtime_error("Memory-mapped files are not supported on this platform.");
+#endif
+    }
+
+    /// @brief Closes the file.
+    void close() noexcept
+    {
+#if NUMINT_HAS_MMAP
+        if (m_fd >= 0) {
+            ::close(m_fd);
+        }
+#endif
+        m_fd     = -1;
+        m_chunks = 0;
+    }
+
+    /// @brief Checks if the file is open.
+    /// @return true if the file is open.
+    auto is_open() const noexcept { return m_fd >= 0; }
+
+    /// @brief Returns the number of chunks in the file.
+    /// @return the number of chunks.
+    auto chunks() const noexcept { return m_chunks; }
+
+    /// @brief Appends a chunk to the file, and maps it for writing.
+    /// @return the mapping of the new chunk.
+    auto append() -> mapping
+    {
+#if NUMINT_HAS_MMAP
+        if (::ftruncate(m_fd, static_cast<off_t>((m_chunks + 1) * m_stride)) != 0) {
+            throw std::runtime_error("Cannot extend the spill file.");
+        }
+        return this->map(m_chunks++, PROT_READ | PROT_WRITE);
+#else
+        return mapping();
+#endif
+    }
+
+    /// @brief Maps a chunk of the file for reading.
+    /// @param index The index of the chunk.
+    /// @return the mapping of the chunk.
+    auto read(std::size_t index) const -> mapping
+    {
+#if NUMINT_HAS_MMAP
+        return this->map(index, PROT_READ);
+#else
+        (void)index;
+        return mapping();
+#endif
+    }
+
+private:
+    /// @brief Maps a chunk.
+    /// @param index The index of the chunk.
+    /// @param protection The protection of the mapping.
+    /// @return the mapping of the chunk.
+    auto map(std::size_t index, int protection) const -> mapping
+    {
+#if NUMINT_HAS_MMAP
+        void *data = ::mmap(nullptr, m_stride, protection, MAP_SHARED, m_fd, static_cast<off_t>(index * m_stride));
+        if (data == MAP_FAILED) {
+            throw std::runtime_error("Cannot map the spill file.");
+        }
+        return mapping(static_cast<unsigned char *>(data), m_stride);
+#else
+        (void)index, (void)protection;
+        return mapping();
+#endif
+    }
+
+    /// The file descriptor.
+    int m_fd{-1};
+    /// The distance between the chunks, in bytes.
+    std::size_t m_stride{};
+    /// The number of chunks in the file.
+    std::size_t m_chunks{};
+};
+
+} // namespace numint::detail
@@ -0,0 +1,137 @@
+/// @file spsc_ring.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Wait-free ring buffer, passing elements from one producer thread to
+/// one consumer thread.
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+namespace numint::detail
+{
+
+/// @brief The size of a cache line, used to keep apart data written by different threads.
+constexpr std::size_t cache_line_size = 64;
+
+/// @brief A fixed-size ring buffer, shared by a single producer thread and a
+/// single consumer thread.
+///
+/// @details The producer only writes the head, and the consumer only writes
+/// the tail, so that pushing and popping never wait for each other: they
+/// either succeed, or fail if the ring is full (or empty). The head and the
+/// tail are kept on different cache lines, together with the last value of the
+/// other index seen by each thread, so that the threads only read the index
+/// of the other one when the ring looks full (or empty). Since the capacity is
+/// a power of two, the counters grow freely, and the slots are found by
+/// masking them.
+///
+/// @tparam T the type of the elements.
+/// @tparam N the number of elements, a power of two.
+template <class T, std::size_t N>
+class spsc_ring
+{
+    static_assert((N >= 2) && ((N & (N - 1)) == 0), "The capacity of the ring must be a power of two.");
+
+public:
+    /// @brief The type of the elements.
+    using value_type = T;
+
+    /// @brief Construct a new ring.
+    spsc_ring() = default;
+
+    /// @brief Returns the capacity of the ring.
+    /// @return the number of elements the ring can hold.
+    static constexpr auto capacity() noexcept -> std::size_t { return N; }
+
+    /// @brief Returns the number of elements in the ring, which is exact only
+    /// when called while neither thread is using the ring.
+    /// @return the number of elements.
+    auto size() const noexcept -> std::size_t
+    {
+        return m_producer.head.load(std::memory_order_acquire) - m_consumer.tail.load(std::memory_order_acquire);
+    }
+
+    /// @brief Checks if the ring is empty (see `size()`).
+    /// @return true if the ring is empty.
+    auto empty() const noexcept -> bool { return this->size() == 0; }
+
+    /// @brief Pushes an element, called by the producer.
+    /// @param value the element.
+    /// @return true if the element was pushed, false if the ring is full.
+    auto try_push(const value_type &value) -> bool { return this->push(&value, 1) == 1; }
+
+    /// @brief Pushes a batch of elements, called by the producer, publishing them at once.
+    /// @param first the iterator to the first element.
+    /// @param count the number of elements.
+    /// @return the number of elements pushed, less than count if the ring is full.
+    template <class InputIt>
+    auto push(InputIt first, std::size_t count) -> std::size_t
+    {
+        const std::size_t head = m_producer.head.load(std::memory_order_relaxed);
+        if (N - (head - m_producer.tail) < count) {
+            m_producer.tail = m_consumer.tail.load(std::memory_order_acquire);
+        }
+        const std::size_t pushed = std::min(count, N - (head - m_producer.tail));
+        for (std::size_t i = 0; i < pushed; ++i, ++first) {
+            m_data[(head + i) & mask] = *first;
+        }
+        m_producer.head.store(head + pushed, std::memory_order_release);
+        return pushed;
+    }
+
+    /// @brief Pops an element, called by the consumer.
+    /// @param value receives the element.
+    /// @return true if an element was popped, false if the ring is empty.
+    auto try_pop(value_type &value) -> bool { return this->pop(&value, 1) == 1; }
+
+    /// @brief Pops a batch of elements, called by the consumer, releasing their slots at once.
+    /// @param out the output iterator receiving the elements.
+    /// @param count the maximum number of elements.
+    /// @return the number of elements popped.
+    template <class OutputIt>
+    auto pop(OutputIt out, std::size_t count) -> std::size_t
+    {
+        const std::size_t tail = m_consumer.tail.load(std::memory_order_relaxed);
+        if (m_consumer.head - tail < count) {
+            m_consumer.head = m_producer.head.load(std::memory_order_acquire);
+        }
+        const std::size_t popped = std::min(count, m_consumer.head - tail);
+        for (std::size_t i = 0; i < popped; ++i, ++out) {
+            *out = m_data[(tail + i) & mask];
+        }
+        m_consumer.tail.store(tail + popped, std::memory_order_release);
+        return popped;
+    }
+
+private:
+    /// @brief The mask turning the counters into slots.
+    static constexpr std::size_t mask = N - 1;
+
+    /// @brief The data written by the producer.
+    struct alignas(cache_line_size) producer_data {
+        /// The number of elements pushed.
+        std::atomic<std::size_t> head{0};
+        /// The number of elements popped, as last seen by the producer.
+        std::size_t tail{0};
+    };
+
+    /// @brief The data written by the consumer.
+    struct alignas(cache_line_size) consumer_data {
+        /// The number of elements popped.
+        std::atomic<std::size_t> tail{0};
+        /// The number of elements pushed, as last seen by the consumer.
+        std::size_t head{0};
+    };
+
+    /// @brief The data written by the producer.
+    producer_data m_producer;
+    /// @brief The data written by the consumer.
+    consumer_data m_consumer;
+    /// @brief The elements.
+    alignas(cache_line_size) std::array<value_type, N> m_data{};
+};
+
+} // namespace numint::detail
@@ -26,4 +26,111 @@ struct has_resize<T, std::void_t<decltype(std::declval<T>().resize(1))>> : std::
 template <typename T>
 constexpr inline bool has_resize_v = has_resize<T>::value;
 
-} // namespace numint::detail
\ No newline at end of file
+/// @brief Checks if a stepper provides an embedded error estimate.
+/// @tparam T The type to check.
+template <typename T, typename = void>
+struct is_embedded_stepper : std::false_type {
+};
+
+/// @brief Checks if a stepper provides an embedded error estimate.
+/// @tparam T The type to check.
+template <typename T>
+struct is_embedded_stepper<T, std::void_t<decltype(T::is_embedded_stepper)>>
+    : std::integral_constant<bool, T::is_embedded_stepper> {
+};
+
+/// @brief Helper variable template to check if a stepper provides an embedded error estimate.
+/// @tparam T The type to check.
+template <typename T>
+constexpr inline bool is_embedded_stepper_v = is_embedded_stepper<T>::value;
+
+/// @brief Checks if a stepper provides its own interpolant of the last step (dense output).
+/// @tparam T The type to check.
+template <typename T, typename = void>
+struct has_dense_output : std::false_type {
+};
+
+/// @brief Checks if a stepper provides its own interpolant of the last step (dense output).
+/// @tparam T The type to check.
+template <typename T>
+struct has_dense_output<
+    T,
+    std::void_t<decltype(std::declval<const T &>().interpolate(
+        std::declval<const typename T::state_type &>(),
+        std::declval<const typename T::state_type &>(),
+        std::declval<typename T::time_type>(),
+        std::declval<typename T::time_type>(),
+        std::declval<typename T::state_type &>()))>> : std::true_type {
+};
+
+/// @brief Helper variable template to check if a stepper provides its own dense output.
+/// @tparam T The type to check.
+template <typename T>
+constexpr inline bool has_dense_output_v = has_dense_output<T>::value;
+
+/// @brief Checks if a stepper can discard the data it caches, without being resized.
+/// @tparam T The type to check.
+template <typename T, typename = void>
+struct has_reset : std::false_type {
+};
+
+/// @brief Checks if a stepper can discard the data it caches, without being resized.
+/// @tparam T The type to check.
+template <typename T>
+struct has_reset<T, std::void_t<decltype(std::declval<T &>().reset())>> : std::true_type {
+};
+
+/// @brief Helper variable template to check if a stepper can discard the data it caches.
+/// @tparam T The type to check.
+template <typename T>
+constexpr inline bool has_reset_v = has_reset<T>::value;
+
+/// @brief Checks if a stepper tells when its last step failed, e.g., when its Newton iterations did not converge.
+/// @tparam T The type to check.
+template <typename T, typename = void>
+struct has_step_failed : std::false_type {
+};
+
+/// @brief Checks if a stepper tells when its last step failed, e.g., when its Newton iterations did not converge.
+/// @tparam T The type to check.
+template <typename T>
+struct has_step_failed<T, std::void_t<decltype(std::declval<const T &>().step_failed())>> : std::true_type {
+};
+
+/// @brief Helper variable template to check if a stepper tells when its last step failed.
+/// @tparam T The type to check.
+template <typename T>
+constexpr inline bool has_step_failed_v = has_step_failed<T>::value;
+
+/// @brief Discards the data cached by a stepper, e.g., after a discontinuity of the system.
+/// @details Steppers without `reset` are resized instead, which also discards their data.
+/// @tparam Stepper The type of the stepper.
+/// @param stepper The stepper.
+/// @param reference A reference state vector, used to resize the stepper.
+template <typename Stepper>
+void reset_stepper(Stepper &stepper, const typename Stepper::state_type &reference)
+{
+    if constexpr (has_reset_v<Stepper>) {
+        (void)reference;
+        stepper.reset();
+    } else {
+        stepper.adjust_size(reference);
+    }
+}
+
+/// @brief Provides the type used to accumulate sums of values of the given type (e.g., inside the error norms).
+/// @details Single precision values are accumulated in double precision,
+/// the other types are accumulated in their own type.
+/// @tparam T The type of the values.
+template <typename T>
+struct accumulator {
+    /// @brief The type of the accumulator.
+    using type = std::conditional_t<std::is_same_v<T, float>, double, T>;
+};
+
+/// @brief Helper alias template for the type used to accumulate sums of values of the given type.
+/// @tparam T The type of the values.
+template <typename T>
+using accumulator_t = typename accumulator<T>::type;
+
+} // namespace numint::detail
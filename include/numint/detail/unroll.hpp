@@ -0,0 +1,71 @@
+/// @file unroll.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Loops over the elements of a state, unrolled at compile time when
+/// the size of the state is known.
+
+#pragma once
+
+#include "numint/detail/device.hpp"
+
+#include <array>
+#include <cstddef>
+#include <utility>
+
+namespace numint::detail
+{
+
+/// @brief The size of the states whose loops are unrolled, at most.
+constexpr std::size_t max_unrolled_size = 32;
+
+/// @brief Provides the size of a state, when it is known at compile time, or zero.
+/// @tparam T The state vector type.
+template <typename T>
+struct static_size : std::integral_constant<std::size_t, 0> {
+};
+
+/// @brief Provides the size of a state, when it is known at compile time, or zero.
+/// @tparam T The type of the elements.
+/// @tparam N The number of elements.
+template <typename T, std::size_t N>
+struct static_size<std::array<T, N>> : std::integral_constant<std::size_t, N> {
+};
+
+/// @brief Helper variable template providing the size of a state known at compile time.
+/// @tparam T The state vector type.
+template <typename T>
+constexpr inline std::size_t static_size_v = static_size<T>::value;
+
+/// @brief Calls the function for each index of the sequence, in order.
+/// @tparam Function The type of the function.
+/// @param function The function, called as `function(i)`.
+template <class Function, std::size_t... I>
+NUMINT_HOST_DEVICE constexpr void unroll(Function &function, std::index_sequence<I...> /*indices*/)
+{
+    (function(I), ...);
+}
+
+/// @brief Calls the function for each index of the elements of the state.
+///
+/// @details For states whose size is known at compile time (`std::array`), and
+/// small enough, the calls are unrolled into straight-line code, in which the
+/// indices are constants. For the others, the function is called in a loop.
+///
+/// @tparam State The state vector type.
+/// @tparam Function The type of the function.
+/// @param x The state.
+/// @param function The function, called as `function(i)` for each index.
+template <class State, class Function>
+NUMINT_HOST_DEVICE constexpr void for_each_index(const State &x, Function &&function)
+{
+    constexpr std::size_t size = static_size_v<State>;
+    if constexpr ((size > 0) && (size <= max_unrolled_size)) {
+        (void)x;
+        detail::unroll(function, std::make_index_sequence<size>{});
+    } else {
+        for (std::size_t i = 0; i < x.size(); ++i) {
+            function(i);
+        }
+    }
+}
+
+} // namespace numint::detail
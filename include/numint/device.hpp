@@ -0,0 +1,493 @@
+/// @file device.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Integration of large ensembles of independent trajectories on GPU
+/// devices (CUDA or HIP), with one trajectory per thread.
+///
+/// @details The same code is compiled by the device compiler (nvcc, or hipcc),
+/// which launches the integration as a kernel, and by the host compiler, which
+/// integrates the trajectories one after the other, on the calling thread
+/// (e.g., to validate the models without a device). With nvcc, the flag
+/// `--expt-relaxed-constexpr` is required, since the steppers call the
+/// `constexpr` functions of the standard library (e.g., `std::array::operator[]`
+/// and `std::max`) from device code.
+
+#pragma once
+
+#include "numint/detail/device.hpp"
+#include "numint/detail/type_traits.hpp"
+#include "numint/detail/unroll.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+namespace numint
+{
+
+#if defined(NUMINT_DEVICE_BACKEND_CUDA)
+/// @brief The stream on which the kernels are launched, and the copies are queued.
+using device_stream = cudaStream_t;
+#elif defined(NUMINT_DEVICE_BACKEND_HIP)
+/// @brief The stream on which the kernels are launched, and the copies are queued.
+using device_stream = hipStream_t;
+#else
+/// @brief The stream on which the kernels are launched, without a device the
+/// trajectories are integrated on the calling thread.
+using device_stream = std::nullptr_t;
+#endif
+
+/// @brief The configuration of the launch of an integration on the device.
+struct device_launch {
+    /// @brief The stream on which the kernel is launched, the default stream when not set.
+    device_stream stream{};
+    /// @brief The number of threads (i.e., of trajectories) of each block.
+    unsigned block_size{128};
+};
+
+/// @brief The tolerances, and the limits of the step-size, of the adaptive integration on the device.
+/// @tparam Value The type of the values of the state.
+/// @tparam Time The datatype used to hold time.
+template <class Value, class Time>
+struct device_tollerances {
+    /// @brief The absolute tolerance.
+    Value atol{Value(1e-6)};
+    /// @brief The relative tolerance.
+    Value rtol{Value(1e-6)};
+    /// @brief The minimum step-size, steps exceeding the tolerance with this step-size are accepted anyway.
+    Time min_delta{Time(1e-12)};
+    /// @brief The maximum step-size.
+    Time max_delta{Time(1)};
+    /// @brief The maximum number of retries of a step exceeding the tolerance.
+    unsigned max_retries{10};
+};
+
+/// @brief A factory returning a copy of the same object for every trajectory
+/// (e.g., the same system, or an empty observer).
+/// @tparam T The type of the object.
+template <class T>
+struct device_replicate {
+    /// @brief The object.
+    T value;
+
+    /// @brief Returns a copy of the object.
+    /// @return the copy.
+    NUMINT_HOST_DEVICE auto operator()(std::size_t /*index*/) const -> T { return value; }
+};
+
+/// @brief An observer which ignores the trajectory.
+struct device_observer_none {
+    /// @brief Ignores the state.
+    /// @tparam State The state vector type.
+    /// @tparam Time The datatype used to hold time.
+    template <class State, class Time>
+    NUMINT_HOST_DEVICE void operator()(const State & /*x*/, Time /*t*/) noexcept
+    {
+        // Nothing to do.
+    }
+};
+
+/// @brief An observer reducing the trajectory to the minimum and the maximum of each variable.
+/// @tparam State The state vector type.
+/// @tparam Time The datatype used to hold time.
+template <class State, class Time>
+struct device_observer_minmax {
+    /// @brief The minimum of each variable.
+    State min{};
+    /// @brief The maximum of each variable.
+    State max{};
+    /// @brief The number of observations.
+    std::uint32_t observations{};
+
+    /// @brief Updates the minimum and the maximum with the given state.
+    /// @param x The state.
+    NUMINT_HOST_DEVICE void operator()(const State &x, Time /*t*/) noexcept
+    {
+        detail::for_each_index(x, [&](std::size_t i) {
+            min[i] = (observations == 0) ? x[i] : std::min(min[i], x[i]);
+            max[i] = (observations == 0) ? x[i] : std::max(max[i], x[i]);
+        });
+        ++observations;
+    }
+};
+
+/// @brief An observer keeping one observation of the trajectory every `every`,
+/// up to `Capacity` of them, in place.
+/// @tparam State The state vector type.
+/// @tparam Time The datatype used to hold time.
+/// @tparam Capacity The maximum number of kept observations.
+template <class State, class Time, std::size_t Capacity>
+struct device_observer_decimate {
+    /// @brief Keep one observation every `every`.
+    std::uint32_t every{1};
+    /// @brief The number of observations.
+    std::uint32_t observations{};
+    /// @brief The number of kept observations.
+    std::uint32_t size{};
+    /// @brief The kept states.
+    std::array<State, Capacity> states{};
+    /// @brief The kept times.
+    std::array<Time, Capacity> times{};
+
+    /// @brief Keeps the state, if it is one of the observations to keep, and there is space left.
+    /// @param x The state.
+    /// @param t The time.
+    NUMINT_HOST_DEVICE void operator()(const State &x, Time t) noexcept
+    {
+        if (((observations++ % every) == 0) && (size < Capacity)) {
+            states[size] = x;
+            times[size]  = t;
+            ++size;
+        }
+    }
+};
+
+/// @brief Integrates a single trajectory with a fixed time step, inside a device thread.
+///
+/// @details It behaves as `integrate_fixed`, and it can be called from device
+/// code, where the stepper and the state are kept in the registers of the thread.
+///
+/// @tparam Stepper The type of the integration stepper.
+/// @tparam Observer The type of the observer function.
+/// @tparam System The type of the system being integrated.
+///
+/// @param stepper The stepper used to perform the integration.
+/// @param observer The observer function to call after each step, receiving the updated state and time.
+/// @param system The system being integrated, which defines the equations of motion or dynamics.
+/// @param state The initial state of the system, which will be updated during integration.
+/// @param start_time The start time for the integration.
+/// @param end_time The final time for the integration.
+/// @param time_delta The fixed step size for integration.
+/// @return The number of steps taken to complete the integration.
+template <class Stepper, class Observer, class System>
+NUMINT_HOST_DEVICE auto integrate_member_fixed(
+    Stepper &stepper,
+    Observer &observer,
+    System &system,
+    typename Stepper::state_type &state,
+    typename Stepper::time_type start_time,
+    typename Stepper::time_type end_time,
+    typename Stepper::time_type time_delta) -> std::uint64_t
+{
+    std::uint64_t steps = 0;
+    stepper.adjust_size(state);
+    observer(state, start_time);
+    while (start_time < end_time) {
+        stepper.do_step(system, state, start_time, time_delta);
+        start_time += time_delta;
+        observer(state, start_time);
+        ++steps;
+    }
+    return steps;
+}
+
+/// @brief Integrates a single trajectory with an adaptive time step, inside a device thread.
+///
+/// @details The stepper must provide an embedded error estimate (e.g.,
+/// `stepper_explicit_dopri5`). The error of each element is scaled by
+/// `atol + rtol * |x_i|`, and a step is accepted when the largest scaled
+/// error is below 1, otherwise it is retried with a smaller step-size. The
+/// step-size is controlled by the elementary controller, and the last step is
+/// shortened to end exactly at `end_time`. Unlike `stepper_adaptive`, it keeps
+/// no state besides the one of the thread, and it can be called from device
+/// code. The integration proceeds forward in time.
+///
+/// @tparam Stepper The type of the integration stepper.
+/// @tparam Observer The type of the observer function.
+/// @tparam System The type of the system being integrated.
+///
+/// @param stepper The stepper used to perform the integration.
+/// @param observer The observer function to call after each accepted step, receiving the updated state and time.
+/// @param system The system being integrated, which defines the equations of motion or dynamics.
+/// @param state The initial state of the system, which will be updated during integration.
+/// @param start_time The start time for the integration.
+/// @param end_time The final time for the integration.
+/// @param time_delta The initial step size for integration.
+/// @param tollerances The tolerances, and the limits of the step-size.
+/// @return The number of accepted steps.
+template <class Stepper, class Observer, class System>
+NUMINT_HOST_DEVICE auto integrate_member_adaptive(
+    Stepper &stepper,
+    Observer &observer,
+    System &system,
+    typename Stepper::state_type &state,
+    typename Stepper::time_type start_time,
+    typename Stepper::time_type end_time,
+    typename Stepper::time_type time_delta,
+    const device_tollerances<typename Stepper::value_type, typename Stepper::time_type> &tollerances)
+    -> std::uint64_t
+{
+    using state_type = typename Stepper::state_type;
+    using time_type  = typename Stepper::time_type;
+    using value_type = typename Stepper::value_type;
+
+    static_assert(detail::is_embedded_stepper_v<Stepper>, "The stepper must provide an embedded error estimate.");
+
+    // The error of an element, scaled by its tolerance.
+    const auto metric = [&tollerances](std::size_t /*i*/, value_type value, value_type error) {
+        return std::abs(error) / (tollerances.atol + tollerances.rtol * std::abs(value));
+    };
+    // The exponent of the elementary controller.
+    const auto exponent = -time_type(1) / time_type(stepper.order_error() + 1);
+
+    std::uint64_t steps = 0;
+    state_type x0       = state;
+    time_delta          = std::min(std::max(time_delta, tollerances.min_delta), tollerances.max_delta);
+    stepper.adjust_size(state);
+    observer(state, start_time);
+    while (start_time < end_time) {
+        // Make sure we don't go beyond the end_time.
+        const time_type span = end_time - start_time;
+        if (!(time_delta < span)) {
+            time_delta = span;
+        }
+        for (unsigned retry = 0;; ++retry) {
+            detail::copy_state(state, x0);
+            const auto error =
+                static_cast<time_type>(stepper.do_step_with_error(system, state, start_time, time_delta, metric));
+            const auto factor = std::min(
+                time_type(5),
+                std::max(time_type(0.2), time_type(0.9) * static_cast<time_type>(std::pow(error, exponent))));
+            if ((error <= 1) || (time_delta <= tollerances.min_delta) || (retry >= tollerances.max_retries)) {
+                // Land exactly on the end_time, unless a retry shortened the last step.
+                start_time = (time_delta < span) ? (start_time + time_delta) : end_time;
+                time_delta = std::min(std::max(time_delta * factor, tollerances.min_delta), tollerances.max_delta);
+                break;
+            }
+            // Reject the step, and retry it with a smaller step-size.
+            detail::copy_state(x0, state);
+            time_delta = std::max(time_delta * factor, tollerances.min_delta);
+        }
+        observer(state, start_time);
+        ++steps;
+    }
+    return steps;
+}
+
+namespace detail
+{
+
+/// @brief Checks the kernel launched last, and throws if it failed to launch.
+inline void check_device_launch()
+{
+#if defined(NUMINT_DEVICE_BACKEND_CUDA)
+    const cudaError_t error = cudaGetLastError();
+    if (error != cudaSuccess) {
+        throw std::runtime_error(std::string("numint: kernel launch failed: ") + cudaGetErrorString(error));
+    }
+#elif defined(NUMINT_DEVICE_BACKEND_HIP)
+    const hipError_t error = hipGetLastError();
+    if (error != hipSuccess) {
+        throw std::runtime_error(std::string("numint: kernel launch failed: ") + hipGetErrorString(error));
+    }
+#endif
+}
+
+#if defined(NUMINT_DEVICE_ENABLED)
+/// @brief Integrates each trajectory in its own thread.
+/// @tparam Member The type of the function integrating a trajectory.
+/// @param member The function integrating a trajectory, called as `member(index)`.
+/// @param members The number of trajectories.
+template <class Member>
+__global__ void integrate_members_kernel(const Member member, const std::size_t members)
+{
+    const std::size_t index = static_cast<std::size_t>(blockIdx.x) * blockDim.x + threadIdx.x;
+    if (index < members) {
+        member(index);
+    }
+}
+#endif
+
+/// @brief Launches the integration of the trajectories, on the device if
+/// available, or on the calling thread otherwise.
+/// @tparam Member The type of the function integrating a trajectory.
+/// @param launch The configuration of the launch.
+/// @param member The function integrating a trajectory, called as `member(index)`.
+/// @param members The number of trajectories.
+template <class Member>
+void launch_members(const device_launch &launch, const Member &member, std::size_t members)
+{
+#if defined(NUMINT_DEVICE_ENABLED)
+    if (members > 0) {
+        const auto blocks = static_cast<unsigned>((members + launch.block_size - 1) / launch.block_size);
+        integrate_members_kernel<<<blocks, launch.block_size, 0, launch.stream>>>(member, members);
+        check_device_launch();
+    }
+#else
+    (void)launch;
+    for (std::size_t index = 0; index < members; ++index) {
+        member(index);
+    }
+#endif
+}
+
+/// @brief The type of the observers created by a factory.
+/// @tparam ObserverFactory The type of the function creating an observer, as `make_observer(index)`.
+template <class ObserverFactory>
+using device_observer_t = std::decay_t<std::invoke_result_t<const ObserverFactory &, std::size_t>>;
+
+/// @brief Integrates a trajectory, inside its own thread.
+/// @tparam Stepper The type of the integration stepper.
+/// @tparam SystemFactory The type of the function creating a system, as `make_system(index)`.
+/// @tparam ObserverFactory The type of the function creating an observer, as `make_observer(index)`.
+/// @tparam Adaptive Whether the step-size is adaptive.
+template <class Stepper, class SystemFactory, class ObserverFactory, bool Adaptive>
+struct device_member {
+    /// @brief The state vector type.
+    using state_type    = typename Stepper::state_type;
+    /// @brief Type used to keep track of time.
+    using time_type     = typename Stepper::time_type;
+    /// @brief Type of value contained in the state vector.
+    using value_type    = typename Stepper::value_type;
+    /// @brief The type of the observers.
+    using observer_type = device_observer_t<ObserverFactory>;
+
+    /// @brief Creates the system of a trajectory.
+    SystemFactory make_system;
+    /// @brief Creates the observer of a trajectory.
+    ObserverFactory make_observer;
+    /// @brief The states of the trajectories.
+    state_type *states;
+    /// @brief Receives the observers of the trajectories, when not null.
+    observer_type *observers;
+    /// @brief The start time for the integration.
+    time_type start_time;
+    /// @brief The final time for the integration.
+    time_type end_time;
+    /// @brief The (initial) step size for integration.
+    time_type time_delta;
+    /// @brief The tolerances of the adaptive integration.
+    device_tollerances<value_type, time_type> tollerances;
+
+    /// @brief Integrates the given trajectory.
+    /// @param index The index of the trajectory.
+    NUMINT_HOST_DEVICE void operator()(std::size_t index) const
+    {
+        Stepper stepper;
+        auto system   = make_system(index);
+        auto observer = make_observer(index);
+        // Keep the state in the registers of the thread.
+        state_type x  = states[index];
+        if constexpr (Adaptive) {
+            integrate_member_adaptive(stepper, observer, system, x, start_time, end_time, time_delta, tollerances);
+        } else {
+            integrate_member_fixed(stepper, observer, system, x, start_time, end_time, time_delta);
+        }
+        states[index] = x;
+        if (observers != nullptr) {
+            observers[index] = observer;
+        }
+    }
+};
+
+} // namespace detail
+
+/// @brief Integrates many independent trajectories with a fixed time step,
+/// with one trajectory per device thread.
+///
+/// @details Each thread creates its own stepper, its own system through
+/// `make_system(index)`, and its own observer through `make_observer(index)`,
+/// which are functors (or extended lambdas) callable from device code. The
+/// system and the observer are called as on the host, hence a model written
+/// against the stepper concept only needs its `operator()` to be marked with
+/// `NUMINT_HOST_DEVICE`. The state must have a size known at compile time
+/// (e.g., `std::array`), so that the stepper is kept in the registers of the
+/// thread. Observers reduce (e.g., `device_observer_minmax`) or decimate
+/// (e.g., `device_observer_decimate`) the trajectory inside the thread, and
+/// they are copied to `observers` at the end.
+///
+/// On the device, `states` and `observers` must point to device memory, and
+/// the function returns as soon as the kernel is queued on the stream: the
+/// results are copied back by queueing the copies on the same stream (e.g.,
+/// with `cudaMemcpyAsync`), so that the next batch of trajectories can be
+/// prepared meanwhile. Without a device, the trajectories are integrated on
+/// the calling thread, before returning.
+///
+/// @tparam Stepper The type of the integration stepper (e.g., `stepper_explicit_rk4`).
+/// @tparam SystemFactory The type of the function creating a system, as `make_system(index)`.
+/// @tparam ObserverFactory The type of the function creating an observer, as `make_observer(index)`.
+///
+/// @param launch The configuration of the launch.
+/// @param make_system Creates the system of a trajectory.
+/// @param make_observer Creates the observer of a trajectory.
+/// @param states The initial states of the trajectories, which will be updated during integration.
+/// @param observers Receives the observers of the trajectories, it can be null.
+/// @param members The number of trajectories.
+/// @param start_time The start time for the integration.
+/// @param end_time The final time for the integration.
+/// @param time_delta The fixed step size for integration.
+/// @throws std::runtime_error if the kernel could not be launched.
+template <class Stepper, class SystemFactory, class ObserverFactory>
+void integrate_device_fixed(
+    const device_launch &launch,
+    SystemFactory make_system,
+    ObserverFactory make_observer,
+    typename Stepper::state_type *states,
+    detail::device_observer_t<ObserverFactory> *observers,
+    std::size_t members,
+    typename Stepper::time_type start_time,
+    typename Stepper::time_type end_time,
+    typename Stepper::time_type time_delta)
+{
+    static_assert(!Stepper::is_adaptive_stepper, "The fixed-step integration requires a fixed-step stepper.");
+    static_assert(
+        detail::static_size_v<typename Stepper::state_type> > 0, "The state must have a size known at compile time.");
+    detail::launch_members(
+        launch,
+        detail::device_member<Stepper, SystemFactory, ObserverFactory, false>{
+            make_system, make_observer, states, observers, start_time, end_time, time_delta, {}},
+        members);
+}
+
+/// @brief Integrates many independent trajectories with an adaptive time
+/// step, with one trajectory per device thread.
+///
+/// @details It behaves as `integrate_device_fixed`, while each thread
+/// controls the step-size of its own trajectory (see
+/// `integrate_member_adaptive`), hence the stepper must provide an embedded
+/// error estimate (e.g., `stepper_explicit_dopri5`). The threads of a block
+/// wait for the slowest one, thus trajectories of similar stiffness should be
+/// launched together.
+///
+/// @tparam Stepper The type of the integration stepper (e.g., `stepper_explicit_dopri5`).
+/// @tparam SystemFactory The type of the function creating a system, as `make_system(index)`.
+/// @tparam ObserverFactory The type of the function creating an observer, as `make_observer(index)`.
+///
+/// @param launch The configuration of the launch.
+/// @param make_system Creates the system of a trajectory.
+/// @param make_observer Creates the observer of a trajectory.
+/// @param states The initial states of the trajectories, which will be updated during integration.
+/// @param observers Receives the observers of the trajectories, it can be null.
+/// @param members The number of trajectories.
+/// @param start_time The start time for the integration.
+/// @param end_time The final time for the integration.
+/// @param time_delta The initial step size for integration.
+/// @param tollerances The tolerances, and the limits of the step-size.
+/// @throws std::runtime_error if the kernel could not be launched.
+template <class Stepper, class SystemFactory, class ObserverFactory>
+void integrate_device_adaptive(
+    const device_launch &launch,
+    SystemFactory make_system,
+    ObserverFactory make_observer,
+    typename Stepper::state_type *states,
+    detail::device_observer_t<ObserverFactory> *observers,
+    std::size_t members,
+    typename Stepper::time_type start_time,
+    typename Stepper::time_type end_time,
+    typename Stepper::time_type time_delta,
+    const device_tollerances<typename Stepper::value_type, typename Stepper::time_type> &tollerances = {})
+{
+    static_assert(
+        detail::static_size_v<typename Stepper::state_type> > 0, "The state must have a size known at compile time.");
+    detail::launch_members(
+        launch,
+        detail::device_member<Stepper, SystemFactory, ObserverFactory, true>{
+            make_system, make_observer, states, observers, start_time, end_time, time_delta, tollerances},
+        members);
+}
+
+} // namespace numint
@@ -0,0 +1,601 @@
+/// @file dual.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Dual numbers, for the forward-mode automatic differentiation of the
+/// systems (exact Jacobians, and sensitivities with respect to parameters).
+///
+/// @details A `dual<T, N>` carries a value, and its derivatives along N
+/// directions, which are propagated exactly through the arithmetic operations
+/// and the mathematical functions. Systems written for a generic scalar type
+/// (i.e., templated on the state, or on the type of its values) evaluate their
+/// derivatives along all the directions in a single call. The mathematical
+/// functions are found by argument-dependent lookup, hence the systems should
+/// call them unqualified, after `using std::sin;` (and so on), rather than as
+/// `std::sin`. The comparisons only consider the values.
+
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+namespace numint
+{
+
+/// @brief A dual number, i.e., a value and its derivatives along N directions.
+/// @tparam T The type of the value, and of the derivatives.
+/// @tparam N The number of directions.
+template <class T, std::size_t N>
+class dual
+{
+public:
+    /// @brief The type of the value, and of the derivatives.
+    using scalar_type = T;
+
+    /// @brief The number of directions.
+    static constexpr std::size_t directions = N;
+
+    /// @brief Constructs a zero constant.
+    constexpr dual() = default;
+
+    /// @brief Constructs a constant, whose derivatives are zero.
+    /// @param value The value.
+    constexpr dual(T value) noexcept
+        : m_value(value)
+    {
+        // Nothing to do.
+    }
+
+    /// @brief Constructs a variable, whose derivative is one along the given direction, and zero along the others.
+    /// @param value The value.
+    /// @param direction The direction.
+    constexpr dual(T value, std::size_t direction) noexcept
+        : m_value(value)
+    {
+        m_derivatives[direction] = T(1);
+    }
+
+    /// @brief Returns the value.
+    /// @return the value.
+    constexpr auto value() const noexcept -> T { return m_value; }
+
+    /// @brief Returns the derivative along the given direction.
+    /// @param direction The direction.
+    /// @return the derivative.
+    constexpr auto derivative(std::size_t direction) const noexcept -> T { return m_derivatives[direction]; }
+
+    /// @brief Returns the derivative along the given direction.
+    /// @param direction The direction.
+    /// @return a reference to the derivative.
+    constexpr auto derivative(std::size_t direction) noexcept -> T & { return m_derivatives[direction]; }
+
+    /// @brief Converts to the value, dropping the derivatives.
+    /// @return the value.
+    constexpr explicit operator T() const noexcept { return m_value; }
+
+    /// @brief Adds another dual number.
+    /// @param rhs The other dual number.
+    /// @return a reference to this dual number.
+    constexpr auto operator+=(const dual &rhs) noexcept -> dual &
+    {
+        m_value += rhs.m_value;
+        for (std::size_t k = 0; k < N; ++k) {
+            m_derivatives[k] += rhs.m_derivatives[k];
+        }
+        return *this;
+    }
+
+    /// @brief Subtracts another dual number.
+    /// @param rhs The other dual number.
+    /// @return a reference to this dual number.
+    constexpr auto operator-=(const dual &rhs) noexcept -> dual &
+    {
+        m_value -= rhs.m_value;
+        for (std::size_t k = 0; k < N; ++k) {
+            m_derivatives[k] -= rhs.m_derivatives[k];
+        }
+        return *this;
+    }
+
+    /// @brief Multiplies by another dual number.
+    /// @param rhs The other dual number.
+    /// @return a reference to this dual number.
+    constexpr auto operator*=(const dual &rhs) noexcept -> dual &
+    {
+        for (std::size_t k = 0; k < N; ++k) {
+            m_derivatives[k] = m_derivatives[k] * rhs.m_value + m_value * rhs.m_derivatives[k];
+        }
+        m_value *= rhs.m_value;
+        return *this;
+    }
+
+    /// @brief Divides by another dual number.
+    /// @param rhs The other dual number.
+    /// @return a reference to this dual number.
+    constexpr auto operator/=(const dual &rhs) noexcept -> dual &
+    {
+        const T inverse = T(1) / rhs.m_value;
+        m_value *= inverse;
+        for (std::size_t k = 0; k < N; ++k) {
+            m_derivatives[k] = (m_derivatives[k] - m_value * rhs.m_derivatives[k]) * inverse;
+        }
+        return *this;
+    }
+
+    /// @brief Multiplies by a constant.
+    /// @param rhs The constant.
+    /// @return a reference to this dual number.
+    constexpr auto operator*=(T rhs) noexcept -> dual &
+    {
+        m_value *= rhs;
+        for (std::size_t k = 0; k < N; ++k) {
+            m_derivatives[k] *= rhs;
+        }
+        return *this;
+    }
+
+    /// @brief Divides by a constant.
+    /// @param rhs The constant.
+    /// @return a reference to this dual number.
+    constexpr auto operator/=(T rhs) noexcept -> dual & { return (*this) *= (T(1) / rhs); }
+
+    /// @brief Returns the dual number itself.
+    /// @param x The dual number.
+    /// @return the dual number.
+    friend constexpr auto operator+(const dual &x) noexcept -> dual { return x; }
+
+    /// @brief Negates a dual number.
+    /// @param x The dual number.
+    /// @return the negated dual number.
+    friend constexpr auto operator-(dual x) noexcept -> dual { return x *= T(-1); }
+
+    /// @brief Adds two dual numbers.
+    /// @param lhs The first dual number.
+    /// @param rhs The second dual number.
+    /// @return the sum.
+    friend constexpr auto operator+(dual lhs, const dual &rhs) noexcept -> dual { return lhs += rhs; }
+
+    /// @brief Subtracts two dual numbers.
+    /// @param lhs The first dual number.
+    /// @param rhs The second dual number.
+    /// @return the difference.
+    friend constexpr auto operator-(dual lhs, const dual &rhs) noexcept -> dual { return lhs -= rhs; }
+
+    /// @brief Multiplies two dual numbers.
+    /// @param lhs The first dual number.
+    /// @param rhs The second dual number.
+    /// @return the product.
+    friend constexpr auto operator*(dual lhs, const dual &rhs) noexcept -> dual { return lhs *= rhs; }
+
+    /// @brief Divides two dual numbers.
+    /// @param lhs The first dual number.
+    /// @param rhs The second dual number.
+    /// @return the quotient.
+    friend constexpr auto operator/(dual lhs, const dual &rhs) noexcept -> dual { return lhs /= rhs; }
+
+    /// @brief Multiplies a dual number by a constant.
+    /// @param lhs The dual number.
+    /// @param rhs The constant.
+    /// @return the product.
+    friend constexpr auto operator*(dual lhs, T rhs) noexcept -> dual { return lhs *= rhs; }
+
+    /// @brief Multiplies a constant by a dual number.
+    /// @param lhs The constant.
+    /// @param rhs The dual number.
+    /// @return the product.
+    friend constexpr auto operator*(T lhs, dual rhs) noexcept -> dual { return rhs *= lhs; }
+
+    /// @brief Divides a dual number by a constant.
+    /// @param lhs The dual number.
+    /// @param rhs The constant.
+    /// @return the quotient.
+    friend constexpr auto operator/(dual lhs, T rhs) noexcept -> dual { return lhs /= rhs; }
+
+    /// @brief Checks if the value of a dual number is less than the value of another one.
+    /// @param lhs The first dual number.
+    /// @param rhs The second dual number.
+    /// @return the result of the comparison.
+    friend constexpr auto operator<(const dual &lhs, const dual &rhs) noexcept -> bool
+    {
+        return lhs.m_value < rhs.m_value;
+    }
+
+    /// @brief Checks if the value of a dual number is greater than the value of another one.
+    /// @param lhs The first dual number.
+    /// @param rhs The second dual number.
+    /// @return the result of the comparison.
+    friend constexpr auto operator>(const dual &lhs, const dual &rhs) noexcept -> bool { return rhs < lhs; }
+
+    /// @brief Checks if the value of a dual number is less than, or equal to, the value of another one.
+    /// @param lhs The first dual number.
+    /// @param rhs The second dual number.
+    /// @return the result of the comparison.
+    friend constexpr auto operator<=(const dual &lhs, const dual &rhs) noexcept -> bool
+    {
+        return lhs.m_value <= rhs.m_value;
+    }
+
+    /// @brief Checks if the value of a dual number is greater than, or equal to, the value of another one.
+    /// @param lhs The first dual number.
+    /// @param rhs The second dual number.
+    /// @return the result of the comparison.
+    friend constexpr auto operator>=(const dual &lhs, const dual &rhs) noexcept -> bool { return rhs <= lhs; }
+
+    /// @brief Checks if the value of a dual number is equal to the value of another one.
+    /// @param lhs The first dual number.
+    /// @param rhs The second dual number.
+    /// @return the result of the comparison.
+    friend constexpr auto operator==(const dual &lhs, const dual &rhs) noexcept -> bool
+    {
+        return (lhs <= rhs) && (rhs <= lhs);
+    }
+
+    /// @brief Checks if the value of a dual number is different from the value of another one.
+    /// @param lhs The first dual number.
+    /// @param rhs The second dual number.
+    /// @return the result of the comparison.
+    friend constexpr auto operator!=(const dual &lhs, const dual &rhs) noexcept -> bool { return !(lhs == rhs); }
+
+private:
+    /// The value.
+    T m_value{};
+    /// The derivatives along the directions.
+    std::array<T, N> m_derivatives{};
+};
+
+/// @brief Checks if a type is a dual number.
+/// @tparam T The type to check.
+template <class T>
+struct is_dual : std::false_type {
+};
+
+/// @brief Checks if a type is a dual number.
+/// @tparam T The type of the value.
+/// @tparam N The number of directions.
+template <class T, std::size_t N>
+struct is_dual<dual<T, N>> : std::true_type {
+};
+
+/// @brief Helper variable template to check if a type is a dual number.
+/// @tparam T The type to check.
+template <class T>
+constexpr inline bool is_dual_v = is_dual<T>::value;
+
+namespace detail
+{
+
+/// @brief Provides the state vector type holding values of another type (e.g., dual numbers).
+/// @tparam State The state vector type.
+/// @tparam U The type of the values of the new state.
+template <class State, class U>
+struct rebind_state;
+
+/// @brief Provides the state vector type holding values of another type (e.g., dual numbers).
+/// @tparam T The type of the values of the state.
+/// @tparam N The number of elements.
+/// @tparam U The type of the values of the new state.
+template <class T, std::size_t N, class U>
+struct rebind_state<std::array<T, N>, U> {
+    /// @brief The new state vector type.
+    using type = std::array<U, N>;
+};
+
+/// @brief Provides the state vector type holding values of another type (e.g., dual numbers).
+/// @tparam T The type of the values of the state.
+/// @tparam Allocator The allocator of the state.
+/// @tparam U The type of the values of the new state.
+template <class T, class Allocator, class U>
+struct rebind_state<std::vector<T, Allocator>, U> {
+    /// @brief The new state vector type.
+    using type = std::vector<U>;
+};
+
+/// @brief Helper alias template for the state vector type holding values of another type.
+/// @tparam State The state vector type.
+/// @tparam U The type of the values of the new state.
+template <class State, class U>
+using rebind_state_t = typename rebind_state<State, U>::type;
+
+} // namespace detail
+
+/// @brief Applies the chain rule, for a function whose value and derivative at x are known.
+/// @tparam T The type of the value.
+/// @tparam N The number of directions.
+/// @param x The argument.
+/// @param value The value of the function at x.
+/// @param derivative The derivative of the function at x.
+/// @return the dual number holding the value of the function, and its derivatives.
+template <class T, std::size_t N>
+constexpr auto chain(const dual<T, N> &x, T value, T derivative) noexcept -> dual<T, N>
+{
+    dual<T, N> result(value);
+    for (std::size_t k = 0; k < N; ++k) {
+        result.derivative(k) = derivative * x.derivative(k);
+    }
+    return result;
+}
+
+/// @brief Computes the absolute value.
+/// @tparam T The type of the value.
+/// @tparam N The number of directions.
+/// @param x The argument.
+/// @return the absolute value.
+template <class T, std::size_t N>
+auto abs(const dual<T, N> &x) noexcept -> dual<T, N>
+{
+    return (x.value() < T(0)) ? -x : x;
+}
+
+/// @brief Computes the absolute value.
+/// @tparam T The type of the value.
+/// @tparam N The number of directions.
+/// @param x The argument.
+/// @return the absolute value.
+template <class T, std::size_t N>
+auto fabs(const dual<T, N> &x) noexcept -> dual<T, N>
+{
+    return abs(x);
+}
+
+/// @brief Computes the square root.
+/// @tparam T The type of the value.
+/// @tparam N The number of directions.
+/// @param x The argument.
+/// @return the square root.
+template <class T, std::size_t N>
+auto sqrt(const dual<T, N> &x) noexcept -> dual<T, N>
+{
+    const T value = std::sqrt(x.value());
+    return chain(x, value, T(0.5) / value);
+}
+
+/// @brief Computes the cubic root.
+/// @tparam T The type of the value.
+/// @tparam N The number of directions.
+/// @param x The argument.
+/// @return the cubic root.
+template <class T, std::size_t N>
+auto cbrt(const dual<T, N> &x) noexcept -> dual<T, N>
+{
+    const T value = std::cbrt(x.value());
+    return chain(x, value, T(1) / (T(3) * value * value));
+}
+
+/// @brief Computes the exponential.
+/// @tparam T The type of the value.
+/// @tparam N The number of directions.
+/// @param x The argument.
+/// @return the exponential.
+template <class T, std::size_t N>
+auto exp(const dual<T, N> &x) noexcept -> dual<T, N>
+{
+    const T value = std::exp(x.value());
+    return chain(x, value, value);
+}
+
+/// @brief Computes the natural logarithm.
+/// @tparam T The type of the value.
+/// @tparam N The number of directions.
+/// @param x The argument.
+/// @return the natural logarithm.
+template <class T, std::size_t N>
+auto log(const dual<T, N> &x) noexcept -> dual<T, N>
+{
+    return chain(x, std::log(x.value()), T(1) / x.value());
+}
+
+/// @brief Computes the power with a constant exponent.
+/// @tparam T The type of the value.
+/// @tparam N The number of directions.
+/// @param x The base.
+/// @param y The exponent.
+/// @return the power.
+template <class T, std::size_t N>
+auto pow(const dual<T, N> &x, T y) noexcept -> dual<T, N>
+{
+    return chain(x, std::pow(x.value(), y), y * std::pow(x.value(), y - T(1)));
+}
+
+/// @brief Computes the power of a constant base.
+/// @tparam T The type of the value.
+/// @tparam N The number of directions.
+/// @param x The base.
+/// @param y The exponent.
+/// @return the power.
+template <class T, std::size_t N>
+auto pow(T x, const dual<T, N> &y) noexcept -> dual<T, N>
+{
+    const T value = std::pow(x, y.value());
+    return chain(y, value, value * std::log(x));
+}
+
+/// @brief Computes the power.
+/// @tparam T The type of the value.
+/// @tparam N The number of directions.
+/// @param x The base.
+/// @param y The exponent.
+/// @return the power.
+template <class T, std::size_t N>
+auto pow(const dual<T, N> &x, const dual<T, N> &y) noexcept -> dual<T, N>
+{
+    return exp(y * log(x));
+}
+
+/// @brief Computes the sine.
+/// @tparam T The type of the value.
+/// @tparam N The number of directions.
+/// @param x The argument.
+/// @return the sine.
+template <class T, std::size_t N>
+auto sin(const dual<T, N> &x) noexcept -> dual<T, N>
+{
+    return chain(x, std::sin(x.value()), std::cos(x.value()));
+}
+
+/// @brief Computes the cosine.
+/// @tparam T The type of the value.
+/// @tparam N The number of directions.
+/// @param x The argument.
+/// @return the cosine.
+template <class T, std::size_t N>
+auto cos(const dual<T, N> &x) noexcept -> dual<T, N>
+{
+    return chain(x, std::cos(x.value()), -std::sin(x.value()));
+}
+
+/// @brief Computes the tangent.
+/// @tparam T The type of the value.
+/// @tparam N The number of directions.
+/// @param x The argument.
+/// @return the tangent.
+template <class T, std::size_t N>
+auto tan(const dual<T, N> &x) noexcept -> dual<T, N>
+{
+    const T value = std::tan(x.value());
+    return chain(x, value, T(1) + value * value);
+}
+
+/// @brief Computes the arc sine.
+/// @tparam T The type of the value.
+/// @tparam N The number of directions.
+/// @param x The argument.
+/// @return the arc sine.
+template <class T, std::size_t N>
+auto asin(const dual<T, N> &x) noexcept -> dual<T, N>
+{
+    return chain(x, std::asin(x.value()), T(1) / std::sqrt(T(1) - x.value() * x.value()));
+}
+
+/// @brief Computes the arc cosine.
+/// @tparam T The type of the value.
+/// @tparam N The number of directions.
+/// @param x The argument.
+/// @return the arc cosine.
+template <class T, std::size_t N>
+auto acos(const dual<T, N> &x) noexcept -> dual<T, N>
+{
+    return chain(x, std::acos(x.value()), T(-1) / std::sqrt(T(1) - x.value() * x.value()));
+}
+
+/// @brief Computes the arc tangent.
+/// @tparam T The type of the value.
+/// @tparam N The number of directions.
+/// @param x The argument.
+/// @return the arc tangent.
+template <class T, std::size_t N>
+auto atan(const dual<T, N> &x) noexcept -> dual<T, N>
+{
+    return chain(x, std::atan(x.value()), T(1) / (T(1) + x.value() * x.value()));
+}
+
+/// @brief Computes the arc tangent of y / x, using the signs to determine the quadrant.
+/// @tparam T The type of the value.
+/// @tparam N The number of directions.
+/// @param y The first argument.
+/// @param x The second argument.
+/// @return the arc tangent.
+template <class T, std::size_t N>
+auto atan2(const dual<T, N> &y, const dual<T, N> &x) noexcept -> dual<T, N>
+{
+    const T inverse = T(1) / (x.value() * x.value() + y.value() * y.value());
+    dual<T, N> result(std::atan2(y.value(), x.value()));
+    for (std::size_t k = 0; k < N; ++k) {
+        result.derivative(k) = (x.value() * y.derivative(k) - y.value() * x.derivative(k)) * inverse;
+    }
+    return result;
+}
+
+/// @brief Computes the hyperbolic sine.
+/// @tparam T The type of the value.
+/// @tparam N The number of directions.
+/// @param x The argument.
+/// @return the hyperbolic sine.
+template <class T, std::size_t N>
+auto sinh(const dual<T, N> &x) noexcept -> dual<T, N>
+{
+    return chain(x, std::sinh(x.value()), std::cosh(x.value()));
+}
+
+/// @brief Computes the hyperbolic cosine.
+/// @tparam T The type of the value.
+/// @tparam N The number of directions.
+/// @param x The argument.
+/// @return the hyperbolic cosine.
+template <class T, std::size_t N>
+auto cosh(const dual<T, N> &x) noexcept -> dual<T, N>
+{
+    return chain(x, std::cosh(x.value()), std::sinh(x.value()));
+}
+
+/// @brief Computes the hyperbolic tangent.
+/// @tparam T The type of the value.
+/// @tparam N The number of directions.
+/// @param x The argument.
+/// @return the hyperbolic tangent.
+template <class T, std::size_t N>
+auto tanh(const dual<T, N> &x) noexcept -> dual<T, N>
+{
+    const T value = std::tanh(x.value());
+    return chain(x, value, T(1) - value * value);
+}
+
+/// @brief Checks if the value is finite.
+/// @tparam T The type of the value.
+/// @tparam N The number of directions.
+/// @param x The argument.
+/// @return true if the value is finite.
+template <class T, std::size_t N>
+auto isfinite(const dual<T, N> &x) noexcept -> bool
+{
+    return std::isfinite(x.value());
+}
+
+/// @brief Checks if the value is not a number.
+/// @tparam T The type of the value.
+/// @tparam N The number of directions.
+/// @param x The argument.
+/// @return true if the value is not a number.
+template <class T, std::size_t N>
+auto isnan(const dual<T, N> &x) noexcept -> bool
+{
+    return std::isnan(x.value());
+}
+
+} // namespace numint
+
+namespace std
+{
+
+/// @brief The limits of a dual number, which are the ones of its value.
+/// @tparam T The type of the value.
+/// @tparam N The number of directions.
+template <class T, std::size_t N>
+struct numeric_limits<numint::dual<T, N>> : public numeric_limits<T> {
+    /// @brief Returns the smallest positive normalized value.
+    /// @return the value.
+    static constexpr auto min() noexcept -> numint::dual<T, N> { return numeric_limits<T>::min(); }
+
+    /// @brief Returns the largest finite value.
+    /// @return the value.
+    static constexpr auto max() noexcept -> numint::dual<T, N> { return numeric_limits<T>::max(); }
+
+    /// @brief Returns the lowest finite value.
+    /// @return the value.
+    static constexpr auto lowest() noexcept -> numint::dual<T, N> { return numeric_limits<T>::lowest(); }
+
+    /// @brief Returns the difference between 1 and the next representable value.
+    /// @return the value.
+    static constexpr auto epsilon() noexcept -> numint::dual<T, N> { return numeric_limits<T>::epsilon(); }
+
+    /// @brief Returns the positive infinity.
+    /// @return the value.
+    static constexpr auto infinity() noexcept -> numint::dual<T, N> { return numeric_limits<T>::infinity(); }
+
+    /// @brief Returns a quiet not-a-number.
+    /// @return the value.
+    static constexpr auto quiet_NaN() noexcept -> numint::dual<T, N> { return numeric_limits<T>::quiet_NaN(); }
+};
+
+} // namespace std
@@ -0,0 +1,215 @@
+/// @file ensemble.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Integration of many independent instances (members) of the same
+/// system, advanced together by a single stepper.
+
+#pragma once
+
+#include "numint/solver.hpp"
+
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+namespace numint
+{
+
+/// @brief State of an ensemble of systems, stored as a structure of arrays.
+///
+/// @details The values of the same variable for all the members are stored
+/// contiguously, i.e., the j-th variable of the i-th member is stored at
+/// position (j * members() + i). The state behaves like an `std::vector`,
+/// hence the steppers operate on it without knowing about the members, and
+/// their element-wise operations run over all the members at once, which
+/// allows the compiler to vectorize them. The number of variables is fixed at
+/// compile time, so that the stepper can resize its internal states, and the
+/// number of members can still be deduced from their size.
+///
+/// @tparam T The type of the variables.
+/// @tparam Variables The number of variables of each member.
+template <class T, std::size_t Variables>
+class ensemble_state
+{
+public:
+    /// @brief Type of the variables.
+    using value_type     = T;
+    /// @brief Type of the container holding the variables.
+    using container_type = std::vector<T>;
+    /// @brief Iterator over the variables.
+    using iterator       = typename container_type::iterator;
+    /// @brief Constant iterator over the variables.
+    using const_iterator = typename container_type::const_iterator;
+
+    /// @brief The number of variables of each member.
+    static constexpr std::size_t variables = Variables;
+
+    /// @brief Constructs an empty ensemble.
+    ensemble_state() = default;
+
+    /// @brief Constructs an ensemble with the given number of members.
+    /// @param members The number of members.
+    explicit ensemble_state(std::size_t members)
+        : m_data(members * Variables)
+    {
+        // Nothing to do.
+    }
+
+    /// @brief Returns the number of members of the ensemble.
+    /// @return the number of members.
+    auto members() const noexcept -> std::size_t { return m_data.size() / Variables; }
+
+    /// @brief Returns the total number of variables, for all the members.
+    /// @return the total number of variables.
+    auto size() const noexcept -> std::size_t { return m_data.size(); }
+
+    /// @brief Resizes the ensemble.
+    /// @param size The total number of variables, it must be a multiple of `variables`.
+    void resize(std::size_t size)
+    {
+        assert((size % Variables) == 0);
+        m_data.resize(size);
+    }
+
+    /// @brief Returns the values of the given variable, for all the members.
+    /// @param variable The index of the variable.
+    /// @return a pointer to the first of `members()` contiguous values.
+    auto variable(std::size_t variable) noexcept -> value_type * { return m_data.data() + variable * members(); }
+
+    /// @brief Returns the values of the given variable, for all the members.
+    /// @param variable The index of the variable.
+    /// @return a pointer to the first of `members()` contiguous values.
+    auto variable(std::size_t variable) const noexcept -> const value_type *
+    {
+        return m_data.data() + variable * members();
+    }
+
+    /// @brief Returns the given variable of the given member.
+    /// @param variable The index of the variable.
+    /// @param member The index of the member.
+    /// @return a reference to the variable.
+    auto operator()(std::size_t variable, std::size_t member) noexcept -> value_type &
+    {
+        return m_data[variable * members() + member];
+    }
+
+    /// @brief Returns the given variable of the given member.
+    /// @param variable The index of the variable.
+    /// @param member The index of the member.
+    /// @return a constant reference to the variable.
+    auto operator()(std::size_t variable, std::size_t member) const noexcept -> const value_type &
+    {
+        return m_data[variable * members() + member];
+    }
+
+    /// @brief Accesses the variables as a flat array.
+    /// @param index The position inside the flat array.
+    /// @return a reference to the variable.
+    auto operator[](std::size_t index) noexcept -> value_type & { return m_data[index]; }
+
+    /// @brief Accesses the variables as a flat array.
+    /// @param index The position inside the flat array.
+    /// @return a constant reference to the variable.
+    auto operator[](std::size_t index) const noexcept -> const value_type & { return m_data[index]; }
+
+    /// @brief Copies the state of a single system inside the given member.
+    /// @tparam State The state of a single system (e.g., `std::array<T, Variables>`).
+    /// @param member The index of the member.
+    /// @param state The state to copy.
+    template <class State>
+    void set_member(std::size_t member, const State &state) noexcept
+    {
+        for (std::size_t j = 0; j < Variables; ++j) {
+            (*this)(j, member) = state[j];
+        }
+    }
+
+    /// @brief Copies the given member inside the state of a single system.
+    /// @tparam State The state of a single system (e.g., `std::array<T, Variables>`).
+    /// @param member The index of the member.
+    /// @param state The state receiving the member.
+    template <class State>
+    void get_member(std::size_t member, State &state) const noexcept
+    {
+        for (std::size_t j = 0; j < Variables; ++j) {
+            state[j] = (*this)(j, member);
+        }
+    }
+
+    /// @brief Returns an iterator to the first variable.
+    /// @return the iterator.
+    auto begin() noexcept -> iterator { return m_data.begin(); }
+
+    /// @brief Returns an iterator past the last variable.
+    /// @return the iterator.
+    auto end() noexcept -> iterator { return m_data.end(); }
+
+    /// @brief Returns a constant iterator to the first variable.
+    /// @return the iterator.
+    auto begin() const noexcept -> const_iterator { return m_data.begin(); }
+
+    /// @brief Returns a constant iterator past the last variable.
+    /// @return the iterator.
+    auto end() const noexcept -> const_iterator { return m_data.end(); }
+
+private:
+    /// The variables of all the members.
+    container_type m_data;
+};
+
+/// @brief Integrates all the members of an ensemble, with a fixed time step.
+///
+/// @details All the members are advanced together, with the same time step,
+/// by a single stepper whose state type is an `ensemble_state`. The system
+/// evaluates the derivatives of all the members at once, for instance:
+///
+///     void operator()(const ensemble_state<double, 2> &x, ensemble_state<double, 2> &dxdt, double t)
+///     {
+///         const double *x0 = x.variable(0), *x1 = x.variable(1);
+///         double *dx0 = dxdt.variable(0), *dx1 = dxdt.variable(1);
+///         for (std::size_t i = 0; i < x.members(); ++i) {
+///             dx0[i] = x1[i];
+///             dx1[i] = -k[i] * x0[i];
+///         }
+///     }
+///
+/// where the loop over the members can be vectorized by the compiler.
+/// Adaptive steppers are not supported, since the step-size would be dictated
+/// by the worst member of the ensemble.
+///
+/// @tparam Stepper The type of the integration stepper.
+/// @tparam System The type of the system being integrated.
+/// @tparam Observer The type of the observer function.
+/// @tparam TerminationCondition The type of the termination condition function.
+///
+/// @param stepper The stepper used to perform the integration.
+/// @param observer The observer function to call after each step, receiving the ensemble and the time.
+/// @param system The system evaluating the derivatives of all the members.
+/// @param state The initial state of the ensemble, which will be updated during integration.
+/// @param start_time The start time for the integration.
+/// @param end_time The final time for the integration.
+/// @param time_delta The fixed step size for integration.
+/// @param check_if_done The termination condition to determine if integration
+/// should stop early. Defaults to a function that always returns false.
+/// @return The number of steps taken to complete the integration.
+template <
+    class Stepper,
+    class System,
+    class Observer,
+    class TerminationCondition = decltype(detail::default_termination_condition<typename Stepper::state_type>)>
+constexpr auto integrate_ensemble(
+    Stepper &stepper,
+    Observer &&observer,
+    System &&system,
+    typename Stepper::state_type &state,
+    typename Stepper::time_type start_time,
+    typename Stepper::time_type end_time,
+    typename Stepper::time_type time_delta,
+    TerminationCondition check_if_done = detail::default_termination_condition<typename Stepper::state_type>) noexcept
+{
+    static_assert(!Stepper::is_adaptive_stepper, "The ensemble integration requires a fixed-step stepper.");
+    return integrate_fixed(
+        stepper, std::forward<Observer>(observer), std::forward<System>(system), state, start_time, end_time,
+        time_delta, check_if_done);
+}
+
+} // namespace numint
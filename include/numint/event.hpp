@@ -0,0 +1,279 @@
+/// @file event.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Detection and localization of events (zero-crossings of guard
+/// functions) during the integration.
+
+#pragma once
+
+#include "numint/detail/dense_output.hpp"
+#include "numint/detail/less_with_sign.hpp"
+#include "numint/detail/type_traits.hpp"
+#include "numint/trace.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <vector>
+
+namespace numint
+{
+
+/// @brief The direction of the zero-crossings triggering an event.
+enum class event_direction : unsigned char {
+    rising,  ///< The guard goes from negative to non-negative.
+    falling, ///< The guard goes from positive to non-positive.
+    both     ///< The guard changes sign, in either direction.
+};
+
+/// @brief What the integration does after an event.
+enum class event_action : unsigned char {
+    proceed, ///< Continue the integration, the event was only recorded.
+    reset,   ///< Continue the integration from the state (or the system) changed by the action.
+    stop     ///< Stop the integration at the event.
+};
+
+/// @brief An event: a guard function, the direction of its zero-crossings,
+/// and the action executed when it crosses zero.
+///
+/// @details The action receives the state at the crossing, which it can
+/// modify (e.g., to reverse the velocity of a bouncing ball), and the time of
+/// the crossing. Switching the mode of a hybrid system is done by changing
+/// the system itself, captured by reference, inside the action. In both cases
+/// the action returns `event_action::reset`, so that the stepper discards the
+/// data cached from the previous steps.
+///
+/// @tparam State The state vector type.
+/// @tparam Time The datatype used to hold time.
+template <class State, class Time>
+struct event {
+    /// @brief Type of value contained in the state vector.
+    using value_type = typename State::value_type;
+
+    /// @brief The guard function, called as `guard(x, t)`.
+    std::function<value_type(const State &, Time)> guard;
+    /// @brief The direction of the zero-crossings triggering the event.
+    event_direction direction{event_direction::both};
+    /// @brief The action, called as `action(x, t)` at the crossing.
+    std::function<event_action(State &, Time)> action;
+};
+
+namespace detail
+{
+
+/// @brief Checks if the guard of an event has crossed zero.
+/// @tparam T The type of the guard values.
+/// @param direction The direction of the crossing.
+/// @param previous The value of the guard before the crossing.
+/// @param value The current value of the guard.
+/// @return true if the guard has crossed zero, in the given direction.
+template <class T>
+constexpr auto has_crossed(event_direction direction, T previous, T value) -> bool
+{
+    const bool rising  = (previous < 0) && !(value < 0);
+    const bool falling = (previous > 0) && !(value > 0);
+    if (direction == event_direction::rising) {
+        return rising;
+    }
+    if (direction == event_direction::falling) {
+        return falling;
+    }
+    return rising || falling;
+}
+
+} // namespace detail
+
+/// @brief Integrates the system with an adaptive stepper, handling the events.
+///
+/// @details After each step, the guards are evaluated at `samples` equally
+/// spaced points of the interpolant of the step (see `integrate_times`), the
+/// last one being the new state, so that the crossings which return to the
+/// same sign within a long step (e.g., a ball bouncing up and falling back)
+/// are not missed. When some of them cross zero, the earliest crossing is
+/// bracketed between two samples, and localized by the Illinois variant of
+/// the regula falsi, evaluating the guard on the interpolant, so that the
+/// step is never repeated. Steppers without their own interpolant evaluate
+/// the system once more per step, for the cubic Hermite interpolant, unless
+/// `samples` is 1. The earliest crossing wins: the state is moved on
+/// the crossing (on the side where the guard has crossed zero), the observer
+/// is called, and the action of the event is executed. Hence, the step-size
+/// is not reduced around the discontinuities, which are handled exactly where
+/// they happen.
+///
+/// @tparam Stepper The type of the integration stepper.
+/// @tparam System The type of the system being integrated.
+/// @tparam Observer The type of the observer function.
+///
+/// @param stepper The stepper used to perform the integration.
+/// @param observer The observer function to call after each step, and at each event.
+/// @param system The system being integrated, which defines the equations of motion or dynamics.
+/// @param state The initial state of the system, which will be updated during integration.
+/// @param start_time The start time for the integration.
+/// @param end_time The final time for the integration.
+/// @param time_delta The initial step size for integration. This may be dynamically adjusted.
+/// @param events The events.
+/// @param samples The number of points of each step where the guards are evaluated.
+///
+/// @return The number of steps taken to complete the integration.
+template <class Stepper, class System, class Observer>
+auto integrate_events(
+    Stepper &stepper,
+    Observer &&observer,
+    System &&system,
+    typename Stepper::state_type &state,
+    typename Stepper::time_type start_time,
+    typename Stepper::time_type end_time,
+    typename Stepper::time_type time_delta,
+    const std::vector<event<typename Stepper::state_type, typename Stepper::time_type>> &events,
+    std::size_t samples = 4)
+{
+    using state_type = typename Stepper::state_type;
+    using time_type  = typename Stepper::time_type;
+    using value_type = typename state_type::value_type;
+
+    // Adjust the stepper's internal size, this also discards any data cached
+    // by the stepper during previous integrations.
+    stepper.adjust_size(state);
+    // Call the observer at the beginning.
+    std::forward<Observer>(observer)(state, start_time);
+
+    // The interpolant of the steps, and the interpolated state.
+    detail::dense_output<Stepper> dense(state);
+    state_type x(state);
+    // The values of the guards at the beginning, and at the end of the sampled part of the step.
+    std::vector<value_type> previous(events.size()), current(events.size());
+    samples = std::max<std::size_t>(samples, 1U);
+    for (std::size_t i = 0; i < events.size(); ++i) {
+        previous[i] = events[i].guard(state, start_time);
+    }
+
+    while (detail::less_with_sign(start_time, end_time, time_delta)) {
+        // Make sure we don't go beyond the end_time.
+        const bool last = !detail::less_with_sign(time_delta, end_time - start_time, time_delta);
+        if (last) {
+            time_delta = end_time - start_time;
+        }
+        const time_type step = time_delta;
+        // Perform one integration step.
+        dense.begin_step(state, start_time);
+        time_type last_time_delta = step;
+        {
+            NUMINT_TRACE_SCOPE("numint::do_step");
+            stepper.do_step(std::forward<System>(system), state, start_time, step);
+        }
+        if constexpr (Stepper::is_adaptive_stepper) {
+            last_time_delta = stepper.get_last_time_delta();
+            time_delta      = stepper.get_time_delta();
+        }
+        const bool landed    = last && !(std::abs(last_time_delta) < std::abs(step));
+        const time_type time = landed ? end_time : start_time + last_time_delta;
+        dense.end_step(time, last_time_delta);
+
+        // Look for the earliest crossing, sampling the guards along the step,
+        // and bracketing it between the times where the guard has not crossed
+        // zero yet (left) and where it has (right).
+        std::size_t triggered = events.size();
+        time_type event_time  = time;
+        time_type sample_begin = start_time;
+        for (std::size_t sample = 1; (sample <= samples) && (triggered == events.size()); ++sample) {
+            // The last sample is the end of the step.
+            const time_type sample_end =
+                (sample == samples)
+                    ? time
+                    : start_time + last_time_delta * static_cast<time_type>(sample) / static_cast<time_type>(samples);
+            if (sample < samples) {
+                dense.interpolate(stepper, std::forward<System>(system), state, sample_end, x);
+            }
+            const state_type &sampled = (sample < samples) ? x : state;
+            for (std::size_t i = 0; i < events.size(); ++i) {
+                current[i] = events[i].guard(sampled, sample_end);
+            }
+            event_time = sample_end;
+            for (std::size_t i = 0; i < events.size(); ++i) {
+                const auto &e = events[i];
+                if (!detail::has_crossed(e.direction, previous[i], current[i])) {
+                    continue;
+                }
+                time_type left = sample_begin, right = sample_end;
+                value_type g_left = previous[i], g_right = current[i];
+                // Discard the crossings happening after the earliest one found so far.
+                if ((triggered < events.size()) && detail::less_with_sign(event_time, right, time_delta)) {
+                    dense.interpolate(stepper, std::forward<System>(system), state, event_time, x);
+                    const value_type g = e.guard(x, event_time);
+                    if (!detail::has_crossed(e.direction, previous[i], g)) {
+                        continue;
+                    }
+                    right = event_time, g_right = g;
+                }
+                // Localize the crossing with the Illinois method.
+                const time_type tollerance =
+                    4 * std::numeric_limits<time_type>::epsilon() * std::max(time_type(1), std::abs(right));
+                for (int iteration = 0, side = 0; (iteration < 64) && (std::abs(right - left) > tollerance);
+                     ++iteration) {
+                    auto middle = static_cast<time_type>((left * g_right - right * g_left) / (g_right - g_left));
+                    // Fall back to bisection, if the secant leaves the bracket.
+                    if (!detail::less_with_sign(left, middle, time_delta) ||
+                        !detail::less_with_sign(middle, right, time_delta)) {
+                        middle = left + (right - left) / 2;
+                    }
+                    dense.interpolate(stepper, std::forward<System>(system), state, middle, x);
+                    const value_type g = e.guard(x, middle);
+                    if (detail::has_crossed(e.direction, previous[i], g)) {
+                        right = middle, g_right = g;
+                        if (side == 1) {
+                            g_left /= 2;
+                        }
+                        side = 1;
+                    } else {
+                        left = middle, g_left = g;
+                        if (side == -1) {
+                            g_right /= 2;
+                        }
+                        side = -1;
+                    }
+                }
+                triggered  = i;
+                event_time = right;
+            }
+            if (triggered == events.size()) {
+                // Keep the guards at the end of the sample.
+                std::swap(previous, current);
+                sample_begin = sample_end;
+            }
+        }
+
+        if (triggered == events.size()) {
+            // No event: advance time, the guards at the end of the step are kept.
+            start_time = time;
+            std::forward<Observer>(observer)(state, start_time);
+            continue;
+        }
+
+        // Move the state on the crossing.
+        if (detail::less_with_sign(event_time, time, time_delta)) {
+            dense.interpolate(stepper, std::forward<System>(system), state, event_time, x);
+            std::copy(x.begin(), x.end(), state.begin());
+        }
+        start_time = event_time;
+        std::forward<Observer>(observer)(state, start_time);
+        // Execute the action.
+        const event_action action = events[triggered].action(state, start_time);
+        if (action == event_action::stop) {
+            break;
+        }
+        if (action == event_action::reset) {
+            std::forward<Observer>(observer)(state, start_time);
+        }
+        // The step was cut short, or the state changed: discard what the stepper cached.
+        detail::reset_stepper(stepper, state);
+        dense.discard();
+        for (std::size_t i = 0; i < events.size(); ++i) {
+            previous[i] = events[i].guard(state, start_time);
+        }
+    }
+    // Return the number of steps it took to integrate.
+    return stepper.steps();
+}
+
+} // namespace numint
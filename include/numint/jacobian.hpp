@@ -0,0 +1,244 @@
+/// @file jacobian.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Support for systems providing their own Jacobian, used by the
+/// implicit steppers.
+///
+/// @details A system provides its Jacobian through a member function:
+///
+///     void jacobian(const State &x, Matrix &J, Time t);
+///
+/// which fills J(i, j) with the derivative of dxdt[i] with respect to x[j],
+/// `Matrix` being the matrix type of the linear solver used by the stepper
+/// (e.g., `dense_matrix`). Alternatively, an existing system can be paired
+/// with a separate Jacobian functor through `with_jacobian`, or its exact
+/// Jacobian can be computed by automatic differentiation through
+/// `with_dual_jacobian`. When the system does not provide a Jacobian, the
+/// linear solver builds it by finite differences.
+
+#pragma once
+
+#include "numint/detail/type_traits.hpp"
+#include "numint/detail/unroll.hpp"
+#include "numint/dual.hpp"
+#include "numint/linear/dense_matrix.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+namespace numint
+{
+
+namespace detail
+{
+
+/// @brief Checks if a system provides its own Jacobian.
+/// @tparam System The type of the system.
+/// @tparam State The state vector type.
+/// @tparam Matrix The matrix type receiving the Jacobian.
+/// @tparam Time The datatype used to hold time.
+template <class System, class State, class Matrix, class Time, class = void>
+struct has_jacobian : std::false_type {
+};
+
+/// @brief Checks if a system provides its own Jacobian.
+/// @tparam System The type of the system.
+/// @tparam State The state vector type.
+/// @tparam Matrix The matrix type receiving the Jacobian.
+/// @tparam Time The datatype used to hold time.
+template <class System, class State, class Matrix, class Time>
+struct has_jacobian<
+    System,
+    State,
+    Matrix,
+    Time,
+    std::void_t<decltype(std::declval<std::remove_reference_t<System> &>().jacobian(
+        std::declval<const State &>(), std::declval<Matrix &>(), std::declval<Time>()))>> : std::true_type {
+};
+
+/// @brief Helper variable template to check if a system provides its own Jacobian.
+template <class System, class State, class Matrix, class Time>
+constexpr inline bool has_jacobian_v = has_jacobian<System, State, Matrix, Time>::value;
+
+/// @brief The number of columns of the Jacobian computed by each evaluation of
+/// the system on dual numbers: all of them for small states whose size is
+/// known at compile time, 8 otherwise.
+/// @tparam State The state vector type.
+template <class State>
+constexpr inline std::size_t default_chunk_v =
+    ((static_size_v<State> > 0) && (static_size_v<State> <= 16)) ? static_size_v<State> : 8;
+
+/// @brief Computes the Jacobian of a system by forward-mode automatic differentiation.
+///
+/// @details The columns are computed in chunks: the variables of each chunk
+/// are seeded along their own direction, and a single evaluation of the
+/// system on dual numbers yields the derivatives of all the equations with
+/// respect to them, exactly.
+///
+/// @tparam Chunk The number of columns computed by each evaluation.
+/// @tparam System The type of the system, evaluated on states of dual numbers.
+/// @tparam State The state vector type.
+/// @tparam DualState The state vector type holding dual numbers.
+/// @tparam Time The datatype used to hold time.
+/// @tparam Store The type of the function receiving the elements.
+/// @param system The system.
+/// @param x The state where the Jacobian is evaluated.
+/// @param t The time where the Jacobian is evaluated.
+/// @param xd Support state, with the same size of x.
+/// @param dxdt_d Support state, with the same size of x.
+/// @param store Receives the elements, as `store(row, col, value)`.
+template <std::size_t Chunk, class System, class State, class DualState, class Time, class Store>
+void dual_jacobian(System &system, const State &x, Time t, DualState &xd, DualState &dxdt_d, Store &&store)
+{
+    using dual_type = typename DualState::value_type;
+
+    const std::size_t n = x.size();
+    for (std::size_t j0 = 0; j0 < n; j0 += Chunk) {
+        const std::size_t width = std::min(Chunk, n - j0);
+        // Seed the variables of the chunk.
+        for (std::size_t i = 0; i < n; ++i) {
+            xd[i] = ((i >= j0) && (i < j0 + width)) ? dual_type(x[i], i - j0) : dual_type(x[i]);
+        }
+        system(xd, dxdt_d, t);
+        for (std::size_t i = 0; i < n; ++i) {
+            for (std::size_t k = 0; k < width; ++k) {
+                store(i, j0 + k, dxdt_d[i].derivative(k));
+            }
+        }
+    }
+}
+
+} // namespace detail
+
+/// @brief Pairs a system with a functor computing its Jacobian.
+/// @tparam System The type of the system.
+/// @tparam Jacobian The type of the Jacobian functor.
+template <class System, class Jacobian>
+class system_with_jacobian
+{
+public:
+    /// @brief Creates the pair.
+    /// @param system The system.
+    /// @param jacobian The Jacobian functor, called as `jacobian(x, J, t)`.
+    template <class S, class J>
+    system_with_jacobian(S &&system, J &&jacobian)
+        : m_system(std::forward<S>(system))
+        , m_jacobian(std::forward<J>(jacobian))
+    {
+        // Nothing to do.
+    }
+
+    /// @brief Evaluates the system.
+    /// @param x The state.
+    /// @param dxdt The derivative of the state.
+    /// @param t The time.
+    template <class State, class Time>
+    void operator()(const State &x, State &dxdt, Time t)
+    {
+        m_system(x, dxdt, t);
+    }
+
+    /// @brief Evaluates the Jacobian of the system.
+    /// @param x The state.
+    /// @param J The matrix receiving the Jacobian.
+    /// @param t The time.
+    template <class State, class Matrix, class Time>
+    void jacobian(const State &x, Matrix &J, Time t)
+    {
+        m_jacobian(x, J, t);
+    }
+
+private:
+    /// The system.
+    System m_system;
+    /// The Jacobian functor.
+    Jacobian m_jacobian;
+};
+
+/// @brief Provides the exact Jacobian of a system, computed by forward-mode
+/// automatic differentiation (see `numint/dual.hpp`).
+///
+/// @details The system must be generic over the type of the values of the
+/// state (e.g., its `operator()` is templated on the state), so that it can be
+/// evaluated on states of dual numbers, and it must call the mathematical
+/// functions unqualified. Each evaluation of the Jacobian costs one evaluation
+/// of the system on dual numbers every `Chunk` variables. The support states
+/// are allocated by the first evaluation.
+///
+/// @tparam System The type of the system.
+/// @tparam State The state vector type.
+/// @tparam Chunk The number of columns computed by each evaluation of the system.
+template <class System, class State, std::size_t Chunk = detail::default_chunk_v<State>>
+class system_with_dual_jacobian
+{
+public:
+    /// @brief Type of value contained in the state vector.
+    using value_type = typename State::value_type;
+    /// @brief The state vector type holding the dual numbers.
+    using dual_state = detail::rebind_state_t<State, dual<value_type, Chunk>>;
+
+    /// @brief Wraps the system.
+    /// @param system The system.
+    template <class S>
+    explicit system_with_dual_jacobian(S &&system)
+        : m_system(std::forward<S>(system))
+    {
+        // Nothing to do.
+    }
+
+    /// @brief Evaluates the system.
+    /// @param x The state.
+    /// @param dxdt The derivative of the state.
+    /// @param t The time.
+    template <class Time>
+    void operator()(const State &x, State &dxdt, Time t)
+    {
+        m_system(x, dxdt, t);
+    }
+
+    /// @brief Evaluates the Jacobian of the system.
+    /// @param x The state.
+    /// @param J The matrix receiving the Jacobian.
+    /// @param t The time.
+    template <class Time>
+    void jacobian(const State &x, dense_matrix<value_type> &J, Time t)
+    {
+        if constexpr (detail::has_resize_v<dual_state>) {
+            m_x.resize(x.size());
+            m_dxdt.resize(x.size());
+        }
+        detail::dual_jacobian<Chunk>(
+            m_system, x, t, m_x, m_dxdt, [&J](std::size_t i, std::size_t j, value_type value) { J(i, j) = value; });
+    }
+
+private:
+    /// The system.
+    System m_system;
+    /// Support states, for the evaluation on dual numbers.
+    dual_state m_x{}, m_dxdt{};
+};
+
+/// @brief Provides the exact Jacobian of a system, computed by automatic differentiation.
+/// @details Objects passed as lvalues are kept by reference, temporaries are moved inside the wrapper.
+/// @tparam State The state vector type.
+/// @param system The system, generic over the type of the values of the state.
+/// @return The system, providing the Jacobian.
+template <class State, class System>
+auto with_dual_jacobian(System &&system)
+{
+    return system_with_dual_jacobian<System, State>(std::forward<System>(system));
+}
+
+/// @brief Pairs a system with a functor computing its Jacobian.
+/// @details Objects passed as lvalues are kept by reference, temporaries are moved inside the pair.
+/// @param system The system.
+/// @param jacobian The Jacobian functor, called as `jacobian(x, J, t)`.
+/// @return The system, providing the Jacobian.
+template <class System, class Jacobian>
+auto with_jacobian(System &&system, Jacobian &&jacobian)
+{
+    return system_with_jacobian<System, Jacobian>(std::forward<System>(system), std::forward<Jacobian>(jacobian));
+}
+
+} // namespace numint
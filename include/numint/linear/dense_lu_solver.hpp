@@ -0,0 +1,206 @@
+/// @file dense_lu_solver.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Linear solver for the implicit steppers, based on a dense Jacobian
+/// and on the LU factorization with partial pivoting.
+///
+/// @details The implicit steppers need to solve linear systems with matrix
+///     M = alpha * I - J
+/// where J is the Jacobian of the system, and alpha depends on the
+/// step-size. They rely on a linear solver exposing:
+///     - `adjust_size(reference)`, which allocates the internal storage;
+///     - `update_jacobian(system, x, dxdt, t)`, which evaluates J at (x, t),
+///       `dxdt` being the derivative of the system at (x, t);
+///     - `factorize(alpha)`, which factorizes M, and returns false if M is singular;
+///     - `solve(b)`, which replaces b with the solution of M * y = b.
+/// Other solvers can be used by the steppers, as long as they expose the same
+/// interface, e.g., `sparse_lu_solver` and `gmres_solver`, for large systems
+/// with sparse Jacobians.
+
+#pragma once
+
+#include "numint/detail/type_traits.hpp"
+#include "numint/jacobian.hpp"
+#include "numint/linear/dense_matrix.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace numint
+{
+
+/// @brief Dense linear solver, based on the LU factorization with partial pivoting.
+/// @tparam State The state vector type.
+template <class State>
+class dense_lu_solver
+{
+public:
+    /// @brief The state vector type.
+    using state_type  = State;
+    /// @brief Type of value contained in the state vector.
+    using value_type  = typename state_type::value_type;
+    /// @brief Type of matrix holding the Jacobian.
+    using matrix_type = dense_matrix<value_type>;
+
+    /// @brief Constructs a new solver.
+    dense_lu_solver() = default;
+
+    /// @brief Adjusts the size of the internal storage.
+    /// @param reference A reference state vector used for size adjustment.
+    void adjust_size(const state_type &reference)
+    {
+        const std::size_t n = reference.size();
+        m_jacobian.resize(n, n);
+        m_lu.resize(n, n);
+        m_pivots.resize(n);
+        if constexpr (detail::has_resize<state_type>::value) {
+            m_x.resize(n);
+            m_dxdt.resize(n);
+        }
+    }
+
+    /// @brief Evaluates the Jacobian of the system.
+    ///
+    /// @details If the system provides its own Jacobian it is used,
+    /// otherwise the Jacobian is approximated by forward differences, one
+    /// column at a time, which costs one evaluation of the system per
+    /// variable.
+    ///
+    /// @tparam System The type of the system.
+    /// @tparam Time The datatype used to hold time.
+    /// @param system The system.
+    /// @param x The state where the Jacobian is evaluated.
+    /// @param dxdt The derivative of the system at (x, t).
+    /// @param t The time where the Jacobian is evaluated.
+    template <class System, class Time>
+    void update_jacobian(System &&system, const state_type &x, const state_type &dxdt, Time t)
+    {
+        ++m_jacobian_evaluations;
+        if constexpr (detail::has_jacobian_v<System, state_type, matrix_type, Time>) {
+            (void)dxdt;
+            system.jacobian(x, m_jacobian, t);
+        } else {
+            const value_type sqrt_eps = std::sqrt(std::numeric_limits<value_type>::epsilon());
+            std::copy(x.begin(), x.end(), m_x.begin());
+            for (std::size_t j = 0; j < x.size(); ++j) {
+                // Perturb the j-th variable.
+                const value_type delta = sqrt_eps * std::max(value_type(1), std::abs(x[j]));
+                m_x[j]                 = x[j] + delta;
+                // Use the actual perturbation, which is exactly representable.
+                const value_type actual = m_x[j] - x[j];
+                system(m_x, m_dxdt, t);
+                for (std::size_t i = 0; i < x.size(); ++i) {
+                    m_jacobian(i, j) = (m_dxdt[i] - dxdt[i]) / actual;
+                }
+                m_x[j] = x[j];
+            }
+        }
+    }
+
+    /// @brief Factorizes the matrix (alpha * I - J).
+    /// @param alpha The coefficient of the identity matrix.
+    /// @return true if the factorization succeeded, false if the matrix is singular.
+    auto factorize(value_type alpha) -> bool
+    {
+        ++m_factorizations;
+        const std::size_t n = m_jacobian.rows();
+        // Build the matrix.
+        for (std::size_t i = 0; i < n; ++i) {
+            for (std::size_t j = 0; j < n; ++j) {
+                m_lu(i, j) = -m_jacobian(i, j);
+            }
+            m_lu(i, i) += alpha;
+        }
+        // Factorize it in place, with partial pivoting.
+        for (std::size_t k = 0; k < n; ++k) {
+            // Find the pivot.
+            std::size_t pivot = k;
+            for (std::size_t i = k + 1; i < n; ++i) {
+                if (std::abs(m_lu(i, k)) > std::abs(m_lu(pivot, k))) {
+                    pivot = i;
+                }
+            }
+            m_pivots[k] = pivot;
+            if (!(std::abs(m_lu(pivot, k)) > value_type(0)) || !std::isfinite(m_lu(pivot, k))) {
+                return false;
+            }
+            if (pivot != k) {
+                std::swap_ranges(m_lu.row(k), m_lu.row(k) + n, m_lu.row(pivot));
+            }
+            // Eliminate the column below the pivot.
+            const value_type inverse = value_type(1) / m_lu(k, k);
+            for (std::size_t i = k + 1; i < n; ++i) {
+                const value_type factor = (m_lu(i, k) *= inverse);
+                if (std::abs(factor) > value_type(0)) {
+                    value_type *row_i       = m_lu.row(i);
+                    const value_type *row_k = m_lu.row(k);
+                    for (std::size_t j = k + 1; j < n; ++j) {
+                        row_i[j] -= factor * row_k[j];
+                    }
+                }
+            }
+        }
+        return true;
+    }
+
+    /// @brief Solves the linear system, using the last factorization.
+    /// @param b The right-hand side, replaced with the solution.
+    void solve(state_type &b) const
+    {
+        const std::size_t n = m_lu.rows();
+        // Apply the permutation, and the forward substitution.
+        for (std::size_t k = 0; k < n; ++k) {
+            if (m_pivots[k] != k) {
+                std::swap(b[k], b[m_pivots[k]]);
+            }
+        }
+        for (std::size_t i = 1; i < n; ++i) {
+            const value_type *row_i = m_lu.row(i);
+            value_type sum          = b[i];
+            for (std::size_t j = 0; j < i; ++j) {
+                sum -= row_i[j] * b[j];
+            }
+            b[i] = sum;
+        }
+        // Apply the backward substitution.
+        for (std::size_t i = n; i-- > 0;) {
+            const value_type *row_i = m_lu.row(i);
+            value_type sum          = b[i];
+            for (std::size_t j = i + 1; j < n; ++j) {
+                sum -= row_i[j] * b[j];
+            }
+            b[i] = sum / row_i[i];
+        }
+    }
+
+    /// @brief Provides access to the last evaluated Jacobian.
+    /// @return a reference to the Jacobian.
+    auto jacobian() const noexcept -> const matrix_type & { return m_jacobian; }
+
+    /// @brief Returns the number of times the Jacobian was evaluated.
+    /// @return the number of Jacobian evaluations.
+    auto jacobian_evaluations() const noexcept { return m_jacobian_evaluations; }
+
+    /// @brief Returns the number of factorizations.
+    /// @return the number of factorizations.
+    auto factorizations() const noexcept { return m_factorizations; }
+
+private:
+    /// The Jacobian of the system.
+    matrix_type m_jacobian;
+    /// The LU factorization of (alpha * I - J).
+    matrix_type m_lu;
+    /// The row exchanged with each row, during the factorization.
+    std::vector<std::size_t> m_pivots;
+    /// Support vectors for the finite differences.
+    state_type m_x, m_dxdt;
+    /// The number of Jacobian evaluations.
+    unsigned long m_jacobian_evaluations{};
+    /// The number of factorizations.
+    unsigned long m_factorizations{};
+};
+
+} // namespace numint
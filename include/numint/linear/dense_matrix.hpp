@@ -0,0 +1,93 @@
+/// @file dense_matrix.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief A dense matrix, used to store Jacobians.
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+namespace numint
+{
+
+/// @brief A dense matrix, with the elements stored by rows.
+/// @tparam T The type of the elements.
+template <class T>
+class dense_matrix
+{
+public:
+    /// @brief Type of the elements.
+    using value_type = T;
+
+    /// @brief Constructs an empty matrix.
+    dense_matrix() = default;
+
+    /// @brief Constructs a matrix filled with zeros.
+    /// @param rows The number of rows.
+    /// @param cols The number of columns.
+    dense_matrix(std::size_t rows, std::size_t cols)
+        : m_rows(rows)
+        , m_cols(cols)
+        , m_data(rows * cols)
+    {
+        // Nothing to do.
+    }
+
+    /// @brief Resizes the matrix, the elements are set to zero.
+    /// @param rows The number of rows.
+    /// @param cols The number of columns.
+    void resize(std::size_t rows, std::size_t cols)
+    {
+        m_rows = rows;
+        m_cols = cols;
+        m_data.assign(rows * cols, value_type(0));
+    }
+
+    /// @brief Returns the number of rows.
+    /// @return the number of rows.
+    auto rows() const noexcept -> std::size_t { return m_rows; }
+
+    /// @brief Returns the number of columns.
+    /// @return the number of columns.
+    auto cols() const noexcept -> std::size_t { return m_cols; }
+
+    /// @brief Sets all the elements to the given value.
+    /// @param value The value.
+    void fill(value_type value) noexcept { std::fill(m_data.begin(), m_data.end(), value); }
+
+    /// @brief Accesses the element at the given position.
+    /// @param row The row of the element.
+    /// @param col The column of the element.
+    /// @return a reference to the element.
+    auto operator()(std::size_t row, std::size_t col) noexcept -> value_type & { return m_data[row * m_cols + col]; }
+
+    /// @brief Accesses the element at the given position.
+    /// @param row The row of the element.
+    /// @param col The column of the element.
+    /// @return a constant reference to the element.
+    auto operator()(std::size_t row, std::size_t col) const noexcept -> const value_type &
+    {
+        return m_data[row * m_cols + col];
+    }
+
+    /// @brief Returns a pointer to the first element of the given row.
+    /// @param row The row.
+    /// @return the pointer to the row.
+    auto row(std::size_t row) noexcept -> value_type * { return m_data.data() + row * m_cols; }
+
+    /// @brief Returns a pointer to the first element of the given row.
+    /// @param row The row.
+    /// @return the pointer to the row.
+    auto row(std::size_t row) const noexcept -> const value_type * { return m_data.data() + row * m_cols; }
+
+private:
+    /// The number of rows.
+    std::size_t m_rows{};
+    /// The number of columns.
+    std::size_t m_cols{};
+    /// The elements, stored by rows.
+    std::vector<value_type> m_data;
+};
+
+} // namespace numint
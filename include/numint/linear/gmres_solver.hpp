@@ -0,0 +1,307 @@
+/// @file gmres_solver.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Iterative linear solver for the implicit steppers, based on GMRES
+/// preconditioned by the incomplete LU factorization of a sparse Jacobian.
+///
+/// @details It exposes the same interface of `dense_lu_solver`, and it is
+/// given the pattern of the Jacobian like `sparse_lu_solver`. It suits the
+/// systems whose complete factorization would fill too much memory, since it
+/// only stores the Jacobian, its incomplete factors (with the same pattern),
+/// and the `restart + 1` vectors of the Krylov basis.
+
+#pragma once
+
+#include "numint/detail/sparse_jacobian.hpp"
+#include "numint/detail/sparse_lu.hpp"
+#include "numint/linear/sparse_matrix.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace numint
+{
+
+/// @brief Iterative linear solver, based on the restarted GMRES method, with ILU(0) preconditioning.
+///
+/// @details The linear systems are solved up to the relative residual set by
+/// `set_tollerance`; when the iterations are exhausted, the last approximation
+/// is returned, and the Newton iterations of the stepper absorb the residual
+/// (or trigger a fresh Jacobian when they stop converging).
+///
+/// @tparam State The state vector type.
+template <class State>
+class gmres_solver
+{
+public:
+    /// @brief The state vector type.
+    using state_type  = State;
+    /// @brief Type of value contained in the state vector.
+    using value_type  = typename state_type::value_type;
+    /// @brief Type of matrix holding the Jacobian.
+    using matrix_type = sparse_matrix<value_type>;
+
+    /// @brief Constructs a new solver.
+    gmres_solver() = default;
+
+    /// @brief Sets the pattern of the non-zero elements of the Jacobian.
+    /// @details It must be set before the integration, when missing (or of
+    /// the wrong size), `adjust_size` falls back to a dense pattern.
+    /// @param pattern The pattern.
+    void set_pattern(sparse_pattern pattern) { m_pattern = std::move(pattern); }
+
+    /// @brief Sets the residual at which the iterations stop, relative to the right-hand side.
+    /// @param tollerance The relative residual.
+    void set_tollerance(value_type tollerance) { m_tollerance = tollerance; }
+
+    /// @brief Sets the number of iterations after which the Krylov basis is discarded.
+    /// @param restart The size of the Krylov basis.
+    void set_restart(std::size_t restart) { m_restart = std::max<std::size_t>(restart, 1); }
+
+    /// @brief Sets the maximum number of iterations of each solution.
+    /// @param max_iterations The maximum number of iterations.
+    void set_max_iterations(std::size_t max_iterations) { m_max_iterations = max_iterations; }
+
+    /// @brief Adjusts the size of the internal storage.
+    /// @param reference A reference state vector used for size adjustment.
+    void adjust_size(const state_type &reference)
+    {
+        const std::size_t n = reference.size();
+        if (m_pattern.size() != n) {
+            m_pattern = sparse_pattern::dense(n);
+        }
+        m_jacobian.assign(m_pattern);
+        m_ilu.analyze(m_pattern, false);
+        m_basis.resize((m_restart + 1) * n);
+        m_hessenberg.resize((m_restart + 1) * m_restart);
+        m_cosines.resize(m_restart);
+        m_sines.resize(m_restart);
+        m_residuals.resize(m_restart + 1);
+        m_coefficients.resize(m_restart);
+        m_x.resize(n);
+        m_r.resize(n);
+        m_z.resize(n);
+    }
+
+    /// @brief Evaluates the Jacobian of the system.
+    /// @tparam System The type of the system.
+    /// @tparam Time The datatype used to hold time.
+    /// @param system The system.
+    /// @param x The state where the Jacobian is evaluated.
+    /// @param dxdt The derivative of the system at (x, t).
+    /// @param t The time where the Jacobian is evaluated.
+    template <class System, class Time>
+    void update_jacobian(System &&system, const state_type &x, const state_type &dxdt, Time t)
+    {
+        m_jacobian.update(std::forward<System>(system), x, dxdt, t);
+    }
+
+    /// @brief Prepares the solution of systems with matrix (alpha * I - J), by computing the preconditioner.
+    /// @param alpha The coefficient of the identity matrix.
+    /// @return true if the preconditioner was computed, false if one of its pivots vanished.
+    auto factorize(value_type alpha) -> bool
+    {
+        ++m_factorizations;
+        m_alpha = alpha;
+        return m_ilu.factorize(m_jacobian.jacobian(), alpha);
+    }
+
+    /// @brief Solves the linear system, by the preconditioned GMRES iterations.
+    /// @param b The right-hand side, replaced with the solution.
+    void solve(state_type &b)
+    {
+        const std::size_t n = m_x.size();
+        std::copy(b.begin(), b.end(), m_r.begin());
+        std::fill(m_x.begin(), m_x.end(), value_type(0));
+        const value_type target = m_tollerance * norm(m_r.data(), n);
+        m_converged             = !(target > 0);
+        for (std::size_t iterations = 0; !m_converged && (iterations < m_max_iterations);) {
+            // Start the Krylov basis from the residual.
+            const value_type beta = norm(m_r.data(), n);
+            if (beta <= target) {
+                m_converged = true;
+                break;
+            }
+            for (std::size_t i = 0; i < n; ++i) {
+                m_basis[i] = m_r[i] / beta;
+            }
+            std::fill(m_residuals.begin(), m_residuals.end(), value_type(0));
+            m_residuals[0] = beta;
+            // Extend the basis, until convergence or restart.
+            std::size_t j  = 0;
+            bool breakdown = false;
+            while ((j < m_restart) && (iterations < m_max_iterations)) {
+                value_type *w = this->basis(j + 1);
+                // w = M * P^-1 * v_j.
+                std::copy(this->basis(j), this->basis(j) + n, m_z.begin());
+                m_ilu.solve(m_z);
+                this->multiply(m_z.data(), w);
+                // Orthogonalize it against the basis (modified Gram-Schmidt).
+                for (std::size_t i = 0; i <= j; ++i) {
+                    const value_type *v = this->basis(i);
+                    value_type h        = 0;
+                    for (std::size_t k = 0; k < n; ++k) {
+                        h += w[k] * v[k];
+                    }
+                    for (std::size_t k = 0; k < n; ++k) {
+                        w[k] -= h * v[k];
+                    }
+                    this->hessenberg(i, j) = h;
+                }
+                const value_type h_next = norm(w, n);
+                if (h_next > 0) {
+                    for (std::size_t k = 0; k < n; ++k) {
+                        w[k] /= h_next;
+                    }
+                }
+                this->hessenberg(j + 1, j) = h_next;
+                // Apply the previous rotations to the new column, and compute the next one.
+                for (std::size_t i = 0; i < j; ++i) {
+                    const value_type upper     = this->hessenberg(i, j);
+                    const value_type lower     = this->hessenberg(i + 1, j);
+                    this->hessenberg(i, j)     = m_cosines[i] * upper + m_sines[i] * lower;
+                    this->hessenberg(i + 1, j) = m_cosines[i] * lower - m_sines[i] * upper;
+                }
+                const value_type denominator = std::hypot(this->hessenberg(j, j), h_next);
+                if (!(denominator > 0)) {
+                    breakdown = true;
+                    break;
+                }
+                m_cosines[j]               = this->hessenberg(j, j) / denominator;
+                m_sines[j]                 = h_next / denominator;
+                this->hessenberg(j, j)     = denominator;
+                this->hessenberg(j + 1, j) = 0;
+                m_residuals[j + 1]         = -m_sines[j] * m_residuals[j];
+                m_residuals[j]             = m_cosines[j] * m_residuals[j];
+                ++j;
+                ++iterations;
+                ++m_iterations;
+                if (std::abs(m_residuals[j]) <= target) {
+                    m_converged = true;
+                    break;
+                }
+            }
+            // Update the solution, x += P^-1 * V * y.
+            for (std::size_t i = j; i-- > 0;) {
+                value_type sum = m_residuals[i];
+                for (std::size_t l = i + 1; l < j; ++l) {
+                    sum -= this->hessenberg(i, l) * m_coefficients[l];
+                }
+                m_coefficients[i] = sum / this->hessenberg(i, i);
+            }
+            std::fill(m_z.begin(), m_z.end(), value_type(0));
+            for (std::size_t i = 0; i < j; ++i) {
+                const value_type *v = this->basis(i);
+                for (std::size_t k = 0; k < n; ++k) {
+                    m_z[k] += m_coefficients[i] * v[k];
+                }
+            }
+            m_ilu.solve(m_z);
+            for (std::size_t k = 0; k < n; ++k) {
+                m_x[k] += m_z[k];
+            }
+            if (m_converged || breakdown) {
+                break;
+            }
+            // Restart from the true residual, r = b - M * x.
+            this->multiply(m_x.data(), m_r.data());
+            for (std::size_t k = 0; k < n; ++k) {
+                m_r[k] = b[k] - m_r[k];
+            }
+        }
+        std::copy(m_x.begin(), m_x.end(), b.begin());
+    }
+
+    /// @brief Provides access to the last evaluated Jacobian.
+    /// @return a reference to the Jacobian.
+    auto jacobian() const noexcept -> const matrix_type & { return m_jacobian.jacobian(); }
+
+    /// @brief Returns whether the last solution reached the tolerance.
+    /// @return true if the last solution converged.
+    auto converged() const noexcept -> bool { return m_converged; }
+
+    /// @brief Returns the number of GMRES iterations executed so far.
+    /// @return the number of iterations.
+    auto iterations() const noexcept { return m_iterations; }
+
+    /// @brief Returns the number of times the Jacobian was evaluated.
+    /// @return the number of Jacobian evaluations.
+    auto jacobian_evaluations() const noexcept { return m_jacobian.evaluations(); }
+
+    /// @brief Returns the number of factorizations of the preconditioner.
+    /// @return the number of factorizations.
+    auto factorizations() const noexcept { return m_factorizations; }
+
+private:
+    /// @brief Computes the Euclidean norm of a vector.
+    /// @param v The vector.
+    /// @param n The number of elements.
+    /// @return the norm.
+    static auto norm(const value_type *v, std::size_t n) noexcept -> value_type
+    {
+        value_type sum = 0;
+        for (std::size_t k = 0; k < n; ++k) {
+            sum += v[k] * v[k];
+        }
+        return std::sqrt(sum);
+    }
+
+    /// @brief Computes y = (alpha * I - J) * x.
+    /// @param x The input vector.
+    /// @param y Receives the product.
+    void multiply(const value_type *x, value_type *y) const noexcept
+    {
+        m_jacobian.jacobian().multiply(x, y);
+        for (std::size_t k = 0; k < m_x.size(); ++k) {
+            y[k] = m_alpha * x[k] - y[k];
+        }
+    }
+
+    /// @brief Returns the given vector of the Krylov basis.
+    /// @param i The index of the vector.
+    /// @return the pointer to its first element.
+    auto basis(std::size_t i) noexcept -> value_type * { return m_basis.data() + i * m_x.size(); }
+
+    /// @brief Accesses the given element of the Hessenberg matrix.
+    /// @param i The row of the element.
+    /// @param j The column of the element.
+    /// @return a reference to the element.
+    auto hessenberg(std::size_t i, std::size_t j) noexcept -> value_type & { return m_hessenberg[i * m_restart + j]; }
+
+    /// The pattern of the Jacobian.
+    sparse_pattern m_pattern;
+    /// The Jacobian of the system.
+    detail::sparse_jacobian<state_type> m_jacobian;
+    /// The incomplete factorization of (alpha * I - J).
+    detail::sparse_lu<value_type> m_ilu;
+    /// The coefficient of the identity matrix.
+    value_type m_alpha{};
+    /// The relative residual at which the iterations stop.
+    value_type m_tollerance{1e-8};
+    /// The size of the Krylov basis.
+    std::size_t m_restart{30};
+    /// The maximum number of iterations of each solution.
+    std::size_t m_max_iterations{300};
+    /// The vectors of the Krylov basis, one after the other.
+    std::vector<value_type> m_basis;
+    /// The Hessenberg matrix, reduced to triangular by the rotations.
+    std::vector<value_type> m_hessenberg;
+    /// The Givens rotations.
+    std::vector<value_type> m_cosines, m_sines;
+    /// The rotated residuals.
+    std::vector<value_type> m_residuals;
+    /// The coefficients of the solution, in the Krylov basis.
+    std::vector<value_type> m_coefficients;
+    /// The solution, the residual, and a support vector.
+    std::vector<value_type> m_x, m_r, m_z;
+    /// Whether the last solution converged.
+    bool m_converged{};
+    /// The number of GMRES iterations.
+    unsigned long m_iterations{};
+    /// The number of factorizations.
+    unsigned long m_factorizations{};
+};
+
+} // namespace numint
@@ -0,0 +1,118 @@
+/// @file sparse_lu_solver.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Linear solver for the implicit steppers, based on a sparse Jacobian
+/// and on its sparse LU factorization.
+///
+/// @details It exposes the same interface of `dense_lu_solver`, and it is
+/// given the pattern of the Jacobian, before the integration, through the
+/// linear solver of the stepper:
+///
+///     numint::stepper_bdf<State, double, numint::sparse_lu_solver<State>> solver;
+///     solver.linear_solver().set_pattern(numint::sparse_pattern::block_diagonal(blocks, 4));
+
+#pragma once
+
+#include "numint/detail/sparse_jacobian.hpp"
+#include "numint/detail/sparse_lu.hpp"
+#include "numint/linear/sparse_matrix.hpp"
+
+#include <cstddef>
+#include <utility>
+
+namespace numint
+{
+
+/// @brief Sparse linear solver, based on the LU factorization of a sparse Jacobian.
+///
+/// @details The Jacobian is provided by the system, filling a
+/// `sparse_matrix` with the given pattern, or it is approximated by finite
+/// differences, perturbing together the columns which do not share any row.
+/// The factors are computed on the variables reordered to limit the fill-in,
+/// and without pivoting (see `detail::sparse_lu`).
+///
+/// @tparam State The state vector type.
+template <class State>
+class sparse_lu_solver
+{
+public:
+    /// @brief The state vector type.
+    using state_type  = State;
+    /// @brief Type of value contained in the state vector.
+    using value_type  = typename state_type::value_type;
+    /// @brief Type of matrix holding the Jacobian.
+    using matrix_type = sparse_matrix<value_type>;
+
+    /// @brief Constructs a new solver.
+    sparse_lu_solver() = default;
+
+    /// @brief Sets the pattern of the non-zero elements of the Jacobian.
+    /// @details It must be set before the integration, when missing (or of
+    /// the wrong size), `adjust_size` falls back to a dense pattern.
+    /// @param pattern The pattern.
+    void set_pattern(sparse_pattern pattern) { m_pattern = std::move(pattern); }
+
+    /// @brief Adjusts the size of the internal storage, and computes the pattern of the factors.
+    /// @param reference A reference state vector used for size adjustment.
+    void adjust_size(const state_type &reference)
+    {
+        if (m_pattern.size() != reference.size()) {
+            m_pattern = sparse_pattern::dense(reference.size());
+        }
+        m_jacobian.assign(m_pattern);
+        m_lu.analyze(m_pattern, true);
+    }
+
+    /// @brief Evaluates the Jacobian of the system.
+    /// @tparam System The type of the system.
+    /// @tparam Time The datatype used to hold time.
+    /// @param system The system.
+    /// @param x The state where the Jacobian is evaluated.
+    /// @param dxdt The derivative of the system at (x, t).
+    /// @param t The time where the Jacobian is evaluated.
+    template <class System, class Time>
+    void update_jacobian(System &&system, const state_type &x, const state_type &dxdt, Time t)
+    {
+        m_jacobian.update(std::forward<System>(system), x, dxdt, t);
+    }
+
+    /// @brief Factorizes the matrix (alpha * I - J).
+    /// @param alpha The coefficient of the identity matrix.
+    /// @return true if the factorization succeeded, false if the matrix is singular.
+    auto factorize(value_type alpha) -> bool
+    {
+        ++m_factorizations;
+        return m_lu.factorize(m_jacobian.jacobian(), alpha);
+    }
+
+    /// @brief Solves the linear system, using the last factorization.
+    /// @param b The right-hand side, replaced with the solution.
+    void solve(state_type &b) { m_lu.solve(b); }
+
+    /// @brief Provides access to the last evaluated Jacobian.
+    /// @return a reference to the Jacobian.
+    auto jacobian() const noexcept -> const matrix_type & { return m_jacobian.jacobian(); }
+
+    /// @brief Returns the number of elements of the factors, i.e., the elements of the Jacobian plus the fill-in.
+    /// @return the number of elements.
+    auto factor_non_zeros() const noexcept -> std::size_t { return m_lu.non_zeros(); }
+
+    /// @brief Returns the number of times the Jacobian was evaluated.
+    /// @return the number of Jacobian evaluations.
+    auto jacobian_evaluations() const noexcept { return m_jacobian.evaluations(); }
+
+    /// @brief Returns the number of factorizations.
+    /// @return the number of factorizations.
+    auto factorizations() const noexcept { return m_factorizations; }
+
+private:
+    /// The pattern of the Jacobian.
+    sparse_pattern m_pattern;
+    /// The Jacobian of the system.
+    detail::sparse_jacobian<state_type> m_jacobian;
+    /// The factorization of (alpha * I - J).
+    detail::sparse_lu<value_type> m_lu;
+    /// The number of factorizations.
+    unsigned long m_factorizations{};
+};
+
+} // namespace numint
@@ -0,0 +1,302 @@
+/// @file sparse_matrix.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief A sparse matrix in the compressed sparse row (CSR) format, used to
+/// store the Jacobians of large systems.
+///
+/// @details The structure of the matrix (i.e., the pattern of its non-zero
+/// elements) is fixed by a `sparse_pattern`, and shared by all the Jacobians
+/// of the same system, while the values change at each evaluation. The
+/// pattern always contains the diagonal, which is needed by the implicit
+/// steppers to form (alpha * I - J).
+
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace numint
+{
+
+/// @brief The pattern of the non-zero elements of a square sparse matrix, in the CSR format.
+class sparse_pattern
+{
+public:
+    /// @brief Constructs an empty pattern.
+    sparse_pattern() = default;
+
+    /// @brief Constructs the pattern from the positions of the non-zero elements.
+    /// @details Duplicated positions are merged, and the diagonal is always included.
+    /// @param size The number of rows (and columns).
+    /// @param entries The (row, column) positions of the non-zero elements.
+    sparse_pattern(std::size_t size, std::vector<std::pair<std::size_t, std::size_t>> entries)
+        : m_row_begin(size + 1)
+    {
+        for (std::size_t i = 0; i < size; ++i) {
+            entries.emplace_back(i, i);
+        }
+        std::sort(entries.begin(), entries.end());
+        entries.erase(std::unique(entries.begin(), entries.end()), entries.end());
+        m_columns.reserve(entries.size());
+        for (const auto &entry : entries) {
+            assert((entry.first < size) && (entry.second < size));
+            ++m_row_begin[entry.first + 1];
+            m_columns.push_back(entry.second);
+        }
+        for (std::size_t i = 0; i < size; ++i) {
+            m_row_begin[i + 1] += m_row_begin[i];
+        }
+    }
+
+    /// @brief Creates the pattern of a dense matrix.
+    /// @param size The number of rows (and columns).
+    /// @return the pattern.
+    static auto dense(std::size_t size) -> sparse_pattern { return banded(size, size, size); }
+
+    /// @brief Creates the pattern of a banded matrix.
+    /// @param size The number of rows (and columns).
+    /// @param lower The number of diagonals below the main one.
+    /// @param upper The number of diagonals above the main one.
+    /// @return the pattern.
+    static auto banded(std::size_t size, std::size_t lower, std::size_t upper) -> sparse_pattern
+    {
+        std::vector<std::pair<std::size_t, std::size_t>> entries;
+        for (std::size_t i = 0; i < size; ++i) {
+            const std::size_t first = (i > lower) ? (i - lower) : 0;
+            const std::size_t last  = std::min(size - 1, i + upper);
+            for (std::size_t j = first; j <= last; ++j) {
+                entries.emplace_back(i, j);
+            }
+        }
+        return sparse_pattern(size, std::move(entries));
+    }
+
+    /// @brief Creates the pattern of a block-diagonal matrix, with dense blocks.
+    /// @param blocks The number of blocks.
+    /// @param block_size The number of rows (and columns) of each block.
+    /// @return the pattern.
+    static auto block_diagonal(std::size_t blocks, std::size_t block_size) -> sparse_pattern
+    {
+        std::vector<std::pair<std::size_t, std::size_t>> entries;
+        entries.reserve(blocks * block_size * block_size);
+        for (std::size_t b = 0; b < blocks; ++b) {
+            add_block(entries, b * block_size, b * block_size, block_size, block_size);
+        }
+        return sparse_pattern(blocks * block_size, std::move(entries));
+    }
+
+    /// @brief Adds the positions of a dense block to a list of positions.
+    /// @details The coupling between the subsystems of a networked model can
+    /// be described by the off-diagonal blocks added to the diagonal ones.
+    /// @param entries The positions.
+    /// @param row The first row of the block.
+    /// @param col The first column of the block.
+    /// @param rows The number of rows of the block.
+    /// @param cols The number of columns of the block.
+    static void add_block(
+        std::vector<std::pair<std::size_t, std::size_t>> &entries,
+        std::size_t row,
+        std::size_t col,
+        std::size_t rows,
+        std::size_t cols)
+    {
+        for (std::size_t i = 0; i < rows; ++i) {
+            for (std::size_t j = 0; j < cols; ++j) {
+                entries.emplace_back(row + i, col + j);
+            }
+        }
+    }
+
+    /// @brief Returns the number of rows (and columns).
+    /// @return the size of the matrix.
+    auto size() const noexcept -> std::size_t { return m_row_begin.empty() ? 0 : m_row_begin.size() - 1; }
+
+    /// @brief Returns the number of non-zero elements.
+    /// @return the number of elements.
+    auto non_zeros() const noexcept -> std::size_t { return m_columns.size(); }
+
+    /// @brief Returns the index of the first element of each row, followed by the number of elements.
+    /// @return the offsets of the rows.
+    auto row_begin() const noexcept -> const std::vector<std::size_t> & { return m_row_begin; }
+
+    /// @brief Returns the column of each element, sorted inside each row.
+    /// @return the columns.
+    auto columns() const noexcept -> const std::vector<std::size_t> & { return m_columns; }
+
+    /// @brief Searches the element at the given position.
+    /// @param row The row of the element.
+    /// @param col The column of the element.
+    /// @return the index of the element, or `non_zeros()` if it is not part of the pattern.
+    auto find(std::size_t row, std::size_t col) const noexcept -> std::size_t
+    {
+        const auto first = m_columns.begin() + static_cast<std::ptrdiff_t>(m_row_begin[row]);
+        const auto last  = m_columns.begin() + static_cast<std::ptrdiff_t>(m_row_begin[row + 1]);
+        const auto it    = std::lower_bound(first, last, col);
+        return ((it != last) && (*it == col)) ? static_cast<std::size_t>(it - m_columns.begin()) : m_columns.size();
+    }
+
+    /// @brief Groups the columns which do not share any row.
+    ///
+    /// @details The columns of the same group can be perturbed together when
+    /// the Jacobian is approximated by finite differences, hence it costs one
+    /// evaluation of the system per group, instead of one per column. The
+    /// groups are assigned greedily, e.g., a banded matrix needs as many
+    /// groups as its bandwidth, and a block-diagonal one as many as the size
+    /// of its blocks.
+    ///
+    /// @return the group of each column, the groups being numbered from zero.
+    auto color_columns() const -> std::vector<std::size_t>
+    {
+        const std::size_t n = this->size();
+        // The rows of each column.
+        std::vector<std::size_t> col_begin(n + 1), rows(m_columns.size());
+        for (std::size_t col : m_columns) {
+            ++col_begin[col + 1];
+        }
+        for (std::size_t j = 0; j < n; ++j) {
+            col_begin[j + 1] += col_begin[j];
+        }
+        std::vector<std::size_t> next(col_begin.begin(), col_begin.end() - 1);
+        for (std::size_t i = 0; i < n; ++i) {
+            for (std::size_t k = m_row_begin[i]; k < m_row_begin[i + 1]; ++k) {
+                rows[next[m_columns[k]]++] = i;
+            }
+        }
+        // Assign to each column the first group not used by the columns sharing a row with it.
+        std::vector<std::size_t> colors(n, n), forbidden(n + 1, n);
+        for (std::size_t j = 0; j < n; ++j) {
+            for (std::size_t k = col_begin[j]; k < col_begin[j + 1]; ++k) {
+                const std::size_t i = rows[k];
+                for (std::size_t l = m_row_begin[i]; l < m_row_begin[i + 1]; ++l) {
+                    if (colors[m_columns[l]] < n) {
+                        forbidden[colors[m_columns[l]]] = j;
+                    }
+                }
+            }
+            std::size_t color = 0;
+            while (forbidden[color] == j) {
+                ++color;
+            }
+            colors[j] = color;
+        }
+        return colors;
+    }
+
+private:
+    /// The index of the first element of each row.
+    std::vector<std::size_t> m_row_begin;
+    /// The column of each element.
+    std::vector<std::size_t> m_columns;
+};
+
+/// @brief A square sparse matrix, with the elements stored by rows (CSR).
+/// @tparam T The type of the elements.
+template <class T>
+class sparse_matrix
+{
+public:
+    /// @brief Type of the elements.
+    using value_type = T;
+
+    /// @brief Constructs an empty matrix.
+    sparse_matrix() = default;
+
+    /// @brief Constructs a matrix filled with zeros.
+    /// @param pattern The pattern of the non-zero elements.
+    explicit sparse_matrix(sparse_pattern pattern)
+        : m_pattern(std::move(pattern))
+        , m_values(m_pattern.non_zeros())
+    {
+        // Nothing to do.
+    }
+
+    /// @brief Changes the pattern of the matrix, the elements are set to zero.
+    /// @param pattern The pattern of the non-zero elements.
+    void assign(sparse_pattern pattern)
+    {
+        m_pattern = std::move(pattern);
+        m_values.assign(m_pattern.non_zeros(), value_type(0));
+    }
+
+    /// @brief Returns the number of rows.
+    /// @return the number of rows.
+    auto rows() const noexcept -> std::size_t { return m_pattern.size(); }
+
+    /// @brief Returns the number of columns.
+    /// @return the number of columns.
+    auto cols() const noexcept -> std::size_t { return m_pattern.size(); }
+
+    /// @brief Returns the pattern of the non-zero elements.
+    /// @return the pattern.
+    auto pattern() const noexcept -> const sparse_pattern & { return m_pattern; }
+
+    /// @brief Provides access to the values of the non-zero elements, in the order of the pattern.
+    /// @return the values.
+    auto values() noexcept -> std::vector<value_type> & { return m_values; }
+
+    /// @brief Provides access to the values of the non-zero elements, in the order of the pattern.
+    /// @return the values.
+    auto values() const noexcept -> const std::vector<value_type> & { return m_values; }
+
+    /// @brief Sets all the non-zero elements to the given value.
+    /// @param value The value.
+    void fill(value_type value) noexcept { std::fill(m_values.begin(), m_values.end(), value); }
+
+    /// @brief Accesses the element at the given position, which must be part of the pattern.
+    /// @details The position is searched inside the row, writing the values
+    /// through `values()` avoids the search. Writes outside the pattern are
+    /// discarded (and asserted against, in debug builds).
+    /// @param row The row of the element.
+    /// @param col The column of the element.
+    /// @return a reference to the element.
+    auto operator()(std::size_t row, std::size_t col) noexcept -> value_type &
+    {
+        const std::size_t index = m_pattern.find(row, col);
+        assert(index < m_values.size());
+        if (index < m_values.size()) {
+            return m_values[index];
+        }
+        return (m_discarded = value_type(0));
+    }
+
+    /// @brief Accesses the element at the given position.
+    /// @param row The row of the element.
+    /// @param col The column of the element.
+    /// @return the element, zero if it is not part of the pattern.
+    auto operator()(std::size_t row, std::size_t col) const noexcept -> value_type
+    {
+        const std::size_t index = m_pattern.find(row, col);
+        return (index < m_values.size()) ? m_values[index] : value_type(0);
+    }
+
+    /// @brief Computes y = J * x.
+    /// @tparam VectorIn The type of the input vector.
+    /// @tparam VectorOut The type of the output vector.
+    /// @param x The input vector.
+    /// @param y Receives the product.
+    template <class VectorIn, class VectorOut>
+    void multiply(const VectorIn &x, VectorOut &y) const noexcept
+    {
+        const auto &row_begin = m_pattern.row_begin();
+        const auto &columns   = m_pattern.columns();
+        for (std::size_t i = 0; i < m_pattern.size(); ++i) {
+            value_type sum = 0;
+            for (std::size_t k = row_begin[i]; k < row_begin[i + 1]; ++k) {
+                sum += m_values[k] * x[columns[k]];
+            }
+            y[i] = sum;
+        }
+    }
+
+private:
+    /// The pattern of the non-zero elements.
+    sparse_pattern m_pattern;
+    /// The values of the non-zero elements.
+    std::vector<value_type> m_values;
+    /// Receives the writes outside the pattern.
+    value_type m_discarded{};
+};
+
+} // namespace numint
@@ -0,0 +1,126 @@
+/// @file multirate.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Support for multirate systems, whose slow and fast variables are
+/// advanced with different step-sizes by `stepper_multirate`.
+///
+/// @details The state of a multirate system holds both the slow and the fast
+/// variables, in any order. The system provides the two parts of its
+/// derivative through two member functions:
+///
+///     void slow(const State &x, State &dxdt, Time t); // derivative of the slow variables
+///     void fast(const State &x, State &dxdt, Time t); // derivative of the fast variables
+///
+/// each filling only the elements of dxdt of its own variables, while reading
+/// any variable of x (i.e., the coupling inputs). Alternatively, two functors
+/// can be paired into a system through `make_multirate`.
+
+#pragma once
+
+#include <type_traits>
+#include <utility>
+
+namespace numint
+{
+
+namespace detail
+{
+
+/// @brief Checks if a system provides the slow and the fast parts of its derivative.
+/// @tparam System The type of the system.
+/// @tparam State The state vector type.
+/// @tparam Time The datatype used to hold time.
+template <class System, class State, class Time, class = void>
+struct is_multirate : std::false_type {
+};
+
+/// @brief Checks if a system provides the slow and the fast parts of its derivative.
+/// @tparam System The type of the system.
+/// @tparam State The state vector type.
+/// @tparam Time The datatype used to hold time.
+template <class System, class State, class Time>
+struct is_multirate<
+    System,
+    State,
+    Time,
+    std::void_t<
+        decltype(std::declval<std::remove_reference_t<System> &>().slow(
+            std::declval<const State &>(), std::declval<State &>(), std::declval<Time>())),
+        decltype(std::declval<std::remove_reference_t<System> &>().fast(
+            std::declval<const State &>(), std::declval<State &>(), std::declval<Time>()))>> : std::true_type {
+};
+
+/// @brief Helper variable template to check if a system provides the slow and the fast parts of its derivative.
+template <class System, class State, class Time>
+constexpr inline bool is_multirate_v = is_multirate<System, State, Time>::value;
+
+} // namespace detail
+
+/// @brief A multirate system, made of the functors computing the derivatives
+/// of the slow and of the fast variables.
+/// @tparam Slow The type of the functor computing the derivative of the slow variables.
+/// @tparam Fast The type of the functor computing the derivative of the fast variables.
+template <class Slow, class Fast>
+class multirate_system
+{
+public:
+    /// @brief Creates the system.
+    /// @param slow The functor filling the slow elements of dxdt, called as `slow(x, dxdt, t)`.
+    /// @param fast The functor filling the fast elements of dxdt, called as `fast(x, dxdt, t)`.
+    template <class S, class F>
+    multirate_system(S &&slow, F &&fast)
+        : m_slow(std::forward<S>(slow))
+        , m_fast(std::forward<F>(fast))
+    {
+        // Nothing to do.
+    }
+
+    /// @brief Evaluates the whole system, so that it can be used by any stepper.
+    /// @param x The state.
+    /// @param dxdt The derivative of the state.
+    /// @param t The time.
+    template <class State, class Time>
+    void operator()(const State &x, State &dxdt, Time t)
+    {
+        m_slow(x, dxdt, t);
+        m_fast(x, dxdt, t);
+    }
+
+    /// @brief Evaluates the derivative of the slow variables.
+    /// @param x The state.
+    /// @param dxdt The derivative of the state, whose slow elements are filled.
+    /// @param t The time.
+    template <class State, class Time>
+    void slow(const State &x, State &dxdt, Time t)
+    {
+        m_slow(x, dxdt, t);
+    }
+
+    /// @brief Evaluates the derivative of the fast variables.
+    /// @param x The state.
+    /// @param dxdt The derivative of the state, whose fast elements are filled.
+    /// @param t The time.
+    template <class State, class Time>
+    void fast(const State &x, State &dxdt, Time t)
+    {
+        m_fast(x, dxdt, t);
+    }
+
+private:
+    /// The functor computing the derivative of the slow variables.
+    Slow m_slow;
+    /// The functor computing the derivative of the fast variables.
+    Fast m_fast;
+};
+
+/// @brief Pairs the functors computing the derivatives of the slow and of the fast variables.
+/// @details Objects passed as lvalues are kept by reference, temporaries are moved inside the pair.
+/// @param slow The functor filling the slow elements of dxdt, called as `slow(x, dxdt, t)`.
+/// @param fast The functor filling the fast elements of dxdt, called as `fast(x, dxdt, t)`.
+/// @return The multirate system.
+template <class Slow, class Fast>
+auto make_multirate(Slow &&slow, Fast &&fast)
+{
+    return multirate_system<Slow, Fast>(std::forward<Slow>(slow), std::forward<Fast>(fast));
+}
+
+} // namespace numint
@@ -0,0 +1,15 @@
+/// @file observer.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Includes all the stages of the pipelines of observers.
+
+#pragma once
+
+#include "numint/observer/observer_binary.hpp"
+#include "numint/observer/observer_callback.hpp"
+#include "numint/observer/observer_decimate.hpp"
+#include "numint/observer/observer_minmax.hpp"
+#include "numint/observer/observer_recorder.hpp"
+#include "numint/observer/observer_ring.hpp"
+#include "numint/observer/observer_sample.hpp"
+#include "numint/observer/observer_stage.hpp"
+#include "numint/observer/observer_trajectory.hpp"
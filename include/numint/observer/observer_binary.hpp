@@ -0,0 +1,349 @@
+/// @file observer_binary.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Stage of a pipeline of observers which streams the trajectory to a
+/// binary file, written by a background thread.
+///
+/// @details The file starts with a header:
+///
+///     offset  size  content
+///          0     8  the magic string "NUMINTTR"
+///          8     4  the version of the format (1)
+///         12     4  the number of variables
+///         16     1  the kind of the times ('f' floating-point, 'i' signed, 'u' unsigned integer)
+///         17     1  the size of the times, in bytes
+///         18     1  the kind of the values
+///         19     1  the size of the values, in bytes
+///
+/// followed by the blocks of samples, each one made of the number of samples
+/// (8 bytes), the column of the times, and one column for each variable. All
+/// the numbers are little-endian.
+
+#pragma once
+
+#include "numint/detail/spsc_ring.hpp"
+#include "numint/observer/observer_stage.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace numint
+{
+
+namespace detail
+{
+
+/// @brief Checks if the host is little-endian.
+/// @return true if the host is little-endian.
+inline auto is_little_endian() noexcept -> bool
+{
+    const std::uint16_t value = 1;
+    unsigned char first;
+    std::memcpy(&first, &value, 1);
+    return first == 1;
+}
+
+/// @brief Returns the character identifying the kind of an arithmetic type, in the binary trajectories.
+/// @tparam T The arithmetic type.
+/// @return 'f' for floating-point types, 'i' for signed integers, 'u' for unsigned integers.
+template <class T>
+constexpr auto binary_kind() noexcept -> char
+{
+    if constexpr (std::is_floating_point_v<T>) {
+        return 'f';
+    } else if constexpr (std::is_signed_v<T>) {
+        return 'i';
+    } else {
+        return 'u';
+    }
+}
+
+} // namespace detail
+
+/// @brief Streams the observations to a binary file, and passes them on.
+///
+/// @details The observations are stored by columns in a fixed set of blocks,
+/// allocated by the constructor. Once a block is full, it is handed to a
+/// background thread, which writes it to the file, while the integration goes
+/// on filling the next block. The blocks are exchanged through two
+/// single-producer/single-consumer rings (see `detail::spsc_ring`), one
+/// handing the full blocks to the writer, and one handing them back once they
+/// are written, hence without locks: the integration only waits for the
+/// writer when all the blocks are waiting to be written, i.e., when the disk
+/// is slower than the integration for longer than the blocks can absorb.
+///
+/// Errors of the writer are reported by `flush()` and `close()`, which throw a
+/// `std::runtime_error`.
+///
+/// @tparam State The state vector type.
+/// @tparam Time The datatype used to hold time.
+template <class State, class Time>
+class observer_binary : public observer_stage<observer_binary<State, Time>>
+{
+public:
+    /// @brief Type of value contained in the state vector.
+    using value_type = typename State::value_type;
+
+    static_assert(std::is_arithmetic_v<Time>, "The times must be arithmetic values.");
+    static_assert(std::is_arithmetic_v<value_type>, "The values must be arithmetic values.");
+
+    /// @brief Opens the file, writes the header, and starts the writer thread.
+    /// @param path The path of the file.
+    /// @param variables The number of variables of the state.
+    /// @param block_samples The number of samples of each block.
+    /// @param blocks The number of blocks, between 2 and `max_blocks`.
+    observer_binary(const std::string &path, std::size_t variables, std::size_t block_samples = 4096,
+                    std::size_t blocks = 8)
+        : m_variables(variables)
+        , m_block_samples(std::max(std::size_t(1), block_samples))
+        , m_blocks(std::min(std::max(std::size_t(2), blocks), max_blocks))
+        , m_times(m_blocks * m_block_samples)
+        , m_values(m_times.size() * m_variables)
+        , m_file(std::fopen(path.c_str(), "wb"))
+    {
+        if (m_file == nullptr) {
+            throw std::runtime_error("Cannot open the trajectory file `" + path + "`.");
+        }
+        // All the blocks are free, the integration is the only thread so far.
+        for (std::size_t block = 0; block < m_blocks; ++block) {
+            m_free.try_push(block);
+        }
+        // Write the header.
+        const char magic[8] = {'N', 'U', 'M', 'I', 'N', 'T', 'T', 'R'};
+        std::fwrite(magic, 1, sizeof(magic), m_file);
+        this->write_integer(std::uint32_t(1));
+        this->write_integer(static_cast<std::uint32_t>(m_variables));
+        const unsigned char types[4] = {
+            static_cast<unsigned char>(detail::binary_kind<Time>()), sizeof(Time),
+            static_cast<unsigned char>(detail::binary_kind<value_type>()), sizeof(value_type)};
+        std::fwrite(types, 1, sizeof(types), m_file);
+        if (m_failed.load(std::memory_order_relaxed) || (std::ferror(m_file) != 0)) {
+            std::fclose(m_file);
+            throw std::runtime_error("Cannot write the trajectory file `" + path + "`.");
+        }
+        m_writer = std::thread(&observer_binary::writer_loop, this);
+    }
+
+    /// @brief Destructor, it writes the pending samples, and closes the file.
+    ~observer_binary()
+    {
+        try {
+            this->close();
+        } catch (...) {
+            // Destructors cannot report errors.
+        }
+    }
+
+    /// @brief Copy constructor.
+    /// @param other The logger instance to copy from.
+    observer_binary(const observer_binary &other) = delete;
+
+    /// @brief Move constructor.
+    /// @param other The logger instance to move from.
+    observer_binary(observer_binary &&other) noexcept = delete;
+
+    /// @brief Copy assignment operator.
+    /// @param other The logger instance to copy from.
+    /// @return Reference to the logger instance.
+    auto operator=(const observer_binary &other) -> observer_binary & = delete;
+
+    /// @brief Move assignment operator.
+    /// @param other The logger instance to move from.
+    /// @return Reference to the logger instance.
+    auto operator=(observer_binary &&other) noexcept -> observer_binary & = delete;
+
+    /// @brief Stores the observation, and passes it on.
+    /// @details Once the file is closed, the observations are only passed on,
+    /// they are neither written nor counted by `samples()`.
+    /// @param x The state vector.
+    /// @param t The time.
+    /// @param next The rest of the pipeline.
+    template <class Next>
+    void observe(const State &x, const Time &t, Next &&next)
+    {
+        // The writer thread is stopped, no block would ever be released.
+        if (m_file == nullptr) {
+            next(x, t);
+            return;
+        }
+        if (m_offset == m_block_samples) {
+            this->publish();
+        }
+        if (m_offset == 0) {
+            // Wait for the writer to release a block.
+            while (!m_free.try_pop(m_block)) {
+                std::this_thread::yield();
+            }
+        }
+        const std::size_t first   = m_block * m_block_samples;
+        m_times[first + m_offset] = t;
+        value_type *values        = m_values.data() + first * m_variables + m_offset;
+        for (std::size_t j = 0; j < m_variables; ++j) {
+            values[j * m_block_samples] = x[j];
+        }
+        ++m_offset;
+        ++m_samples;
+        next(x, t);
+    }
+
+    /// @brief Returns the number of samples observed.
+    /// @return the number of samples.
+    auto samples() const noexcept { return m_samples; }
+
+    /// @brief Waits until all the samples observed so far are written to the file.
+    void flush()
+    {
+        if (m_file == nullptr) {
+            return;
+        }
+        this->publish();
+        // Wait for the writer to release all the blocks.
+        while (m_free.size() != m_blocks) {
+            std::this_thread::yield();
+        }
+        std::fflush(m_file);
+        if (m_failed.load(std::memory_order_acquire)) {
+            throw std::runtime_error("Cannot write the trajectory file.");
+        }
+    }
+
+    /// @brief Writes the pending samples, stops the writer thread, and closes the file.
+    void close()
+    {
+        if (m_file == nullptr) {
+            return;
+        }
+        this->publish();
+        m_stop.store(true, std::memory_order_release);
+        m_writer.join();
+        const bool failed = m_failed.load(std::memory_order_acquire) || (std::fclose(m_file) != 0);
+        m_file            = nullptr;
+        if (failed) {
+            throw std::runtime_error("Cannot write the trajectory file.");
+        }
+    }
+
+    /// @brief The maximum number of blocks.
+    static constexpr std::size_t max_blocks = 64;
+
+private:
+    /// @brief A block handed to the writer.
+    struct filled_block {
+        /// The index of the block.
+        std::size_t block;
+        /// The number of samples of the block.
+        std::size_t count;
+    };
+
+    /// @brief Hands the block being filled to the writer, if it holds some samples.
+    void publish()
+    {
+        if (m_offset > 0) {
+            // Never full, since it can hold all the blocks.
+            m_filled.try_push(filled_block{m_block, m_offset});
+            m_offset = 0;
+        }
+    }
+
+    /// @brief Writes the blocks handed by the integration, until stopped.
+    void writer_loop()
+    {
+        filled_block filled{};
+        while (true) {
+            // Read the flag before the ring, so that the last blocks are written, after the stop.
+            const bool stop = m_stop.load(std::memory_order_acquire);
+            if (!m_filled.try_pop(filled)) {
+                if (stop) {
+                    return;
+                }
+                std::this_thread::sleep_for(std::chrono::microseconds(100));
+                continue;
+            }
+            this->write_block(filled.block, filled.count);
+            m_free.try_push(filled.block);
+        }
+    }
+
+    /// @brief Writes a block to the file.
+    /// @param block The index of the block.
+    /// @param count The number of samples of the block.
+    void write_block(std::size_t block, std::size_t count)
+    {
+        const std::size_t first = block * m_block_samples;
+        this->write_integer(static_cast<std::uint64_t>(count));
+        this->write_column(m_times.data() + first, count);
+        for (std::size_t j = 0; j < m_variables; ++j) {
+            this->write_column(m_values.data() + (first * m_variables) + (j * m_block_samples), count);
+        }
+    }
+
+    /// @brief Writes an integer to the file.
+    /// @param value The integer.
+    template <class T>
+    void write_integer(T value)
+    {
+        this->write_column(&value, 1);
+    }
+
+    /// @brief Writes a column of values to the file, in little-endian order.
+    /// @param data The values.
+    /// @param count The number of values.
+    template <class T>
+    void write_column(const T *data, std::size_t count)
+    {
+        if (detail::is_little_endian()) {
+            if (std::fwrite(data, sizeof(T), count, m_file) != count) {
+                m_failed.store(true, std::memory_order_release);
+            }
+            return;
+        }
+        unsigned char bytes[sizeof(T)];
+        for (std::size_t i = 0; i < count; ++i) {
+            std::memcpy(bytes, data + i, sizeof(T));
+            std::reverse(bytes, bytes + sizeof(T));
+            if (std::fwrite(bytes, 1, sizeof(T), m_file) != sizeof(T)) {
+                m_failed.store(true, std::memory_order_release);
+            }
+        }
+    }
+
+    /// The number of variables.
+    std::size_t m_variables;
+    /// The number of samples of each block.
+    std::size_t m_block_samples;
+    /// The number of blocks.
+    std::size_t m_blocks;
+    /// The columns of the times of the blocks.
+    std::vector<Time> m_times;
+    /// The columns of the values of the blocks.
+    std::vector<value_type> m_values;
+    /// The file.
+    std::FILE *m_file;
+    /// The block being filled.
+    std::size_t m_block{};
+    /// The position inside the block being filled.
+    std::size_t m_offset{};
+    /// The number of samples observed.
+    std::size_t m_samples{};
+    /// The blocks handed to the writer.
+    detail::spsc_ring<filled_block, max_blocks> m_filled;
+    /// The blocks released by the writer, ready to be filled.
+    detail::spsc_ring<std::size_t, max_blocks> m_free;
+    /// Whether the writer must stop, once the blocks are written.
+    std::atomic<bool> m_stop{false};
+    /// Whether the writer has failed to write the file.
+    std::atomic<bool> m_failed{false};
+    /// The writer thread.
+    std::thread m_writer;
+};
+
+} // namespace numint
@@ -0,0 +1,103 @@
+/// @file observer_callback.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Stages of a pipeline of observers which forward the observations to callbacks.
+
+#pragma once
+
+#include "numint/observer/observer_stage.hpp"
+
+#include <tuple>
+#include <utility>
+
+namespace numint
+{
+
+/// @brief Calls a callback, and passes on all the observations.
+/// @tparam Callback The type of the callback (a reference, if kept by reference).
+template <class Callback>
+class observer_callback : public observer_stage<observer_callback<Callback>>
+{
+public:
+    /// @brief Creates the stage.
+    /// @param callback The callback, called as `callback(x, t)`.
+    template <class C>
+    explicit constexpr observer_callback(C &&callback)
+        : m_callback(std::forward<C>(callback))
+    {
+        // Nothing to do.
+    }
+
+    /// @brief Calls the callback, and passes on the observation.
+    /// @param x The state vector.
+    /// @param t The time.
+    /// @param next The rest of the pipeline.
+    template <class State, class Time, class Next>
+    constexpr void observe(const State &x, const Time &t, Next &&next)
+    {
+        m_callback(x, t);
+        next(x, t);
+    }
+
+private:
+    /// The callback.
+    Callback m_callback;
+};
+
+/// @brief Calls several observers (or stages) in order, and passes on all the observations.
+/// @tparam Observers The types of the observers (references, if kept by reference).
+template <class... Observers>
+class observer_fanout : public observer_stage<observer_fanout<Observers...>>
+{
+public:
+    /// @brief Creates the stage.
+    /// @param observers The observers, each called as `observer(x, t)`.
+    template <class... O>
+    explicit constexpr observer_fanout(O &&...observers)
+        : m_observers(std::forward<O>(observers)...)
+    {
+        // Nothing to do.
+    }
+
+    /// @brief Calls the observers, and passes on the observation.
+    /// @param x The state vector.
+    /// @param t The time.
+    /// @param next The rest of the pipeline.
+    template <class State, class Time, class Next>
+    constexpr void observe(const State &x, const Time &t, Next &&next)
+    {
+        std::apply([&x, &t](auto &...observer) { (observer(x, t), ...); }, m_observers);
+        next(x, t);
+    }
+
+    /// @brief Provides access to one of the observers.
+    /// @tparam Index The index of the observer.
+    /// @return a reference to the observer.
+    template <std::size_t Index>
+    constexpr auto get() -> auto & { return std::get<Index>(m_observers); }
+
+private:
+    /// The observers.
+    std::tuple<Observers...> m_observers;
+};
+
+/// @brief Wraps a callback in a stage of a pipeline of observers.
+/// @details Callbacks passed as lvalues are kept by reference, temporaries are moved inside the stage.
+/// @param callback The callback, called as `callback(x, t)`.
+/// @return the stage.
+template <class Callback>
+constexpr auto make_observer_callback(Callback &&callback)
+{
+    return observer_callback<Callback>(std::forward<Callback>(callback));
+}
+
+/// @brief Creates a stage calling several observers in order.
+/// @details Observers passed as lvalues are kept by reference, temporaries are moved inside the stage.
+/// @param observers The observers, each called as `observer(x, t)`.
+/// @return the stage.
+template <class... Observers>
+constexpr auto make_observer_fanout(Observers &&...observers)
+{
+    return observer_fanout<Observers...>(std::forward<Observers>(observers)...);
+}
+
+} // namespace numint
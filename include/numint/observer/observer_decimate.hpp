@@ -0,0 +1,41 @@
+/// @file observer_decimate.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Stage of a pipeline of observers which passes on one observation every N.
+
+#pragma once
+
+#include "numint/observer/observer_stage.hpp"
+
+#include <cstddef>
+
+namespace numint
+{
+
+/// @brief Passes on one observation every `Decimation`, starting from the last one of the first group.
+/// @tparam Decimation The decimation factor, with 0 and 1 all the observations are passed on.
+template <std::size_t Decimation>
+class observer_decimate : public observer_stage<observer_decimate<Decimation>>
+{
+public:
+    /// @brief Passes on the observation, if it is the one to keep.
+    /// @param x The state vector.
+    /// @param t The time.
+    /// @param next The rest of the pipeline.
+    template <class State, class Time, class Next>
+    constexpr void observe(const State &x, const Time &t, Next &&next)
+    {
+        if constexpr (Decimation > 1) {
+            if (++m_counter != Decimation) {
+                return;
+            }
+            m_counter = 0;
+        }
+        next(x, t);
+    }
+
+private:
+    /// The decimation counter.
+    std::size_t m_counter{};
+};
+
+} // namespace numint
@@ -0,0 +1,85 @@
+/// @file observer_minmax.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Stage of a pipeline of observers which tracks the range of each variable.
+
+#pragma once
+
+#include "numint/observer/observer_stage.hpp"
+
+#include <cstddef>
+
+namespace numint
+{
+
+/// @brief Tracks the minimum and the maximum of each variable, and passes on all the observations.
+///
+/// @details The extremes are copied from the first observation, which, for
+/// states that are resized (e.g., `std::vector`), is the only one allocating
+/// memory, unless a reference state is given to the constructor.
+///
+/// @tparam State The state vector type.
+template <class State>
+class observer_minmax : public observer_stage<observer_minmax<State>>
+{
+public:
+    /// @brief Type of value contained in the state vector.
+    using value_type = typename State::value_type;
+
+    /// @brief Creates the stage.
+    observer_minmax() = default;
+
+    /// @brief Creates the stage, allocating the extremes.
+    /// @param reference A reference state vector used for size adjustment.
+    explicit observer_minmax(const State &reference)
+        : m_min(reference)
+        , m_max(reference)
+    {
+        // Nothing to do.
+    }
+
+    /// @brief Updates the extremes, and passes on the observation.
+    /// @param x The state vector.
+    /// @param t The time.
+    /// @param next The rest of the pipeline.
+    template <class Time, class Next>
+    constexpr void observe(const State &x, const Time &t, Next &&next)
+    {
+        if (m_count++ == 0) {
+            m_min = x;
+            m_max = x;
+        } else {
+            for (std::size_t i = 0; i < x.size(); ++i) {
+                if (x[i] < m_min[i]) {
+                    m_min[i] = x[i];
+                }
+                if (m_max[i] < x[i]) {
+                    m_max[i] = x[i];
+                }
+            }
+        }
+        next(x, t);
+    }
+
+    /// @brief Returns the minimum of each variable.
+    /// @return the minimum of each variable.
+    constexpr auto min() const -> const State & { return m_min; }
+
+    /// @brief Returns the maximum of each variable.
+    /// @return the maximum of each variable.
+    constexpr auto max() const -> const State & { return m_max; }
+
+    /// @brief Returns the number of observations.
+    /// @return the number of observations.
+    constexpr auto count() const { return m_count; }
+
+    /// @brief Forgets the observations.
+    constexpr void reset() { m_count = 0; }
+
+private:
+    /// The extremes.
+    State m_min{}, m_max{};
+    /// The number of observations.
+    std::size_t m_count{};
+};
+
+} // namespace numint
@@ -0,0 +1,99 @@
+/// @file observer_recorder.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Stage of a pipeline of observers which records the last observations in a ring buffer.
+
+#pragma once
+
+#include "numint/observer/observer_stage.hpp"
+
+#include <cstddef>
+#include <vector>
+
+namespace numint
+{
+
+/// @brief Records the last `capacity` observations, and passes on all of them.
+///
+/// @details The buffer is allocated by the constructor. When a reference
+/// state is given, the slots are allocated as copies of it, so that no memory
+/// is allocated while recording, even for states that are resized (e.g.,
+/// `std::vector`). Once the buffer is full, the oldest observations are
+/// overwritten.
+///
+/// @tparam State The state vector type.
+/// @tparam Time The datatype used to hold time.
+template <class State, class Time>
+class observer_recorder : public observer_stage<observer_recorder<State, Time>>
+{
+public:
+    /// @brief Creates the recorder.
+    /// @param capacity The number of observations kept.
+    /// @param reference A reference state vector used to allocate the slots.
+    explicit observer_recorder(std::size_t capacity, const State &reference = State())
+        : m_times(capacity)
+        , m_states(capacity, reference)
+    {
+        // Nothing to do.
+    }
+
+    /// @brief Records the observation, and passes it on.
+    /// @param x The state vector.
+    /// @param t The time.
+    /// @param next The rest of the pipeline.
+    template <class Next>
+    constexpr void observe(const State &x, const Time &t, Next &&next)
+    {
+        if (!m_times.empty()) {
+            m_times[m_head]  = t;
+            m_states[m_head] = x;
+            m_head           = (m_head + 1 == m_times.size()) ? 0 : m_head + 1;
+            if (m_size < m_times.size()) {
+                ++m_size;
+            }
+        }
+        next(x, t);
+    }
+
+    /// @brief Returns the maximum number of observations kept.
+    /// @return the capacity of the buffer.
+    auto capacity() const noexcept { return m_times.size(); }
+
+    /// @brief Returns the number of observations kept.
+    /// @return the number of observations.
+    auto size() const noexcept { return m_size; }
+
+    /// @brief Returns the time of an observation.
+    /// @param index The index of the observation, 0 being the oldest one.
+    /// @return the time of the observation.
+    auto time(std::size_t index) const -> const Time & { return m_times[this->slot(index)]; }
+
+    /// @brief Returns the state of an observation.
+    /// @param index The index of the observation, 0 being the oldest one.
+    /// @return the state of the observation.
+    auto state(std::size_t index) const -> const State & { return m_states[this->slot(index)]; }
+
+    /// @brief Forgets the observations.
+    void clear() noexcept { m_head = m_size = 0; }
+
+private:
+    /// @brief Returns the slot of an observation.
+    /// @param index The index of the observation, 0 being the oldest one.
+    /// @return the slot holding the observation.
+    auto slot(std::size_t index) const noexcept -> std::size_t
+    {
+        const std::size_t oldest = (m_size < m_times.size()) ? 0 : m_head;
+        const std::size_t slot   = oldest + index;
+        return (slot < m_times.size()) ? slot : slot - m_times.size();
+    }
+
+    /// The times of the observations.
+    std::vector<Time> m_times;
+    /// The states of the observations.
+    std::vector<State> m_states;
+    /// The slot receiving the next observation.
+    std::size_t m_head{};
+    /// The number of observations kept.
+    std::size_t m_size{};
+};
+
+} // namespace numint
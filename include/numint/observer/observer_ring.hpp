@@ -0,0 +1,89 @@
+/// @file observer_ring.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Stage of a pipeline of observers which hands the observations to
+/// another thread, through a wait-free ring buffer.
+
+#pragma once
+
+#include "numint/detail/spsc_ring.hpp"
+#include "numint/observer/observer_stage.hpp"
+
+#include <cstddef>
+#include <memory>
+
+namespace numint
+{
+
+/// @brief An observation, as handed to the consumer of an `observer_ring`.
+/// @tparam State The state vector type.
+/// @tparam Time The datatype used to hold time.
+template <class State, class Time>
+struct trajectory_sample {
+    /// @brief The time.
+    Time time{};
+    /// @brief The state.
+    State state{};
+};
+
+/// @brief Pushes the observations in a ring buffer, read by another thread
+/// (e.g., for telemetry or visualization), and passes them on.
+///
+/// @details The integration thread is the only producer of the ring, and the
+/// thread reading the observations, through `ring().pop(...)`, is the only
+/// consumer: the two never share a lock, nor wait for each other. When the
+/// consumer falls behind and the ring is full, the observations are dropped,
+/// and counted, instead of stalling the integration.
+///
+/// The ring is allocated by the constructor. Resizable states (e.g.,
+/// `std::vector`) allocate their slot the first time it is written.
+///
+/// @tparam State The state vector type.
+/// @tparam Time The datatype used to hold time.
+/// @tparam N The capacity of the ring, a power of two.
+template <class State, class Time, std::size_t N = 1024>
+class observer_ring : public observer_stage<observer_ring<State, Time, N>>
+{
+public:
+    /// @brief The type of the ring.
+    using ring_type = detail::spsc_ring<trajectory_sample<State, Time>, N>;
+
+    /// @brief Creates the adapter, and its ring.
+    observer_ring()
+        : m_ring(std::make_unique<ring_type>())
+    {
+        // Nothing to do.
+    }
+
+    /// @brief Pushes the observation, and passes it on.
+    /// @param x The state vector.
+    /// @param t The time.
+    /// @param next The rest of the pipeline.
+    template <class Next>
+    void observe(const State &x, const Time &t, Next &&next)
+    {
+        m_sample.time  = t;
+        m_sample.state = x;
+        if (!m_ring->try_push(m_sample)) {
+            ++m_dropped;
+        }
+        next(x, t);
+    }
+
+    /// @brief Provides access to the ring, for the consumer.
+    /// @return a reference to the ring.
+    auto ring() noexcept -> ring_type & { return *m_ring; }
+
+    /// @brief Returns the number of observations dropped because the ring was full.
+    /// @return the number of dropped observations.
+    auto dropped() const noexcept { return m_dropped; }
+
+private:
+    /// The ring.
+    std::unique_ptr<ring_type> m_ring;
+    /// The observation being pushed, kept to reuse the memory of resizable states.
+    trajectory_sample<State, Time> m_sample;
+    /// The number of observations dropped.
+    std::size_t m_dropped{};
+};
+
+} // namespace numint
@@ -0,0 +1,82 @@
+/// @file observer_sample.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Stage of a pipeline of observers which passes on the observations on a time grid.
+
+#pragma once
+
+#include "numint/observer/observer_stage.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+
+namespace numint
+{
+
+/// @brief Passes on the first observation at, or after, each point of a regular time grid.
+///
+/// @details The observations are not interpolated: the observation passed on
+/// is the first one whose time is beyond the point of the grid. To observe the
+/// state exactly on the grid, use `integrate_times`.
+///
+/// @tparam Time The datatype used to hold time.
+template <class Time>
+class observer_sample : public observer_stage<observer_sample<Time>>
+{
+public:
+    /// @brief Creates the stage.
+    /// @param period The period of the grid, which must be positive.
+    /// @param start The first point of the grid.
+    /// @throws std::invalid_argument if the period is not positive.
+    explicit constexpr observer_sample(Time period, Time start = Time(0))
+        : m_start(start)
+        , m_period(period)
+        , m_next_time(start)
+    {
+        // A period which is not positive would never move past the observations.
+        if (!(period > Time(0))) {
+            throw std::invalid_argument("The period of observer_sample must be positive.");
+        }
+    }
+
+    /// @brief Passes on the observation, if it reaches the next point of the grid.
+    /// @param x The state vector.
+    /// @param t The time.
+    /// @param next The rest of the pipeline.
+    template <class State, class Next>
+    constexpr void observe(const State &x, const Time &t, Next &&next)
+    {
+        if (t < m_next_time) {
+            return;
+        }
+        // Move to the first point of the grid beyond the observation, computed
+        // from its index, so that the cost does not depend on the gap from the
+        // last observation, and the points of the grid do not accumulate the
+        // rounding errors. The index always grows, even when the period is
+        // below the resolution of the time, and it saturates when the grid
+        // has more points than the index can count.
+        using std::floor;
+        constexpr auto max_index = std::numeric_limits<std::uint64_t>::max();
+        const auto passed        = floor((t - m_start) / m_period);
+        const auto index         = (passed < static_cast<decltype(passed)>(max_index))
+                                     ? static_cast<std::uint64_t>(passed) + 1U
+                                     : max_index;
+        m_index                  = std::max(index, (m_index < max_index) ? m_index + 1U : max_index);
+        m_next_time              = m_start + static_cast<Time>(m_index) * m_period;
+        next(x, t);
+    }
+
+private:
+    /// The first point of the grid.
+    Time m_start;
+    /// The period of the grid.
+    Time m_period;
+    /// The next point of the grid.
+    Time m_next_time;
+    /// The index of the next point of the grid.
+    std::uint64_t m_index{};
+};
+
+} // namespace numint
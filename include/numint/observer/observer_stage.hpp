@@ -0,0 +1,124 @@
+/// @file observer_stage.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Base of the observers which can be composed at compile time, with `operator|`.
+///
+/// @details Each stage of a pipeline of observers implements:
+///
+///     template <class State, class Time, class Next>
+///     void observe(const State &x, const Time &t, Next &&next);
+///
+/// and calls `next(x, t)` to pass the observation down the pipeline. Filters
+/// (e.g., `observer_decimate`) call it only for some observations, while sinks
+/// (e.g., `observer_recorder`) consume the observation, and pass it on. Since
+/// the stages are combined by templates, and called without virtual functions,
+/// the compiler inlines the whole pipeline inside the integration loop, and a
+/// pipeline which does nothing costs nothing.
+///
+/// Stages passed as lvalues to `operator|` are kept by reference, so that
+/// their results can be retrieved after the integration, while temporaries are
+/// moved inside the pipeline.
+
+#pragma once
+
+#include <type_traits>
+#include <utility>
+
+namespace numint
+{
+
+/// @brief The end of a pipeline of observers, which ignores the observations.
+struct observer_null {
+    /// @brief Ignores the observation.
+    /// @param x The state vector.
+    /// @param t The time.
+    template <class State, class Time>
+    constexpr void operator()(const State &x, const Time &t) const noexcept
+    {
+        (void)x, (void)t;
+    }
+};
+
+/// @brief Base of the stages of a pipeline of observers (CRTP).
+/// @tparam Derived The stage deriving from this class.
+template <class Derived>
+class observer_stage
+{
+public:
+    /// @brief Performs the observation, as the last stage of the pipeline.
+    /// @param x The state vector.
+    /// @param t The time.
+    template <class State, class Time>
+    constexpr void operator()(const State &x, const Time &t)
+    {
+        static_cast<Derived &>(*this).observe(x, t, observer_null{});
+    }
+};
+
+/// @brief Two stages of a pipeline of observers, the observations passed on
+/// by the first one are received by the second one.
+/// @tparam First The type of the first stage (a reference, if kept by reference).
+/// @tparam Second The type of the second stage (a reference, if kept by reference).
+template <class First, class Second>
+class observer_pipe : public observer_stage<observer_pipe<First, Second>>
+{
+public:
+    /// @brief Creates the pipe.
+    /// @param first The first stage.
+    /// @param second The second stage.
+    template <class F, class S>
+    constexpr observer_pipe(F &&first, S &&second)
+        : m_first(std::forward<F>(first))
+        , m_second(std::forward<S>(second))
+    {
+        // Nothing to do.
+    }
+
+    /// @brief Passes the observation through both stages.
+    /// @param x The state vector.
+    /// @param t The time.
+    /// @param next The rest of the pipeline.
+    template <class State, class Time, class Next>
+    constexpr void observe(const State &x, const Time &t, Next &&next)
+    {
+        m_first.observe(x, t, [this, &next](const State &y, const Time &s) { m_second.observe(y, s, next); });
+    }
+
+    /// @brief Provides access to the first stage.
+    /// @return a reference to the first stage.
+    constexpr auto first() -> std::remove_reference_t<First> & { return m_first; }
+
+    /// @brief Provides access to the second stage.
+    /// @return a reference to the second stage.
+    constexpr auto second() -> std::remove_reference_t<Second> & { return m_second; }
+
+private:
+    /// The first stage.
+    First m_first;
+    /// The second stage.
+    Second m_second;
+};
+
+namespace detail
+{
+
+/// @brief Checks if a type is a stage of a pipeline of observers.
+/// @tparam T The type to check.
+template <class T>
+constexpr inline bool is_observer_stage_v = std::is_base_of_v<observer_stage<std::decay_t<T>>, std::decay_t<T>>;
+
+} // namespace detail
+
+/// @brief Chains two stages of a pipeline of observers.
+/// @param first The first stage.
+/// @param second The second stage, receiving the observations passed on by the first one.
+/// @return the pipeline.
+template <
+    class First,
+    class Second,
+    std::enable_if_t<detail::is_observer_stage_v<First> && detail::is_observer_stage_v<Second>, int> = 0>
+constexpr auto operator|(First &&first, Second &&second)
+{
+    return observer_pipe<First, Second>(std::forward<First>(first), std::forward<Second>(second));
+}
+
+} // namespace numint
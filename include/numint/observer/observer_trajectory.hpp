@@ -0,0 +1,276 @@
+/// @file observer_trajectory.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Stage of a pipeline of observers which records the whole trajectory
+/// by columns, spilling it to a memory-mapped file when it exceeds a memory budget.
+
+#pragma once
+
+#include "numint/detail/spill_file.hpp"
+#include "numint/observer/observer_stage.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace numint
+{
+
+/// @brief Records all the observations, by columns, and passes them on.
+///
+/// @details The observations are stored in chunks of `chunk_samples()`
+/// samples, and each chunk holds the column of the times, followed by one
+/// column for each variable, so that each column is contiguous inside its
+/// chunk. The size of the chunks does not depend on the expected number of
+/// samples, which only reserves the index of the chunks, so that a low
+/// estimate does not lead to small chunks. The chunks are allocated as the
+/// trajectory grows, within the memory budget, and they are kept by `clear()`
+/// for the next trajectory. Once the budget is exhausted, the following chunks
+/// are appended to a file, which is memory mapped one chunk at a time, so that
+/// the resident memory stays bounded regardless of the length of the
+/// trajectory. Samples in the file are mapped back, one chunk at a time, when
+/// they are read.
+///
+/// @tparam State The state vector type.
+/// @tparam Time The datatype used to hold time.
+template <class State, class Time>
+class observer_trajectory : public observer_stage<observer_trajectory<State, Time>>
+{
+public:
+    /// @brief Type of value contained in the state vector.
+    using value_type = typename State::value_type;
+
+    /// @brief The minimum number of samples of each chunk.
+    static constexpr std::size_t min_chunk_samples = 1024;
+
+    /// @brief Creates the recorder.
+    /// @param variables The number of variables of the state.
+    /// @param expected_samples The expected number of samples (e.g., from `compute_samples`).
+    /// @param memory_budget The memory available to the chunks, in bytes, 0 meaning no limit.
+    /// @param spill_path The file receiving the chunks beyond the budget, if
+    /// empty an anonymous temporary file is used.
+    /// @param chunk_samples The number of samples of each chunk, at least `min_chunk_samples`.
+    observer_trajectory(
+        std::size_t variables,
+        std::size_t expected_samples,
+        std::size_t memory_budget = 0,
+        std::string spill_path    = std::string(),
+        std::size_t chunk_samples = 65536)
+        : m_variables(variables)
+        , m_chunk_samples(std::max(min_chunk_samples, chunk_samples))
+        , m_values_offset(align(m_chunk_samples * sizeof(Time), alignof(value_type)))
+        , m_chunk_size(m_values_offset + m_chunk_samples * m_variables * sizeof(value_type))
+        , m_max_memory_chunks((memory_budget == 0) ? static_cast<std::size_t>(-1) : memory_budget / m_chunk_size)
+        , m_spill_path(std::move(spill_path))
+    {
+        // Reserve the index of the chunks for the expected samples.
+        const std::size_t chunks = (expected_samples + m_chunk_samples - 1) / m_chunk_samples;
+        m_memory.reserve(std::min(chunks, m_max_memory_chunks));
+    }
+
+    /// @brief Records the observation, and passes it on.
+    /// @param x The state vector.
+    /// @param t The time.
+    /// @param next The rest of the pipeline.
+    template <class Next>
+    void observe(const State &x, const Time &t, Next &&next)
+    {
+        if ((m_write == nullptr) || (m_offset == m_chunk_samples)) {
+            this->next_chunk();
+        }
+        times(m_write)[m_offset] = t;
+        value_type *values       = this->values(m_write) + m_offset;
+        for (std::size_t j = 0; j < m_variables; ++j) {
+            values[j * m_chunk_samples] = x[j];
+        }
+        ++m_offset;
+        ++m_size;
+        next(x, t);
+    }
+
+    /// @brief Returns the number of recorded samples.
+    /// @return the number of samples.
+    auto size() const noexcept { return m_size; }
+
+    /// @brief Returns the number of variables of each sample.
+    /// @return the number of variables.
+    auto variables() const noexcept { return m_variables; }
+
+    /// @brief Returns the number of samples of each chunk.
+    /// @return the number of samples of each chunk.
+    auto chunk_samples() const noexcept { return m_chunk_samples; }
+
+    /// @brief Returns the number of samples stored in the spill file.
+    /// @return the number of samples stored in the file.
+    auto spilled_samples() const noexcept
+    {
+        const std::size_t in_memory = m_memory.size() * m_chunk_samples;
+        return (m_size > in_memory) ? m_size - in_memory : 0;
+    }
+
+    /// @brief Returns the time of a sample.
+    /// @param index The index of the sample.
+    /// @return the time of the sample.
+    auto time(std::size_t index) const -> Time
+    {
+        return times(this->chunk(index / m_chunk_samples))[index % m_chunk_samples];
+    }
+
+    /// @brief Returns the value of a variable in a sample.
+    /// @param index The index of the sample.
+    /// @param variable The index of the variable.
+    /// @return the value of the variable.
+    auto value(std::size_t index, std::size_t variable) const -> value_type
+    {
+        return values(this->chunk(index / m_chunk_samples))[variable * m_chunk_samples + index % m_chunk_samples];
+    }
+
+    /// @brief Copies the times of all the samples.
+    /// @param out The output iterator receiving the times.
+    /// @return the output iterator past the last time.
+    template <class OutputIt>
+    auto copy_times(OutputIt out) const -> OutputIt
+    {
+        for (std::size_t c = 0, first = 0; first < m_size; ++c, first += m_chunk_samples) {
+            const Time *column = times(this->chunk(c));
+            out                = std::copy(column, column + std::min(m_chunk_samples, m_size - first), out);
+        }
+        return out;
+    }
+
+    /// @brief Copies the values of a variable in all the samples.
+    /// @param variable The index of the variable.
+    /// @param out The output iterator receiving the values.
+    /// @return the output iterator past the last value.
+    template <class OutputIt>
+    auto copy_column(std::size_t variable, OutputIt out) const -> OutputIt
+    {
+        for (std::size_t c = 0, first = 0; first < m_size; ++c, first += m_chunk_samples) {
+            const value_type *column = values(this->chunk(c)) + variable * m_chunk_samples;
+            out                      = std::copy(column, column + std::min(m_chunk_samples, m_size - first), out);
+        }
+        return out;
+    }
+
+    /// @brief Forgets the samples, keeping the chunks allocated in memory, and discarding the spill file.
+    void clear()
+    {
+        m_write = nullptr;
+        m_chunk = m_offset = m_size = 0;
+        m_spill_write.reset();
+        m_spill_read.reset();
+        m_spill.close();
+    }
+
+private:
+    /// @brief Rounds a size up to a multiple of an alignment.
+    /// @param size The size.
+    /// @param alignment The alignment.
+    /// @return the rounded size.
+    static constexpr auto align(std::size_t size, std::size_t alignment) -> std::size_t
+    {
+        return ((size + alignment - 1) / alignment) * alignment;
+    }
+
+    /// @brief Returns the column of the times of a chunk.
+    /// @param data The address of the chunk.
+    /// @return the column of the times.
+    static auto times(unsigned char *data) -> Time * { return reinterpret_cast<Time *>(data); }
+
+    /// @brief Returns the column of the times of a chunk.
+    /// @param data The address of the chunk.
+    /// @return the column of the times.
+    static auto times(const unsigned char *data) -> const Time * { return reinterpret_cast<const Time *>(data); }
+
+    /// @brief Returns the columns of the values of a chunk.
+    /// @param data The address of the chunk.
+    /// @return the columns of the values.
+    auto values(unsigned char *data) const -> value_type *
+    {
+        return reinterpret_cast<value_type *>(data + m_values_offset);
+    }
+
+    /// @brief Returns the columns of the values of a chunk.
+    /// @param data The address of the chunk.
+    /// @return the columns of the values.
+    auto values(const unsigned char *data) const -> const value_type *
+    {
+        return reinterpret_cast<const value_type *>(data + m_values_offset);
+    }
+
+    /// @brief Moves the writing to the next chunk, allocating it, or appending it to the spill file.
+    void next_chunk()
+    {
+        if (m_write != nullptr) {
+            ++m_chunk;
+        }
+        m_offset = 0;
+        if (m_chunk < m_memory.size()) {
+            m_write = m_memory[m_chunk].get();
+        } else if (!m_spill.is_open() && (m_memory.size() < m_max_memory_chunks)) {
+            m_memory.emplace_back(new unsigned char[m_chunk_size]);
+            m_write = m_memory.back().get();
+        } else {
+            if (!m_spill.is_open()) {
+                m_spill.open(m_spill_path, m_chunk_size);
+            }
+            // Replacing the mapping unmaps the previous chunk, which the system writes back to the file.
+            m_spill_read.reset();
+            m_spill_write = m_spill.append();
+            m_write       = m_spill_write.data();
+        }
+    }
+
+    /// @brief Returns the address of a chunk, mapping it if it is in the spill file.
+    /// @param index The index of the chunk.
+    /// @return the address of the chunk.
+    auto chunk(std::size_t index) const -> const unsigned char *
+    {
+        if (index < m_memory.size()) {
+            return m_memory[index].get();
+        }
+        if (index == m_chunk) {
+            return m_write;
+        }
+        if (index != m_spill_read_index || m_spill_read.data() == nullptr) {
+            m_spill_read       = m_spill.read(index - m_memory.size());
+            m_spill_read_index = index;
+        }
+        return m_spill_read.data();
+    }
+
+    /// The number of variables.
+    std::size_t m_variables;
+    /// The number of samples of each chunk.
+    std::size_t m_chunk_samples;
+    /// The offset of the columns of the values, inside a chunk.
+    std::size_t m_values_offset;
+    /// The size of a chunk, in bytes.
+    std::size_t m_chunk_size;
+    /// The maximum number of chunks kept in memory.
+    std::size_t m_max_memory_chunks;
+    /// The path of the spill file.
+    std::string m_spill_path;
+    /// The chunks kept in memory.
+    std::vector<std::unique_ptr<unsigned char[]>> m_memory;
+    /// The spill file.
+    detail::spill_file m_spill;
+    /// The mapping of the chunk of the spill file being written.
+    detail::spill_file::mapping m_spill_write;
+    /// The mapping of the last chunk of the spill file being read.
+    mutable detail::spill_file::mapping m_spill_read;
+    /// The index of the chunk of the spill file being read.
+    mutable std::size_t m_spill_read_index{};
+    /// The chunk being written.
+    unsigned char *m_write{};
+    /// The index of the chunk being written.
+    std::size_t m_chunk{};
+    /// The position inside the chunk being written.
+    std::size_t m_offset{};
+    /// The number of samples.
+    std::size_t m_size{};
+};
+
+} // namespace numint
@@ -0,0 +1,112 @@
+/// @file parallel.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Integration of many independent trajectories, spread over a pool of
+/// worker threads.
+
+#pragma once
+
+#include "numint/solver.hpp"
+#include "numint/thread_pool.hpp"
+
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+namespace numint
+{
+
+namespace detail
+{
+
+/// @brief A value owned by a single worker, aligned to its own cache line, so
+/// that workers updating their own values do not interfere with each other.
+/// @tparam T The type of the value.
+template <class T>
+struct alignas(64) worker_local {
+    /// @brief Constructs the value.
+    /// @param _value The initial value.
+    explicit worker_local(T &&_value)
+        : value(std::move(_value))
+    {
+        // Nothing to do.
+    }
+
+    /// The value.
+    T value;
+};
+
+} // namespace detail
+
+/// @brief Integrates many independent trajectories in parallel.
+///
+/// @details The trajectories are spread over the workers of the pool, which
+/// balance the load by work stealing, so that trajectories that take longer
+/// (e.g., with an adaptive stepper) do not leave the other workers idle.
+/// Each worker creates its own stepper once, through `make_stepper`, and
+/// reuses it for all the trajectories it integrates. Each trajectory has its
+/// own observer, created in order through `make_observer` before starting,
+/// and its own system, created through `make_system` by the worker that
+/// integrates it. The observers are returned in the order of the
+/// trajectories, hence the results do not depend on the scheduling.
+///
+/// Adaptive steppers are integrated with `integrate_adaptive`, all the other
+/// ones with `integrate_fixed`.
+///
+/// @tparam StepperFactory The type of the function creating a stepper, as `make_stepper()`.
+/// @tparam SystemFactory The type of the function creating a system, as `make_system(index)`.
+/// @tparam ObserverFactory The type of the function creating an observer, as `make_observer(index)`.
+/// @tparam State The state vector type.
+/// @tparam Time The datatype used to hold time.
+///
+/// @param pool The pool of worker threads.
+/// @param make_stepper Creates the stepper of a worker.
+/// @param make_system Creates the system of a trajectory, it must be safe to call concurrently.
+/// @param make_observer Creates the observer of a trajectory.
+/// @param states The initial states of the trajectories, which will be updated during integration.
+/// @param start_time The start time for the integration.
+/// @param end_time The final time for the integration.
+/// @param time_delta The (initial) step size for integration.
+/// @return The observers of the trajectories, in the same order of the states.
+template <class StepperFactory, class SystemFactory, class ObserverFactory, class State, class Time>
+auto integrate_parallel(
+    thread_pool &pool,
+    StepperFactory &&make_stepper,
+    SystemFactory &&make_system,
+    ObserverFactory &&make_observer,
+    std::vector<State> &states,
+    Time start_time,
+    Time end_time,
+    Time time_delta)
+{
+    using stepper_type  = std::decay_t<std::invoke_result_t<StepperFactory>>;
+    using observer_type = std::decay_t<std::invoke_result_t<ObserverFactory, std::size_t>>;
+
+    static_assert(
+        std::is_same_v<typename stepper_type::state_type, State>, "The stepper must operate on the given state type.");
+
+    // Create the steppers, one for each worker.
+    std::vector<detail::worker_local<stepper_type>> steppers;
+    steppers.reserve(pool.size());
+    for (std::size_t worker = 0; worker < pool.size(); ++worker) {
+        steppers.emplace_back(make_stepper());
+    }
+    // Create the observers, one for each trajectory.
+    std::vector<observer_type> observers;
+    observers.reserve(states.size());
+    for (std::size_t index = 0; index < states.size(); ++index) {
+        observers.emplace_back(make_observer(index));
+    }
+    // Integrate the trajectories.
+    pool.parallel_for(states.size(), [&](std::size_t worker, std::size_t index) {
+        stepper_type &stepper = steppers[worker].value;
+        auto system           = make_system(index);
+        if constexpr (stepper_type::is_adaptive_stepper) {
+            integrate_adaptive(stepper, observers[index], system, states[index], start_time, end_time, time_delta);
+        } else {
+            integrate_fixed(stepper, observers[index], system, states[index], start_time, end_time, time_delta);
+        }
+    });
+    return observers;
+}
+
+} // namespace numint
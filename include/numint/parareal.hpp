@@ -0,0 +1,217 @@
+/// @file parareal.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Parallel-in-time integration of a single trajectory, by the
+/// Parareal algorithm, spread over a pool of worker threads.
+
+#pragma once
+
+#include "numint/detail/it_algebra.hpp"
+#include "numint/parallel.hpp"
+#include "numint/solver.hpp"
+#include "numint/thread_pool.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+namespace numint
+{
+
+/// @brief The outcome of `integrate_parareal`.
+/// @tparam State The state vector type.
+/// @tparam Time The datatype used to hold time.
+template <class State, class Time>
+struct parareal_result {
+    /// @brief The states at the boundaries of the time slices, from the start time to the end time.
+    std::vector<State> boundaries;
+    /// @brief The times of the boundaries of the time slices.
+    std::vector<Time> times;
+    /// @brief The number of iterations executed, each one integrating the time slices in parallel.
+    std::size_t iterations{};
+    /// @brief The largest correction of a boundary, during the last iteration.
+    typename State::value_type error{};
+    /// @brief Whether the corrections fell below the tolerance.
+    bool converged{};
+};
+
+namespace detail
+{
+
+/// @brief Integrates a time slice with the given stepper.
+/// @details Adaptive steppers are integrated with `integrate_adaptive`, while
+/// fixed-step ones take the fewest equal steps, not larger than the given
+/// one, which end exactly on the end time, since `integrate_fixed` would step
+/// past it whenever the step does not divide the slice.
+/// @tparam Stepper The type of the stepper.
+/// @tparam System The type of the system.
+/// @tparam State The state vector type.
+/// @tparam Time The datatype used to hold time.
+/// @param stepper The stepper.
+/// @param system The system.
+/// @param state The state at the beginning of the slice, updated to the state at its end.
+/// @param start_time The start time of the slice.
+/// @param end_time The end time of the slice.
+/// @param time_delta The (initial) step size for integration.
+template <class Stepper, class System, class State, class Time>
+void propagate(Stepper &stepper, System &system, State &state, Time start_time, Time end_time, Time time_delta)
+{
+    if constexpr (Stepper::is_adaptive_stepper) {
+        integrate_adaptive(stepper, [](const State &, Time) {}, system, state, start_time, end_time, time_delta);
+    } else {
+        const Time span  = end_time - start_time;
+        const auto steps = static_cast<std::size_t>(std::max(std::ceil(span / time_delta - Time(1e-9)), Time(1)));
+        const Time delta = span / static_cast<Time>(steps);
+        stepper.adjust_size(state);
+        for (std::size_t step = 0; step < steps; ++step) {
+            stepper.do_step(system, state, start_time + delta * static_cast<Time>(step), delta);
+        }
+    }
+}
+
+} // namespace detail
+
+/// @brief Integrates a single trajectory, parallel in time, by the Parareal algorithm.
+///
+/// @details The time span is split into `slices` time slices. A cheap coarse
+/// stepper (e.g., `stepper_euler` with a large step-size) first sweeps all the
+/// slices in order, providing a guess for the states at their boundaries.
+/// Then, each iteration integrates all the slices in parallel, starting from
+/// their guessed boundaries, with the accurate fine stepper (e.g., an adaptive
+/// Runge-Kutta stepper), and sweeps the slices again with the coarse stepper,
+/// correcting each boundary as
+///
+///     U[n + 1] = G(U[n]) + F(U_old[n]) - G(U_old[n]),
+///
+/// where F and G are the fine and the coarse propagators. The iterations stop
+/// when the largest correction of a boundary, measured as in
+/// `ErrorFormula::Mixed`, falls below the tolerance. After k iterations, the
+/// first k slices are exactly the ones of the fine stepper, hence the
+/// algorithm converges within `slices` iterations, and it pays off when it
+/// converges in far fewer iterations than the number of workers.
+///
+/// Each worker creates its own fine stepper and system once, through
+/// `make_fine` and `make_system`, while the coarse sweeps run on the calling
+/// thread. Adaptive steppers are integrated with `integrate_adaptive`, while
+/// fixed-step ones take equal steps, not larger than the given ones, ending
+/// exactly on the boundaries of the slices.
+///
+/// @tparam CoarseFactory The type of the function creating the coarse stepper, as `make_coarse()`.
+/// @tparam FineFactory The type of the function creating a fine stepper, as `make_fine()`.
+/// @tparam SystemFactory The type of the function creating a system, as `make_system()`.
+/// @tparam State The state vector type.
+/// @tparam Time The datatype used to hold time.
+///
+/// @param pool The pool of worker threads.
+/// @param make_coarse Creates the coarse stepper.
+/// @param make_fine Creates the fine stepper of a worker.
+/// @param make_system Creates the system of a worker, and of the coarse sweeps.
+/// @param state The initial state of the system, updated to the state at the end time.
+/// @param start_time The start time for the integration.
+/// @param end_time The final time for the integration.
+/// @param slices The number of time slices.
+/// @param coarse_delta The step size of the coarse stepper.
+/// @param fine_delta The (initial) step size of the fine stepper.
+/// @param tollerance The tolerance on the corrections of the boundaries.
+/// @param max_iterations The maximum number of iterations, zero to allow as many as the slices.
+/// @return the boundaries of the time slices, and the outcome of the iterations.
+template <class CoarseFactory, class FineFactory, class SystemFactory, class State, class Time>
+auto integrate_parareal(
+    thread_pool &pool,
+    CoarseFactory &&make_coarse,
+    FineFactory &&make_fine,
+    SystemFactory &&make_system,
+    State &state,
+    Time start_time,
+    Time end_time,
+    std::size_t slices,
+    Time coarse_delta,
+    Time fine_delta,
+    typename State::value_type tollerance,
+    std::size_t max_iterations = 0) -> parareal_result<State, Time>
+{
+    using coarse_type = std::decay_t<std::invoke_result_t<CoarseFactory>>;
+    using fine_type   = std::decay_t<std::invoke_result_t<FineFactory>>;
+    using system_type = std::decay_t<std::invoke_result_t<SystemFactory>>;
+    using value_type  = typename State::value_type;
+
+    static_assert(
+        std::is_same_v<typename coarse_type::state_type, State> &&
+            std::is_same_v<typename fine_type::state_type, State>,
+        "The steppers must operate on the given state type.");
+
+    slices         = std::max<std::size_t>(slices, 1U);
+    max_iterations = (max_iterations == 0) ? slices : std::min(max_iterations, slices);
+
+    parareal_result<State, Time> result;
+    result.times.resize(slices + 1);
+    for (std::size_t n = 0; n <= slices; ++n) {
+        result.times[n] = start_time + (end_time - start_time) * static_cast<Time>(n) / static_cast<Time>(slices);
+    }
+    result.times[slices] = end_time;
+
+    // Create the fine steppers and the systems, one for each worker.
+    std::vector<detail::worker_local<fine_type>> fine;
+    std::vector<detail::worker_local<system_type>> systems;
+    fine.reserve(pool.size());
+    systems.reserve(pool.size());
+    for (std::size_t worker = 0; worker < pool.size(); ++worker) {
+        fine.emplace_back(make_fine());
+        systems.emplace_back(make_system());
+    }
+    coarse_type coarse = make_coarse();
+    system_type system = make_system();
+
+    // The boundaries (U), the coarse (G) and the fine (F) solutions at the end of each slice.
+    std::vector<State> &U = result.boundaries;
+    U.assign(slices + 1, state);
+    std::vector<State> G(slices, state), F(slices, state);
+    State x(state);
+
+    // Initial coarse sweep.
+    for (std::size_t n = 0; n < slices; ++n) {
+        G[n] = U[n];
+        detail::propagate(coarse, system, G[n], result.times[n], result.times[n + 1], coarse_delta);
+        U[n + 1] = G[n];
+    }
+
+    for (std::size_t k = 0; k < max_iterations; ++k) {
+        ++result.iterations;
+        // The first k slices have converged, integrate the other ones in parallel with the fine stepper.
+        pool.parallel_for(slices - k, [&](std::size_t worker, std::size_t index) {
+            const std::size_t n = k + index;
+            F[n]                = U[n];
+            detail::propagate(
+                fine[worker].value, systems[worker].value, F[n], result.times[n], result.times[n + 1], fine_delta);
+        });
+        // The boundary at the end of slice k is now exact.
+        result.error = detail::it_algebra::max_comb_diff<value_type>(
+            F[k].begin(), F[k].end(), U[k + 1].begin(), U[k + 1].end());
+        U[k + 1] = F[k];
+        // Correct the following boundaries, sweeping them with the coarse stepper.
+        for (std::size_t n = k + 1; n < slices; ++n) {
+            x = U[n];
+            detail::propagate(coarse, system, x, result.times[n], result.times[n + 1], coarse_delta);
+            for (std::size_t i = 0; i < x.size(); ++i) {
+                // U[n + 1] = G(U[n]) + F(U_old[n]) - G(U_old[n]).
+                const value_type corrected = x[i] + F[n][i] - G[n][i];
+                G[n][i]                    = x[i];
+                x[i]                       = corrected;
+            }
+            result.error = std::max(
+                result.error,
+                detail::it_algebra::max_comb_diff<value_type>(x.begin(), x.end(), U[n + 1].begin(), U[n + 1].end()));
+            U[n + 1] = x;
+        }
+        if (!(result.error > tollerance)) {
+            result.converged = true;
+            break;
+        }
+    }
+    result.converged = result.converged || (result.iterations == slices);
+    state            = U[slices];
+    return result;
+}
+
+} // namespace numint
@@ -0,0 +1,132 @@
+/// @file piecewise.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Integration over a schedule of segments, each one changing the
+/// inputs (or the parameters) of the system at its beginning.
+
+#pragma once
+
+#include "numint/detail/less_with_sign.hpp"
+#include "numint/detail/type_traits.hpp"
+#include "numint/trace.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace numint
+{
+
+/// @brief A segment of a piecewise integration: its duration, and the update
+/// of the inputs (or of the parameters) of the system at its beginning.
+///
+/// @details The update receives the state and the time at the beginning of
+/// the segment. It changes the system itself, captured by reference (e.g., the
+/// supplied voltage of a motor), and it can also change the state. Segments
+/// without an update only split the integration, without touching the stepper.
+///
+/// @tparam State The state vector type.
+/// @tparam Time The datatype used to hold time.
+template <class State, class Time>
+struct segment {
+    /// @brief The duration of the segment.
+    Time duration{};
+    /// @brief The update, called as `update(x, t)` at the beginning of the segment.
+    std::function<void(State &, Time)> update;
+};
+
+/// @brief Integrates the system over a schedule of segments, which change its
+/// inputs (or its parameters) at their beginning.
+///
+/// @details The whole schedule is a single integration: the stepper is sized
+/// once, and the observer is called at the beginning, after each step, and
+/// after an update which changed the state. The last step of each segment is
+/// shortened to end exactly on its boundary, where the update is applied, and
+/// the stepper only discards the data which the discontinuity makes invalid
+/// (e.g., the FSAL derivative, the history of the multistep steppers, or of
+/// the step-size controller, see `reset`), while it keeps its internal state
+/// vectors. The step-size chosen by an adaptive stepper carries over the
+/// boundaries, hence it does not ramp up again from `time_delta` at every
+/// segment.
+///
+/// @tparam Stepper The type of the integration stepper.
+/// @tparam System The type of the system being integrated.
+/// @tparam Observer The type of the observer function.
+///
+/// @param stepper The stepper used to perform the integration.
+/// @param observer The observer function to call after each step.
+/// @param system The system being integrated, which defines the equations of motion or dynamics.
+/// @param state The initial state of the system, which will be updated during integration.
+/// @param start_time The start time for the integration.
+/// @param segments The segments, in order.
+/// @param time_delta The (initial) step size for integration.
+///
+/// @return The number of steps taken to complete the integration.
+template <class Stepper, class System, class Observer>
+auto integrate_piecewise(
+    Stepper &stepper,
+    Observer &&observer,
+    System &&system,
+    typename Stepper::state_type &state,
+    typename Stepper::time_type start_time,
+    const std::vector<segment<typename Stepper::state_type, typename Stepper::time_type>> &segments,
+    typename Stepper::time_type time_delta)
+{
+    using state_type = typename Stepper::state_type;
+    using time_type  = typename Stepper::time_type;
+
+    // Adjust the stepper's internal size, this also discards any data cached
+    // by the stepper during previous integrations.
+    stepper.adjust_size(state);
+    // Call the observer at the beginning.
+    std::forward<Observer>(observer)(state, start_time);
+
+    // The state before the update, to find out if the update changed it.
+    state_type x(state);
+    for (std::size_t i = 0; i < segments.size(); ++i) {
+        const auto &s            = segments[i];
+        const time_type end_time = start_time + s.duration;
+        if (s.update) {
+            std::copy(state.begin(), state.end(), x.begin());
+            s.update(state, start_time);
+            if (!std::equal(state.begin(), state.end(), x.begin())) {
+                std::forward<Observer>(observer)(state, start_time);
+            }
+            // The stepper was just sized for the first segment.
+            if (i > 0) {
+                detail::reset_stepper(stepper, state);
+            }
+        }
+        while (detail::less_with_sign(start_time, end_time, time_delta)) {
+            // Make sure we don't go beyond the end of the segment.
+            const bool last      = !detail::less_with_sign(time_delta, end_time - start_time, time_delta);
+            const time_type step = last ? (end_time - start_time) : time_delta;
+            // Perform one integration step.
+            {
+                NUMINT_TRACE_SCOPE("numint::do_step");
+                stepper.do_step(std::forward<System>(system), state, start_time, step);
+            }
+            time_type last_time_delta = step;
+            if constexpr (Stepper::is_adaptive_stepper) {
+                last_time_delta = stepper.get_last_time_delta();
+                // Keep the step-size chosen by the stepper, unless the last step was shortened.
+                if (!last || (std::abs(stepper.get_time_delta()) < std::abs(time_delta))) {
+                    time_delta = stepper.get_time_delta();
+                }
+            }
+            // Advance time, landing exactly on the boundary.
+            start_time = (last && !(std::abs(last_time_delta) < std::abs(step))) ? end_time
+                                                                                 : start_time + last_time_delta;
+            // Call the observer.
+            {
+                NUMINT_TRACE_SCOPE("numint::observer");
+                std::forward<Observer>(observer)(state, start_time);
+            }
+        }
+    }
+    // Return the number of steps it took to integrate.
+    return stepper.steps();
+}
+
+} // namespace numint
@@ -0,0 +1,210 @@
+/// @file realtime.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Real-time stepping, with a bounded amount of work per call, for the
+/// simulations running inside a control loop (e.g., hardware-in-the-loop).
+
+#pragma once
+
+#include "numint/detail/less_with_sign.hpp"
+#include "numint/trace.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <utility>
+
+namespace numint
+{
+
+/// @brief The outcome of a call to `realtime_stepper::step_until`.
+/// @tparam Time The datatype used to hold time.
+template <class Time>
+struct realtime_status {
+    /// @brief The number of steps executed by the call.
+    std::size_t steps{};
+    /// @brief The time reached by the integration.
+    Time time{};
+    /// @brief The time left between the time reached and the deadline, which is zero if the deadline was met.
+    Time lag{};
+    /// @brief Whether the budget ran out before reaching the deadline.
+    bool overrun{};
+};
+
+/// @brief Advances a fixed-step stepper towards a deadline, within a bounded
+/// budget of steps (and, optionally, of wall-clock time) per call.
+///
+/// @details Each call to `step_until(system, x, deadline)` executes at most
+/// `max_steps` steps of size `time_delta`, the last one adjusted to land
+/// exactly on the deadline. Hence, the number of evaluations of the system per
+/// call is bounded by `max_steps` times the number of stages of the explicit
+/// stepper. The adaptive steppers are rejected, since their retries are not
+/// bounded by the step-size alone. When the budget runs out before the
+/// deadline, the call reports the overrun and the lag, and the next calls
+/// catch up, again within their own budget.
+///
+/// The stepper is sized by `start`, hence `step_until` neither allocates
+/// memory, nor throws, as long as the system does not. When a wall-clock
+/// budget is set, the call also stops before the step that, according to the
+/// slowest recent step, would exceed it. The estimate of the slowest step
+/// never exceeds the budget, and it moves by 1/8 towards each faster step,
+/// so that a single hiccup (e.g., a page fault) does not hold back the later
+/// calls, which always execute at least one step.
+///
+///     realtime_stepper<stepper_rk4<State, double>> solver(1e-5, 16);
+///     solver.start(x, 0.);
+///     // Inside the 10 kHz loop:
+///     const auto status = solver.step_until(system, x, tick * 1e-4);
+///
+/// @tparam Stepper The fixed-step stepper we rely upon.
+/// @tparam Clock The clock measuring the wall-clock budget.
+template <class Stepper, class Clock = std::chrono::steady_clock>
+class realtime_stepper
+{
+public:
+    /// @brief Type of the stepper we rely upon.
+    using stepper_type = Stepper;
+    /// @brief Type used to keep track of time.
+    using time_type    = typename Stepper::time_type;
+    /// @brief The state vector.
+    using state_type   = typename Stepper::state_type;
+    /// @brief The clock measuring the wall-clock budget.
+    using clock        = Clock;
+    /// @brief The type of the wall-clock durations.
+    using duration     = std::chrono::nanoseconds;
+    /// @brief The outcome of a call to `step_until`.
+    using status_type  = realtime_status<time_type>;
+
+    static_assert(!Stepper::is_adaptive_stepper, "The real-time stepping requires a fixed-step stepper.");
+
+    /// @brief Creates a new real-time stepper.
+    /// @param time_delta The step-size.
+    /// @param max_steps The maximum number of steps executed by each call to `step_until`.
+    realtime_stepper(time_type time_delta, std::size_t max_steps)
+        : m_stepper()
+        , m_time()
+        , m_time_delta(time_delta)
+        , m_max_steps(max_steps)
+        , m_budget(duration::zero())
+        , m_worst_step(duration::zero())
+        , m_overruns()
+    {
+        // Nothing to do.
+    }
+
+    /// @brief Destructor.
+    ~realtime_stepper() = default;
+
+    /// @brief Copy constructor.
+    /// @param other The logger instance to copy from.
+    realtime_stepper(const realtime_stepper &other) = delete;
+
+    /// @brief Move constructor.
+    /// @param other The logger instance to move from.
+    realtime_stepper(realtime_stepper &&other) noexcept = default;
+
+    /// @brief Copy assignment operator.
+    /// @param other The logger instance to copy from.
+    /// @return Reference to the logger instance.
+    auto operator=(const realtime_stepper &other) -> realtime_stepper & = delete;
+
+    /// @brief Move assignment operator.
+    /// @param other The logger instance to move from.
+    /// @return Reference to the logger instance.
+    auto operator=(realtime_stepper &&other) noexcept -> realtime_stepper & = default;
+
+    /// @brief Provides access to the stepper we rely upon.
+    /// @return A reference to the stepper.
+    constexpr auto stepper() -> stepper_type & { return m_stepper; }
+
+    /// @brief Sets the wall-clock budget of each call to `step_until`, zero disables it.
+    /// @param budget The wall-clock budget.
+    void set_budget(duration budget) noexcept { m_budget = budget; }
+
+    /// @brief Returns the time reached by the integration.
+    /// @return the current time.
+    constexpr auto time() const noexcept -> time_type { return m_time; }
+
+    /// @brief Returns the number of calls to `step_until` which did not reach their deadline.
+    /// @return the number of overruns.
+    constexpr auto overruns() const noexcept -> std::size_t { return m_overruns; }
+
+    /// @brief Returns the estimate of the slowest recent step, only when the wall-clock budget is set.
+    /// @return the wall-clock duration of the slowest recent step.
+    constexpr auto worst_step() const noexcept -> duration { return m_worst_step; }
+
+    /// @brief Prepares the integration, sizing the stepper for the state.
+    /// @details It is the only function allocating memory, and it must be called before the control loop.
+    /// @param x The initial state.
+    /// @param t The initial time.
+    void start(const state_type &x, time_type t)
+    {
+        m_stepper.adjust_size(x);
+        m_time       = t;
+        m_worst_step = duration::zero();
+        m_overruns   = 0;
+    }
+
+    /// @brief Advances the integration towards the deadline, within the budget.
+    /// @tparam System The type of the system being integrated.
+    /// @param system The system being integrated.
+    /// @param x The state, updated by the integration.
+    /// @param deadline The time which the integration should reach.
+    /// @return the outcome of the call.
+    template <class System>
+    auto step_until(System &&system, state_type &x, time_type deadline) noexcept -> status_type
+    {
+        status_type status;
+        const bool timed                     = m_budget > duration::zero();
+        const typename clock::time_point now = timed ? clock::now() : typename clock::time_point();
+        typename clock::time_point last      = now;
+        while ((status.steps < m_max_steps) && detail::less_with_sign(m_time, deadline, m_time_delta)) {
+            // Skip the step which would exceed the wall-clock budget, but
+            // always execute at least one step, so that the call progresses.
+            if (timed && (status.steps > 0) && ((last - now) + m_worst_step > m_budget)) {
+                break;
+            }
+            // Make sure we don't go beyond the deadline, and stretch the last
+            // step a little, rather than adding a tiny one, when the rounding
+            // of the time leaves the deadline just past a whole step.
+            const time_type left = deadline - m_time;
+            const bool last_step = !detail::less_with_sign(m_time_delta + m_time_delta / 1024, left, m_time_delta);
+            {
+                NUMINT_TRACE_SCOPE("numint::do_step");
+                m_stepper.do_step(std::forward<System>(system), x, m_time, last_step ? left : m_time_delta);
+            }
+            // Land exactly on the deadline.
+            m_time = last_step ? deadline : m_time + m_time_delta;
+            ++status.steps;
+            if (timed) {
+                const typename clock::time_point end = clock::now();
+                const auto elapsed                    = std::chrono::duration_cast<duration>(end - last);
+                // Follow the slower steps at once, and decay towards the faster ones.
+                m_worst_step = (elapsed > m_worst_step) ? elapsed : (m_worst_step - (m_worst_step - elapsed) / 8);
+                m_worst_step = (m_worst_step > m_budget) ? m_budget : m_worst_step;
+                last         = end;
+            }
+        }
+        status.time    = m_time;
+        status.overrun = detail::less_with_sign(m_time, deadline, m_time_delta);
+        status.lag     = status.overrun ? (deadline - m_time) : time_type(0);
+        m_overruns += status.overrun ? 1 : 0;
+        return status;
+    }
+
+private:
+    /// The stepper we rely upon.
+    stepper_type m_stepper;
+    /// The time reached by the integration.
+    time_type m_time;
+    /// The step-size.
+    time_type m_time_delta;
+    /// The maximum number of steps executed by each call.
+    std::size_t m_max_steps;
+    /// The wall-clock budget of each call, zero when disabled.
+    duration m_budget;
+    /// The estimate of the slowest recent step.
+    duration m_worst_step;
+    /// The number of calls which did not reach their deadline.
+    std::size_t m_overruns;
+};
+
+} // namespace numint
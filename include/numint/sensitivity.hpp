@@ -0,0 +1,284 @@
+/// @file sensitivity.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Forward sensitivity analysis: the derivatives of the trajectory with
+/// respect to the parameters of the system, integrated together with it.
+///
+/// @details The sensitivities s_k = dx/dp_k evolve as
+///
+///     ds_k/dt = J_x(x, p, t) * s_k + df/dp_k(x, p, t),
+///
+/// which are integrated together with the state, as a single augmented
+/// system. The right-hand side of all the sensitivity equations is obtained
+/// with a single evaluation of the system on dual numbers (see
+/// `numint/dual.hpp`), whose derivatives are seeded with the sensitivities and
+/// the parameters, hence the gradients with respect to all the parameters come
+/// out of one integration, instead of two per parameter with central finite
+/// differences. The augmented system is an ordinary system, which can be
+/// integrated by any stepper, and the error control of the adaptive steppers
+/// also covers the sensitivities.
+
+#pragma once
+
+#include "numint/detail/type_traits.hpp"
+#include "numint/dual.hpp"
+#include "numint/jacobian.hpp"
+#include "numint/linear/dense_matrix.hpp"
+
+#include <array>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace numint
+{
+
+namespace detail
+{
+
+/// @brief Provides the state vector type holding a state, and the given number of copies of it.
+/// @tparam State The state vector type.
+/// @tparam Blocks The number of blocks of the augmented state.
+template <class State, std::size_t Blocks>
+struct augmented_state;
+
+/// @brief Provides the state vector type holding a state, and the given number of copies of it.
+/// @tparam T The type of the values of the state.
+/// @tparam N The number of elements.
+/// @tparam Blocks The number of blocks of the augmented state.
+template <class T, std::size_t N, std::size_t Blocks>
+struct augmented_state<std::array<T, N>, Blocks> {
+    /// @brief The augmented state vector type.
+    using type = std::array<T, N * Blocks>;
+};
+
+/// @brief Provides the state vector type holding a state, and the given number of copies of it.
+/// @tparam T The type of the values of the state.
+/// @tparam Allocator The allocator of the state.
+/// @tparam Blocks The number of blocks of the augmented state.
+template <class T, class Allocator, std::size_t Blocks>
+struct augmented_state<std::vector<T, Allocator>, Blocks> {
+    /// @brief The augmented state vector type.
+    using type = std::vector<T, Allocator>;
+};
+
+/// @brief Helper alias template for the augmented state vector type.
+/// @tparam State The state vector type.
+/// @tparam Blocks The number of blocks of the augmented state.
+template <class State, std::size_t Blocks>
+using augmented_state_t = typename augmented_state<State, Blocks>::type;
+
+} // namespace detail
+
+/// @brief The system of the forward sensitivities of a model with respect to its parameters.
+///
+/// @details The model is created by `make_model(p)`, from an array holding
+/// its parameters. The model must be generic over the type of its parameters,
+/// and of the values of its state, which are the same (e.g., `Model<T>`
+/// holding parameters of type `T`, and evaluating `std::array<T, 2>` states),
+/// and it must call the mathematical functions unqualified. The factory is
+/// called with arrays of dual numbers, once for the sensitivities, and once
+/// for the Jacobian.
+///
+/// The augmented state holds the state, followed by the sensitivities with
+/// respect to each parameter: the derivative of the i-th variable with respect
+/// to the k-th parameter is at position `(k + 1) * n + i`, where n is the
+/// size of the state (see `augment` and `sensitivity`).
+///
+/// The Jacobian, used by the implicit steppers, is the block-diagonal matrix
+/// with the Jacobian of the model on each block, which is exact for the
+/// state, and drops the second derivatives of the model from the
+/// sensitivities. The Newton iterations still converge to the exact solution
+/// of the augmented system.
+///
+/// @tparam State The state vector type of the model.
+/// @tparam Parameters The number of parameters.
+/// @tparam ModelFactory The type of the function creating the model, as `make_model(p)`.
+/// @tparam Chunk The number of columns of the Jacobian computed by each evaluation of the model.
+template <class State, std::size_t Parameters, class ModelFactory, std::size_t Chunk = detail::default_chunk_v<State>>
+class sensitivity_system
+{
+public:
+    /// @brief Type of value contained in the state vector.
+    using value_type      = typename State::value_type;
+    /// @brief The augmented state vector type.
+    using state_type      = detail::augmented_state_t<State, Parameters + 1>;
+    /// @brief The type of the parameters.
+    using parameters_type = std::array<value_type, Parameters>;
+    /// @brief The dual numbers carrying the sensitivities.
+    using dual_type       = dual<value_type, Parameters>;
+
+    /// @brief The number of parameters.
+    static constexpr std::size_t parameters = Parameters;
+
+    /// @brief Creates the system of the sensitivities.
+    /// @param make_model Creates the model, from an array holding its parameters.
+    /// @param values The values of the parameters.
+    sensitivity_system(ModelFactory make_model, const parameters_type &values)
+        : m_model(make_model(sensitivity_system::seed(values)))
+        , m_jacobian_model(make_model(sensitivity_system::constant(values)))
+    {
+        // Nothing to do.
+    }
+
+    /// @brief Creates the augmented state, whose sensitivities are zero, from a state.
+    /// @details The sensitivities of the initial conditions which depend on the parameters can then be set.
+    /// @param x The state.
+    /// @return the augmented state.
+    static auto augment(const State &x) -> state_type
+    {
+        state_type y{};
+        if constexpr (detail::has_resize_v<state_type>) {
+            y.resize(x.size() * (Parameters + 1));
+        }
+        for (std::size_t i = 0; i < x.size(); ++i) {
+            y[i] = x[i];
+        }
+        return y;
+    }
+
+    /// @brief Returns the number of variables of the state, inside an augmented state.
+    /// @param y The augmented state.
+    /// @return the number of variables.
+    static auto variables(const state_type &y) -> std::size_t { return y.size() / (Parameters + 1); }
+
+    /// @brief Returns the sensitivity of a variable of the state with respect to a parameter.
+    /// @param y The augmented state.
+    /// @param variable The index of the variable.
+    /// @param parameter The index of the parameter.
+    /// @return the derivative of the variable with respect to the parameter.
+    static auto sensitivity(const state_type &y, std::size_t variable, std::size_t parameter) -> value_type
+    {
+        return y[(parameter + 1) * variables(y) + variable];
+    }
+
+    /// @brief Returns the sensitivity of a variable of the state with respect to a parameter.
+    /// @param y The augmented state.
+    /// @param variable The index of the variable.
+    /// @param parameter The index of the parameter.
+    /// @return a reference to the derivative of the variable with respect to the parameter.
+    static auto sensitivity(state_type &y, std::size_t variable, std::size_t parameter) -> value_type &
+    {
+        return y[(parameter + 1) * variables(y) + variable];
+    }
+
+    /// @brief Evaluates the augmented system: the model, and the right-hand side of the sensitivity equations.
+    /// @param y The augmented state.
+    /// @param dydt The derivative of the augmented state.
+    /// @param t The time.
+    template <class Time>
+    void operator()(const state_type &y, state_type &dydt, Time t)
+    {
+        const std::size_t n = variables(y);
+        if constexpr (detail::has_resize_v<dual_state>) {
+            m_x.resize(n);
+            m_dxdt.resize(n);
+        }
+        // Seed the state with its sensitivities.
+        for (std::size_t i = 0; i < n; ++i) {
+            m_x[i] = dual_type(y[i]);
+            for (std::size_t k = 0; k < Parameters; ++k) {
+                m_x[i].derivative(k) = y[(k + 1) * n + i];
+            }
+        }
+        // The derivatives carry J_x * s_k + df/dp_k.
+        m_model(m_x, m_dxdt, t);
+        for (std::size_t i = 0; i < n; ++i) {
+            dydt[i] = m_dxdt[i].value();
+            for (std::size_t k = 0; k < Parameters; ++k) {
+                dydt[(k + 1) * n + i] = m_dxdt[i].derivative(k);
+            }
+        }
+    }
+
+    /// @brief Evaluates the block-diagonal Jacobian of the augmented system.
+    /// @param y The augmented state.
+    /// @param J The matrix receiving the Jacobian.
+    /// @param t The time.
+    template <class Time>
+    void jacobian(const state_type &y, dense_matrix<value_type> &J, Time t)
+    {
+        const std::size_t n = variables(y);
+        if constexpr (detail::has_resize_v<State>) {
+            m_state.resize(n);
+            m_jacobian_x.resize(n);
+            m_jacobian_dxdt.resize(n);
+        }
+        for (std::size_t i = 0; i < n; ++i) {
+            m_state[i] = y[i];
+        }
+        J.fill(value_type(0));
+        detail::dual_jacobian<Chunk>(
+            m_jacobian_model, m_state, t, m_jacobian_x, m_jacobian_dxdt,
+            [&J, n](std::size_t i, std::size_t j, value_type value) {
+                for (std::size_t block = 0; block <= Parameters; ++block) {
+                    J(block * n + i, block * n + j) = value;
+                }
+            });
+    }
+
+private:
+    /// The dual numbers used to compute the Jacobian.
+    using jacobian_dual_type = dual<value_type, Chunk>;
+    /// The state vector type holding the dual numbers carrying the sensitivities.
+    using dual_state         = detail::rebind_state_t<State, dual_type>;
+    /// The state vector type holding the dual numbers used to compute the Jacobian.
+    using jacobian_state     = detail::rebind_state_t<State, jacobian_dual_type>;
+    /// The model evaluating the sensitivities.
+    using model_type = std::decay_t<std::invoke_result_t<ModelFactory &, const std::array<dual_type, Parameters> &>>;
+    /// The model evaluating the Jacobian.
+    using jacobian_model_type =
+        std::decay_t<std::invoke_result_t<ModelFactory &, const std::array<jacobian_dual_type, Parameters> &>>;
+
+    /// @brief Seeds each parameter along its own direction.
+    /// @param values The values of the parameters.
+    /// @return the parameters, as dual numbers.
+    static auto seed(const parameters_type &values) -> std::array<dual_type, Parameters>
+    {
+        std::array<dual_type, Parameters> result{};
+        for (std::size_t k = 0; k < Parameters; ++k) {
+            result[k] = dual_type(values[k], k);
+        }
+        return result;
+    }
+
+    /// @brief Converts the parameters to constant dual numbers, used to compute the Jacobian.
+    /// @param values The values of the parameters.
+    /// @return the parameters, as dual numbers.
+    static auto constant(const parameters_type &values) -> std::array<jacobian_dual_type, Parameters>
+    {
+        std::array<jacobian_dual_type, Parameters> result{};
+        for (std::size_t k = 0; k < Parameters; ++k) {
+            result[k] = jacobian_dual_type(values[k]);
+        }
+        return result;
+    }
+
+    /// The model, whose parameters are seeded.
+    model_type m_model;
+    /// The model, whose parameters are constant, used to compute the Jacobian.
+    jacobian_model_type m_jacobian_model;
+    /// Support states, for the evaluation of the sensitivities.
+    dual_state m_x{}, m_dxdt{};
+    /// Support states, for the evaluation of the Jacobian.
+    jacobian_state m_jacobian_x{}, m_jacobian_dxdt{};
+    /// The state, extracted from the augmented state.
+    State m_state{};
+};
+
+/// @brief Creates the system of the forward sensitivities of a model with respect to its parameters.
+/// @tparam State The state vector type of the model.
+/// @tparam Parameters The number of parameters.
+/// @tparam ModelFactory The type of the function creating the model, as `make_model(p)`.
+/// @param make_model Creates the model, from an array holding its parameters.
+/// @param values The values of the parameters.
+/// @return the system of the sensitivities.
+template <class State, std::size_t Parameters, class ModelFactory>
+auto make_sensitivity_system(
+    ModelFactory make_model,
+    const std::array<typename State::value_type, Parameters> &values)
+{
+    return sensitivity_system<State, Parameters, ModelFactory>(std::move(make_model), values);
+}
+
+} // namespace numint
@@ -0,0 +1,129 @@
+/// @file separable.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Support for separable systems, whose coordinates and momenta are
+/// advanced separately by the symplectic steppers.
+///
+/// @details The state of a separable system holds the coordinates q in its
+/// first half, and the momenta p in its second half. The system provides the
+/// two halves of its derivative through two member functions:
+///
+///     void coordinate(const State &x, State &dxdt, Time t); // dq/dt, from p
+///     void momentum(const State &x, State &dxdt, Time t);   // dp/dt, from q
+///
+/// which fill, respectively, the first and the second half of dxdt. For a
+/// Hamiltonian H(q, p) = T(p) + V(q), they are dq/dt = dT/dp and dp/dt =
+/// -dV/dq. Alternatively, two functors can be paired into a system through
+/// `make_separable`. The symplectic steppers also accept ordinary systems,
+/// which are evaluated whole, and of which they use only the half they need.
+
+#pragma once
+
+#include <type_traits>
+#include <utility>
+
+namespace numint
+{
+
+namespace detail
+{
+
+/// @brief Checks if a system provides the two halves of its derivative.
+/// @tparam System The type of the system.
+/// @tparam State The state vector type.
+/// @tparam Time The datatype used to hold time.
+template <class System, class State, class Time, class = void>
+struct is_separable : std::false_type {
+};
+
+/// @brief Checks if a system provides the two halves of its derivative.
+/// @tparam System The type of the system.
+/// @tparam State The state vector type.
+/// @tparam Time The datatype used to hold time.
+template <class System, class State, class Time>
+struct is_separable<
+    System,
+    State,
+    Time,
+    std::void_t<
+        decltype(std::declval<std::remove_reference_t<System> &>().coordinate(
+            std::declval<const State &>(), std::declval<State &>(), std::declval<Time>())),
+        decltype(std::declval<std::remove_reference_t<System> &>().momentum(
+            std::declval<const State &>(), std::declval<State &>(), std::declval<Time>()))>> : std::true_type {
+};
+
+/// @brief Helper variable template to check if a system provides the two halves of its derivative.
+template <class System, class State, class Time>
+constexpr inline bool is_separable_v = is_separable<System, State, Time>::value;
+
+} // namespace detail
+
+/// @brief A separable system, made of the functors computing the derivatives
+/// of the coordinates and of the momenta.
+/// @tparam Coordinate The type of the functor computing the derivative of the coordinates.
+/// @tparam Momentum The type of the functor computing the derivative of the momenta.
+template <class Coordinate, class Momentum>
+class separable_system
+{
+public:
+    /// @brief Creates the system.
+    /// @param coordinate The functor filling the first half of dxdt, called as `coordinate(x, dxdt, t)`.
+    /// @param momentum The functor filling the second half of dxdt, called as `momentum(x, dxdt, t)`.
+    template <class C, class M>
+    separable_system(C &&coordinate, M &&momentum)
+        : m_coordinate(std::forward<C>(coordinate))
+        , m_momentum(std::forward<M>(momentum))
+    {
+        // Nothing to do.
+    }
+
+    /// @brief Evaluates the whole system, so that it can be used by any stepper.
+    /// @param x The state.
+    /// @param dxdt The derivative of the state.
+    /// @param t The time.
+    template <class State, class Time>
+    void operator()(const State &x, State &dxdt, Time t)
+    {
+        m_coordinate(x, dxdt, t);
+        m_momentum(x, dxdt, t);
+    }
+
+    /// @brief Evaluates the derivative of the coordinates.
+    /// @param x The state.
+    /// @param dxdt The derivative of the state, whose first half is filled.
+    /// @param t The time.
+    template <class State, class Time>
+    void coordinate(const State &x, State &dxdt, Time t)
+    {
+        m_coordinate(x, dxdt, t);
+    }
+
+    /// @brief Evaluates the derivative of the momenta.
+    /// @param x The state.
+    /// @param dxdt The derivative of the state, whose second half is filled.
+    /// @param t The time.
+    template <class State, class Time>
+    void momentum(const State &x, State &dxdt, Time t)
+    {
+        m_momentum(x, dxdt, t);
+    }
+
+private:
+    /// The functor computing the derivative of the coordinates.
+    Coordinate m_coordinate;
+    /// The functor computing the derivative of the momenta.
+    Momentum m_momentum;
+};
+
+/// @brief Pairs the functors computing the derivatives of the coordinates and of the momenta.
+/// @details Objects passed as lvalues are kept by reference, temporaries are moved inside the pair.
+/// @param coordinate The functor filling the first half of dxdt, called as `coordinate(x, dxdt, t)`.
+/// @param momentum The functor filling the second half of dxdt, called as `momentum(x, dxdt, t)`.
+/// @return The separable system.
+template <class Coordinate, class Momentum>
+auto make_separable(Coordinate &&coordinate, Momentum &&momentum)
+{
+    return separable_system<Coordinate, Momentum>(
+        std::forward<Coordinate>(coordinate), std::forward<Momentum>(momentum));
+}
+
+} // namespace numint
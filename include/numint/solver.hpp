@@ -5,9 +5,13 @@
 
 #pragma once
 
+#include "numint/detail/dense_output.hpp"
 #include "numint/detail/it_algebra.hpp"
 #include "numint/detail/less_with_sign.hpp"
 #include "numint/detail/type_traits.hpp"
+#include "numint/trace.hpp"
+
+#include <stdexcept>
 
 enum : unsigned char {
     NUMINT_MAJOR_VERSION = 1, ///< Major version of the library.
@@ -48,9 +52,15 @@ constexpr void integrate_one_step(
     const typename Stepper::time_type time_delta) noexcept
 {
     // Perform one integration step.
-    stepper.do_step(std::forward<System>(system), state, time, time_delta);
+    {
+        NUMINT_TRACE_SCOPE("numint::do_step");
+        stepper.do_step(std::forward<System>(system), state, time, time_delta);
+    }
     // Call the observer.
-    std::forward<Observer>(observer)(state, time);
+    {
+        NUMINT_TRACE_SCOPE("numint::observer");
+        std::forward<Observer>(observer)(state, time);
+    }
 }
 
 /// @brief Default termination condition that never ends early.
@@ -74,12 +84,13 @@ constexpr auto default_termination_condition(const State &state) noexcept -> boo
 
 } // namespace detail
 
-/// @brief Integrates the system over a fixed time step between the start and end time.
+/// @brief Continues the integration of the system over a fixed time step, keeping the data cached by the stepper.
 ///
-/// @details This function performs fixed-step integration of a system over a
-/// given time interval using the specified stepper. The observer is invoked
-/// after every integration step, and an optional termination condition can be
-/// used to stop the integration early.
+/// @details It behaves as `integrate_fixed`, without discarding the data
+/// cached by the stepper (e.g., the history of the multistep steppers), so
+/// that the integration continues the previous one, or the one restored
+/// from a checkpoint (see `checkpoint.hpp`). The stepper must already be
+/// sized for the state.
 ///
 /// @tparam Stepper The type of the integration stepper.
 /// @tparam System The type of the system being integrated.
@@ -101,7 +112,7 @@ template <
     class System,
     class Observer,
     class TerminationCondition = decltype(detail::default_termination_condition<typename Stepper::state_type>)>
-constexpr auto integrate_fixed(
+constexpr auto resume_fixed(
     Stepper &stepper,
     Observer &&observer,
     System &&system,
@@ -111,11 +122,6 @@ constexpr auto integrate_fixed(
     typename Stepper::time_type time_delta,
     TerminationCondition check_if_done = detail::default_termination_condition<typename Stepper::state_type>) noexcept
 {
-    using state_type = typename Stepper::state_type;
-    // Check if the state vector can (and should) be resized.
-    if constexpr (numint::detail::has_resize_v<state_type>) {
-        stepper.adjust_size(state);
-    }
     // Call the observer at the beginning.
     std::forward<Observer>(observer)(state, start_time);
     // Run until the time reaches the `end_time`.
@@ -134,14 +140,59 @@ constexpr auto integrate_fixed(
     return stepper.steps();
 }
 
-/// @brief Integrates the system from the start time to the end time using an
-/// adaptive stepper.
+/// @brief Integrates the system over a fixed time step between the start and end time.
 ///
-/// @details This function performs adaptive integration of a system over a
-/// specified time interval using the given stepper. It dynamically adjusts the
-/// step size to ensure accuracy and stability. The observer is invoked after
-/// every integration step, and an optional termination condition can be used to
-/// stop the integration early.
+/// @details This function performs fixed-step integration of a system over a
+/// given time interval using the specified stepper. The observer is invoked
+/// after every integration step, and an optional termination condition can be
+/// used to stop the integration early.
+///
+/// @tparam Stepper The type of the integration stepper.
+/// @tparam System The type of the system being integrated.
+/// @tparam Observer The type of the observer function.
+/// @tparam TerminationCondition The type of the termination condition function.
+///
+/// @param stepper The stepper used to perform the integration.
+/// @param observer The observer function to call after each step, receiving the updated state and time.
+/// @param system The system being integrated, which defines the equations of motion or dynamics.
+/// @param state The initial state of the system, which will be updated during integration.
+/// @param start_time The start time for the integration.
+/// @param end_time The final time for the integration.
+/// @param time_delta The fixed step size for integration.
+/// @param check_if_done The termination condition to determine if integration
+/// should stop early. Defaults to a function that always returns false.
+/// @return The number of steps taken to complete the integration.
+template <
+    class Stepper,
+    class System,
+    class Observer,
+    class TerminationCondition = decltype(detail::default_termination_condition<typename Stepper::state_type>)>
+constexpr auto integrate_fixed(
+    Stepper &stepper,
+    Observer &&observer,
+    System &&system,
+    typename Stepper::state_type &state,
+    typename Stepper::time_type start_time,
+    typename Stepper::time_type end_time,
+    typename Stepper::time_type time_delta,
+    TerminationCondition check_if_done = detail::default_termination_condition<typename Stepper::state_type>) noexcept
+{
+    // Adjust the stepper's internal size, this also discards any data cached
+    // by the stepper during previous integrations.
+    stepper.adjust_size(state);
+    // Run the integration.
+    return resume_fixed(
+        stepper, std::forward<Observer>(observer), std::forward<System>(system), state, start_time, end_time,
+        time_delta, check_if_done);
+}
+
+/// @brief Continues the integration of the system with an adaptive stepper, keeping the data cached by the stepper.
+///
+/// @details It behaves as `integrate_adaptive`, without discarding the
+/// data cached by the stepper (e.g., the history of the multistep steppers,
+/// or of the controller), so that the integration continues the previous
+/// one, or the one restored from a checkpoint (see `checkpoint.hpp`). The
+/// stepper must already be sized for the state.
 ///
 /// @tparam Stepper The type of the integration stepper.
 /// @tparam System The type of the system being integrated.
@@ -164,7 +215,7 @@ template <
     class System,
     class Observer,
     class TerminationCondition = decltype(detail::default_termination_condition<typename Stepper::state_type>)>
-constexpr auto integrate_adaptive(
+constexpr auto resume_adaptive(
     Stepper &stepper,
     Observer &&observer,
     System &&system,
@@ -174,13 +225,6 @@ constexpr auto integrate_adaptive(
     typename Stepper::time_type time_delta,
     TerminationCondition check_if_done = detail::default_termination_condition<typename Stepper::state_type>)
 {
-    using state_type = typename Stepper::state_type;
-
-    // Adjust the stepper's internal size if the state supports resizing.
-    if constexpr (numint::detail::has_resize_v<state_type>) {
-        stepper.adjust_size(state);
-    }
-
     // Run until the time reaches the `end_time`, the outer while loop allows to
     // precisely simulate up to end_time. That's why the outer loop is usually
     // simulated 2 times.
@@ -190,8 +234,8 @@ constexpr auto integrate_adaptive(
             // Perform one integration step.
             detail::integrate_one_step(
                 stepper, std::forward<Observer>(observer), std::forward<System>(system), state, start_time, time_delta);
-            // Advance time.
-            start_time += time_delta;
+            // Advance time, by the step-size that was actually accepted.
+            start_time += stepper.get_last_time_delta();
             // Update integration step size.
             time_delta = stepper.get_time_delta();
             // Check if the integration should terminate early by calling the check_if_done function.
@@ -208,4 +252,179 @@ constexpr auto integrate_adaptive(
     return stepper.steps();
 }
 
+/// @brief Integrates the system from the start time to the end time using an
+/// adaptive stepper.
+///
+/// @details This function performs adaptive integration of a system over a
+/// specified time interval using the given stepper. It dynamically adjusts the
+/// step size to ensure accuracy and stability. The observer is invoked after
+/// every integration step, and an optional termination condition can be used to
+/// stop the integration early.
+///
+/// @tparam Stepper The type of the integration stepper.
+/// @tparam System The type of the system being integrated.
+/// @tparam Observer The type of the observer function.
+/// @tparam TerminationCondition The type of the termination condition function.
+///
+/// @param stepper The stepper used to perform the integration.
+/// @param observer The observer function to call after each step, receiving the updated state and time.
+/// @param system The system being integrated, which defines the equations of motion or dynamics.
+/// @param state The initial state of the system, which will be updated during integration.
+/// @param start_time The start time for the integration.
+/// @param end_time The final time for the integration.
+/// @param time_delta The initial step size for integration. This may be dynamically adjusted.
+/// @param check_if_done The termination condition to determine if integration
+/// should stop early. Defaults to a function that always returns false.
+///
+/// @return The number of steps taken to complete the integration.
+template <
+    class Stepper,
+    class System,
+    class Observer,
+    class TerminationCondition = decltype(detail::default_termination_condition<typename Stepper::state_type>)>
+constexpr auto integrate_adaptive(
+    Stepper &stepper,
+    Observer &&observer,
+    System &&system,
+    typename Stepper::state_type &state,
+    typename Stepper::time_type start_time,
+    typename Stepper::time_type end_time,
+    typename Stepper::time_type time_delta,
+    TerminationCondition check_if_done = detail::default_termination_condition<typename Stepper::state_type>)
+{
+    // Adjust the stepper's internal size, this also discards any data cached
+    // by the stepper during previous integrations.
+    stepper.adjust_size(state);
+    // Run the integration.
+    return resume_adaptive(
+        stepper, std::forward<Observer>(observer), std::forward<System>(system), state, start_time, end_time,
+        time_delta, check_if_done);
+}
+
+/// @brief Integrates the system, and observes the state at the requested times.
+///
+/// @details The stepper takes the steps it would take without any observer
+/// (i.e., the largest ones allowed by the tolerance, for adaptive steppers, or
+/// `time_delta`, for fixed-step ones), and the state at the requested times is
+/// obtained by interpolating the step containing them (dense output). Steppers
+/// providing their own interpolant (e.g., `stepper_dopri5`, `stepper_bs32`, or
+/// `stepper_bdf`) use it, at no additional cost, while for the others the
+/// cubic Hermite interpolant is used, which costs one evaluation of the system
+/// per step containing requested times. The integration starts from the first
+/// requested time, and stops at the last one, forward in time for a positive
+/// `time_delta`, and backward for a negative one.
+///
+/// @tparam Stepper The type of the integration stepper.
+/// @tparam System The type of the system being integrated.
+/// @tparam Observer The type of the observer function.
+/// @tparam TimeIterator The type of iterator over the requested times.
+/// @tparam TerminationCondition The type of the termination condition function.
+///
+/// @param stepper The stepper used to perform the integration.
+/// @param observer The observer function to call at each requested time, receiving the state and the time.
+/// @param system The system being integrated, which defines the equations of motion or dynamics.
+/// @param state The state of the system at the first requested time, which is
+/// updated up to the last requested time.
+/// @param times_begin The beginning of the requested times, in the direction of
+/// the integration (i.e., in ascending order for a positive `time_delta`, and in
+/// descending order for a negative one).
+/// @param times_end The end of the requested times.
+/// @param time_delta The (initial) step size for integration, its sign gives the direction of the integration.
+/// @param check_if_done The termination condition to determine if integration
+/// should stop early. Defaults to a function that always returns false.
+///
+/// @return The number of steps taken to complete the integration.
+/// @throws std::invalid_argument if the requested times are not in the direction of the integration.
+template <
+    class Stepper,
+    class System,
+    class Observer,
+    class TimeIterator,
+    class TerminationCondition = decltype(detail::default_termination_condition<typename Stepper::state_type>)>
+auto integrate_times(
+    Stepper &stepper,
+    Observer &&observer,
+    System &&system,
+    typename Stepper::state_type &state,
+    TimeIterator times_begin,
+    TimeIterator times_end,
+    typename Stepper::time_type time_delta,
+    TerminationCondition check_if_done = detail::default_termination_condition<typename Stepper::state_type>)
+{
+    using state_type = typename Stepper::state_type;
+    using time_type  = typename Stepper::time_type;
+
+    // Adjust the stepper's internal size, this also discards any data cached
+    // by the stepper during previous integrations.
+    stepper.adjust_size(state);
+    if (times_begin == times_end) {
+        return stepper.steps();
+    }
+    // Find the last requested time, and check that the times follow the direction of the integration.
+    const time_type direction = time_delta;
+    time_type end_time        = *times_begin;
+    for (TimeIterator it = times_begin; it != times_end; ++it) {
+        if (detail::less_with_sign<time_type>(*it, end_time, direction)) {
+            throw std::invalid_argument("The times of integrate_times must follow the direction of time_delta.");
+        }
+        end_time = *it;
+    }
+    // The interpolant of the steps, and the interpolated state.
+    detail::dense_output<Stepper> dense(state);
+    state_type x(state);
+
+    // Observe the requested times at the beginning.
+    time_type time = *times_begin;
+    for (; (times_begin != times_end) && !detail::less_with_sign<time_type>(time, *times_begin, direction);
+         ++times_begin) {
+        std::forward<Observer>(observer)(state, *times_begin);
+    }
+    while (times_begin != times_end) {
+        // Keep the state at the beginning of the step.
+        dense.begin_step(state, time);
+        const time_type start_time = time;
+        // Make sure we don't go beyond the last requested time.
+        const bool last = !detail::less_with_sign<time_type>(time_delta, end_time - time, direction);
+        if (last) {
+            time_delta = end_time - time;
+        }
+        const time_type step = time_delta;
+        // Perform one integration step.
+        time_type last_time_delta = step;
+        {
+            NUMINT_TRACE_SCOPE("numint::do_step");
+            stepper.do_step(std::forward<System>(system), state, time, step);
+        }
+        if constexpr (Stepper::is_adaptive_stepper) {
+            last_time_delta = stepper.get_last_time_delta();
+            time_delta      = stepper.get_time_delta();
+        }
+        // Advance time, landing exactly on the last requested time.
+        const bool landed = last && !detail::less_with_sign(last_time_delta, step, direction);
+        time              = landed ? end_time : start_time + last_time_delta;
+        dense.end_step(time, last_time_delta);
+        // Observe the requested times inside the step.
+        for (; (times_begin != times_end) && !detail::less_with_sign<time_type>(time, *times_begin, direction);
+             ++times_begin) {
+            if (!detail::less_with_sign<time_type>(*times_begin, time, direction)) {
+                NUMINT_TRACE_SCOPE("numint::observer");
+                std::forward<Observer>(observer)(state, *times_begin);
+            } else {
+                {
+                    NUMINT_TRACE_SCOPE("numint::interpolate");
+                    dense.interpolate(stepper, std::forward<System>(system), state, *times_begin, x);
+                }
+                NUMINT_TRACE_SCOPE("numint::observer");
+                std::forward<Observer>(observer)(x, *times_begin);
+            }
+        }
+        // Check if the integration should terminate early by calling the check_if_done function.
+        if (check_if_done(state)) {
+            break; // Terminate the integration early.
+        }
+    }
+    // Return the number of steps it took to integrate.
+    return stepper.steps();
+}
+
 } // namespace numint
\ No newline at end of file
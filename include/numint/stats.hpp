@@ -0,0 +1,385 @@
+/// @file stats.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Statistics of the integration, collected by `stepper_instrumented`.
+///
+/// @details The statistics are a policy of `stepper_instrumented`:
+/// `solver_stats` collects them all, `solver_stats<Time, false>` only the
+/// counters (without reading the clock), while `no_stats` collects nothing,
+/// and reduces the instrumented stepper to the stepper it wraps.
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <utility>
+
+namespace numint
+{
+
+/// @brief The statistics of the integration.
+///
+/// @details The statistics count the evaluations of the system, and the
+/// accepted and rejected steps, they keep track of the step-sizes of the
+/// accepted steps, and of the histogram of their errors (for the adaptive
+/// steppers providing it), and, when `Timing` is true, they measure the time
+/// spent evaluating the system, inside the stepper, and inside the observer.
+///
+/// The histogram counts the ratios between the estimated error and the
+/// tolerance by decade: the bin `i` counts the ratios in [10^(i - 9),
+/// 10^(i - 8)), the first one also counts the smaller ratios, and the last one
+/// the larger ones. Hence, the bin 9 counts the steps accepted above the
+/// tolerance (e.g., because the step-size reached its minimum).
+///
+/// @tparam Time The datatype used to hold time.
+/// @tparam Timing Whether the time spent by the integration is measured.
+template <class Time, bool Timing = true>
+class solver_stats
+{
+public:
+    /// @brief Type used to keep track of time.
+    using time_type = Time;
+
+    /// @brief The clock measuring the time spent by the integration.
+    using clock = std::chrono::steady_clock;
+
+    /// @brief The type of the time spent by the integration.
+    using duration = std::chrono::nanoseconds;
+
+    /// @brief The type of the instants read from the clock.
+    using time_point = std::conditional_t<Timing, clock::time_point, int>;
+
+    /// @brief Indicates whether the statistics are collected.
+    static constexpr bool enabled = true;
+
+    /// @brief Indicates whether the time spent by the integration is measured.
+    static constexpr bool timing = Timing;
+
+    /// @brief The number of bins of the histogram of the errors.
+    static constexpr std::size_t error_bins = 12;
+
+    /// @brief Reads the clock, if the time is measured.
+    /// @return the current instant.
+    static auto now() noexcept -> time_point
+    {
+        if constexpr (Timing) {
+            return clock::now();
+        } else {
+            return 0;
+        }
+    }
+
+    /// @brief Returns the time elapsed since the given instant, if the time is measured.
+    /// @param start The instant.
+    /// @return the elapsed time.
+    static auto since(time_point start) noexcept -> duration
+    {
+        if constexpr (Timing) {
+            return std::chrono::duration_cast<duration>(clock::now() - start);
+        } else {
+            (void)start;
+            return duration::zero();
+        }
+    }
+
+    /// @brief Returns the bin of the histogram counting the given ratio between error and tolerance.
+    /// @param ratio The ratio.
+    /// @return the index of the bin.
+    static auto error_bin(double ratio) noexcept -> std::size_t
+    {
+        if (!(ratio > 0)) {
+            return 0;
+        }
+        const double bin = std::floor(std::log10(ratio)) + 9.;
+        return static_cast<std::size_t>(std::min(std::max(bin, 0.), static_cast<double>(error_bins - 1)));
+    }
+
+    /// @brief Returns the lower bound of the ratios counted by a bin.
+    /// @param bin The index of the bin.
+    /// @return the lower bound, zero for the first bin.
+    static auto error_bin_lower_bound(std::size_t bin) noexcept -> double
+    {
+        return (bin == 0) ? 0. : std::pow(10., static_cast<double>(bin) - 9.);
+    }
+
+    /// @brief Registers an evaluation of the system.
+    /// @param elapsed The time spent by the evaluation.
+    void record_evaluation(duration elapsed) noexcept
+    {
+        ++m_rhs_evaluations;
+        m_rhs_time += elapsed;
+    }
+
+    /// @brief Registers an accepted step.
+    /// @param time_delta The step-size of the step.
+    /// @param rejections The number of attempts rejected before accepting the step.
+    /// @param elapsed The time spent by the step, evaluations of the system included.
+    void record_step(time_type time_delta, std::uint64_t rejections, duration elapsed) noexcept
+    {
+        ++m_accepted_steps;
+        m_rejected_steps += rejections;
+        m_min_time_delta = std::min(m_min_time_delta, time_delta);
+        m_max_time_delta = std::max(m_max_time_delta, time_delta);
+        m_sum_time_delta += time_delta;
+        m_step_time += elapsed;
+    }
+
+    /// @brief Registers the error of an accepted step.
+    /// @param ratio The ratio between the estimated error and the tolerance.
+    void record_error(double ratio) noexcept { ++m_error_histogram[error_bin(ratio)]; }
+
+    /// @brief Registers a call of the observer.
+    /// @param elapsed The time spent by the observer.
+    void record_observer(duration elapsed) noexcept
+    {
+        ++m_observations;
+        m_observer_time += elapsed;
+    }
+
+    /// @brief Returns the number of evaluations of the system.
+    /// @return the number of evaluations.
+    auto rhs_evaluations() const noexcept -> std::uint64_t { return m_rhs_evaluations; }
+
+    /// @brief Returns the number of accepted steps.
+    /// @return the number of steps.
+    auto accepted_steps() const noexcept -> std::uint64_t { return m_accepted_steps; }
+
+    /// @brief Returns the number of rejected attempts.
+    /// @return the number of rejected attempts.
+    auto rejected_steps() const noexcept -> std::uint64_t { return m_rejected_steps; }
+
+    /// @brief Returns the number of calls of the observer.
+    /// @return the number of calls.
+    auto observations() const noexcept -> std::uint64_t { return m_observations; }
+
+    /// @brief Returns the smallest step-size of the accepted steps.
+    /// @return the step-size, or zero without steps.
+    auto min_time_delta() const noexcept -> time_type { return m_accepted_steps ? m_min_time_delta : time_type(0); }
+
+    /// @brief Returns the largest step-size of the accepted steps.
+    /// @return the step-size, or zero without steps.
+    auto max_time_delta() const noexcept -> time_type { return m_accepted_steps ? m_max_time_delta : time_type(0); }
+
+    /// @brief Returns the mean step-size of the accepted steps.
+    /// @return the step-size, or zero without steps.
+    auto mean_time_delta() const noexcept -> time_type
+    {
+        return m_accepted_steps ? m_sum_time_delta / static_cast<time_type>(m_accepted_steps) : time_type(0);
+    }
+
+    /// @brief Returns the histogram of the errors of the accepted steps (see `error_bin`).
+    /// @return the number of steps counted by each bin.
+    auto error_histogram() const noexcept -> const std::array<std::uint64_t, error_bins> &
+    {
+        return m_error_histogram;
+    }
+
+    /// @brief Returns the time spent evaluating the system.
+    /// @return the time.
+    auto rhs_time() const noexcept -> duration { return m_rhs_time; }
+
+    /// @brief Returns the time spent inside the stepper, evaluations of the system excluded.
+    /// @return the time.
+    auto stepper_time() const noexcept -> duration { return m_step_time - m_rhs_time; }
+
+    /// @brief Returns the time spent inside the observer.
+    /// @return the time.
+    auto observer_time() const noexcept -> duration { return m_observer_time; }
+
+    /// @brief Discards the statistics collected so far.
+    void reset() noexcept { *this = solver_stats(); }
+
+private:
+    /// The number of evaluations of the system.
+    std::uint64_t m_rhs_evaluations{};
+    /// The number of accepted steps.
+    std::uint64_t m_accepted_steps{};
+    /// The number of rejected attempts.
+    std::uint64_t m_rejected_steps{};
+    /// The number of calls of the observer.
+    std::uint64_t m_observations{};
+    /// The smallest step-size.
+    time_type m_min_time_delta{std::numeric_limits<time_type>::max()};
+    /// The largest step-size.
+    time_type m_max_time_delta{std::numeric_limits<time_type>::lowest()};
+    /// The sum of the step-sizes.
+    time_type m_sum_time_delta{};
+    /// The histogram of the errors.
+    std::array<std::uint64_t, error_bins> m_error_histogram{};
+    /// The time spent evaluating the system.
+    duration m_rhs_time{};
+    /// The time spent by the steps, evaluations of the system included.
+    duration m_step_time{};
+    /// The time spent inside the observer.
+    duration m_observer_time{};
+};
+
+/// @brief The statistics policy collecting nothing.
+struct no_stats {
+    /// @brief Indicates whether the statistics are collected.
+    static constexpr bool enabled = false;
+};
+
+namespace detail
+{
+
+/// @brief Checks if a stepper counts its rejected steps.
+/// @tparam T The type to check.
+template <typename T, typename = void>
+struct has_rejections : std::false_type {
+};
+
+/// @brief Checks if a stepper counts its rejected steps.
+/// @tparam T The type to check.
+template <typename T>
+struct has_rejections<T, std::void_t<decltype(std::declval<const T &>().rejections())>> : std::true_type {
+};
+
+/// @brief Checks if a stepper provides the error of its last accepted step.
+/// @tparam T The type to check.
+template <typename T, typename = void>
+struct has_error_ratio : std::false_type {
+};
+
+/// @brief Checks if a stepper provides the error of its last accepted step.
+/// @tparam T The type to check.
+template <typename T>
+struct has_error_ratio<T, std::void_t<decltype(std::declval<const T &>().get_last_error_ratio())>>
+    : std::true_type {
+};
+
+/// @brief A system counting, and timing, its evaluations.
+///
+/// @details The Jacobian, and the halves of the separable systems, are
+/// forwarded as well, so that the steppers detect them as they would on the
+/// system itself.
+///
+/// @tparam System The type of the system.
+/// @tparam Stats The type of the statistics.
+template <class System, class Stats>
+class counted_system
+{
+public:
+    /// @brief Wraps the system.
+    /// @param system The system.
+    /// @param stats The statistics.
+    counted_system(System &system, Stats &stats) noexcept
+        : m_system(system)
+        , m_stats(stats)
+    {
+        // Nothing to do.
+    }
+
+    /// @brief Evaluates the system.
+    /// @param x The state.
+    /// @param dxdt The derivative of the state.
+    /// @param t The time.
+    template <class State, class Time>
+    void operator()(const State &x, State &dxdt, Time t)
+    {
+        const auto start = Stats::now();
+        m_system(x, dxdt, t);
+        m_stats.record_evaluation(Stats::since(start));
+    }
+
+    /// @brief Evaluates the Jacobian of the system, if it provides one.
+    /// @param x The state.
+    /// @param J The Jacobian.
+    /// @param t The time.
+    /// @return whatever the system returns.
+    template <class State, class Matrix, class Time, class S = System>
+    auto jacobian(const State &x, Matrix &J, Time t) -> decltype(std::declval<S &>().jacobian(x, J, t))
+    {
+        return m_system.jacobian(x, J, t);
+    }
+
+    /// @brief Evaluates the derivative of the coordinates, if the system is separable.
+    /// @param x The state.
+    /// @param dxdt The derivative of the state.
+    /// @param t The time.
+    template <class State, class Time, class S = System>
+    auto coordinate(const State &x, State &dxdt, Time t) -> decltype(std::declval<S &>().coordinate(x, dxdt, t))
+    {
+        const auto start = Stats::now();
+        m_system.coordinate(x, dxdt, t);
+        m_stats.record_evaluation(Stats::since(start));
+    }
+
+    /// @brief Evaluates the derivative of the momenta, if the system is separable.
+    /// @param x The state.
+    /// @param dxdt The derivative of the state.
+    /// @param t The time.
+    template <class State, class Time, class S = System>
+    auto momentum(const State &x, State &dxdt, Time t) -> decltype(std::declval<S &>().momentum(x, dxdt, t))
+    {
+        const auto start = Stats::now();
+        m_system.momentum(x, dxdt, t);
+        m_stats.record_evaluation(Stats::since(start));
+    }
+
+private:
+    /// The system.
+    System &m_system;
+    /// The statistics.
+    Stats &m_stats;
+};
+
+} // namespace detail
+
+/// @brief An observer timing the one it wraps.
+/// @tparam Observer The type of the observer.
+/// @tparam Stats The type of the statistics.
+template <class Observer, class Stats>
+class timed_observer
+{
+public:
+    /// @brief Wraps the observer.
+    /// @param observer The observer.
+    /// @param stats The statistics.
+    template <class O>
+    timed_observer(O &&observer, Stats &stats)
+        : m_observer(std::forward<O>(observer))
+        , m_stats(stats)
+    {
+        // Nothing to do.
+    }
+
+    /// @brief Calls the observer.
+    /// @param x The state.
+    /// @param t The time.
+    template <class State, class Time>
+    void operator()(const State &x, const Time &t)
+    {
+        const auto start = Stats::now();
+        m_observer(x, t);
+        m_stats.record_observer(Stats::since(start));
+    }
+
+    /// @brief Provides access to the observer.
+    /// @return the observer.
+    auto observer() noexcept -> std::remove_reference_t<Observer> & { return m_observer; }
+
+private:
+    /// The observer.
+    Observer m_observer;
+    /// The statistics.
+    Stats &m_stats;
+};
+
+/// @brief Wraps an observer, so that the time it spends is measured by the statistics.
+/// @details Objects passed as lvalues are kept by reference, temporaries are moved inside the wrapper.
+/// @param observer The observer.
+/// @param stats The statistics, e.g., the ones of a `stepper_instrumented`.
+/// @return the wrapped observer.
+template <class Observer, class Stats>
+auto with_stats(Observer &&observer, Stats &stats)
+{
+    return timed_observer<Observer, Stats>(std::forward<Observer>(observer), stats);
+}
+
+} // namespace numint
@@ -0,0 +1,593 @@
+/// @file stepper_abm.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Predictor-corrector multistep steppers implementing the
+/// Adams-Bashforth-Moulton formulas, with fixed and adaptive step-size.
+
+#pragma once
+
+#include "numint/detail/adams.hpp"
+#include "numint/detail/rotating_buffer.hpp"
+#include "numint/detail/less_with_sign.hpp"
+#include "numint/detail/type_traits.hpp"
+#include "numint/stepper/stepper_rk4.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+namespace numint
+{
+
+/// @brief Stepper implementing the Adams-Bashforth-Moulton predictor-corrector
+/// with `Steps` steps, which has order `Steps`.
+///
+/// @details Each step predicts the solution with the Adams-Bashforth formula,
+/// evaluates the system at the prediction, and corrects it with the
+/// Adams-Moulton formula of the same order (PECE). Hence, it evaluates the
+/// system twice per step, the derivative at the corrected solution being the
+/// first one of the next step. The corrector makes the formula far more stable
+/// and accurate than `stepper_adams_bashforth` of the same order.
+///
+/// The first `Steps - 1` steps are taken by `stepper_rk4`, and the history is
+/// handled as in `stepper_adams_bashforth`.
+///
+/// @tparam State The state vector type.
+/// @tparam Time The datatype used to hold time.
+/// @tparam Steps The number of steps of the predictor, from 1 to 8.
+template <class State, class Time, std::size_t Steps>
+class stepper_abm
+{
+    static_assert((Steps >= 1) && (Steps <= 8), "The Adams-Bashforth-Moulton formulas have from 1 to 8 steps.");
+
+public:
+    /// @brief Type used for the order of the stepper.
+    using order_type = unsigned short;
+
+    /// @brief Type used to keep track of time.
+    using time_type = Time;
+
+    /// @brief The state vector type.
+    using state_type = State;
+
+    /// @brief Type of value contained in the state vector.
+    using value_type = typename state_type::value_type;
+
+    /// @brief Indicates whether this is an adaptive stepper.
+    static constexpr bool is_adaptive_stepper = false;
+
+    /// @brief Constructs a new stepper.
+    stepper_abm() = default;
+
+    /// @brief Destructor.
+    ~stepper_abm() = default;
+
+    /// @brief Copy constructor.
+    /// @param other The logger instance to copy from.
+    stepper_abm(const stepper_abm &other) = delete;
+
+    /// @brief Move constructor.
+    /// @param other The logger instance to move from.
+    stepper_abm(stepper_abm &&other) noexcept = default;
+
+    /// @brief Copy assignment operator.
+    /// @param other The logger instance to copy from.
+    /// @return Reference to the logger instance.
+    auto operator=(const stepper_abm &other) -> stepper_abm & = delete;
+
+    /// @brief Move assignment operator.
+    /// @param other The logger instance to move from.
+    /// @return Reference to the logger instance.
+    auto operator=(stepper_abm &&other) noexcept -> stepper_abm & = default;
+
+    /// @brief Returns the order of the stepper.
+    /// @return The order of the formulas.
+    constexpr auto order_step() const -> order_type { return static_cast<order_type>(Steps); }
+
+    /// @brief Adjusts the size of the internal state vectors based on a reference.
+    /// @details It also discards the history.
+    /// @param reference A reference state vector used for size adjustment.
+    constexpr void adjust_size(const state_type &reference)
+    {
+        m_initializer.adjust_size(reference);
+        if constexpr (detail::has_resize<state_type>::value) {
+            for (std::size_t j = 0; j < Steps; ++j) {
+                m_derivatives[j].resize(reference.size());
+            }
+            m_dxdt.resize(reference.size());
+            m_x.resize(reference.size());
+        }
+        m_history = 0;
+    }
+
+    /// @brief Discards the data cached from the previous steps (e.g., after a discontinuity of the system).
+    /// @details Unlike `adjust_size`, it keeps the internal state vectors, and restarts the history.
+    void reset()
+    {
+        m_history = 0;
+    }
+
+    /// @brief Returns the number of steps executed by the stepper so far.
+    /// @return The number of integration steps executed.
+    constexpr auto steps() const { return m_steps; }
+
+    /// @brief Saves, or restores, the state carried by the stepper between the steps (see `numint/checkpoint.hpp`).
+    /// @details It includes the history of the derivatives, so that the next step continues it.
+    /// @tparam Archive The type of the archive.
+    /// @param archive The archive.
+    template <class Archive>
+    void serialize(Archive &archive)
+    {
+        archive(m_steps, m_derivatives, m_times, m_predictor, m_corrector, m_x, m_time, m_history);
+    }
+
+    /// @brief Performs a single integration step.
+    /// @tparam System The type of the system representing the differential equations.
+    /// @param system The system to integrate.
+    /// @param x The initial state vector.
+    /// @param t The initial time.
+    /// @param dt The time step for integration.
+    template <class System>
+    void do_step(System &&system, state_type &x, const time_type t, const time_type dt)
+    {
+        // Discard the history, if the state does not continue it.
+        if ((m_history > 0) &&
+            ((std::abs(t - m_time) > 0) || !std::equal(x.begin(), x.end(), m_x.begin()))) {
+            m_history = 0;
+        }
+
+        // Add the derivative at the beginning of the step to the history.
+        m_derivatives.rotate();
+        m_times.rotate();
+        std::forward<System>(system)(x, m_derivatives[0], t);
+        m_times[0] = t;
+        m_history  = std::min(m_history + 1, Steps);
+
+        if (m_history < Steps) {
+            // Not enough history yet, take the step with RK4, starting from the derivative we just evaluated.
+            m_initializer.do_step(std::forward<System>(system), x, m_derivatives[0], t, dt);
+        } else {
+            std::array<double, Steps> nodes{};
+            // Predict: m_x = x(t) + dt * sum_j b_j * f(t_j).
+            for (std::size_t j = 0; j < Steps; ++j) {
+                nodes[j] = static_cast<double>((m_times[j] - t) / dt);
+            }
+            const auto &predictor = m_predictor.weights(nodes, Steps);
+            std::copy(x.begin(), x.end(), m_x.begin());
+            for (std::size_t j = 0; j < Steps; ++j) {
+                const auto weight = static_cast<value_type>(dt * time_type(predictor[j]));
+                const auto &dxdt  = m_derivatives[j];
+                for (std::size_t i = 0; i < x.size(); ++i) {
+                    m_x[i] += weight * dxdt[i];
+                }
+            }
+            // Evaluate: m_dxdt = f(m_x, t + dt).
+            std::forward<System>(system)(m_x, m_dxdt, t + dt);
+            // Correct: x(t + dt) = x(t) + dt * (a_0 * m_dxdt + sum_j a_j+1 * f(t_j)).
+            nodes[0] = 1;
+            for (std::size_t j = 1; j < Steps; ++j) {
+                nodes[j] = static_cast<double>((m_times[j - 1] - t) / dt);
+            }
+            const auto &corrector = m_corrector.weights(nodes, Steps);
+            for (std::size_t j = 0; j < Steps; ++j) {
+                const auto weight = static_cast<value_type>(dt * time_type(corrector[j]));
+                const auto &dxdt  = (j == 0) ? m_dxdt : m_derivatives[j - 1];
+                for (std::size_t i = 0; i < x.size(); ++i) {
+                    x[i] += weight * dxdt[i];
+                }
+            }
+        }
+
+        // Keep track of where the history ends.
+        m_time = t + dt;
+        std::copy(x.begin(), x.end(), m_x.begin());
+        ++m_steps;
+    }
+
+private:
+    /// The stepper taking the first steps.
+    stepper_rk4<State, Time> m_initializer;
+    /// The derivatives of the previous steps, the most recent first.
+    detail::rotating_buffer<state_type, Steps> m_derivatives;
+    /// The times of the derivatives.
+    detail::rotating_buffer<time_type, Steps> m_times;
+    /// The weights of the predictor.
+    detail::adams_formula<Steps> m_predictor;
+    /// The weights of the corrector.
+    detail::adams_formula<Steps> m_corrector;
+    /// The derivative at the prediction.
+    state_type m_dxdt;
+    /// The prediction, and the state at the end of the last step.
+    state_type m_x{};
+    /// The time at the end of the last step.
+    time_type m_time{};
+    /// The number of derivatives in the history.
+    std::size_t m_history{};
+    /// The number of steps of integration.
+    uint64_t m_steps{};
+};
+
+/// @brief Adaptive stepper implementing the Adams-Bashforth-Moulton
+/// predictor-corrector, with variable step-size and variable order, from 1 to `Steps`.
+///
+/// @details Each step is a PECE pair of formulas of the same order, as in
+/// `stepper_abm`, whose weights are computed from the actual times of the
+/// history. The difference between the prediction and the correction
+/// estimates the local error (Milne's device), which is measured, for each
+/// element, against `tollerance * (1 + |x|)`, as a root mean square. Steps
+/// above the tolerance are retried with a smaller step-size.
+///
+/// The integration starts from order 1, and raises the order while the history
+/// grows. Once a step-size and an order were used for enough steps, the error
+/// of the neighbouring orders is estimated from the backward differences of
+/// the derivatives, and the order with the smallest error, which allows the
+/// largest step, is selected. Hence, no other stepper is needed to start the
+/// integration, which is restarted from order 1 whenever the state passed to
+/// `do_step` is not the one produced by the previous step.
+///
+/// Like `stepper_bdf`, the stepper controls its own step-size, retrieved with
+/// `get_time_delta()`, and it is meant to be used with `integrate_adaptive`.
+///
+/// @tparam State The state vector type.
+/// @tparam Time The datatype used to hold time.
+/// @tparam Steps The maximum order, from 1 to 8.
+template <class State, class Time, std::size_t Steps>
+class stepper_adaptive_abm
+{
+    static_assert((Steps >= 1) && (Steps <= 8), "The Adams-Bashforth-Moulton formulas have from 1 to 8 steps.");
+
+public:
+    /// @brief Type used for the order of the stepper.
+    using order_type                          = unsigned short;
+    /// @brief Type used to keep track of time.
+    using time_type                           = Time;
+    /// @brief The state vector.
+    using state_type                          = State;
+    /// @brief Type of value contained in the state vector.
+    using value_type                          = typename state_type::value_type;
+    /// @brief Determines if this is an adaptive stepper or not.
+    static constexpr bool is_adaptive_stepper = true;
+
+    /// @brief Constructs a new stepper.
+    stepper_adaptive_abm() = default;
+
+    /// @brief Destructor.
+    ~stepper_adaptive_abm() = default;
+
+    /// @brief Copy constructor.
+    /// @param other The logger instance to copy from.
+    stepper_adaptive_abm(const stepper_adaptive_abm &other) = delete;
+
+    /// @brief Move constructor.
+    /// @param other The logger instance to move from.
+    stepper_adaptive_abm(stepper_adaptive_abm &&other) noexcept = default;
+
+    /// @brief Copy assignment operator.
+    /// @param other The logger instance to copy from.
+    /// @return Reference to the logger instance.
+    auto operator=(const stepper_adaptive_abm &other) -> stepper_adaptive_abm & = delete;
+
+    /// @brief Move assignment operator.
+    /// @param other The logger instance to move from.
+    /// @return Reference to the logger instance.
+    auto operator=(stepper_adaptive_abm &&other) noexcept -> stepper_adaptive_abm & = default;
+
+    /// @brief Sets the tollerance.
+    /// @param tollerance the tollerance to set.
+    constexpr void set_tollerance(value_type tollerance) { m_tollerance = tollerance; }
+
+    /// @brief Sets the minimum step-size.
+    /// @param min_delta the minimum step-size.
+    constexpr void set_min_delta(time_type min_delta) { m_min_delta = min_delta; }
+
+    /// @brief Sets the maximum step-size.
+    /// @param max_delta the maximum step-size.
+    constexpr void set_max_delta(time_type max_delta) { m_max_delta = max_delta; }
+
+    /// @brief Sets the maximum number of times a rejected step is retried.
+    /// @details Once the retries are exhausted, the last attempt is accepted
+    /// even if its error is above the tolerance.
+    /// @param max_retries the maximum number of retries.
+    constexpr void set_max_retries(unsigned max_retries) { m_max_retries = max_retries; }
+
+    /// @brief Returns the current order of the formulas.
+    /// @return the order.
+    constexpr auto order_step() const -> order_type { return static_cast<order_type>(m_order); }
+
+    /// @brief Returns the step-size proposed for the next step.
+    /// @return the step-size.
+    constexpr auto get_time_delta() const -> time_type { return m_time_delta; }
+
+    /// @brief Returns the step-size used by the last step.
+    /// @return the step-size.
+    constexpr auto get_last_time_delta() const -> time_type { return m_last_time_delta; }
+
+    /// @brief Adjusts the size of the internal state vectors based on a reference.
+    /// @details It also discards the history, which restarts the integration from order 1.
+    /// @param reference A reference state vector used for size adjustment.
+    void adjust_size(const state_type &reference)
+    {
+        if constexpr (detail::has_resize<state_type>::value) {
+            for (std::size_t j = 0; j <= Steps; ++j) {
+                m_derivatives[j].resize(reference.size());
+                m_differences[j].resize(reference.size());
+            }
+            m_dxdt.resize(reference.size());
+            m_xp.resize(reference.size());
+            m_x.resize(reference.size());
+        }
+        m_history = 0;
+    }
+
+    /// @brief Discards the data cached from the previous steps (e.g., after a discontinuity of the system).
+    /// @details Unlike `adjust_size`, it keeps the internal state vectors, and restarts the history.
+    void reset()
+    {
+        m_history = 0;
+    }
+
+    /// @brief Returns the number of steps the stepper executed up until now.
+    /// @return the number of integration steps.
+    constexpr auto steps() const { return m_steps; }
+
+    /// @brief Returns the number of rejected steps.
+    /// @return the number of rejected steps.
+    constexpr auto rejections() const { return m_rejections; }
+
+    /// @brief Saves, or restores, the state carried by the stepper between the steps (see `numint/checkpoint.hpp`).
+    /// @details It includes the history of the derivatives, so that the next step continues it.
+    /// @tparam Archive The type of the archive.
+    /// @param archive The archive.
+    template <class Archive>
+    void serialize(Archive &archive)
+    {
+        archive(m_steps, m_rejections, m_derivatives, m_times, m_predictor, m_corrector, m_x, m_time_delta,
+                m_last_time_delta, m_time, m_order, m_history, m_equal_steps);
+    }
+
+    /// @brief Performs one integration step.
+    ///
+    /// @details When the integration starts, or restarts, the step begins
+    /// with the step-size dt, otherwise with the one proposed by the previous
+    /// step. The step-size that was actually used is returned by
+    /// `get_last_time_delta()`, the one proposed for the next step by
+    /// `get_time_delta()`.
+    ///
+    /// @tparam System The type of the system being integrated.
+    /// @param system The system that defines the equations of motion or dynamics.
+    /// @param x The state of the system, which will be updated after this step.
+    /// @param t The current time.
+    /// @param dt The time step to use for the integration.
+    template <class System>
+    void do_step(System &&system, state_type &x, const time_type t, const time_type dt)
+    {
+        // Restart from order 1, if the state does not continue the history.
+        if ((m_history == 0) || (std::abs(t - m_time) > 0) || !std::equal(x.begin(), x.end(), m_x.begin())) {
+            m_history     = 0;
+            m_order       = 1;
+            m_equal_steps = 0;
+            m_time_delta  = this->clamp(dt);
+        } else {
+            // Do not step beyond what the caller asked (e.g., the end of the integration).
+            m_time_delta = this->clamp(detail::less_with_sign(dt, m_time_delta, dt) ? dt : m_time_delta);
+        }
+
+        // Add the derivative at the beginning of the step to the history.
+        m_derivatives.rotate();
+        m_times.rotate();
+        std::forward<System>(system)(x, m_derivatives[0], t);
+        m_times[0] = t;
+        m_history  = std::min(m_history + 1, Steps + 1);
+        m_order    = std::min(m_order, m_history);
+
+        value_type error_norm = 0;
+        for (unsigned retry = 0;; ++retry) {
+            const time_type h = m_time_delta;
+            std::array<double, Steps> nodes{};
+            // Predict: m_xp = x(t) + h * sum_j b_j * f(t_j).
+            for (std::size_t j = 0; j < m_order; ++j) {
+                nodes[j] = static_cast<double>((m_times[j] - t) / h);
+            }
+            const auto &predictor = m_predictor.weights(nodes, m_order);
+            std::copy(x.begin(), x.end(), m_xp.begin());
+            for (std::size_t j = 0; j < m_order; ++j) {
+                const auto weight = static_cast<value_type>(h * time_type(predictor[j]));
+                const auto &dxdt  = m_derivatives[j];
+                for (std::size_t i = 0; i < x.size(); ++i) {
+                    m_xp[i] += weight * dxdt[i];
+                }
+            }
+            // Evaluate: m_dxdt = f(m_xp, t + h).
+            std::forward<System>(system)(m_xp, m_dxdt, t + h);
+            // Correct: m_x = x(t) + h * (a_0 * m_dxdt + sum_j a_j+1 * f(t_j)).
+            nodes[0] = 1;
+            for (std::size_t j = 1; j < m_order; ++j) {
+                nodes[j] = static_cast<double>((m_times[j - 1] - t) / h);
+            }
+            const auto &corrector = m_corrector.weights(nodes, m_order);
+            std::copy(x.begin(), x.end(), m_x.begin());
+            for (std::size_t j = 0; j < m_order; ++j) {
+                const auto weight = static_cast<value_type>(h * time_type(corrector[j]));
+                const auto &dxdt  = (j == 0) ? m_dxdt : m_derivatives[j - 1];
+                for (std::size_t i = 0; i < x.size(); ++i) {
+                    m_x[i] += weight * dxdt[i];
+                }
+            }
+
+            // Estimate the local error of the corrector, from its distance to the prediction.
+            const double milne = std::abs(
+                detail::adams_moulton_error[m_order] /
+                (detail::adams_bashforth_error[m_order] - detail::adams_moulton_error[m_order]));
+            error_norm = 0;
+            for (std::size_t i = 0; i < x.size(); ++i) {
+                const value_type scale = m_tollerance * (1 + std::abs(m_x[i]));
+                error_norm += square((m_x[i] - m_xp[i]) / scale);
+            }
+            error_norm = static_cast<value_type>(milne) * std::sqrt(error_norm / static_cast<value_type>(x.size()));
+
+            // Reject the step if the error is above the tolerance, unless we cannot do better.
+            if ((error_norm > 1) && (m_min_delta < std::abs(m_time_delta)) && (retry < m_max_retries)) {
+                m_time_delta  = this->clamp(h * static_cast<time_type>(this->factor(error_norm, m_order)));
+                m_equal_steps = 0;
+                ++m_rejections;
+                continue;
+            }
+            break;
+        }
+
+        // Accept the step.
+        m_last_time_delta = m_time_delta;
+        m_time            = t + m_time_delta;
+        std::copy(m_x.begin(), m_x.end(), x.begin());
+        ++m_steps;
+
+        // Propose the next step-size, changing the order once the current one was used for enough steps.
+        double factor = this->factor(error_norm, m_order);
+        if (++m_equal_steps > m_order) {
+            factor        = this->select_order(error_norm);
+            m_equal_steps = 0;
+        }
+        m_time_delta = this->clamp(m_time_delta * static_cast<time_type>(factor));
+    }
+
+private:
+    /// @brief The smallest reduction of the step-size.
+    static constexpr double min_factor = 0.2;
+    /// @brief The largest increase of the step-size.
+    static constexpr double max_factor = 2;
+
+    /// @brief Returns the square of a value.
+    /// @param value the value.
+    /// @return the square of the value.
+    static constexpr auto square(value_type value) -> value_type { return value * value; }
+
+    /// @brief Returns the factor scaling the step-size, to meet the tolerance.
+    /// @param error_norm the norm of the error.
+    /// @param order the order of the formulas.
+    /// @return the factor.
+    static auto factor(value_type error_norm, std::size_t order) -> double
+    {
+        if (!(error_norm > 0)) {
+            return max_factor;
+        }
+        const double exponent = -1. / static_cast<double>(order + 1);
+        return std::clamp(0.9 * std::pow(static_cast<double>(error_norm), exponent), min_factor, max_factor);
+    }
+
+    /// @brief Limits the step-size.
+    /// @param dt the step-size.
+    /// @return the limited step-size.
+    constexpr auto clamp(time_type dt) const -> time_type
+    {
+        return detail::clamp_with_sign(dt, m_min_delta, m_max_delta);
+    }
+
+    /// @brief Selects the order of the next steps, among the current one and its neighbours.
+    ///
+    /// @details The local error of the corrector of order k is proportional
+    /// to the k-th backward difference of the derivatives, which, for
+    /// variable step-sizes, is obtained from the divided differences over the
+    /// times of the history, scaled by the current step-size.
+    ///
+    /// @param error_norm the estimated error of the last step.
+    /// @return the factor scaling the step-size, for the selected order.
+    auto select_order(value_type error_norm) -> double
+    {
+        const std::size_t size   = m_x.size();
+        const std::size_t levels = std::min({m_order + 1, m_history - 1, Steps});
+        if (levels < m_order) {
+            return this->factor(error_norm, m_order);
+        }
+        // Divided differences of the derivatives: after the loop, m_differences[l] = f[t_0, ..., t_l].
+        for (std::size_t j = 0; j <= levels; ++j) {
+            std::copy(m_derivatives[j].begin(), m_derivatives[j].end(), m_differences[j].begin());
+        }
+        for (std::size_t l = 1; l <= levels; ++l) {
+            for (std::size_t j = levels; j >= l; --j) {
+                const auto step = static_cast<value_type>(m_times[j - l] - m_times[j]);
+                for (std::size_t i = 0; i < size; ++i) {
+                    m_differences[j][i] = (m_differences[j - 1][i] - m_differences[j][i]) / step;
+                }
+            }
+        }
+        // Estimate the error of the orders around the current one.
+        std::array<value_type, Steps + 2> errors{};
+        errors.fill(std::numeric_limits<value_type>::max());
+        for (std::size_t k = std::max(std::size_t(1), m_order - 1); k <= levels; ++k) {
+            // The backward difference, scaled: h^k * k! * f[t_0, ..., t_k].
+            double scale = 1;
+            for (std::size_t l = 1; l <= k; ++l) {
+                scale *= static_cast<double>(m_last_time_delta) * static_cast<double>(l);
+            }
+            scale *= std::abs(detail::adams_moulton_error[k]) * static_cast<double>(m_last_time_delta);
+            value_type norm = 0;
+            for (std::size_t i = 0; i < size; ++i) {
+                norm += square(static_cast<value_type>(scale) * m_differences[k][i] /
+                               (m_tollerance * (1 + std::abs(m_x[i]))));
+            }
+            errors[k] = std::sqrt(norm / static_cast<value_type>(size));
+        }
+        // Prefer the order allowing the largest step.
+        std::size_t order = m_order;
+        double factor     = this->factor(errors[m_order], m_order);
+        if (m_order > 1) {
+            const double lower = this->factor(errors[m_order - 1], m_order - 1);
+            if (lower > factor) {
+                order = m_order - 1, factor = lower;
+            }
+        }
+        if ((m_order < Steps) && (levels > m_order)) {
+            const double higher = this->factor(errors[m_order + 1], m_order + 1);
+            if (higher > factor) {
+                order = m_order + 1, factor = higher;
+            }
+        }
+        m_order = order;
+        return factor;
+    }
+
+    /// The derivatives of the previous steps, the most recent first.
+    detail::rotating_buffer<state_type, Steps + 1> m_derivatives;
+    /// The times of the derivatives.
+    detail::rotating_buffer<time_type, Steps + 1> m_times;
+    /// Support vectors for the divided differences of the derivatives.
+    std::array<state_type, Steps + 1> m_differences;
+    /// The weights of the predictor.
+    detail::adams_formula<Steps> m_predictor;
+    /// The weights of the corrector.
+    detail::adams_formula<Steps> m_corrector;
+    /// The derivative at the prediction.
+    state_type m_dxdt;
+    /// The prediction.
+    state_type m_xp;
+    /// The correction, and the state at the end of the last step.
+    state_type m_x{};
+    /// The tollerance value we use to tune the step-size.
+    value_type m_tollerance{value_type(0.0001)};
+    /// The step-size.
+    time_type m_time_delta{time_type(1e-12)};
+    /// The minimum step-size.
+    time_type m_min_delta{time_type(1e-12)};
+    /// The maximum step-size.
+    time_type m_max_delta{1};
+    /// The step-size used by the last accepted step.
+    time_type m_last_time_delta{};
+    /// The time at the end of the last step.
+    time_type m_time{};
+    /// The order of the formulas.
+    std::size_t m_order{1};
+    /// The number of derivatives in the history.
+    std::size_t m_history{};
+    /// The number of steps executed with the current order and step-size.
+    std::size_t m_equal_steps{};
+    /// The maximum number of retries of a rejected step.
+    unsigned m_max_retries{10};
+    /// The number of steps of integration.
+    uint64_t m_steps{};
+    /// The number of rejected steps.
+    uint64_t m_rejections{};
+};
+
+} // namespace numint
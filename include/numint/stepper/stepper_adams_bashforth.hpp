@@ -0,0 +1,189 @@
+/// @file stepper_adams_bashforth.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Explicit multistep stepper implementing the Adams-Bashforth formulas.
+
+#pragma once
+
+#include "numint/detail/adams.hpp"
+#include "numint/detail/rotating_buffer.hpp"
+#include "numint/detail/type_traits.hpp"
+#include "numint/stepper/stepper_rk4.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+namespace numint
+{
+
+/// @brief Stepper implementing the Adams-Bashforth formula with `Steps` steps,
+/// which has order `Steps`.
+///
+/// @details Each step evaluates the system only once, at the beginning of the
+/// step, and combines the derivative with the ones of the previous steps, kept
+/// in a `detail::rotating_buffer`. The first `Steps - 1` steps, which do not
+/// have enough history, are taken by `stepper_rk4`. The weights of the
+/// formula are computed from the actual times of the history, so that the
+/// step-size can change between the steps.
+///
+/// The history is discarded by `adjust_size`, and whenever the state passed to
+/// `do_step` is not the one produced by the previous step (e.g., after an
+/// event changed it).
+///
+/// @tparam State The state vector type.
+/// @tparam Time The datatype used to hold time.
+/// @tparam Steps The number of steps of the formula, from 1 to 8.
+template <class State, class Time, std::size_t Steps>
+class stepper_adams_bashforth
+{
+    static_assert((Steps >= 1) && (Steps <= 8), "The Adams-Bashforth formulas have from 1 to 8 steps.");
+
+public:
+    /// @brief Type used for the order of the stepper.
+    using order_type = unsigned short;
+
+    /// @brief Type used to keep track of time.
+    using time_type = Time;
+
+    /// @brief The state vector type.
+    using state_type = State;
+
+    /// @brief Type of value contained in the state vector.
+    using value_type = typename state_type::value_type;
+
+    /// @brief Indicates whether this is an adaptive stepper.
+    static constexpr bool is_adaptive_stepper = false;
+
+    /// @brief Constructs a new stepper.
+    stepper_adams_bashforth() = default;
+
+    /// @brief Destructor.
+    ~stepper_adams_bashforth() = default;
+
+    /// @brief Copy constructor.
+    /// @param other The logger instance to copy from.
+    stepper_adams_bashforth(const stepper_adams_bashforth &other) = delete;
+
+    /// @brief Move constructor.
+    /// @param other The logger instance to move from.
+    stepper_adams_bashforth(stepper_adams_bashforth &&other) noexcept = default;
+
+    /// @brief Copy assignment operator.
+    /// @param other The logger instance to copy from.
+    /// @return Reference to the logger instance.
+    auto operator=(const stepper_adams_bashforth &other) -> stepper_adams_bashforth & = delete;
+
+    /// @brief Move assignment operator.
+    /// @param other The logger instance to move from.
+    /// @return Reference to the logger instance.
+    auto operator=(stepper_adams_bashforth &&other) noexcept -> stepper_adams_bashforth & = default;
+
+    /// @brief Returns the order of the stepper.
+    /// @return The order of the formula.
+    constexpr auto order_step() const -> order_type { return static_cast<order_type>(Steps); }
+
+    /// @brief Adjusts the size of the internal state vectors based on a reference.
+    /// @details It also discards the history.
+    /// @param reference A reference state vector used for size adjustment.
+    constexpr void adjust_size(const state_type &reference)
+    {
+        m_initializer.adjust_size(reference);
+        if constexpr (detail::has_resize<state_type>::value) {
+            for (std::size_t j = 0; j < Steps; ++j) {
+                m_derivatives[j].resize(reference.size());
+            }
+            m_x.resize(reference.size());
+        }
+        m_history = 0;
+    }
+
+    /// @brief Discards the data cached from the previous steps (e.g., after a discontinuity of the system).
+    /// @details Unlike `adjust_size`, it keeps the internal state vectors, and restarts the history.
+    void reset()
+    {
+        m_history = 0;
+    }
+
+    /// @brief Returns the number of steps executed by the stepper so far.
+    /// @return The number of integration steps executed.
+    constexpr auto steps() const { return m_steps; }
+
+    /// @brief Saves, or restores, the state carried by the stepper between the steps (see `numint/checkpoint.hpp`).
+    /// @details It includes the history of the derivatives, so that the next step continues it.
+    /// @tparam Archive The type of the archive.
+    /// @param archive The archive.
+    template <class Archive>
+    void serialize(Archive &archive)
+    {
+        archive(m_steps, m_derivatives, m_times, m_formula, m_x, m_time, m_history);
+    }
+
+    /// @brief Performs a single integration step.
+    /// @tparam System The type of the system representing the differential equations.
+    /// @param system The system to integrate.
+    /// @param x The initial state vector.
+    /// @param t The initial time.
+    /// @param dt The time step for integration.
+    template <class System>
+    void do_step(System &&system, state_type &x, const time_type t, const time_type dt)
+    {
+        // Discard the history, if the state does not continue it.
+        if ((m_history > 0) &&
+            ((std::abs(t - m_time) > 0) || !std::equal(x.begin(), x.end(), m_x.begin()))) {
+            m_history = 0;
+        }
+
+        // Add the derivative at the beginning of the step to the history.
+        m_derivatives.rotate();
+        m_times.rotate();
+        std::forward<System>(system)(x, m_derivatives[0], t);
+        m_times[0] = t;
+        m_history  = std::min(m_history + 1, Steps);
+
+        if (m_history < Steps) {
+            // Not enough history yet, take the step with RK4, starting from the derivative we just evaluated.
+            m_initializer.do_step(std::forward<System>(system), x, m_derivatives[0], t, dt);
+        } else {
+            // x(t + dt) = x(t) + dt * sum_j b_j * f(t_j).
+            std::array<double, Steps> nodes{};
+            for (std::size_t j = 0; j < Steps; ++j) {
+                nodes[j] = static_cast<double>((m_times[j] - t) / dt);
+            }
+            const auto &weights = m_formula.weights(nodes, Steps);
+            for (std::size_t j = 0; j < Steps; ++j) {
+                const auto weight = static_cast<value_type>(dt * time_type(weights[j]));
+                const auto &dxdt  = m_derivatives[j];
+                for (std::size_t i = 0; i < x.size(); ++i) {
+                    x[i] += weight * dxdt[i];
+                }
+            }
+        }
+
+        // Keep track of where the history ends.
+        m_time = t + dt;
+        std::copy(x.begin(), x.end(), m_x.begin());
+        ++m_steps;
+    }
+
+private:
+    /// The stepper taking the first steps.
+    stepper_rk4<State, Time> m_initializer;
+    /// The derivatives of the previous steps, the most recent first.
+    detail::rotating_buffer<state_type, Steps> m_derivatives;
+    /// The times of the derivatives.
+    detail::rotating_buffer<time_type, Steps> m_times;
+    /// The weights of the formula.
+    detail::adams_formula<Steps> m_formula;
+    /// The state at the end of the last step.
+    state_type m_x{};
+    /// The time at the end of the last step.
+    time_type m_time{};
+    /// The number of derivatives in the history.
+    std::size_t m_history{};
+    /// The number of steps of integration.
+    uint64_t m_steps{};
+};
+
+} // namespace numint
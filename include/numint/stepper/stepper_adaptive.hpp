@@ -5,12 +5,16 @@
 
 #pragma once
 
+#include "numint/controller.hpp"
 #include "numint/detail/it_algebra.hpp"
+#include "numint/detail/less_with_sign.hpp"
 #include "numint/detail/type_traits.hpp"
 
+#include <algorithm>
 #include <cmath>
 #include <cstdint>
-#include <iostream>
+#include <limits>
+#include <type_traits>
 
 namespace numint
 {
@@ -19,21 +23,36 @@ namespace numint
 enum class ErrorFormula : unsigned char {
     Absolute, ///< Use the absolute truncation error.
     Relative, ///< Use the relative truncation error.
-    Mixed     ///< Use a mixed absolute and relative truncation error.
+    Mixed,    ///< Use a mixed absolute and relative truncation error.
+    Weighted  ///< Use the root mean square of the truncation error, weighted by absolute and relative tolerances.
 };
 
 /// @brief It dynamically controlls the step-size of a stepper.
+///
+/// @details The truncation error is estimated by comparing a full step with
+/// `Iterations` smaller steps (step doubling). If the stepper provides an
+/// embedded solution (e.g., `stepper_dopri5`), that solution is used instead,
+/// which avoids the additional sub-steps altogether.
+///
 /// @tparam Stepper The stepper we rely upon.
 /// @tparam Iterations The number of iterations we are going to do while
 /// integrating, higher values means more accurate results, but computationally
-/// expensive.
+/// expensive. It is ignored by steppers providing an embedded solution.
 /// @tparam Error The type of error formula we rely upon.
-template <class Stepper, int Iterations = 2, ErrorFormula Error = ErrorFormula::Absolute>
+/// @tparam Controller The step-size controller (e.g., `controller_i`,
+/// `controller_pi`, or `controller_pid`).
+template <
+    class Stepper,
+    int Iterations     = 2,
+    ErrorFormula Error = ErrorFormula::Absolute,
+    class Controller   = controller_i<typename Stepper::time_type>>
 class stepper_adaptive
 {
 public:
     /// @brief Type of internal fixed-step stepper we are using.
     using stepper_type                        = Stepper;
+    /// @brief Type of step-size controller we are using.
+    using controller_type                     = Controller;
     /// @brief Type used for the order of the stepper.
     using order_type                          = typename Stepper::order_type;
     /// @brief Type used to keep track of time.
@@ -42,6 +61,8 @@ public:
     using state_type                          = typename Stepper::state_type;
     /// @brief Type of value contained in the state vector.
     using value_type                          = typename Stepper::state_type::value_type;
+    /// @brief Type used to accumulate the squares of the scaled errors.
+    using accumulator_type                    = detail::accumulator_t<value_type>;
     /// @brief Determines if this is an adaptive stepper or not.
     static constexpr bool is_adaptive_stepper = true;
 
@@ -49,13 +70,18 @@ public:
     stepper_adaptive()
         : m_stepper_main()
         , m_stepper_tuner()
-        , m_tollerance(0.0001)
-        , m_time_delta(1e-12)
-        , m_min_delta(1e-12)
+        , m_controller()
+        , m_y0()
+        , m_y1()
+        , m_tollerance(time_type(0.0001))
+        , m_time_delta(time_type(1e-12))
+        , m_min_delta(time_type(1e-12))
         , m_max_delta(1)
         , m_t_err(.0)
         , m_t_err_abs(.0)
         , m_t_err_rel(.0)
+        , m_last_time_delta(.0)
+        , m_max_retries(10)
 
     {
         // Nothing to do.
@@ -84,11 +110,56 @@ public:
 
     /// @brief Sets the tolerance for step-size control.
     ///
+    /// @details With `ErrorFormula::Weighted`, it is used as both the absolute
+    /// and the relative tolerance of every element (see `set_tollerances`).
+    ///
     /// @param tollerance The tolerance value to use for adjusting the step size.
-    constexpr void set_tollerance(value_type tollerance) { m_tollerance = tollerance; }
+    void set_tollerance(value_type tollerance)
+    {
+        m_tollerance = tollerance;
+        this->set_tollerances(tollerance, tollerance);
+    }
+
+    /// @brief Sets the absolute and the relative tolerances of every element, used by `ErrorFormula::Weighted`.
+    ///
+    /// @details The error of each element is scaled by `atol + rtol * |x_i|`,
+    /// where |x_i| is the largest magnitude of the element at the beginning
+    /// and at the end of the step, and the step is accepted when the root mean
+    /// square of the scaled errors is below 1. The scale is floored to the
+    /// smallest normal value, still, a zero absolute tolerance makes elements
+    /// which stay close to zero control the step-size.
+    ///
+    /// @param atol The absolute tolerance.
+    /// @param rtol The relative tolerance.
+    void set_tollerances(value_type atol, value_type rtol)
+    {
+        m_atol                  = atol;
+        m_rtol                  = rtol;
+        m_component_tollerances = false;
+        std::fill(m_atols.begin(), m_atols.end(), m_atol);
+        std::fill(m_rtols.begin(), m_rtols.end(), m_rtol);
+    }
+
+    /// @brief Sets the absolute and the relative tolerances of each element, used by `ErrorFormula::Weighted`.
+    ///
+    /// @details It allows to integrate states whose elements have different
+    /// magnitudes (e.g., positions in meters and currents in milliamperes).
+    /// Both vectors must have the same size of the state.
+    ///
+    /// @param atol The absolute tolerance of each element.
+    /// @param rtol The relative tolerance of each element.
+    void set_tollerances(const state_type &atol, const state_type &rtol)
+    {
+        m_atols                 = atol;
+        m_rtols                 = rtol;
+        m_component_tollerances = true;
+    }
 
     /// @brief Sets the minimum allowed step size.
     ///
+    /// @details The bounds of the step size are positive, and apply to its
+    /// magnitude, also when integrating backward in time.
+    ///
     /// @param min_delta The minimum step size.
     constexpr void set_min_delta(value_type min_delta) { m_min_delta = min_delta; }
 
@@ -97,6 +168,25 @@ public:
     /// @param max_delta The maximum step size.
     constexpr void set_max_delta(value_type max_delta) { m_max_delta = max_delta; }
 
+    /// @brief Sets the maximum number of times a step is retried after being rejected.
+    ///
+    /// @details Once the retries are exhausted, the last attempt is accepted
+    /// regardless of its error, the same happens when the step-size reaches
+    /// the minimum step size.
+    ///
+    /// @param max_retries The maximum number of retries.
+    constexpr void set_max_retries(unsigned max_retries) { m_max_retries = max_retries; }
+
+    /// @brief Provides access to the step-size controller, e.g., to tune its gains.
+    /// @return A reference to the controller.
+    constexpr auto controller() -> controller_type & { return m_controller; }
+
+    /// @brief Provides access to the main stepper, e.g., to set up its linear solver.
+    /// @details With step doubling, the sub-steps are computed by a second
+    /// stepper, which is not affected.
+    /// @return A reference to the main stepper.
+    constexpr auto stepper() -> stepper_type & { return m_stepper_main; }
+
     /// @brief The order of the stepper we rely upon.
     /// @return the order of the internal stepper.
     constexpr auto order_step() const -> order_type { return m_stepper_main.order_step(); }
@@ -105,18 +195,86 @@ public:
     /// @return The current step size as a `time_type` value.
     constexpr auto get_time_delta() const -> time_type { return m_time_delta; }
 
+    /// @brief Retrieves the step size used by the last accepted step.
+    /// @details It can be smaller than the one requested, if the first
+    /// attempts were rejected.
+    /// @return The last step size as a `time_type` value.
+    constexpr auto get_last_time_delta() const -> time_type { return m_last_time_delta; }
+
+    /// @brief Retrieves the ratio between the estimated error and the tolerance of the last accepted step.
+    /// @details Values above 1 mean that the step was accepted only because
+    /// the step-size reached the minimum, or the retries were exhausted.
+    /// @return The ratio of the last accepted step.
+    constexpr auto get_last_error_ratio() const -> value_type { return m_last_error_ratio; }
+
     /// @brief Adjusts the size of the internal state vectors.
+    /// @details This is the only place where the stepper allocates memory,
+    /// the following calls to `do_step` reuse the internal state vectors.
     /// @param reference a reference state vector vector.
     void adjust_size(const state_type &reference)
     {
+        if constexpr (detail::has_resize<state_type>::value) {
+            // The solution (0) is not stored when the stepper provides the embedded solution.
+            if constexpr (!detail::is_embedded_stepper_v<stepper_type>) {
+                m_y0.resize(reference.size());
+            }
+            m_y1.resize(reference.size());
+        }
+        // Size the tolerances of the elements, unless they were provided one by one.
+        if constexpr (Error == ErrorFormula::Weighted) {
+            if (!m_component_tollerances) {
+                if constexpr (detail::has_resize<state_type>::value) {
+                    m_atols.resize(reference.size());
+                    m_rtols.resize(reference.size());
+                }
+                std::fill(m_atols.begin(), m_atols.end(), m_atol);
+                std::fill(m_rtols.begin(), m_rtols.end(), m_rtol);
+            }
+        }
+        // Discard the error history of the previous integrations.
+        m_controller.reset();
         m_stepper_main.adjust_size(reference);
-        m_stepper_tuner.adjust_size(reference);
+        // The tuner is not needed when the stepper provides the embedded solution.
+        if constexpr (!detail::is_embedded_stepper_v<stepper_type>) {
+            m_stepper_tuner.adjust_size(reference);
+        }
+    }
+
+    /// @brief Discards the data cached from the previous steps (e.g., after a discontinuity of the system).
+    /// @details Unlike `adjust_size`, it keeps the internal state vectors, while
+    /// the history of the controller is discarded.
+    void reset()
+    {
+        m_controller.reset();
+        detail::reset_stepper(m_stepper_main, m_y1);
+        if constexpr (!detail::is_embedded_stepper_v<stepper_type>) {
+            detail::reset_stepper(m_stepper_tuner, m_y1);
+        }
     }
 
     /// @brief Returns the number of steps the stepper executed up until now.
     /// @return the number of integration steps.
     constexpr auto steps() const { return m_steps; }
 
+    /// @brief Returns the number of steps that were rejected and retried up until now.
+    /// @return the number of rejected steps.
+    constexpr auto rejections() const { return m_rejections; }
+
+    /// @brief Saves, or restores, the state carried by the stepper between the steps (see `numint/checkpoint.hpp`).
+    /// @details It includes the state of the wrapped steppers, and the history of the controller.
+    /// @tparam Archive The type of the archive.
+    /// @param archive The archive.
+    template <class Archive>
+    void serialize(Archive &archive)
+    {
+        m_stepper_main.serialize(archive);
+        if constexpr (!detail::is_embedded_stepper_v<stepper_type>) {
+            m_stepper_tuner.serialize(archive);
+        }
+        m_controller.serialize(archive);
+        archive(m_time_delta, m_last_time_delta, m_last_error_ratio, m_steps, m_rejections);
+    }
+
     /// @brief Performs one integration step using the provided system.
     ///
     /// @details This function advances the state of the system by one step
@@ -129,6 +287,17 @@ public:
     ///     y_{n + 0.5} = y_n + 0.5 * h * f(t_n, y_n)
     ///     y_{n + 1} = y_{n + 0.5} + 0.5 * h * f(t_n, y_n)
     ///
+    /// When the stepper provides an embedded solution, (0) is the embedded
+    /// solution, and (1) is the main one, both computed by a single step.
+    ///
+    /// If the truncation error is above the tolerance, the step is rejected,
+    /// and it is retried from the initial state with a smaller step-size.
+    /// Only the accepted solution is written back to `x`, and the step-size
+    /// actually used is returned by `get_last_time_delta()`.
+    ///
+    /// The solutions are computed inside internal state vectors, sized by
+    /// `adjust_size`, hence no memory is allocated by this function.
+    ///
     /// @tparam System The type of the system being integrated.
     ///
     /// @param system The system that defines the equations of motion or dynamics.
@@ -138,110 +307,243 @@ public:
     template <class System>
     constexpr void do_step(System &&system, state_type &x, const time_type t, const time_type dt)
     {
-        using detail::it_algebra::max_abs_diff;
-        using detail::it_algebra::max_comb_diff;
-        using detail::it_algebra::max_rel_diff;
-
         // Copy the step size.
         m_time_delta = dt;
-        // Copy the initial state.
-        state_type y(x);
-        // Compute values of (0).
-        m_stepper_main.do_step(std::forward<System>(system), y, t, m_time_delta);
-        // Compute values of (1).
-        if constexpr (Iterations <= 2) {
-            const time_type dh = m_time_delta * .5;
-            m_stepper_tuner.do_step(std::forward<System>(system), x, t + dh, dh);
-            m_stepper_tuner.do_step(std::forward<System>(system), x, t + m_time_delta, dh);
-        } else {
-            const time_type dh = m_time_delta * (1. / Iterations);
-            for (unsigned i = 0; i < Iterations; ++i) {
-                m_stepper_tuner.do_step(std::forward<System>(system), x, t + (dh * i), dh);
+        for (unsigned retry = 0;; ++retry) {
+            // Start both solutions from the initial state, the embedded
+            // solution is not stored at all.
+            if constexpr (!detail::is_embedded_stepper_v<stepper_type>) {
+                std::copy(x.begin(), x.end(), m_y0.begin());
             }
+            std::copy(x.begin(), x.end(), m_y1.begin());
+            // Compute both solutions, and the ratio between the error and the tolerance.
+            const value_type ratio = this->compute_error_ratio(std::forward<System>(system), x, t);
+            // Accept the step if the error is within the tolerance, or if we
+            // cannot do better (step-size at the minimum, or no more retries).
+            if ((ratio <= 1) || !(m_min_delta < std::abs(m_time_delta)) || (retry >= m_max_retries)) {
+                // Update the state.
+                std::copy(m_y1.begin(), m_y1.end(), x.begin());
+                // Keep track of the step-size we used, and of its error.
+                m_last_time_delta  = m_time_delta;
+                m_last_error_ratio = ratio;
+                // Update the time-delta, preventing it from growing right after a rejection.
+                this->update_time_delta(ratio, true, retry > 0);
+                // Increase the number of steps.
+                ++m_steps;
+                break;
+            }
+            // Reject the step, and reduce the time-delta.
+            this->update_time_delta(ratio, false, true);
+            // Increase the number of rejected steps.
+            ++m_rejections;
         }
-        // Calculate truncation error.
-        if constexpr (Error == ErrorFormula::Absolute) {
-            // Get absolute truncation error.
-            m_t_err_abs = max_abs_diff<value_type>(x.begin(), x.end(), y.begin(), y.end());
-            // Update the time-delta.
-            m_time_delta *= 0.9 * std::min(std::max(std::pow(m_tollerance / (2 * m_t_err_abs), 0.2), 0.3), 2.);
-        } else if constexpr (Error == ErrorFormula::Relative) {
-            // Get relative truncation error.
-            m_t_err_rel = max_rel_diff<value_type>(x.begin(), x.end(), y.begin(), y.end());
-            // Update the time-delta.
-            m_time_delta *= 0.9 * std::min(std::max(std::pow(m_tollerance / (2 * m_t_err_rel), 0.2), 0.3), 2.);
+    }
+
+    /// @brief Interpolates the last accepted step, with the continuous extension of the stepper.
+    ///
+    /// @details Available only when the stepper provides both an embedded
+    /// solution and its own dense output, because the stages left by the
+    /// last call of the stepper must belong to the accepted step.
+    ///
+    /// @param x0 The state at the beginning of the last step.
+    /// @param x1 The state at the end of the last step.
+    /// @param dt The step-size of the last step.
+    /// @param theta The position inside the step, between 0 and 1.
+    /// @param x Receives the interpolated state.
+    template <
+        class S = stepper_type,
+        std::enable_if_t<detail::is_embedded_stepper_v<S> && detail::has_dense_output_v<S>, int> = 0>
+    void interpolate(
+        const state_type &x0,
+        const state_type &x1,
+        const time_type dt,
+        const time_type theta,
+        state_type &x) const
+    {
+        m_stepper_main.interpolate(x0, x1, dt, theta, x);
+    }
+
+private:
+    /// @brief Checks if the last step of the given stepper failed, e.g., if its Newton iterations did not converge.
+    /// @param stepper The stepper.
+    /// @return true if the stepper reports a failure, false for the steppers that cannot fail.
+    static constexpr bool step_failed(const stepper_type &stepper)
+    {
+        if constexpr (detail::has_step_failed_v<stepper_type>) {
+            return stepper.step_failed();
         } else {
-            // Get mixed truncation error.
-            m_t_err = max_comb_diff<value_type>(x.begin(), x.end(), y.begin(), y.end());
-            // Update the time-delta.
-            m_time_delta *= 0.9 * std::min(std::max(std::pow(m_tollerance / (2 * m_t_err), 0.2), 0.3), 2.);
+            (void)stepper;
+            return false;
         }
-        // Check boundaries.
-        m_time_delta = std::min(std::max(m_time_delta, m_min_delta), m_max_delta);
-        // Increase the number of steps.
-        ++m_steps;
+    }
 
-        /*
-        // Copy the step size.
-        m_time_delta = dt;
-        // Copy the initial state.
-        state_type y0, y1;
-        while (true) {
-            y0 = x, y1 = x;
+    /// @brief Computes the two solutions, and the ratio between the estimated truncation error and the tolerance.
+    ///
+    /// @details With step doubling the two solutions are stored inside
+    /// `m_y0` and `m_y1`, and the error is estimated as twice their
+    /// difference. With an embedded solution, the stepper updates `m_y1`
+    /// and measures the error of the embedded solution in the same pass,
+    /// without storing the embedded solution.
+    ///
+    /// @tparam System The type of the system being integrated.
+    /// @param system The system that defines the equations of motion or dynamics.
+    /// @param x The state at the beginning of the step.
+    /// @param t The current time.
+    /// @return The ratio, values below 1 mean that the step can be accepted, it
+    /// is infinite when the stepper reports a failed step.
+    template <class System>
+    constexpr auto compute_error_ratio(System &&system, const state_type &x, const time_type t) -> value_type
+    {
+        using detail::it_algebra::max_abs_diff;
+        using detail::it_algebra::max_comb_diff;
+        using detail::it_algebra::max_rel_diff;
+        using detail::it_algebra::rms_weighted_diff;
 
+        // Calculate truncation error.
+        value_type error;
+        if constexpr (detail::is_embedded_stepper_v<stepper_type>) {
+            // Compute values of (1), and the error of the embedded solution (0).
+            m_error_sum = 0;
+            error       = m_stepper_main.do_step_with_error(
+                std::forward<System>(system), m_y1, t, m_time_delta,
+                [this, &x](std::size_t i, value_type value, value_type e) {
+                    return this->error_metric(i, value, e, x[i]);
+                });
+            if constexpr (Error == ErrorFormula::Absolute) {
+                m_t_err_abs = error;
+            } else if constexpr (Error == ErrorFormula::Relative) {
+                m_t_err_rel = error;
+            } else if constexpr (Error == ErrorFormula::Mixed) {
+                m_t_err = error;
+            } else {
+                // The metric accumulated the squares of the scaled errors, which are relative to the tolerances.
+                const auto n = static_cast<accumulator_type>(m_y1.size());
+                m_t_err = error = std::max(
+                    static_cast<value_type>(std::sqrt(m_error_sum / n)), std::numeric_limits<value_type>::epsilon());
+                return error;
+            }
+            return error / m_tollerance;
+        } else {
             // Compute values of (0).
-            m_stepper_main.do_step(std::forward<System>(system), y0, t, m_time_delta);
-
+            m_stepper_main.do_step(std::forward<System>(system), m_y0, t, m_time_delta);
+            bool failed = step_failed(m_stepper_main);
             // Compute values of (1).
             if constexpr (Iterations <= 2) {
-                const time_type dh = m_time_delta * .5;
-                m_stepper_tuner.do_step(std::forward<System>(system), y1, t + dh, dh);
-                m_stepper_tuner.do_step(std::forward<System>(system), y1, t + m_time_delta, dh);
+                const time_type dh = m_time_delta / 2;
+                m_stepper_tuner.do_step(std::forward<System>(system), m_y1, t, dh);
+                failed |= step_failed(m_stepper_tuner);
+                m_stepper_tuner.do_step(std::forward<System>(system), m_y1, t + dh, dh);
+                failed |= step_failed(m_stepper_tuner);
             } else {
-                const time_type dh = m_time_delta * (1. / Iterations);
+                const time_type dh = m_time_delta / Iterations;
                 for (unsigned i = 0; i < Iterations; ++i) {
-                    m_stepper_tuner.do_step(std::forward<System>(system), y1, t + dh * i, dh);
+                    m_stepper_tuner.do_step(std::forward<System>(system), m_y1, t + (dh * i), dh);
+                    failed |= step_failed(m_stepper_tuner);
                 }
             }
-
-            // Calculate truncation error.
+            // A step whose implicit equation was not solved is rejected, and retried with a smaller step-size.
+            if (failed) {
+                return std::numeric_limits<value_type>::infinity();
+            }
             if constexpr (Error == ErrorFormula::Absolute) {
                 // Get absolute truncation error.
-                m_t_err = max_abs_diff<value_type>(y0.begin(), y0.end(), y1.begin(), y1.end());
+                error = m_t_err_abs = max_abs_diff<value_type>(m_y1.begin(), m_y1.end(), m_y0.begin(), m_y0.end());
             } else if constexpr (Error == ErrorFormula::Relative) {
                 // Get relative truncation error.
-                m_t_err = max_rel_diff<value_type>(y0.begin(), y0.end(), y1.begin(), y1.end());
-            } else {
+                error = m_t_err_rel = max_rel_diff<value_type>(m_y1.begin(), m_y1.end(), m_y0.begin(), m_y0.end());
+            } else if constexpr (Error == ErrorFormula::Mixed) {
                 // Get mixed truncation error.
-                m_t_err = max_comb_diff<value_type>(y0.begin(), y0.end(), y1.begin(), y1.end());
+                error = m_t_err = max_comb_diff<value_type>(m_y1.begin(), m_y1.end(), m_y0.begin(), m_y0.end());
+            } else {
+                // Get weighted truncation error, which is already relative to the tolerances.
+                error = m_t_err = rms_weighted_diff<value_type>(
+                    m_y1.begin(), m_y1.end(), m_y0.begin(), x.cbegin(), m_atols.cbegin(), m_rtols.cbegin());
+                return 2 * error;
             }
+            return (2 * error) / m_tollerance;
+        }
+    }
 
-            // Update the time-delta.
-            m_time_delta *= 0.9 * std::min(std::max(std::pow(m_tollerance / (2 * m_t_err), 0.2), 0.3), 2.);
-            // Check boundaries.
-            m_time_delta = std::min(std::max(m_time_delta, m_min_delta), m_max_delta);
-
-            // Increase the number of steps.
-            ++m_steps;
+    /// @brief Measures the error of a single element, according to the error formula.
+    /// @details With `ErrorFormula::Weighted`, it also accumulates the square
+    /// of the scaled error inside `m_error_sum`.
+    /// @param i The index of the element.
+    /// @param value The value of the element, in the solution (1).
+    /// @param error The difference between the solutions (1) and (0).
+    /// @param reference The value of the element at the beginning of the step.
+    /// @return The truncation error of the element.
+    constexpr auto error_metric(std::size_t i, value_type value, value_type error, value_type reference)
+        -> value_type
+    {
+        if constexpr (Error == ErrorFormula::Absolute) {
+            (void)i, (void)reference;
+            return std::abs(error);
+        } else if constexpr (Error == ErrorFormula::Relative) {
+            (void)i, (void)reference;
+            return std::abs(value) > 0 ? std::abs(error / value) : std::abs(error);
+        } else if constexpr (Error == ErrorFormula::Mixed) {
+            (void)i, (void)reference;
+            return std::abs(value) > 0 ? std::max(std::abs(error / value), std::abs(error)) : std::abs(error);
+        } else {
+            // The scale never drops below the smallest normal value, to avoid 0 / 0.
+            const auto scale = std::max(
+                static_cast<accumulator_type>(m_atols[i] + m_rtols[i] * std::max(std::abs(value), std::abs(reference))),
+                static_cast<accumulator_type>(std::numeric_limits<value_type>::min()));
+            const auto ratio = static_cast<accumulator_type>(error) / scale;
+            m_error_sum += ratio * ratio;
+            return static_cast<value_type>(std::abs(ratio));
+        }
+    }
 
-            // Check if error is within tolerance
-            if (m_t_err <= m_tollerance) {
-                std::cout << m_t_err << "\n";
-                // Update the state.
-                x = y1;
-                break;
-            }
+    /// @brief Returns the order of the truncation error estimate, plus one.
+    ///
+    /// @details With step doubling the local error of the stepper is used,
+    /// with an embedded solution the local error of the embedded method.
+    ///
+    /// @return The exponent of the step-size in the local error.
+    constexpr auto error_order() const -> unsigned
+    {
+        if constexpr (detail::is_embedded_stepper_v<stepper_type>) {
+            return m_stepper_main.order_error() + 1U;
+        } else {
+            return m_stepper_main.order_step() + 1U;
         }
-        */
     }
 
-private:
+    /// @brief Updates the step-size based on the ratio between error and tolerance.
+    ///
+    /// @param ratio The ratio between the error and the tolerance.
+    /// @param accepted Whether the step was accepted, or it is going to be retried.
+    /// @param limit_growth Whether the step-size is not allowed to grow (i.e., after a rejection).
+    constexpr void update_time_delta(value_type ratio, bool accepted, bool limit_growth)
+    {
+        const auto r      = static_cast<time_type>(ratio);
+        const auto factor = accepted ? m_controller.accept(r, this->error_order())
+                                     : m_controller.reject(r, this->error_order());
+        // The constants come first, so that a NaN factor shrinks the step-size.
+        m_time_delta *= time_type(0.9) * std::min(time_type(limit_growth ? 1 : 2), std::max(time_type(0.3), factor));
+        // Check boundaries, keeping the direction of the integration.
+        m_time_delta = detail::clamp_with_sign(m_time_delta, m_min_delta, m_max_delta);
+    }
+
     /// The main stepper.
     stepper_type m_stepper_main;
     /// A temporary stepper we use to tune the main stepper.
     stepper_type m_stepper_tuner;
+    /// The step-size controller.
+    controller_type m_controller;
+    /// The solutions (0) and (1), kept between steps to avoid allocations.
+    state_type m_y0, m_y1;
     /// The tollerance value we use to tune the step-size.
     time_type m_tollerance;
+    /// The absolute and relative tolerances of every element, used by the weighted error.
+    value_type m_atol{value_type(0.0001)}, m_rtol{value_type(0.0001)};
+    /// The absolute and relative tolerances of each element, used by the weighted error.
+    state_type m_atols{}, m_rtols{};
+    /// Whether the tolerances were provided one element at a time.
+    bool m_component_tollerances{false};
+    /// The sum of the squares of the scaled errors, accumulated by the weighted error metric.
+    accumulator_type m_error_sum{};
     /// A copy of the step-size.
     time_type m_time_delta;
     /// The minimum step-size.
@@ -254,8 +556,16 @@ private:
     value_type m_t_err_abs;
     /// Holds the relative error between the main stepper and the temporary stepper.
     value_type m_t_err_rel;
+    /// The step-size used by the last accepted step.
+    time_type m_last_time_delta;
+    /// The ratio between the error and the tolerance of the last accepted step.
+    value_type m_last_error_ratio{};
+    /// The maximum number of retries of a rejected step.
+    unsigned m_max_retries;
     /// The number of steps of integration.
     uint64_t m_steps{};
+    /// The number of rejected steps.
+    uint64_t m_rejections{};
 };
 
 } // namespace numint
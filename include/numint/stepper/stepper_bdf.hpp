@@ -0,0 +1,619 @@
+/// @file stepper_bdf.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Variable-order, variable-step backward differentiation formulas, for stiff systems.
+
+#pragma once
+
+#include "numint/detail/less_with_sign.hpp"
+#include "numint/detail/type_traits.hpp"
+#include "numint/linear/dense_lu_solver.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+namespace numint
+{
+
+/// @brief Adaptive stepper implementing the backward differentiation formulas
+/// (BDF) of order 1 to 5.
+///
+/// @details The stepper keeps the history of the solution as backward
+/// differences, scaled by the step-size (Shampine and Reichelt, "The MATLAB
+/// ODE Suite", 1997), which allows to change both the step-size and the order
+/// at a small cost. Each step solves the implicit equation of the formula by
+/// simplified Newton iterations: the Jacobian is reused across steps for as
+/// long as the iterations converge, the matrix is factorized again only when
+/// the step-size or the order change. The local error is measured, for each
+/// element, against `tollerance * (1 + |x|)`, as a root mean square.
+///
+/// Like `stepper_adaptive`, the stepper controls its own step-size, which is
+/// retrieved with `get_time_delta()`, and it is meant to be used with
+/// `integrate_adaptive`. The history is discarded by `adjust_size`, and
+/// whenever the state passed to `do_step` is not the one produced by the
+/// previous step, in which case the integration restarts from order 1.
+///
+/// @tparam State The state vector type.
+/// @tparam Time The datatype used to hold time.
+/// @tparam LinearSolver The linear solver used by the Newton iterations.
+template <class State, class Time, class LinearSolver = dense_lu_solver<State>>
+class stepper_bdf
+{
+public:
+    /// @brief Type used for the order of the stepper.
+    using order_type                          = unsigned short;
+    /// @brief Type used to keep track of time.
+    using time_type                           = Time;
+    /// @brief The state vector.
+    using state_type                          = State;
+    /// @brief Type of value contained in the state vector.
+    using value_type                          = typename state_type::value_type;
+    /// @brief Type of the linear solver.
+    using linear_solver_type                  = LinearSolver;
+    /// @brief Determines if this is an adaptive stepper or not.
+    static constexpr bool is_adaptive_stepper = true;
+
+    /// @brief The maximum order of the formulas.
+    static constexpr std::size_t max_order = 5;
+
+    /// @brief Constructs a new stepper.
+    stepper_bdf() = default;
+
+    /// @brief Destructor.
+    ~stepper_bdf() = default;
+
+    /// @brief Copy constructor.
+    /// @param other The logger instance to copy from.
+    stepper_bdf(const stepper_bdf &other) = delete;
+
+    /// @brief Move constructor.
+    /// @param other The logger instance to move from.
+    stepper_bdf(stepper_bdf &&other) noexcept = default;
+
+    /// @brief Copy assignment operator.
+    /// @param other The logger instance to copy from.
+    /// @return Reference to the logger instance.
+    auto operator=(const stepper_bdf &other) -> stepper_bdf & = delete;
+
+    /// @brief Move assignment operator.
+    /// @param other The logger instance to move from.
+    /// @return Reference to the logger instance.
+    auto operator=(stepper_bdf &&other) noexcept -> stepper_bdf & = default;
+
+    /// @brief Sets the tolerance for step-size control.
+    ///
+    /// @param tollerance The tolerance value to use for adjusting the step size.
+    constexpr void set_tollerance(value_type tollerance) { m_tollerance = tollerance; }
+
+    /// @brief Sets the minimum allowed step size.
+    ///
+    /// @param min_delta The minimum step size.
+    constexpr void set_min_delta(time_type min_delta) { m_min_delta = min_delta; }
+
+    /// @brief Sets the maximum allowed step size.
+    ///
+    /// @param max_delta The maximum step size.
+    constexpr void set_max_delta(time_type max_delta) { m_max_delta = max_delta; }
+
+    /// @brief Sets the maximum number of times a step is retried after being rejected.
+    ///
+    /// @details Once the retries are exhausted, the last attempt is accepted
+    /// regardless of its error, the same happens when the step-size reaches
+    /// the minimum step size.
+    ///
+    /// @param max_retries The maximum number of retries.
+    constexpr void set_max_retries(unsigned max_retries) { m_max_retries = max_retries; }
+
+    /// @brief Provides access to the linear solver, e.g., to retrieve its statistics.
+    /// @return a reference to the linear solver.
+    constexpr auto linear_solver() -> linear_solver_type & { return m_linear_solver; }
+
+    /// @brief Returns the order of the formula currently in use.
+    /// @return the current order, between 1 and `max_order`.
+    constexpr auto order_step() const -> order_type { return static_cast<order_type>(m_order); }
+
+    /// @brief Retrieves the current adaptive step size.
+    /// @return The current step size as a `time_type` value.
+    constexpr auto get_time_delta() const -> time_type { return m_time_delta; }
+
+    /// @brief Retrieves the step size used by the last accepted step.
+    /// @return The last accepted step size as a `time_type` value.
+    constexpr auto get_last_time_delta() const -> time_type { return m_last_time_delta; }
+
+    /// @brief Adjusts the size of the internal state vectors based on a reference.
+    /// @details It also discards the history, which restarts the integration from order 1.
+    /// @param reference A reference state vector used for size adjustment.
+    void adjust_size(const state_type &reference)
+    {
+        m_linear_solver.adjust_size(reference);
+        if constexpr (detail::has_resize<state_type>::value) {
+            for (auto &difference : m_differences) {
+                difference.resize(reference.size());
+            }
+            m_y.resize(reference.size());
+            m_d.resize(reference.size());
+            m_f.resize(reference.size());
+            m_psi.resize(reference.size());
+            m_scale.resize(reference.size());
+        }
+        m_initialized    = false;
+        m_jacobian_valid = false;
+        m_factorized     = false;
+    }
+
+    /// @brief Discards the data cached from the previous steps (e.g., after a discontinuity of the system).
+    /// @details Unlike `adjust_size`, it keeps the internal state vectors, and restarts the history from order 1.
+    void reset()
+    {
+        m_initialized = false;
+    }
+
+    /// @brief Returns the number of steps the stepper executed up until now.
+    /// @return the number of integration steps.
+    constexpr auto steps() const { return m_steps; }
+
+    /// @brief Returns the number of rejected steps.
+    /// @return the number of rejected steps.
+    constexpr auto rejections() const { return m_rejections; }
+
+    /// @brief Returns the number of steps accepted without the convergence of the Newton iterations.
+    /// @return the number of failed steps.
+    constexpr auto newton_failures() const { return m_newton_failures; }
+
+    /// @brief Checks if the Newton iterations of the last step did not converge.
+    /// @return true if the state of the last step is not a solution of the implicit equation.
+    constexpr bool step_failed() const { return m_step_failed; }
+
+    /// @brief Saves, or restores, the state carried by the stepper between the steps (see `numint/checkpoint.hpp`).
+    /// @details It includes the history of the differences, so that the next step continues it.
+    /// The Jacobian is not saved, it is evaluated again by the first step after the restore.
+    /// @tparam Archive The type of the archive.
+    /// @param archive The archive.
+    template <class Archive>
+    void serialize(Archive &archive)
+    {
+        archive(m_differences, m_time_delta, m_last_time_delta, m_time, m_order, m_equal_steps, m_initialized);
+        archive(m_steps, m_rejections, m_newton_failures);
+        // The Jacobian kept by the linear solver does not belong to the restored history.
+        m_jacobian_valid = false;
+        m_factorized     = false;
+    }
+
+    /// @brief Performs one integration step.
+    ///
+    /// @details The step starts with the step-size dt, which is reduced
+    /// until the Newton iterations converge and the local error is within
+    /// the tolerance. The step-size that was actually used is returned
+    /// by `get_last_time_delta()`, the one proposed for the next step by
+    /// `get_time_delta()`. If the Newton iterations do not converge even at
+    /// the minimum step-size, or after the maximum number of retries, the
+    /// last iterate is accepted, the step is counted by `newton_failures()`,
+    /// and the step-size is not increased afterwards.
+    ///
+    /// @tparam System The type of the system being integrated.
+    /// @param system The system that defines the equations of motion or dynamics.
+    /// @param x The state of the system, which will be updated after this step.
+    /// @param t The current time.
+    /// @param dt The time step to use for the integration.
+    template <class System>
+    void do_step(System &&system, state_type &x, const time_type t, const time_type dt)
+    {
+        const std::size_t size = x.size();
+
+        // Restart from order 1, if the state does not continue the history.
+        if (!m_initialized || (std::abs(t - m_time) > 0) ||
+            !std::equal(x.begin(), x.end(), m_differences[0].begin())) {
+            this->restart(system, x, t, this->clamp(dt));
+        } else {
+            this->rescale(this->clamp(dt));
+        }
+        // Evaluate the Jacobian, if it was discarded while keeping the history (e.g., by a restore).
+        if (!m_jacobian_valid) {
+            system(m_differences[0], m_f, t);
+            m_linear_solver.update_jacobian(system, m_differences[0], m_f, t);
+            m_jacobian_valid   = true;
+            m_jacobian_current = true;
+            m_factorized       = false;
+        }
+
+        const value_type newton_tollerance = std::max(
+            10 * std::numeric_limits<value_type>::epsilon() / m_tollerance,
+            std::min(value_type(0.03), std::sqrt(m_tollerance)));
+
+        value_type error_norm = 0;
+        unsigned iterations   = 0;
+        for (unsigned retry = 0;; ++retry) {
+            const time_type t_new = t + m_time_delta;
+            const time_type c     = m_time_delta / static_cast<time_type>(gamma[m_order]);
+
+            // Solve the implicit equation, with a Jacobian evaluated at the
+            // current state if the one we have does not let the iterations converge.
+            bool converged = false;
+            for (;;) {
+                if (!m_factorized || (std::abs(c - m_c) > 0)) {
+                    m_factorized = m_linear_solver.factorize(static_cast<value_type>(1 / c));
+                    m_c          = c;
+                }
+                if (m_factorized) {
+                    converged = this->solve_newton(system, t_new, c, newton_tollerance, iterations);
+                }
+                if (converged || m_jacobian_current) {
+                    break;
+                }
+                system(m_differences[0], m_f, t);
+                m_linear_solver.update_jacobian(system, m_differences[0], m_f, t);
+                m_jacobian_current = true;
+                m_factorized       = false;
+            }
+
+            // Otherwise, the step is retried with a quarter of the step-size,
+            // the last iterate is accepted only if we cannot do better.
+            m_step_failed = !converged;
+            if (!converged) {
+                if ((m_min_delta < std::abs(m_time_delta)) && (retry < m_max_retries)) {
+                    this->rescale(this->clamp(m_time_delta / 4));
+                    ++m_rejections;
+                    continue;
+                }
+                ++m_newton_failures;
+                break;
+            }
+
+            // Measure the local error.
+            const auto error_constant = static_cast<value_type>(1. / static_cast<double>(m_order + 1));
+            error_norm                = 0;
+            for (std::size_t i = 0; i < size; ++i) {
+                m_scale[i] = m_tollerance * (1 + std::abs(m_y[i]));
+                error_norm += square(error_constant * m_d[i] / m_scale[i]);
+            }
+            error_norm = std::sqrt(error_norm / static_cast<value_type>(size));
+
+            // Reject the step if the error is above the tolerance, unless we cannot do better.
+            if ((error_norm > 1) && (m_min_delta < std::abs(m_time_delta)) && (retry < m_max_retries)) {
+                const double exponent = -1. / static_cast<double>(m_order + 1);
+                const double factor   = std::max(min_factor, safety(iterations) * std::pow(error_norm, exponent));
+                this->rescale(this->clamp(m_time_delta * static_cast<time_type>(factor)));
+                ++m_rejections;
+                continue;
+            }
+            break;
+        }
+
+        // Accept the step, and update the differences.
+        m_last_time_delta = m_time_delta;
+        m_time            = t + m_time_delta;
+        for (std::size_t i = 0; i < size; ++i) {
+            m_differences[m_order + 2][i] = m_d[i] - m_differences[m_order + 1][i];
+            m_differences[m_order + 1][i] = m_d[i];
+        }
+        for (std::size_t j = m_order + 1; j-- > 0;) {
+            for (std::size_t i = 0; i < size; ++i) {
+                m_differences[j][i] += m_differences[j + 1][i];
+            }
+        }
+        std::copy(m_differences[0].begin(), m_differences[0].end(), x.begin());
+        // The Jacobian is no more evaluated at the current state.
+        m_jacobian_current = false;
+        ++m_steps;
+
+        // Change the order and the step-size, once the current ones were used
+        // for enough steps, and never right after a failed step.
+        if (m_step_failed) {
+            m_equal_steps = 0;
+        } else if (++m_equal_steps > m_order) {
+            this->select_order(size, error_norm, iterations);
+        }
+    }
+
+    /// @brief Interpolates the last accepted step, with the polynomial of the formula.
+    ///
+    /// @details The interpolant is the polynomial defined by the backward
+    /// differences, which is already available, hence it costs no
+    /// evaluation of the system:
+    ///     x(t_n + s) = D0 + sum_j Dj * prod_{m < j} (s + m * h) / ((m + 1) * h)
+    ///
+    /// @param x0 The state at the beginning of the last step (unused).
+    /// @param x1 The state at the end of the last step (unused).
+    /// @param dt The step-size of the last step.
+    /// @param theta The position inside the step, between 0 and 1.
+    /// @param x Receives the interpolated state.
+    void interpolate(
+        const state_type &x0,
+        const state_type &x1,
+        const time_type dt,
+        const time_type theta,
+        state_type &x) const
+    {
+        (void)x0, (void)x1;
+        // The coefficients of the differences.
+        value_type coefficients[max_order + 1];
+        coefficients[0] = 1;
+        for (std::size_t m = 0; m < m_order; ++m) {
+            const time_type s   = (theta - 1) * dt + static_cast<time_type>(m) * m_time_delta;
+            coefficients[m + 1] = coefficients[m] *
+                                  static_cast<value_type>(s / (static_cast<time_type>(m + 1) * m_time_delta));
+        }
+        for (std::size_t i = 0; i < x.size(); ++i) {
+            value_type sum = 0;
+            for (std::size_t j = 0; j <= m_order; ++j) {
+                sum += coefficients[j] * m_differences[j][i];
+            }
+            x[i] = sum;
+        }
+    }
+
+private:
+    /// @brief Sum of the reciprocals, gamma[k] = 1 + 1/2 + ... + 1/k.
+    static constexpr std::array<double, max_order + 1> gamma = {
+        0., 1., 1.5, 1.8333333333333333, 2.0833333333333333, 2.2833333333333333};
+    /// @brief The maximum number of Newton iterations.
+    static constexpr unsigned max_iterations = 4;
+    /// @brief The minimum factor of reduction of the step-size.
+    static constexpr double min_factor = 0.2;
+    /// @brief The maximum factor of growth of the step-size.
+    static constexpr double max_factor = 10;
+
+    /// @brief Computes the square of a value.
+    /// @param value The value.
+    /// @return the square of the value.
+    static constexpr auto square(value_type value) -> value_type { return value * value; }
+
+    /// @brief Safety factor of the step-size, which decreases with the number of Newton iterations.
+    /// @param iterations The number of Newton iterations of the last step.
+    /// @return the safety factor.
+    static constexpr auto safety(unsigned iterations) -> double
+    {
+        return 0.9 * (2 * max_iterations + 1) / (2 * max_iterations + iterations);
+    }
+
+    /// @brief Limits the step-size within the boundaries.
+    /// @param dt The step-size.
+    /// @return the limited step-size.
+    constexpr auto clamp(time_type dt) const -> time_type
+    {
+        return detail::clamp_with_sign(dt, m_min_delta, m_max_delta);
+    }
+
+    /// @brief Restarts the history from the given state, with order 1.
+    /// @tparam System The type of the system being integrated.
+    /// @param system The system that defines the equations of motion or dynamics.
+    /// @param x The state of the system.
+    /// @param t The current time.
+    /// @param dt The step-size.
+    template <class System>
+    void restart(System &&system, const state_type &x, const time_type t, const time_type dt)
+    {
+        std::copy(x.begin(), x.end(), m_differences[0].begin());
+        system(x, m_f, t);
+        for (std::size_t i = 0; i < x.size(); ++i) {
+            m_differences[1][i] = static_cast<value_type>(dt) * m_f[i];
+        }
+        m_linear_solver.update_jacobian(system, x, m_f, t);
+        m_jacobian_valid   = true;
+        m_jacobian_current = true;
+        m_factorized       = false;
+        m_order            = 1;
+        m_equal_steps      = 0;
+        m_time             = t;
+        m_time_delta       = dt;
+        m_initialized      = true;
+    }
+
+    /// @brief Executes the Newton iterations, starting from the prediction of the differences.
+    /// @tparam System The type of the system being integrated.
+    /// @param system The system that defines the equations of motion or dynamics.
+    /// @param t The time at the end of the step.
+    /// @param c The step-size, divided by the coefficient of the formula.
+    /// @param tollerance The tolerance on the (scaled) corrections.
+    /// @param iterations Receives the number of iterations.
+    /// @return true if the iterations converged, false otherwise.
+    template <class System>
+    auto solve_newton(System &&system, time_type t, time_type c, value_type tollerance, unsigned &iterations) -> bool
+    {
+        const std::size_t size = m_y.size();
+        const auto cv          = static_cast<value_type>(c);
+        // Predict the solution, and compute the constant term of the formula.
+        const auto gamma_k = static_cast<value_type>(gamma[m_order]);
+        for (std::size_t i = 0; i < size; ++i) {
+            value_type predict = 0, psi = 0;
+            for (std::size_t j = 0; j <= m_order; ++j) {
+                predict += m_differences[j][i];
+            }
+            for (std::size_t j = 1; j <= m_order; ++j) {
+                psi += static_cast<value_type>(gamma[j]) * m_differences[j][i];
+            }
+            m_y[i]     = predict;
+            m_d[i]     = 0;
+            m_psi[i]   = psi / gamma_k;
+            m_scale[i] = m_tollerance * (1 + std::abs(predict));
+        }
+        value_type norm_old = 0, rate = 0;
+        for (iterations = 1; iterations <= max_iterations; ++iterations) {
+            system(m_y, m_f, t);
+            // Solve (I - c * J) * dy = c * f - psi - d, scaled by 1 / c.
+            for (std::size_t i = 0; i < size; ++i) {
+                m_f[i] = m_f[i] - (m_psi[i] + m_d[i]) / cv;
+            }
+            m_linear_solver.solve(m_f);
+            value_type norm = 0;
+            for (std::size_t i = 0; i < size; ++i) {
+                m_y[i] += m_f[i];
+                m_d[i] += m_f[i];
+                norm += square(m_f[i] / m_scale[i]);
+            }
+            norm = std::sqrt(norm / static_cast<value_type>(size));
+            if (!std::isfinite(norm)) {
+                return false;
+            }
+            if (iterations > 1) {
+                rate = norm / norm_old;
+                // Stop if the iterations diverge, or if they are too slow to converge.
+                const auto remaining = static_cast<value_type>(max_iterations - iterations);
+                if ((rate >= 1) || (std::pow(rate, remaining) / (1 - rate) * norm > tollerance)) {
+                    return false;
+                }
+            }
+            if (!(norm > 0) || ((iterations > 1) && (rate / (1 - rate) * norm < tollerance))) {
+                return true;
+            }
+            norm_old = norm;
+        }
+        return false;
+    }
+
+    /// @brief Computes the matrix which changes the step-size of the differences by a factor.
+    /// @param factor The factor of change of the step-size.
+    /// @param matrix Receives the matrix.
+    void compute_r(double factor, double (&matrix)[max_order + 1][max_order + 1]) const
+    {
+        for (std::size_t j = 0; j <= m_order; ++j) {
+            matrix[0][j] = 1;
+        }
+        for (std::size_t i = 1; i <= m_order; ++i) {
+            matrix[i][0] = 0;
+            for (std::size_t j = 1; j <= m_order; ++j) {
+                const auto di = static_cast<double>(i), dj = static_cast<double>(j);
+                matrix[i][j]  = matrix[i - 1][j] * (di - 1 - factor * dj) / di;
+            }
+        }
+    }
+
+    /// @brief Changes the step-size, transforming the differences accordingly.
+    /// @param dt The new step-size.
+    void rescale(time_type dt)
+    {
+        if (!(std::abs(dt - m_time_delta) > 0)) {
+            return;
+        }
+        const double factor = static_cast<double>(dt / m_time_delta);
+        double r[max_order + 1][max_order + 1], u[max_order + 1][max_order + 1];
+        this->compute_r(factor, r);
+        this->compute_r(1, u);
+        // The transformation, ru = r * u.
+        double ru[max_order + 1][max_order + 1];
+        for (std::size_t i = 0; i <= m_order; ++i) {
+            for (std::size_t j = 0; j <= m_order; ++j) {
+                ru[i][j] = 0;
+                for (std::size_t k = 0; k <= m_order; ++k) {
+                    ru[i][j] += r[i][k] * u[k][j];
+                }
+            }
+        }
+        // D[j] = sum_k ru[k][j] * D[k], for j = 1, ..., order (D[0] does not change).
+        for (std::size_t i = 0; i < m_differences[0].size(); ++i) {
+            value_type old[max_order + 1];
+            for (std::size_t k = 0; k <= m_order; ++k) {
+                old[k] = m_differences[k][i];
+            }
+            for (std::size_t j = 1; j <= m_order; ++j) {
+                value_type sum = 0;
+                for (std::size_t k = 0; k <= m_order; ++k) {
+                    sum += static_cast<value_type>(ru[k][j]) * old[k];
+                }
+                m_differences[j][i] = sum;
+            }
+        }
+        m_time_delta  = dt;
+        m_equal_steps = 0;
+    }
+
+    /// @brief Selects the order, and the step-size, of the next step.
+    /// @details It compares the error estimates of the orders k - 1, k, and k + 1,
+    /// and keeps the one allowing the largest step-size.
+    /// @param size The size of the state.
+    /// @param error_norm The error of the last step, with the current order.
+    /// @param iterations The number of Newton iterations of the last step.
+    void select_order(std::size_t size, value_type error_norm, unsigned iterations)
+    {
+        const value_type infinity = std::numeric_limits<value_type>::infinity();
+        value_type error_m_norm = infinity, error_p_norm = infinity;
+        if (m_order > 1) {
+            const auto error_constant = static_cast<value_type>(1. / static_cast<double>(m_order));
+            error_m_norm              = 0;
+            for (std::size_t i = 0; i < size; ++i) {
+                error_m_norm += square(error_constant * m_differences[m_order][i] / m_scale[i]);
+            }
+            error_m_norm = std::sqrt(error_m_norm / static_cast<value_type>(size));
+        }
+        if (m_order < max_order) {
+            const auto error_constant = static_cast<value_type>(1. / static_cast<double>(m_order + 2));
+            error_p_norm              = 0;
+            for (std::size_t i = 0; i < size; ++i) {
+                error_p_norm += square(error_constant * m_differences[m_order + 2][i] / m_scale[i]);
+            }
+            error_p_norm = std::sqrt(error_p_norm / static_cast<value_type>(size));
+        }
+        // The factor of growth allowed by each order.
+        const auto k             = static_cast<double>(m_order);
+        const double factor_m    = std::pow(static_cast<double>(error_m_norm), -1. / k);
+        const double factor_same = std::pow(static_cast<double>(error_norm), -1. / (k + 1));
+        const double factor_p    = std::pow(static_cast<double>(error_p_norm), -1. / (k + 2));
+        double factor            = factor_same;
+        if ((factor_m > factor) && (factor_m >= factor_p)) {
+            factor = factor_m;
+            --m_order;
+        } else if (factor_p > factor) {
+            factor = factor_p;
+            ++m_order;
+        }
+        const auto scaled = static_cast<time_type>(std::min(max_factor, safety(iterations) * factor));
+        this->rescale(this->clamp(m_time_delta * scaled));
+        m_equal_steps = 0;
+    }
+
+    /// The linear solver.
+    linear_solver_type m_linear_solver;
+    /// The backward differences of the solution, scaled by the step-size.
+    std::array<state_type, max_order + 3> m_differences;
+    /// The solution of the step.
+    state_type m_y;
+    /// The correction from the prediction to the solution.
+    state_type m_d;
+    /// Support vector for the derivative, and for the Newton corrections.
+    state_type m_f;
+    /// The constant term of the formula.
+    state_type m_psi;
+    /// The scale of the error of each element.
+    state_type m_scale;
+    /// The tollerance value we use to tune the step-size.
+    value_type m_tollerance{value_type(0.0001)};
+    /// The step-size.
+    time_type m_time_delta{time_type(1e-12)};
+    /// The minimum step-size.
+    time_type m_min_delta{time_type(1e-12)};
+    /// The maximum step-size.
+    time_type m_max_delta{1};
+    /// The step-size used by the last accepted step.
+    time_type m_last_time_delta{};
+    /// The time of the last state in the history.
+    time_type m_time{};
+    /// The coefficient of f used for the last factorization.
+    time_type m_c{};
+    /// The order of the formula.
+    std::size_t m_order{1};
+    /// The number of steps executed with the current order and step-size.
+    std::size_t m_equal_steps{};
+    /// The maximum number of retries of a rejected step.
+    unsigned m_max_retries{10};
+    /// Whether the history is valid.
+    bool m_initialized{false};
+    /// Whether the linear solver holds a Jacobian of the system.
+    bool m_jacobian_valid{false};
+    /// Whether the Jacobian was evaluated at the current state.
+    bool m_jacobian_current{false};
+    /// Whether the factorization is valid.
+    bool m_factorized{false};
+    /// The number of steps of integration.
+    uint64_t m_steps{};
+    /// The number of rejected steps.
+    uint64_t m_rejections{};
+    /// The number of steps accepted without the convergence of the Newton iterations.
+    uint64_t m_newton_failures{};
+    /// Whether the Newton iterations of the last step did not converge.
+    bool m_step_failed{};
+};
+
+} // namespace numint
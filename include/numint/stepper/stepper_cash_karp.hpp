@@ -0,0 +1,269 @@
+/// @file stepper_cash_karp.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Simplification of the code available at:
+///     https://github.com/headmyshoulder/odeint-v2
+
+#pragma once
+
+#include "numint/detail/it_algebra.hpp"
+#include "numint/detail/type_traits.hpp"
+#include "numint/vec_expr.hpp"
+
+namespace numint
+{
+
+/// @brief Stepper implementing the Cash-Karp 5(4) embedded Runge-Kutta method.
+///
+/// @details The method uses six evaluations of the system per step. Alongside
+/// the fifth-order solution, the stepper can provide the fourth-order embedded
+/// solution, which is used by `stepper_adaptive` to estimate the truncation
+/// error without resorting to step doubling.
+///
+/// @tparam State The state vector type.
+/// @tparam Time The datatype used to hold time.
+template <class State, class Time>
+class stepper_cash_karp
+{
+public:
+    /// @brief Type used for the order of the stepper.
+    using order_type = unsigned short;
+
+    /// @brief Type used to keep track of time.
+    using time_type = Time;
+
+    /// @brief The state vector type.
+    using state_type = State;
+
+    /// @brief Type of value contained in the state vector.
+    using value_type = typename state_type::value_type;
+
+    /// @brief Indicates whether this is an adaptive stepper.
+    static constexpr bool is_adaptive_stepper = false;
+
+    /// @brief Indicates whether this stepper provides an embedded error estimate.
+    static constexpr bool is_embedded_stepper = true;
+
+    /// @brief Constructs a new stepper.
+    stepper_cash_karp() = default;
+
+    /// @brief Destructor.
+    ~stepper_cash_karp() = default;
+
+    /// @brief Copy constructor.
+    /// @param other The logger instance to copy from.
+    stepper_cash_karp(const stepper_cash_karp &other) = delete;
+
+    /// @brief Move constructor.
+    /// @param other The logger instance to move from.
+    stepper_cash_karp(stepper_cash_karp &&other) noexcept = default;
+
+    /// @brief Copy assignment operator.
+    /// @param other The logger instance to copy from.
+    /// @return Reference to the logger instance.
+    auto operator=(const stepper_cash_karp &other) -> stepper_cash_karp & = delete;
+
+    /// @brief Move assignment operator.
+    /// @param other The logger instance to move from.
+    /// @return Reference to the logger instance.
+    auto operator=(stepper_cash_karp &&other) noexcept -> stepper_cash_karp & = default;
+
+    /// @brief Returns the order of the stepper.
+    /// @return The order of the main solution, which is 5.
+    constexpr auto order_step() const -> order_type { return 5; }
+
+    /// @brief Returns the order of the embedded solution.
+    /// @return The order of the embedded solution, which is 4.
+    constexpr auto order_error() const -> order_type { return 4; }
+
+    /// @brief Adjusts the size of the internal state vectors based on a reference.
+    /// @param reference A reference state vector used for size adjustment.
+    void adjust_size(const state_type &reference)
+    {
+        if constexpr (detail::has_resize<state_type>::value) {
+            m_dxdt1.resize(reference.size());
+            m_dxdt2.resize(reference.size());
+            m_dxdt3.resize(reference.size());
+            m_dxdt4.resize(reference.size());
+            m_dxdt5.resize(reference.size());
+            m_dxdt6.resize(reference.size());
+            m_x.resize(reference.size());
+        }
+    }
+
+    /// @brief Discards the data cached from the previous steps (e.g., after a discontinuity of the system).
+    /// @details The stepper does not carry any data between the steps.
+    void reset()
+    {
+        // Nothing to do.
+    }
+
+    /// @brief Returns the number of steps executed by the stepper so far.
+    /// @return The number of integration steps executed.
+    constexpr auto steps() const { return m_steps; }
+
+    /// @brief Saves, or restores, the state carried by the stepper between the steps (see `numint/checkpoint.hpp`).
+    /// @tparam Archive The type of the archive.
+    /// @param archive The archive.
+    template <class Archive>
+    void serialize(Archive &archive)
+    {
+        archive(m_steps);
+    }
+
+    /// @brief Performs a single integration step using the Cash-Karp method.
+    /// @tparam System The type of the system representing the differential equations.
+    /// @param system The system to integrate.
+    /// @param x The initial state vector, replaced with the fifth-order solution.
+    /// @param t The initial time.
+    /// @param dt The time step for integration.
+    template <class System>
+    void do_step(System &&system, state_type &x, const time_type t, const time_type dt)
+    {
+        // Compute the six stages.
+        this->compute_stages(std::forward<System>(system), x, t, dt);
+
+        // Update the state with the fifth-order solution (the coefficients of
+        // m_dxdt2 and m_dxdt5 are zero):
+        //      x(t + dt) = x(t) + dt * (b1 * m_dxdt1 + b3 * m_dxdt3 + b4 * m_dxdt4 + b6 * m_dxdt6);
+        detail::it_algebra::accumulate_operation(
+            x.begin(), x.end(), std::multiplies<>(), dt * time_type(37. / 378.), m_dxdt1.begin(),
+            dt * time_type(250. / 621.), m_dxdt3.begin(), dt * time_type(125. / 594.), m_dxdt4.begin(),
+            dt * time_type(512. / 1771.), m_dxdt6.begin());
+
+        // Increase the number of steps.
+        ++m_steps;
+    }
+
+    /// @brief Performs a single integration step, and provides the embedded solution.
+    /// @tparam System The type of the system representing the differential equations.
+    /// @param system The system to integrate.
+    /// @param x The initial state vector, replaced with the fifth-order solution.
+    /// @param x_embedded The output state vector, receiving the fourth-order solution.
+    /// @param t The initial time.
+    /// @param dt The time step for integration.
+    template <class System>
+    void do_step(System &&system, state_type &x, state_type &x_embedded, const time_type t, const time_type dt)
+    {
+        // Compute the six stages.
+        this->compute_stages(std::forward<System>(system), x, t, dt);
+
+        // Compute the fourth-order embedded solution (the coefficient of m_dxdt2 is zero):
+        //      x_embedded = x(t) + dt * sum(b*_i * m_dxdt_i);
+        detail::it_algebra::sum_operation(
+            x_embedded.begin(), x_embedded.end(), std::multiplies<>(), time_type(1), x.begin(),
+            dt * time_type(2825. / 27648.), m_dxdt1.begin(), dt * time_type(18575. / 48384.), m_dxdt3.begin(),
+            dt * time_type(13525. / 55296.), m_dxdt4.begin(), dt * time_type(277. / 14336.), m_dxdt5.begin(),
+            dt * time_type(1. / 4.), m_dxdt6.begin());
+
+        // Update the state with the fifth-order solution:
+        //      x(t + dt) = x(t) + dt * (b1 * m_dxdt1 + b3 * m_dxdt3 + b4 * m_dxdt4 + b6 * m_dxdt6);
+        detail::it_algebra::accumulate_operation(
+            x.begin(), x.end(), std::multiplies<>(), dt * time_type(37. / 378.), m_dxdt1.begin(),
+            dt * time_type(250. / 621.), m_dxdt3.begin(), dt * time_type(125. / 594.), m_dxdt4.begin(),
+            dt * time_type(512. / 1771.), m_dxdt6.begin());
+
+        // Increase the number of steps.
+        ++m_steps;
+    }
+
+    /// @brief Performs a single integration step, and measures the error of the embedded solution.
+    /// @details The difference between the fifth-order and the fourth-order solutions is
+    /// computed directly from the stages, and it is measured while the state
+    /// is updated, in a single pass, without storing the embedded solution.
+    /// @tparam System The type of the system representing the differential equations.
+    /// @tparam Metric The type of the error metric.
+    /// @param system The system to integrate.
+    /// @param x The initial state vector, replaced with the fifth-order solution.
+    /// @param t The initial time.
+    /// @param dt The time step for integration.
+    /// @param metric The error metric, called as `metric(i, value, error)` for each element of the new state.
+    /// @return The maximum of the error metric over the elements.
+    template <class System, class Metric>
+    auto do_step_with_error(System &&system, state_type &x, const time_type t, const time_type dt, Metric metric)
+        -> value_type
+    {
+        // Compute the six stages.
+        this->compute_stages(std::forward<System>(system), x, t, dt);
+
+        // Update the state with the fifth-order solution, and measure the error:
+        //      x(t + dt) = x(t) + dt * sum(b_i * m_dxdt_i);
+        //      error = dt * sum((b_i - b*_i) * m_dxdt_i);
+        const value_type error = numint::assign_max_error(
+            x,
+            numint::vec(x) + (dt * time_type(37. / 378.)) * numint::vec(m_dxdt1) +
+                (dt * time_type(250. / 621.)) * numint::vec(m_dxdt3) +
+                (dt * time_type(125. / 594.)) * numint::vec(m_dxdt4) +
+                (dt * time_type(512. / 1771.)) * numint::vec(m_dxdt6),
+            (dt * time_type(37. / 378. - 2825. / 27648.)) * numint::vec(m_dxdt1) +
+                (dt * time_type(250. / 621. - 18575. / 48384.)) * numint::vec(m_dxdt3) +
+                (dt * time_type(125. / 594. - 13525. / 55296.)) * numint::vec(m_dxdt4) +
+                (dt * time_type(-277. / 14336.)) * numint::vec(m_dxdt5) +
+                (dt * time_type(512. / 1771. - 1. / 4.)) * numint::vec(m_dxdt6),
+            metric);
+
+        // Increase the number of steps.
+        ++m_steps;
+        return error;
+    }
+
+private:
+    /// @brief Computes the six stages of the method.
+    /// @tparam System The type of the system representing the differential equations.
+    /// @param system The system to integrate.
+    /// @param x The initial state vector.
+    /// @param t The initial time.
+    /// @param dt The time step for integration.
+    template <class System>
+    void compute_stages(System &&system, const state_type &x, const time_type t, const time_type dt)
+    {
+        // Stage 1:
+        //      m_dxdt1 = f(x, t);
+        std::forward<System>(system)(x, m_dxdt1, t);
+
+        // Stage 2:
+        //      m_dxdt2 = f(x + dt * (a21 * m_dxdt1), t + c2 * dt);
+        detail::it_algebra::sum_operation(
+            m_x.begin(), m_x.end(), std::multiplies<>(), time_type(1), x.begin(), dt * time_type(1. / 5.),
+            m_dxdt1.begin());
+        std::forward<System>(system)(m_x, m_dxdt2, t + (dt * time_type(1. / 5.)));
+
+        // Stage 3:
+        //      m_dxdt3 = f(x + dt * (a31 * m_dxdt1 + a32 * m_dxdt2), t + c3 * dt);
+        detail::it_algebra::sum_operation(
+            m_x.begin(), m_x.end(), std::multiplies<>(), time_type(1), x.begin(), dt * time_type(3. / 40.),
+            m_dxdt1.begin(), dt * time_type(9. / 40.), m_dxdt2.begin());
+        std::forward<System>(system)(m_x, m_dxdt3, t + (dt * time_type(3. / 10.)));
+
+        // Stage 4:
+        //      m_dxdt4 = f(x + dt * (a41 * m_dxdt1 + a42 * m_dxdt2 + a43 * m_dxdt3), t + c4 * dt);
+        detail::it_algebra::sum_operation(
+            m_x.begin(), m_x.end(), std::multiplies<>(), time_type(1), x.begin(), dt * time_type(3. / 10.),
+            m_dxdt1.begin(), dt * time_type(-9. / 10.), m_dxdt2.begin(), dt * time_type(6. / 5.), m_dxdt3.begin());
+        std::forward<System>(system)(m_x, m_dxdt4, t + (dt * time_type(3. / 5.)));
+
+        // Stage 5:
+        //      m_dxdt5 = f(x + dt * (a51 * m_dxdt1 + ... + a54 * m_dxdt4), t + dt);
+        detail::it_algebra::sum_operation(
+            m_x.begin(), m_x.end(), std::multiplies<>(), time_type(1), x.begin(), dt * time_type(-11. / 54.),
+            m_dxdt1.begin(), dt * time_type(5. / 2.), m_dxdt2.begin(), dt * time_type(-70. / 27.), m_dxdt3.begin(),
+            dt * time_type(35. / 27.), m_dxdt4.begin());
+        std::forward<System>(system)(m_x, m_dxdt5, t + dt);
+
+        // Stage 6:
+        //      m_dxdt6 = f(x + dt * (a61 * m_dxdt1 + ... + a65 * m_dxdt5), t + c6 * dt);
+        detail::it_algebra::sum_operation(
+            m_x.begin(), m_x.end(), std::multiplies<>(), time_type(1), x.begin(), dt * time_type(1631. / 55296.),
+            m_dxdt1.begin(), dt * time_type(175. / 512.), m_dxdt2.begin(), dt * time_type(575. / 13824.),
+            m_dxdt3.begin(), dt * time_type(44275. / 110592.), m_dxdt4.begin(), dt * time_type(253. / 4096.),
+            m_dxdt5.begin());
+        std::forward<System>(system)(m_x, m_dxdt6, t + (dt * time_type(7. / 8.)));
+    }
+
+    /// Support vectors for the stages.
+    state_type m_dxdt1, m_dxdt2, m_dxdt3, m_dxdt4, m_dxdt5, m_dxdt6, m_x;
+
+    /// The number of steps of integration.
+    unsigned long m_steps{};
+};
+
+} // namespace numint
@@ -0,0 +1,366 @@
+/// @file stepper_dopri5.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Simplification of the code available at:
+///     https://github.com/headmyshoulder/odeint-v2
+
+#pragma once
+
+#include "numint/detail/it_algebra.hpp"
+#include "numint/detail/type_traits.hpp"
+#include "numint/vec_expr.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <utility>
+
+namespace numint
+{
+
+/// @brief Stepper implementing the Dormand-Prince 5(4) embedded Runge-Kutta method.
+///
+/// @details The method uses seven stages, the last one being evaluated at the
+/// new state, so that it can be reused as the first stage of the following
+/// step (First Same As Last, FSAL). Hence, when a step starts from the state
+/// where the previous one ended, only six evaluations of the system are
+/// required. Alongside the fifth-order solution, the stepper can provide the
+/// fourth-order embedded solution, which is used by `stepper_adaptive` to
+/// estimate the truncation error without resorting to step doubling, and a
+/// continuous extension of the last step, which is used for dense output.
+///
+/// @tparam State The state vector type.
+/// @tparam Time The datatype used to hold time.
+template <class State, class Time>
+class stepper_dopri5
+{
+public:
+    /// @brief Type used for the order of the stepper.
+    using order_type = unsigned short;
+
+    /// @brief Type used to keep track of time.
+    using time_type = Time;
+
+    /// @brief The state vector type.
+    using state_type = State;
+
+    /// @brief Type of value contained in the state vector.
+    using value_type = typename state_type::value_type;
+
+    /// @brief Indicates whether this is an adaptive stepper.
+    static constexpr bool is_adaptive_stepper = false;
+
+    /// @brief Indicates whether this stepper provides an embedded error estimate.
+    static constexpr bool is_embedded_stepper = true;
+
+    /// @brief Constructs a new stepper.
+    stepper_dopri5() = default;
+
+    /// @brief Destructor.
+    ~stepper_dopri5() = default;
+
+    /// @brief Copy constructor.
+    /// @param other The logger instance to copy from.
+    stepper_dopri5(const stepper_dopri5 &other) = delete;
+
+    /// @brief Move constructor.
+    /// @param other The logger instance to move from.
+    stepper_dopri5(stepper_dopri5 &&other) noexcept = default;
+
+    /// @brief Copy assignment operator.
+    /// @param other The logger instance to copy from.
+    /// @return Reference to the logger instance.
+    auto operator=(const stepper_dopri5 &other) -> stepper_dopri5 & = delete;
+
+    /// @brief Move assignment operator.
+    /// @param other The logger instance to move from.
+    /// @return Reference to the logger instance.
+    auto operator=(stepper_dopri5 &&other) noexcept -> stepper_dopri5 & = default;
+
+    /// @brief Returns the order of the stepper.
+    /// @return The order of the main solution, which is 5.
+    constexpr auto order_step() const -> order_type { return 5; }
+
+    /// @brief Returns the order of the embedded solution.
+    /// @return The order of the embedded solution, which is 4.
+    constexpr auto order_error() const -> order_type { return 4; }
+
+    /// @brief Adjusts the size of the internal state vectors based on a reference.
+    /// @details It also discards the derivatives cached by the FSAL property,
+    /// and for the retries of a rejected step, since they might refer to a
+    /// different system or state.
+    /// @param reference A reference state vector used for size adjustment.
+    void adjust_size(const state_type &reference)
+    {
+        if constexpr (detail::has_resize<state_type>::value) {
+            m_dxdt1.resize(reference.size());
+            m_dxdt2.resize(reference.size());
+            m_dxdt3.resize(reference.size());
+            m_dxdt4.resize(reference.size());
+            m_dxdt5.resize(reference.size());
+            m_dxdt6.resize(reference.size());
+            m_dxdt7.resize(reference.size());
+            m_x.resize(reference.size());
+            m_x0.resize(reference.size());
+        }
+        m_fsal  = false;
+        m_first = false;
+    }
+
+    /// @brief Discards the data cached from the previous steps (e.g., after a discontinuity of the system).
+    /// @details The last derivative, reused by the next step (FSAL), and the
+    /// first one, reused by the retries of a rejected step, are evaluated again.
+    void reset()
+    {
+        m_fsal  = false;
+        m_first = false;
+    }
+
+    /// @brief Returns the number of steps executed by the stepper so far.
+    /// @return The number of integration steps executed.
+    constexpr auto steps() const { return m_steps; }
+
+    /// @brief Saves, or restores, the state carried by the stepper between the steps (see `numint/checkpoint.hpp`).
+    /// @details It includes the last stage of the last step, which is reused by the next one (FSAL).
+    /// @tparam Archive The type of the archive.
+    /// @param archive The archive.
+    template <class Archive>
+    void serialize(Archive &archive)
+    {
+        archive(m_steps, m_fsal, m_x, m_t1, m_dxdt7);
+        // The first stage is not saved, the retries evaluate it again.
+        m_first = false;
+    }
+
+    /// @brief Performs a single integration step using the Dormand-Prince method.
+    /// @tparam System The type of the system representing the differential equations.
+    /// @param system The system to integrate.
+    /// @param x The initial state vector, replaced with the fifth-order solution.
+    /// @param t The initial time.
+    /// @param dt The time step for integration.
+    template <class System>
+    void do_step(System &&system, state_type &x, const time_type t, const time_type dt)
+    {
+        // Compute the first six stages, the last one is the new solution:
+        //      m_x = x(t) + dt * sum(b_i * m_dxdt_i);
+        this->compute_stages(std::forward<System>(system), x, t, dt);
+
+        // Move the state to the fifth-order solution.
+        std::copy(m_x.begin(), m_x.end(), x.begin());
+
+        // Evaluate the last stage at the new state, it will be reused by the next step:
+        //      m_dxdt7 = f(x(t + dt), t + dt);
+        std::forward<System>(system)(x, m_dxdt7, t + dt);
+        m_fsal = true;
+        m_t1   = t + dt;
+
+        // Increase the number of steps.
+        ++m_steps;
+    }
+
+    /// @brief Performs a single integration step, and provides the embedded solution.
+    /// @tparam System The type of the system representing the differential equations.
+    /// @param system The system to integrate.
+    /// @param x The initial state vector, replaced with the fifth-order solution.
+    /// @param x_embedded The output state vector, receiving the fourth-order solution.
+    /// @param t The initial time.
+    /// @param dt The time step for integration.
+    template <class System>
+    void do_step(System &&system, state_type &x, state_type &x_embedded, const time_type t, const time_type dt)
+    {
+        // Compute the first six stages, and the fifth-order solution.
+        this->compute_stages(std::forward<System>(system), x, t, dt);
+
+        // Evaluate the last stage at the new state:
+        //      m_dxdt7 = f(m_x, t + dt);
+        std::forward<System>(system)(m_x, m_dxdt7, t + dt);
+        m_fsal = true;
+        m_t1   = t + dt;
+
+        // Compute the fourth-order embedded solution:
+        //      x_embedded = x(t) + dt * sum(b*_i * m_dxdt_i);
+        detail::it_algebra::sum_operation(
+            x_embedded.begin(), x_embedded.end(), std::multiplies<>(), time_type(1), x.begin(),
+            dt * time_type(5179. / 57600.), m_dxdt1.begin(), dt * time_type(7571. / 16695.), m_dxdt3.begin(),
+            dt * time_type(393. / 640.), m_dxdt4.begin(), dt * time_type(-92097. / 339200.), m_dxdt5.begin(),
+            dt * time_type(187. / 2100.), m_dxdt6.begin(), dt * time_type(1. / 40.), m_dxdt7.begin());
+
+        // Move the state to the fifth-order solution.
+        std::copy(m_x.begin(), m_x.end(), x.begin());
+
+        // Increase the number of steps.
+        ++m_steps;
+    }
+
+    /// @brief Performs a single integration step, and measures the error of the embedded solution.
+    /// @details The difference between the fifth-order and the fourth-order solutions is
+    /// computed directly from the stages, and it is measured while the state
+    /// is updated, in a single pass, without storing the embedded solution.
+    /// @tparam System The type of the system representing the differential equations.
+    /// @tparam Metric The type of the error metric.
+    /// @param system The system to integrate.
+    /// @param x The initial state vector, replaced with the fifth-order solution.
+    /// @param t The initial time.
+    /// @param dt The time step for integration.
+    /// @param metric The error metric, called as `metric(i, value, error)` for each element of the new state.
+    /// @return The maximum of the error metric over the elements.
+    template <class System, class Metric>
+    auto do_step_with_error(System &&system, state_type &x, const time_type t, const time_type dt, Metric metric)
+        -> value_type
+    {
+        // Compute the first six stages, and the fifth-order solution.
+        this->compute_stages(std::forward<System>(system), x, t, dt);
+
+        // Evaluate the last stage at the new state:
+        //      m_dxdt7 = f(m_x, t + dt);
+        std::forward<System>(system)(m_x, m_dxdt7, t + dt);
+        m_fsal = true;
+        m_t1   = t + dt;
+
+        // Move the state to the fifth-order solution, and measure the error:
+        //      error = dt * sum((b_i - b*_i) * m_dxdt_i);
+        const value_type error = numint::assign_max_error(
+            x, numint::vec(m_x),
+            (dt * time_type(35. / 384. - 5179. / 57600.)) * numint::vec(m_dxdt1) +
+                (dt * time_type(500. / 1113. - 7571. / 16695.)) * numint::vec(m_dxdt3) +
+                (dt * time_type(125. / 192. - 393. / 640.)) * numint::vec(m_dxdt4) +
+                (dt * time_type(-2187. / 6784. + 92097. / 339200.)) * numint::vec(m_dxdt5) +
+                (dt * time_type(11. / 84. - 187. / 2100.)) * numint::vec(m_dxdt6) +
+                (dt * time_type(-1. / 40.)) * numint::vec(m_dxdt7),
+            metric);
+
+        // Increase the number of steps.
+        ++m_steps;
+        return error;
+    }
+
+    /// @brief Interpolates the last step, with the fourth-order continuous extension of the method.
+    ///
+    /// @details The interpolant (Hairer, Norsett, and Wanner, Section II.6)
+    /// reuses the stages of the last step, hence it costs no additional
+    /// evaluation of the system:
+    ///     x(t + theta * dt) = x0 + theta * (r1 + (1 - theta) * (r2 + theta * (r3 + (1 - theta) * r4)))
+    /// where r1 = x1 - x0, r2 = dt * k1 - r1, r3 = r1 - dt * k7 - r2, r4 = dt * sum(d_i * k_i).
+    ///
+    /// @param x0 The state at the beginning of the last step.
+    /// @param x1 The state at the end of the last step.
+    /// @param dt The step-size of the last step.
+    /// @param theta The position inside the step, between 0 and 1.
+    /// @param x Receives the interpolated state.
+    void interpolate(
+        const state_type &x0,
+        const state_type &x1,
+        const time_type dt,
+        const time_type theta,
+        state_type &x) const
+    {
+        const auto th = static_cast<value_type>(theta);
+        const auto h  = static_cast<value_type>(dt);
+        for (std::size_t i = 0; i < x.size(); ++i) {
+            const value_type r1 = x1[i] - x0[i];
+            const value_type r2 = h * m_dxdt1[i] - r1;
+            const value_type r3 = r1 - h * m_dxdt7[i] - r2;
+            const value_type r4 =
+                h * (value_type(-12715105075. / 11282082432.) * m_dxdt1[i] +
+                     value_type(87487479700. / 32700410799.) * m_dxdt3[i] +
+                     value_type(-10690763975. / 1880347072.) * m_dxdt4[i] +
+                     value_type(701980252875. / 199316789632.) * m_dxdt5[i] +
+                     value_type(-1453857185. / 822651844.) * m_dxdt6[i] +
+                     value_type(69997945. / 29380423.) * m_dxdt7[i]);
+            x[i] = x0[i] + th * (r1 + (1 - th) * (r2 + th * (r3 + (1 - th) * r4)));
+        }
+    }
+
+private:
+    /// @brief Computes the first six stages, and stores the fifth-order solution inside m_x.
+    /// @tparam System The type of the system representing the differential equations.
+    /// @param system The system to integrate.
+    /// @param x The initial state vector.
+    /// @param t The initial time.
+    /// @param dt The time step for integration.
+    template <class System>
+    void compute_stages(System &&system, const state_type &x, const time_type t, const time_type dt)
+    {
+        // Stage 1: reuse the last stage of the previous step, if we are
+        // starting from the state and the time where it ended (i.e., it was accepted), or
+        // its first stage, if we are starting again from the same point
+        // (i.e., it was rejected):
+        //      m_dxdt1 = f(x, t);
+        if (m_fsal && !(t < m_t1) && !(m_t1 < t) && std::equal(x.begin(), x.end(), m_x.begin())) {
+            std::swap(m_dxdt1, m_dxdt7);
+            std::copy(x.begin(), x.end(), m_x0.begin());
+        } else if (!m_first || (t < m_t0) || (m_t0 < t) || !std::equal(x.begin(), x.end(), m_x0.begin())) {
+            std::forward<System>(system)(x, m_dxdt1, t);
+            std::copy(x.begin(), x.end(), m_x0.begin());
+        }
+        m_t0    = t;
+        m_fsal  = false;
+        m_first = true;
+
+        // Stage 2:
+        //      m_dxdt2 = f(x + dt * (a21 * m_dxdt1), t + c2 * dt);
+        detail::it_algebra::sum_operation(
+            m_x.begin(), m_x.end(), std::multiplies<>(), time_type(1), x.begin(), dt * time_type(1. / 5.),
+            m_dxdt1.begin());
+        std::forward<System>(system)(m_x, m_dxdt2, t + (dt * time_type(1. / 5.)));
+
+        // Stage 3:
+        //      m_dxdt3 = f(x + dt * (a31 * m_dxdt1 + a32 * m_dxdt2), t + c3 * dt);
+        detail::it_algebra::sum_operation(
+            m_x.begin(), m_x.end(), std::multiplies<>(), time_type(1), x.begin(), dt * time_type(3. / 40.),
+            m_dxdt1.begin(), dt * time_type(9. / 40.), m_dxdt2.begin());
+        std::forward<System>(system)(m_x, m_dxdt3, t + (dt * time_type(3. / 10.)));
+
+        // Stage 4:
+        //      m_dxdt4 = f(x + dt * (a41 * m_dxdt1 + a42 * m_dxdt2 + a43 * m_dxdt3), t + c4 * dt);
+        detail::it_algebra::sum_operation(
+            m_x.begin(), m_x.end(), std::multiplies<>(), time_type(1), x.begin(), dt * time_type(44. / 45.),
+            m_dxdt1.begin(), dt * time_type(-56. / 15.), m_dxdt2.begin(), dt * time_type(32. / 9.), m_dxdt3.begin());
+        std::forward<System>(system)(m_x, m_dxdt4, t + (dt * time_type(4. / 5.)));
+
+        // Stage 5:
+        //      m_dxdt5 = f(x + dt * (a51 * m_dxdt1 + ... + a54 * m_dxdt4), t + c5 * dt);
+        detail::it_algebra::sum_operation(
+            m_x.begin(), m_x.end(), std::multiplies<>(), time_type(1), x.begin(), dt * time_type(19372. / 6561.),
+            m_dxdt1.begin(), dt * time_type(-25360. / 2187.), m_dxdt2.begin(), dt * time_type(64448. / 6561.),
+            m_dxdt3.begin(), dt * time_type(-212. / 729.), m_dxdt4.begin());
+        std::forward<System>(system)(m_x, m_dxdt5, t + (dt * time_type(8. / 9.)));
+
+        // Stage 6:
+        //      m_dxdt6 = f(x + dt * (a61 * m_dxdt1 + ... + a65 * m_dxdt5), t + dt);
+        detail::it_algebra::sum_operation(
+            m_x.begin(), m_x.end(), std::multiplies<>(), time_type(1), x.begin(), dt * time_type(9017. / 3168.),
+            m_dxdt1.begin(), dt * time_type(-355. / 33.), m_dxdt2.begin(), dt * time_type(46732. / 5247.),
+            m_dxdt3.begin(), dt * time_type(49. / 176.), m_dxdt4.begin(), dt * time_type(-5103. / 18656.),
+            m_dxdt5.begin());
+        std::forward<System>(system)(m_x, m_dxdt6, t + dt);
+
+        // Fifth-order solution (the coefficient of m_dxdt2 is zero):
+        //      m_x = x + dt * (b1 * m_dxdt1 + b3 * m_dxdt3 + ... + b6 * m_dxdt6);
+        detail::it_algebra::sum_operation(
+            m_x.begin(), m_x.end(), std::multiplies<>(), time_type(1), x.begin(), dt * time_type(35. / 384.),
+            m_dxdt1.begin(), dt * time_type(500. / 1113.), m_dxdt3.begin(), dt * time_type(125. / 192.),
+            m_dxdt4.begin(), dt * time_type(-2187. / 6784.), m_dxdt5.begin(), dt * time_type(11. / 84.),
+            m_dxdt6.begin());
+    }
+
+    /// Support vectors for the stages.
+    state_type m_dxdt1{}, m_dxdt2{}, m_dxdt3{}, m_dxdt4{}, m_dxdt5{}, m_dxdt6{}, m_dxdt7{}, m_x{};
+
+    /// The state and the time where the first stage was evaluated.
+    state_type m_x0{};
+    time_type m_t0{};
+
+    /// Whether the last stage holds the derivative at the state stored in m_x, at m_t1.
+    bool m_fsal{false};
+
+    /// The time where the last stage was evaluated.
+    time_type m_t1{};
+
+    /// Whether the first stage holds the derivative at the state stored in m_x0, at m_t0.
+    bool m_first{false};
+
+    /// The number of steps of integration.
+    unsigned long m_steps{};
+};
+
+} // namespace numint
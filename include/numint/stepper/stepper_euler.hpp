@@ -70,10 +70,26 @@ public:
         }
     }
 
+    /// @brief Discards the data cached from the previous steps (e.g., after a discontinuity of the system).
+    /// @details The stepper does not carry any data between the steps.
+    void reset()
+    {
+        // Nothing to do.
+    }
+
     /// @brief Returns the number of steps executed by the stepper so far.
     /// @return The number of integration steps executed.
     constexpr auto steps() const { return m_steps; }
 
+    /// @brief Saves, or restores, the state carried by the stepper between the steps (see `numint/checkpoint.hpp`).
+    /// @tparam Archive The type of the archive.
+    /// @param archive The archive.
+    template <class Archive>
+    void serialize(Archive &archive)
+    {
+        archive(m_steps);
+    }
+
     /// @brief Performs a single integration step using Euler's method.
     /// @tparam System The type of the system representing the differential equations.
     /// @param system The system to integrate.
@@ -0,0 +1,422 @@
+/// @file stepper_explicit_rk.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Generic explicit Runge-Kutta stepper, driven by a Butcher tableau
+/// known at compile time.
+
+#pragma once
+
+#include "numint/detail/device.hpp"
+#include "numint/detail/hermite.hpp"
+#include "numint/detail/type_traits.hpp"
+#include "numint/detail/unroll.hpp"
+#include "numint/tableau.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <utility>
+
+namespace numint
+{
+
+/// @brief Stepper implementing the explicit Runge-Kutta method described by a
+/// Butcher tableau (see `numint/tableau.hpp`).
+///
+/// @details Since the tableau is known at compile time, the stages and the
+/// sums over the stages are unrolled, and the terms whose coefficient is zero
+/// are dropped, so that each stage is compiled to the same code as a
+/// hand-written stepper. For states whose size is known at compile time
+/// (`std::array`), the loops over the elements are unrolled as well, which
+/// turns each stage into straight-line code for small systems.
+///
+/// When the tableau provides an embedded solution, the stepper can be used by
+/// `stepper_adaptive` as an embedded pair (see `do_step_with_error`). When the
+/// last stage of the tableau is evaluated at the solution (FSAL), it is reused
+/// as the first stage of the next step, as long as the step starts from the
+/// state where the previous one ended, and the last step can be interpolated
+/// for dense output.
+///
+/// The stepping functions are also compiled for GPU devices (see
+/// `numint/device.hpp`), where each thread integrates a trajectory whose state
+/// has a size known at compile time, and is kept in the registers.
+///
+/// @tparam State The state vector type.
+/// @tparam Time The datatype used to hold time.
+/// @tparam Tableau The Butcher tableau of the method.
+template <class State, class Time, class Tableau>
+class stepper_explicit_rk
+{
+    static_assert(Tableau::stages >= 1, "The tableau must have at least one stage.");
+    static_assert(detail::is_explicit_tableau<Tableau>(), "The coefficients must be strictly lower triangular.");
+
+    /// The number of stages.
+    static constexpr std::size_t stages = Tableau::stages;
+
+    /// Whether the last stage is evaluated at the solution.
+    static constexpr bool fsal = detail::is_fsal_tableau_v<Tableau>;
+
+public:
+    /// @brief Type used for the order of the stepper.
+    using order_type = unsigned short;
+
+    /// @brief Type used to keep track of time.
+    using time_type = Time;
+
+    /// @brief The state vector type.
+    using state_type = State;
+
+    /// @brief Type of value contained in the state vector.
+    using value_type = typename state_type::value_type;
+
+    /// @brief The Butcher tableau of the method.
+    using tableau_type = Tableau;
+
+    /// @brief Indicates whether this is an adaptive stepper.
+    static constexpr bool is_adaptive_stepper = false;
+
+    /// @brief Indicates whether this stepper provides an embedded error estimate.
+    static constexpr bool is_embedded_stepper = detail::has_embedded_tableau_v<Tableau>;
+
+    /// @brief Constructs a new stepper.
+    stepper_explicit_rk() = default;
+
+    /// @brief Destructor.
+    ~stepper_explicit_rk() = default;
+
+    /// @brief Copy constructor.
+    /// @param other The logger instance to copy from.
+    stepper_explicit_rk(const stepper_explicit_rk &other) = delete;
+
+    /// @brief Move constructor.
+    /// @param other The logger instance to move from.
+    stepper_explicit_rk(stepper_explicit_rk &&other) noexcept = default;
+
+    /// @brief Copy assignment operator.
+    /// @param other The logger instance to copy from.
+    /// @return Reference to the logger instance.
+    auto operator=(const stepper_explicit_rk &other) -> stepper_explicit_rk & = delete;
+
+    /// @brief Move assignment operator.
+    /// @param other The logger instance to move from.
+    /// @return Reference to the logger instance.
+    auto operator=(stepper_explicit_rk &&other) noexcept -> stepper_explicit_rk & = default;
+
+    /// @brief Returns the order of the stepper.
+    /// @return The order of the method.
+    NUMINT_HOST_DEVICE constexpr auto order_step() const -> order_type { return Tableau::order; }
+
+    /// @brief Returns the order of the embedded solution, for embedded tableaux.
+    /// @return The order of the embedded solution.
+    NUMINT_HOST_DEVICE constexpr auto order_error() const -> order_type
+    {
+        static_assert(is_embedded_stepper, "The tableau does not provide an embedded solution.");
+        return Tableau::order_error;
+    }
+
+    /// @brief Adjusts the size of the internal state vectors based on a reference.
+    /// @details It also discards the derivatives cached by the FSAL property,
+    /// and for the retries of a rejected step, since they might refer to a
+    /// different system or state.
+    /// @param reference A reference state vector used for size adjustment.
+    NUMINT_HOST_DEVICE constexpr void adjust_size(const state_type &reference)
+    {
+        if constexpr (detail::has_resize<state_type>::value) {
+            for (auto &k : m_k) {
+                k.resize(reference.size());
+            }
+            m_x.resize(reference.size());
+            if constexpr (fsal) {
+                m_x0.resize(reference.size());
+            }
+        }
+        m_fsal  = false;
+        m_first = false;
+    }
+
+    /// @brief Discards the data cached from the previous steps (e.g., after a discontinuity of the system).
+    /// @details The last derivative, reused by the next step (FSAL), and the
+    /// first one, reused by the retries of a rejected step, are evaluated again.
+    NUMINT_HOST_DEVICE void reset()
+    {
+        m_fsal  = false;
+        m_first = false;
+    }
+
+    /// @brief Returns the number of steps executed by the stepper so far.
+    /// @return The number of integration steps executed.
+    NUMINT_HOST_DEVICE constexpr auto steps() const { return m_steps; }
+
+    /// @brief Saves, or restores, the state carried by the stepper between the steps (see `numint/checkpoint.hpp`).
+    /// @details For the FSAL tableaux, it includes the last stage of the last step, which is reused by the next one.
+    /// @tparam Archive The type of the archive.
+    /// @param archive The archive.
+    template <class Archive>
+    void serialize(Archive &archive)
+    {
+        archive(m_steps);
+        if constexpr (fsal) {
+            archive(m_fsal, m_x, m_t1, m_k[stages - 1]);
+        }
+        // The first stage is not saved, the retries evaluate it again.
+        m_first = false;
+    }
+
+    /// @brief Performs a single integration step.
+    /// @tparam System The type of the system representing the differential equations.
+    /// @param system The system to integrate.
+    /// @param x The initial state vector.
+    /// @param t The initial time.
+    /// @param dt The time step for integration.
+    template <class System>
+    NUMINT_HOST_DEVICE void do_step(System &&system, state_type &x, const time_type t, const time_type dt)
+    {
+        this->compute_stages(std::forward<System>(system), x, t, dt);
+
+        if constexpr (fsal) {
+            // The last stage was evaluated at the solution, it will be reused by the next step.
+            detail::copy_state(m_x, x);
+            m_fsal = true;
+            m_t1   = t + dt;
+        } else {
+            //      x = x(t) + dt * sum(b_i * k_i);
+            detail::for_each_index(x, [&](std::size_t i) {
+                x[i] = this->combine<solution_weights>(x[i], i, dt, std::make_index_sequence<stages>{});
+            });
+        }
+
+        ++m_steps;
+    }
+
+    /// @brief Performs a single integration step, and measures the error of the embedded solution.
+    /// @details The difference between the solution and the embedded solution
+    /// is computed directly from the stages, and it is measured while the
+    /// state is updated, in a single pass, without storing the embedded solution.
+    /// @tparam System The type of the system representing the differential equations.
+    /// @tparam Metric The type of the error metric.
+    /// @param system The system to integrate.
+    /// @param x The initial state vector, replaced with the solution.
+    /// @param t The initial time.
+    /// @param dt The time step for integration.
+    /// @param metric The error metric, called as `metric(i, value, error)` for each element of the new state.
+    /// @return The maximum of the error metric over the elements.
+    template <class System, class Metric>
+    NUMINT_HOST_DEVICE auto do_step_with_error(
+        System &&system, state_type &x, const time_type t, const time_type dt, Metric metric) -> value_type
+    {
+        static_assert(is_embedded_stepper, "The tableau does not provide an embedded solution.");
+
+        this->compute_stages(std::forward<System>(system), x, t, dt);
+
+        // Move the state to the solution, and measure the error:
+        //      error = dt * sum((b_i - b*_i) * k_i);
+        value_type result(std::numeric_limits<value_type>::epsilon());
+        detail::for_each_index(x, [&](std::size_t i) {
+            value_type value;
+            if constexpr (fsal) {
+                value = m_x[i];
+            } else {
+                value = this->combine<solution_weights>(x[i], i, dt, std::make_index_sequence<stages>{});
+            }
+            const value_type error =
+                this->combine<error_weights>(value_type(0), i, dt, std::make_index_sequence<stages>{});
+            result = std::max(result, static_cast<value_type>(metric(i, value, error)));
+            x[i]   = value;
+        });
+        if constexpr (fsal) {
+            m_fsal = true;
+            m_t1   = t + dt;
+        }
+
+        ++m_steps;
+        return result;
+    }
+
+    /// @brief Interpolates the last step, with the cubic Hermite polynomial.
+    /// @details Available for the FSAL tableaux only, whose first and last
+    /// stages are the derivatives at both ends of the step, so that the
+    /// interpolation costs no additional evaluation of the system.
+    /// @param x0 The state at the beginning of the last step.
+    /// @param x1 The state at the end of the last step.
+    /// @param dt The step-size of the last step.
+    /// @param theta The position inside the step, between 0 and 1.
+    /// @param x Receives the interpolated state.
+    template <class T = Tableau, std::enable_if_t<detail::is_fsal_tableau_v<T>, int> = 0>
+    void interpolate(
+        const state_type &x0,
+        const state_type &x1,
+        const time_type dt,
+        const time_type theta,
+        state_type &x) const
+    {
+        detail::hermite_interpolate(x0, m_k[0], x1, m_k[stages - 1], dt, theta, x);
+    }
+
+private:
+    /// @brief The coefficients of a stage.
+    /// @tparam Stage The index of the stage.
+    template <std::size_t Stage>
+    struct stage_weights {
+        /// @brief Returns the coefficient of a previous stage.
+        /// @param j The index of the previous stage.
+        /// @return the coefficient.
+        NUMINT_HOST_DEVICE static constexpr auto weight(std::size_t j) -> double { return Tableau::a[Stage][j]; }
+    };
+
+    /// @brief The weights of the solution.
+    struct solution_weights {
+        /// @brief Returns the weight of a stage.
+        /// @param j The index of the stage.
+        /// @return the weight.
+        NUMINT_HOST_DEVICE static constexpr auto weight(std::size_t j) -> double { return Tableau::b[j]; }
+    };
+
+    /// @brief The weights of the error, i.e., of the difference between the solution and the embedded one.
+    struct error_weights {
+        /// @brief Returns the weight of a stage.
+        /// @param j The index of the stage.
+        /// @return the weight.
+        NUMINT_HOST_DEVICE static constexpr auto weight(std::size_t j) -> double
+        {
+            return Tableau::b[j] - Tableau::b_hat[j];
+        }
+    };
+
+    /// @brief Adds the term of a stage to a sum, unless its weight is zero.
+    /// @tparam Weights The weights of the sum.
+    /// @tparam J The index of the stage.
+    /// @param sum The sum.
+    /// @param i The index of the element.
+    /// @param dt The time step.
+    template <class Weights, std::size_t J>
+    NUMINT_HOST_DEVICE constexpr void accumulate(
+        [[maybe_unused]] value_type &sum,
+        [[maybe_unused]] std::size_t i,
+        [[maybe_unused]] const time_type dt) const
+    {
+        if constexpr (!detail::is_zero_coefficient(Weights::weight(J))) {
+            sum += static_cast<value_type>(dt * time_type(Weights::weight(J))) * m_k[J][i];
+        }
+    }
+
+    /// @brief Computes an element of `init + dt * sum(w_j * k_j)`, over the given stages.
+    /// @tparam Weights The weights of the sum.
+    /// @param init The initial value.
+    /// @param i The index of the element.
+    /// @param dt The time step.
+    /// @return the element.
+    template <class Weights, std::size_t... J>
+    NUMINT_HOST_DEVICE constexpr auto combine(
+        value_type init,
+        [[maybe_unused]] std::size_t i,
+        [[maybe_unused]] const time_type dt,
+        std::index_sequence<J...> /*stages*/) const -> value_type
+    {
+        (this->accumulate<Weights, J>(init, i, dt), ...);
+        return init;
+    }
+
+    /// @brief Computes a stage, after the first one. For the last stage of the
+    /// FSAL tableaux, m_x holds the solution.
+    /// @tparam Stage The index of the stage.
+    /// @tparam System The type of the system representing the differential equations.
+    /// @param system The system to integrate.
+    /// @param x The initial state vector.
+    /// @param t The initial time.
+    /// @param dt The time step for integration.
+    template <std::size_t Stage, class System>
+    NUMINT_HOST_DEVICE void compute_stage(System &&system, const state_type &x, const time_type t, const time_type dt)
+    {
+        //      k_s = f(x + dt * sum(a_sj * k_j), t + c_s * dt);
+        detail::for_each_index(x, [&](std::size_t i) {
+            m_x[i] = this->combine<stage_weights<Stage>>(x[i], i, dt, std::make_index_sequence<Stage>{});
+        });
+        std::forward<System>(system)(m_x, m_k[Stage], t + time_type(Tableau::c[Stage]) * dt);
+    }
+
+    /// @brief Computes all the stages.
+    /// @tparam System The type of the system representing the differential equations.
+    /// @param system The system to integrate.
+    /// @param x The initial state vector.
+    /// @param t The initial time.
+    /// @param dt The time step for integration.
+    template <class System, std::size_t... Stage>
+    NUMINT_HOST_DEVICE void compute_stages(
+        [[maybe_unused]] System &&system,
+        [[maybe_unused]] const state_type &x,
+        [[maybe_unused]] const time_type t,
+        [[maybe_unused]] const time_type dt,
+        std::index_sequence<Stage...> /*stages*/)
+    {
+        (this->compute_stage<Stage + 1>(std::forward<System>(system), x, t, dt), ...);
+    }
+
+    /// @brief Computes all the stages.
+    /// @tparam System The type of the system representing the differential equations.
+    /// @param system The system to integrate.
+    /// @param x The initial state vector.
+    /// @param t The initial time.
+    /// @param dt The time step for integration.
+    template <class System>
+    NUMINT_HOST_DEVICE void compute_stages(System &&system, const state_type &x, const time_type t, const time_type dt)
+    {
+        // Stage 1: reuse the last stage of the previous step, if we are
+        // starting from the state and the time where it ended (i.e., it was accepted), or,
+        // for the FSAL tableaux, its first stage, if we are starting again
+        // from the same point (i.e., it was rejected):
+        //      k_1 = f(x, t);
+        if (m_fsal && !(t < m_t1) && !(m_t1 < t) && detail::equal_states(x, m_x)) {
+            if constexpr (detail::has_resize_v<state_type>) {
+                using std::swap;
+                swap(m_k[0], m_k[stages - 1]);
+            } else {
+                // The states are stored in place, copying only the first stage is cheaper than swapping them.
+                detail::copy_state(m_k[stages - 1], m_k[0]);
+            }
+            detail::copy_state(x, m_x0);
+        } else if (!m_first || (t < m_t0) || (m_t0 < t) || !detail::equal_states(x, m_x0)) {
+            std::forward<System>(system)(x, m_k[0], t);
+            if constexpr (fsal) {
+                detail::copy_state(x, m_x0);
+            }
+        }
+        m_t0    = t;
+        m_fsal  = false;
+        m_first = fsal;
+
+        this->compute_stages(std::forward<System>(system), x, t, dt, std::make_index_sequence<stages - 1>{});
+    }
+
+    /// The stages.
+    std::array<state_type, stages> m_k{};
+    /// The state at which the stages are evaluated, for the FSAL tableaux it
+    /// holds the solution of the last step.
+    state_type m_x{};
+    /// Whether the last stage holds the derivative at the state stored in m_x, at m_t1.
+    bool m_fsal{false};
+    /// The time where the last stage was evaluated, for the FSAL tableaux.
+    time_type m_t1{};
+    /// The state and the time where the first stage was evaluated, for the FSAL tableaux.
+    state_type m_x0{};
+    time_type m_t0{};
+    /// Whether the first stage holds the derivative at the state stored in m_x0, at m_t0.
+    bool m_first{false};
+    /// The number of steps of integration.
+    uint64_t m_steps{};
+};
+
+/// @brief Stepper implementing the classic Runge-Kutta 4th order method, through its tableau.
+/// @tparam State The state vector type.
+/// @tparam Time The datatype used to hold time.
+template <class State, class Time>
+using stepper_explicit_rk4 = stepper_explicit_rk<State, Time, tableau::rk4>;
+
+/// @brief Stepper implementing the Dormand-Prince 5(4) method, through its tableau.
+/// @tparam State The state vector type.
+/// @tparam Time The datatype used to hold time.
+template <class State, class Time>
+using stepper_explicit_dopri5 = stepper_explicit_rk<State, Time, tableau::dopri5>;
+
+} // namespace numint
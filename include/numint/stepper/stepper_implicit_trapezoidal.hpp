@@ -0,0 +1,176 @@
+/// @file stepper_implicit_trapezoidal.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Implicit trapezoidal method (Crank-Nicolson), for stiff systems.
+
+#pragma once
+
+#include "numint/detail/newton.hpp"
+#include "numint/detail/type_traits.hpp"
+#include "numint/linear/dense_lu_solver.hpp"
+#include "numint/vec_expr.hpp"
+
+#include <algorithm>
+
+namespace numint
+{
+
+/// @brief Stepper implementing the implicit trapezoidal method.
+///
+/// @details The new state is the solution of:
+///     x(t + dt) = x(t) + 0.5 * dt * (f(x(t), t) + f(x(t + dt), t + dt))
+/// which is computed by simplified Newton iterations. The method is
+/// second-order accurate and A-stable, hence the step-size is not limited by
+/// the fastest time constants of the system, even though the fast components
+/// are damped only weakly. The Jacobian is provided by the system (see
+/// `numint/jacobian.hpp`), or built by finite differences, and it is reused
+/// across the steps for as long as the iterations converge.
+///
+/// @tparam State The state vector type.
+/// @tparam Time The datatype used to hold time.
+/// @tparam LinearSolver The linear solver used by the Newton iterations.
+template <class State, class Time, class LinearSolver = dense_lu_solver<State>>
+class stepper_implicit_trapezoidal
+{
+public:
+    /// @brief Type used for the order of the stepper.
+    using order_type                          = unsigned short;
+    /// @brief Type used to keep track of time.
+    using time_type                           = Time;
+    /// @brief The state vector.
+    using state_type                          = State;
+    /// @brief Type of value contained in the state vector.
+    using value_type                          = typename state_type::value_type;
+    /// @brief Type of the linear solver.
+    using linear_solver_type                  = LinearSolver;
+    /// @brief Determines if this is an adaptive stepper or not.
+    static constexpr bool is_adaptive_stepper = false;
+
+    /// @brief Constructs a new stepper.
+    stepper_implicit_trapezoidal() = default;
+
+    /// @brief Destructor.
+    ~stepper_implicit_trapezoidal() = default;
+
+    /// @brief Copy constructor.
+    /// @param other The logger instance to copy from.
+    stepper_implicit_trapezoidal(const stepper_implicit_trapezoidal &other) = delete;
+
+    /// @brief Move constructor.
+    /// @param other The logger instance to move from.
+    stepper_implicit_trapezoidal(stepper_implicit_trapezoidal &&other) noexcept = default;
+
+    /// @brief Copy assignment operator.
+    /// @param other The logger instance to copy from.
+    /// @return Reference to the logger instance.
+    auto operator=(const stepper_implicit_trapezoidal &other) -> stepper_implicit_trapezoidal & = delete;
+
+    /// @brief Move assignment operator.
+    /// @param other The logger instance to move from.
+    /// @return Reference to the logger instance.
+    auto operator=(stepper_implicit_trapezoidal &&other) noexcept -> stepper_implicit_trapezoidal & = default;
+
+    /// @brief The order of the stepper we rely upon.
+    /// @return the order of the internal stepper.
+    constexpr auto order_step() const -> order_type { return 2; }
+
+    /// @brief Sets the tolerance of the Newton iterations, relative to (1 + |x|).
+    /// @param tollerance The tolerance.
+    constexpr void set_newton_tollerance(value_type tollerance) { m_newton.set_tollerance(tollerance); }
+
+    /// @brief Sets the maximum number of Newton iterations per step.
+    /// @param max_iterations The maximum number of iterations.
+    constexpr void set_max_newton_iterations(unsigned max_iterations) { m_newton.set_max_iterations(max_iterations); }
+
+    /// @brief Provides access to the linear solver, e.g., to retrieve its statistics.
+    /// @return a reference to the linear solver.
+    constexpr auto linear_solver() -> linear_solver_type & { return m_newton.linear_solver(); }
+
+    /// @brief Adjusts the size of the internal state vectors.
+    /// @param reference a reference state vector vector.
+    void adjust_size(const state_type &reference)
+    {
+        m_newton.adjust_size(reference);
+        if constexpr (detail::has_resize<state_type>::value) {
+            m_x.resize(reference.size());
+            m_b.resize(reference.size());
+        }
+    }
+
+    /// @brief Discards the data cached from the previous steps (e.g., after a discontinuity of the system).
+    /// @details Unlike `adjust_size`, it keeps the internal state vectors, while
+    /// the Jacobian is evaluated again by the next step.
+    void reset()
+    {
+        m_newton.reset();
+    }
+
+    /// @brief Returns the number of steps the stepper executed up until now.
+    /// @return the number of integration steps.
+    constexpr auto steps() const { return m_steps; }
+
+    /// @brief Returns the number of steps where the Newton iterations did not converge.
+    /// @details In that case, the state is updated with the last iterate, and `step_failed` tells `stepper_adaptive`
+    /// to reject the step.
+    /// @return the number of failed steps.
+    constexpr auto newton_failures() const { return m_newton_failures; }
+
+    /// @brief Checks if the Newton iterations of the last step did not converge.
+    /// @return true if the state of the last step is not a solution of the implicit equation.
+    constexpr bool step_failed() const { return m_step_failed; }
+
+    /// @brief Saves, or restores, the state carried by the stepper between the steps (see `numint/checkpoint.hpp`).
+    /// @details The Jacobian is not saved, it is evaluated again by the first step after the restore.
+    /// @tparam Archive The type of the archive.
+    /// @param archive The archive.
+    template <class Archive>
+    void serialize(Archive &archive)
+    {
+        archive(m_steps, m_newton_failures);
+    }
+
+    /// @brief Perform a single integration step using the implicit trapezoidal method.
+    /// @tparam System The type of the system representing the differential equations.
+    /// @param system the system we are integrating.
+    /// @param x the initial state.
+    /// @param t the initial time.
+    /// @param dt the step-size.
+    template <class System>
+    void do_step(System &&system, state_type &x, const time_type t, const time_type dt)
+    {
+        // Keep the initial state.
+        std::copy(x.begin(), x.end(), m_x.begin());
+
+        // Compute the constant term, which is also our initial guess:
+        //      b = x(t) + 0.5 * dt * f(x(t), t)
+        system(m_x, m_b, t);
+        numint::assign(m_b, numint::vec(m_x) + (dt / 2) * numint::vec(m_b));
+        std::copy(m_b.begin(), m_b.end(), x.begin());
+
+        // Solve the implicit equation:
+        //      x(t + dt) = b + 0.5 * dt * f(x(t + dt), t + dt)
+        m_step_failed = false;
+        if (!m_newton.solve(system, x, m_b, dt / 2, t + dt, m_x, t)) {
+            ++m_newton_failures;
+            m_step_failed = true;
+        }
+
+        // Increment the number of integration steps.
+        ++m_steps;
+    }
+
+private:
+    /// The Newton iterations.
+    detail::newton_solver<state_type, time_type, linear_solver_type> m_newton;
+    /// The initial state.
+    state_type m_x;
+    /// The constant term of the implicit equation.
+    state_type m_b;
+    /// The number of steps of integration.
+    unsigned long m_steps{};
+    /// The number of steps where the Newton iterations did not converge.
+    unsigned long m_newton_failures{};
+    /// If the Newton iterations of the last step did not converge.
+    bool m_step_failed{};
+};
+
+} // namespace numint
@@ -60,7 +60,7 @@ public:
 
     /// @brief Returns the order of the stepper.
     /// @return The order of the internal stepper, which is 2 for the Improved Euler method.
-    constexpr auto order_step() const -> order_type { return 1; }
+    constexpr auto order_step() const -> order_type { return 2; }
 
     /// @brief Adjusts the size of the internal state vectors based on a reference.
     /// @param reference A reference state vector used for size adjustment.
@@ -73,10 +73,26 @@ public:
         }
     }
 
+    /// @brief Discards the data cached from the previous steps (e.g., after a discontinuity of the system).
+    /// @details The stepper does not carry any data between the steps.
+    void reset()
+    {
+        // Nothing to do.
+    }
+
     /// @brief Returns the number of steps executed by the stepper so far.
     /// @return The number of integration steps executed.
     constexpr auto steps() const { return m_steps; }
 
+    /// @brief Saves, or restores, the state carried by the stepper between the steps (see `numint/checkpoint.hpp`).
+    /// @tparam Archive The type of the archive.
+    /// @param archive The archive.
+    template <class Archive>
+    void serialize(Archive &archive)
+    {
+        archive(m_steps);
+    }
+
     /// @brief Performs a single integration step using Heun's method (Improved Euler method).
     /// @param system The system to integrate.
     /// @param x The initial state vector.
@@ -92,7 +108,7 @@ public:
         // Calculate the state at the next time point using Euler's method:
         //      m_x(t + dt) = x(t) + dxdt1 * dt;
         detail::it_algebra::sum_operation(
-            m_x.begin(), m_x.end(), std::multiplies<>(), 1., x.begin(), dt, m_dxdt1.begin());
+            m_x.begin(), m_x.end(), std::multiplies<>(), time_type(1), x.begin(), dt, m_dxdt1.begin());
 
         // Calculate the derivative at the midpoint:
         //      dxdt2 = system(m_x, t + dt);
@@ -101,7 +117,7 @@ public:
         // Update the state vector using the average of the derivatives:
         //      x(t + dt) = x(t) + (dt / 2) * (dxdt1 + dxdt2);
         detail::it_algebra::accumulate_operation(
-            x.begin(), x.end(), std::multiplies<>(), dt * .5, m_dxdt1.begin(), dt * .5, m_dxdt2.begin());
+            x.begin(), x.end(), std::multiplies<>(), dt / 2, m_dxdt1.begin(), dt / 2, m_dxdt2.begin());
 
         // Increment the number of integration steps.
         ++m_steps;
@@ -0,0 +1,206 @@
+/// @file stepper_instrumented.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief A stepper collecting the statistics of the stepper it wraps.
+
+#pragma once
+
+#include "numint/detail/type_traits.hpp"
+#include "numint/stats.hpp"
+
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+namespace numint
+{
+
+/// @brief It collects the statistics of the integration carried out by another stepper.
+///
+/// @details The instrumented stepper can be used wherever the wrapped one is
+/// used: it counts (and times) the evaluations of the system, the accepted
+/// steps and their step-sizes, the rejected attempts of the steppers counting
+/// them (i.e., `rejections()`), and the errors of the steppers providing them
+/// (i.e., `get_last_error_ratio()`). The time spent inside the observer is
+/// measured by wrapping it with `with_stats`, e.g.:
+///
+///     stepper_instrumented<stepper_adaptive<stepper_dopri5<State, double>>> stepper;
+///     integrate_adaptive(stepper, with_stats(observer, stepper.stats()), system, x, 0., 10., 1e-3);
+///
+/// With `no_stats` the steps are simply forwarded to the wrapped stepper.
+///
+/// @tparam Stepper The stepper we rely upon.
+/// @tparam Stats The statistics policy (e.g., `solver_stats`, or `no_stats`).
+template <class Stepper, class Stats = solver_stats<typename Stepper::time_type>>
+class stepper_instrumented
+{
+public:
+    /// @brief Type of the stepper we are instrumenting.
+    using stepper_type                        = Stepper;
+    /// @brief Type of the statistics.
+    using stats_type                          = Stats;
+    /// @brief Type used for the order of the stepper.
+    using order_type                          = typename Stepper::order_type;
+    /// @brief Type used to keep track of time.
+    using time_type                           = typename Stepper::time_type;
+    /// @brief The state vector.
+    using state_type                          = typename Stepper::state_type;
+    /// @brief Type of value contained in the state vector.
+    using value_type                          = typename Stepper::value_type;
+    /// @brief Determines if this is an adaptive stepper or not.
+    static constexpr bool is_adaptive_stepper = Stepper::is_adaptive_stepper;
+
+    /// @brief Creates a new instrumented stepper.
+    stepper_instrumented()
+        : m_stepper()
+        , m_stats()
+    {
+        // Nothing to do.
+    }
+
+    /// @brief Destructor.
+    ~stepper_instrumented() = default;
+
+    /// @brief Copy constructor.
+    /// @param other The logger instance to copy from.
+    stepper_instrumented(const stepper_instrumented &other) = delete;
+
+    /// @brief Move constructor.
+    /// @param other The logger instance to move from.
+    stepper_instrumented(stepper_instrumented &&other) noexcept = default;
+
+    /// @brief Copy assignment operator.
+    /// @param other The logger instance to copy from.
+    /// @return Reference to the logger instance.
+    auto operator=(const stepper_instrumented &other) -> stepper_instrumented & = delete;
+
+    /// @brief Move assignment operator.
+    /// @param other The logger instance to move from.
+    /// @return Reference to the logger instance.
+    auto operator=(stepper_instrumented &&other) noexcept -> stepper_instrumented & = default;
+
+    /// @brief Provides access to the stepper we are instrumenting, e.g., to tune it.
+    /// @return A reference to the stepper.
+    constexpr auto stepper() -> stepper_type & { return m_stepper; }
+
+    /// @brief Provides access to the statistics collected so far.
+    /// @return A reference to the statistics.
+    constexpr auto stats() -> stats_type & { return m_stats; }
+
+    /// @brief Provides access to the statistics collected so far.
+    /// @return A constant reference to the statistics.
+    constexpr auto stats() const -> const stats_type & { return m_stats; }
+
+    /// @brief The order of the stepper we rely upon.
+    /// @return the order of the internal stepper.
+    constexpr auto order_step() const -> order_type { return m_stepper.order_step(); }
+
+    /// @brief Sets the tolerance of the adaptive stepper.
+    /// @param tollerance The tolerance value to use for adjusting the step size.
+    constexpr void set_tollerance(value_type tollerance) { m_stepper.set_tollerance(tollerance); }
+
+    /// @brief Sets the minimum allowed step size of the adaptive stepper.
+    /// @param min_delta The minimum step size.
+    constexpr void set_min_delta(value_type min_delta) { m_stepper.set_min_delta(min_delta); }
+
+    /// @brief Sets the maximum allowed step size of the adaptive stepper.
+    /// @param max_delta The maximum step size.
+    constexpr void set_max_delta(value_type max_delta) { m_stepper.set_max_delta(max_delta); }
+
+    /// @brief Retrieves the current step size of the adaptive stepper.
+    /// @return The current step size as a `time_type` value.
+    constexpr auto get_time_delta() const -> time_type { return m_stepper.get_time_delta(); }
+
+    /// @brief Retrieves the step size used by the last accepted step of the adaptive stepper.
+    /// @return The last step size as a `time_type` value.
+    constexpr auto get_last_time_delta() const -> time_type { return m_stepper.get_last_time_delta(); }
+
+    /// @brief Adjusts the size of the internal state vectors of the stepper.
+    /// @param reference a reference state vector vector.
+    void adjust_size(const state_type &reference) { m_stepper.adjust_size(reference); }
+
+    /// @brief Discards the data cached by the wrapped stepper (e.g., after a discontinuity of the system).
+    template <class S = stepper_type, std::enable_if_t<detail::has_reset_v<S>, int> = 0>
+    void reset()
+    {
+        m_stepper.reset();
+    }
+
+    /// @brief Returns the number of steps the stepper executed up until now.
+    /// @return the number of integration steps.
+    constexpr auto steps() const { return m_stepper.steps(); }
+
+    /// @brief Saves, or restores, the state carried by the stepper between the steps (see `numint/checkpoint.hpp`).
+    /// @details Only the wrapped stepper is saved, the statistics keep counting from their current values.
+    /// @tparam Archive The type of the archive.
+    /// @param archive The archive.
+    template <class Archive>
+    void serialize(Archive &archive)
+    {
+        m_stepper.serialize(archive);
+    }
+
+    /// @brief Performs one integration step, collecting its statistics.
+    ///
+    /// @tparam System The type of the system being integrated.
+    ///
+    /// @param system The system that defines the equations of motion or dynamics.
+    /// @param x The state of the system, which will be updated after this step.
+    /// @param t The current time.
+    /// @param dt The time step to use for the integration.
+    template <class System>
+    constexpr void do_step(System &&system, state_type &x, const time_type t, const time_type dt)
+    {
+        if constexpr (!stats_type::enabled) {
+            m_stepper.do_step(std::forward<System>(system), x, t, dt);
+        } else {
+            using system_type = std::remove_reference_t<System>;
+            // Count the evaluations of the system.
+            detail::counted_system<system_type, stats_type> counted(system, m_stats);
+            // Keep track of the rejections of this step alone.
+            std::uint64_t rejections = 0;
+            if constexpr (detail::has_rejections<stepper_type>::value) {
+                rejections = static_cast<std::uint64_t>(m_stepper.rejections());
+            }
+            const auto start = stats_type::now();
+            m_stepper.do_step(counted, x, t, dt);
+            const auto elapsed = stats_type::since(start);
+            if constexpr (detail::has_rejections<stepper_type>::value) {
+                rejections = static_cast<std::uint64_t>(m_stepper.rejections()) - rejections;
+            }
+            if constexpr (is_adaptive_stepper) {
+                m_stats.record_step(m_stepper.get_last_time_delta(), rejections, elapsed);
+            } else {
+                m_stats.record_step(dt, rejections, elapsed);
+            }
+            if constexpr (detail::has_error_ratio<stepper_type>::value) {
+                m_stats.record_error(static_cast<double>(m_stepper.get_last_error_ratio()));
+            }
+        }
+    }
+
+    /// @brief Interpolates the last step, with the continuous extension of the stepper.
+    ///
+    /// @param x0 The state at the beginning of the last step.
+    /// @param x1 The state at the end of the last step.
+    /// @param dt The step-size of the last step.
+    /// @param theta The position inside the step, between 0 and 1.
+    /// @param x Receives the interpolated state.
+    template <class S = stepper_type, std::enable_if_t<detail::has_dense_output_v<S>, int> = 0>
+    void interpolate(
+        const state_type &x0,
+        const state_type &x1,
+        const time_type dt,
+        const time_type theta,
+        state_type &x) const
+    {
+        m_stepper.interpolate(x0, x1, dt, theta, x);
+    }
+
+private:
+    /// The stepper we are instrumenting.
+    stepper_type m_stepper;
+    /// The statistics collected so far.
+    stats_type m_stats;
+};
+
+} // namespace numint
@@ -70,10 +70,26 @@ public:
         }
     }
 
+    /// @brief Discards the data cached from the previous steps (e.g., after a discontinuity of the system).
+    /// @details The stepper does not carry any data between the steps.
+    void reset()
+    {
+        // Nothing to do.
+    }
+
     /// @brief Returns the number of steps executed by the stepper so far.
     /// @return The number of integration steps executed.
     constexpr auto steps() const { return m_steps; }
 
+    /// @brief Saves, or restores, the state carried by the stepper between the steps (see `numint/checkpoint.hpp`).
+    /// @tparam Archive The type of the archive.
+    /// @param archive The archive.
+    template <class Archive>
+    void serialize(Archive &archive)
+    {
+        archive(m_steps);
+    }
+
     /// @brief Performs a single integration step using the Midpoint Method.
     /// @param system The system to integrate.
     /// @param x The initial state vector.
@@ -88,15 +104,15 @@ public:
 
         // Update the state vector to the midpoint:
         //      x(t + (dt / 2)) = x(t) + dxdt * (dt / 2);
-        detail::it_algebra::accumulate_operation(x.begin(), x.end(), std::multiplies<>(), dt / 2., m_dxdt.begin());
+        detail::it_algebra::accumulate_operation(x.begin(), x.end(), std::multiplies<>(), dt / 2, m_dxdt.begin());
 
         // Calculate the derivative at the midpoint:
         //      dxdt = system(x, t + (dt / 2));
-        std::forward<System>(system)(x, m_dxdt, t + (dt / 2.));
+        std::forward<System>(system)(x, m_dxdt, t + (dt / 2));
 
         // Update the state vector to the next time step using the midpoint method:
         //      x(t + dt) = x(t) + dxdt * (dt / 2);
-        detail::it_algebra::accumulate_operation(x.begin(), x.end(), std::multiplies<>(), dt / 2., m_dxdt.begin());
+        detail::it_algebra::accumulate_operation(x.begin(), x.end(), std::multiplies<>(), dt / 2, m_dxdt.begin());
 
         // Increment the number of integration steps.
         ++m_steps;
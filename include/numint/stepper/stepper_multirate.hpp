@@ -0,0 +1,338 @@
+/// @file stepper_multirate.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Multirate stepper, advancing the slow variables of a system with
+/// large steps, and sub-cycling the fast ones with small steps.
+
+#pragma once
+
+#include "numint/detail/less_with_sign.hpp"
+#include "numint/detail/type_traits.hpp"
+#include "numint/multirate.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+namespace numint
+{
+
+namespace detail
+{
+
+/// @brief The slow part of a multirate system, with the fast variables frozen.
+/// @tparam System The type of the multirate system.
+template <class System>
+class multirate_slow_part
+{
+public:
+    /// @brief Wraps the system.
+    /// @param system The multirate system.
+    explicit multirate_slow_part(System &system) noexcept
+        : m_system(system)
+    {
+        // Nothing to do.
+    }
+
+    /// @brief Evaluates the derivative of the slow variables, the one of the fast variables being zero.
+    /// @param x The state.
+    /// @param dxdt The derivative of the state.
+    /// @param t The time.
+    template <class State, class Time>
+    void operator()(const State &x, State &dxdt, Time t)
+    {
+        std::fill(dxdt.begin(), dxdt.end(), typename State::value_type(0));
+        m_system.slow(x, dxdt, t);
+    }
+
+private:
+    /// The multirate system.
+    System &m_system;
+};
+
+/// @brief The fast part of a multirate system, with the slow variables moving along a line.
+/// @tparam System The type of the multirate system.
+/// @tparam State The state vector type.
+template <class System, class State>
+class multirate_fast_part
+{
+public:
+    /// @brief Wraps the system.
+    /// @param system The multirate system.
+    /// @param rate The derivative of the slow variables, zero for the fast ones.
+    multirate_fast_part(System &system, const State &rate) noexcept
+        : m_system(system)
+        , m_rate(rate)
+    {
+        // Nothing to do.
+    }
+
+    /// @brief Evaluates the derivative of the fast variables, the one of the slow variables being constant.
+    /// @param x The state.
+    /// @param dxdt The derivative of the state.
+    /// @param t The time.
+    template <class Time>
+    void operator()(const State &x, State &dxdt, Time t)
+    {
+        std::copy(m_rate.begin(), m_rate.end(), dxdt.begin());
+        m_system.fast(x, dxdt, t);
+    }
+
+private:
+    /// The multirate system.
+    System &m_system;
+    /// The derivative of the slow variables.
+    const State &m_rate;
+};
+
+} // namespace detail
+
+/// @brief It advances the slow and the fast variables of a multirate system with different step-sizes.
+///
+/// @details Each step follows the slowest-first scheme: the slow variables
+/// are advanced by the slow stepper over the whole step, while the fast ones
+/// are frozen at the beginning of the step; then the fast variables are
+/// sub-cycled by the fast stepper, while the slow ones, read as coupling
+/// inputs, are interpolated linearly between the beginning and the end of the
+/// step. The slow part of the system is evaluated only by the slow stepper,
+/// and the fast part only by the fast one (see `numint/multirate.hpp`).
+///
+/// The fast variables are sub-cycled with `set_substeps()` steps of equal
+/// size, or, if the fast stepper is adaptive, with the step-sizes chosen by
+/// its controller, the last one being clamped to the end of the step. If the
+/// slow stepper is adaptive, so is the multirate stepper, which exposes the
+/// step-size control of the slow stepper (only the slow variables contribute
+/// to its error); otherwise both steppers must have a fixed step-size.
+///
+/// Freezing the fast variables makes the coupling from the fast to the slow
+/// variables first-order accurate in the step-size, which suits the systems
+/// whose fast variables settle quickly (e.g., the electrical part of a
+/// motor, with respect to its mechanical load). The fast stepper is best a
+/// one-step method, since the history kept by the multistep ones spans slow
+/// steps with different rates of the slow variables.
+///
+/// @tparam SlowStepper The stepper advancing the slow variables.
+/// @tparam FastStepper The stepper sub-cycling the fast variables.
+template <class SlowStepper, class FastStepper>
+class stepper_multirate
+{
+public:
+    /// @brief Type of the stepper advancing the slow variables.
+    using slow_stepper_type                   = SlowStepper;
+    /// @brief Type of the stepper sub-cycling the fast variables.
+    using fast_stepper_type                   = FastStepper;
+    /// @brief Type used for the order of the stepper.
+    using order_type                          = typename SlowStepper::order_type;
+    /// @brief Type used to keep track of time.
+    using time_type                           = typename SlowStepper::time_type;
+    /// @brief The state vector.
+    using state_type                          = typename SlowStepper::state_type;
+    /// @brief Type of value contained in the state vector.
+    using value_type                          = typename SlowStepper::value_type;
+    /// @brief Determines if this is an adaptive stepper or not.
+    static constexpr bool is_adaptive_stepper = SlowStepper::is_adaptive_stepper;
+
+    static_assert(
+        std::is_same_v<state_type, typename FastStepper::state_type> &&
+            std::is_same_v<time_type, typename FastStepper::time_type>,
+        "The slow and the fast steppers must share the state and the time types.");
+
+    /// @brief Creates a new multirate stepper.
+    stepper_multirate()
+        : m_slow()
+        , m_fast()
+        , m_x()
+        , m_rate()
+        , m_substeps(10)
+        , m_fast_delta()
+        , m_steps()
+        , m_fast_steps()
+    {
+        // Nothing to do.
+    }
+
+    /// @brief Destructor.
+    ~stepper_multirate() = default;
+
+    /// @brief Copy constructor.
+    /// @param other The logger instance to copy from.
+    stepper_multirate(const stepper_multirate &other) = delete;
+
+    /// @brief Move constructor.
+    /// @param other The logger instance to move from.
+    stepper_multirate(stepper_multirate &&other) noexcept = default;
+
+    /// @brief Copy assignment operator.
+    /// @param other The logger instance to copy from.
+    /// @return Reference to the logger instance.
+    auto operator=(const stepper_multirate &other) -> stepper_multirate & = delete;
+
+    /// @brief Move assignment operator.
+    /// @param other The logger instance to move from.
+    /// @return Reference to the logger instance.
+    auto operator=(stepper_multirate &&other) noexcept -> stepper_multirate & = default;
+
+    /// @brief Sets the number of steps of the fast variables, for each step of the slow ones.
+    /// @details With an adaptive fast stepper, it only sets the first step-size of the fast variables.
+    /// @param substeps The number of fast steps, at least one.
+    constexpr void set_substeps(unsigned substeps) { m_substeps = std::max(substeps, 1U); }
+
+    /// @brief Provides access to the stepper advancing the slow variables, e.g., to tune it.
+    /// @return A reference to the slow stepper.
+    constexpr auto slow_stepper() -> slow_stepper_type & { return m_slow; }
+
+    /// @brief Provides access to the stepper sub-cycling the fast variables, e.g., to tune it.
+    /// @return A reference to the fast stepper.
+    constexpr auto fast_stepper() -> fast_stepper_type & { return m_fast; }
+
+    /// @brief The order of the slow stepper.
+    /// @return the order of the slow stepper.
+    constexpr auto order_step() const -> order_type { return m_slow.order_step(); }
+
+    /// @brief Sets the tolerance of the adaptive slow stepper.
+    /// @param tollerance The tolerance value to use for adjusting the step size.
+    constexpr void set_tollerance(value_type tollerance) { m_slow.set_tollerance(tollerance); }
+
+    /// @brief Sets the minimum allowed step size of the adaptive slow stepper.
+    /// @param min_delta The minimum step size.
+    constexpr void set_min_delta(value_type min_delta) { m_slow.set_min_delta(min_delta); }
+
+    /// @brief Sets the maximum allowed step size of the adaptive slow stepper.
+    /// @param max_delta The maximum step size.
+    constexpr void set_max_delta(value_type max_delta) { m_slow.set_max_delta(max_delta); }
+
+    /// @brief Retrieves the current step size of the adaptive slow stepper.
+    /// @return The current step size as a `time_type` value.
+    constexpr auto get_time_delta() const -> time_type { return m_slow.get_time_delta(); }
+
+    /// @brief Retrieves the step size used by the last accepted step of the adaptive slow stepper.
+    /// @return The last step size as a `time_type` value.
+    constexpr auto get_last_time_delta() const -> time_type { return m_slow.get_last_time_delta(); }
+
+    /// @brief Adjusts the size of the internal state vectors.
+    /// @param reference a reference state vector vector.
+    void adjust_size(const state_type &reference)
+    {
+        if constexpr (detail::has_resize<state_type>::value) {
+            m_x.resize(reference.size());
+            m_rate.resize(reference.size());
+        }
+        m_slow.adjust_size(reference);
+        m_fast.adjust_size(reference);
+        m_fast_delta = time_type(0);
+    }
+
+    /// @brief Discards the data cached from the previous steps (e.g., after a discontinuity of the system).
+    /// @details Unlike `adjust_size`, it keeps the internal state vectors and the step-size of the fast variables.
+    void reset()
+    {
+        detail::reset_stepper(m_slow, m_x);
+        detail::reset_stepper(m_fast, m_x);
+    }
+
+    /// @brief Returns the number of steps the stepper executed up until now.
+    /// @return the number of integration steps.
+    constexpr auto steps() const { return m_steps; }
+
+    /// @brief Returns the number of steps of the fast variables executed up until now.
+    /// @return the number of fast steps.
+    constexpr auto fast_steps() const { return m_fast_steps; }
+
+    /// @brief Saves, or restores, the state carried by the stepper between the steps (see `numint/checkpoint.hpp`).
+    /// @details It includes the state of both steppers.
+    /// @tparam Archive The type of the archive.
+    /// @param archive The archive.
+    template <class Archive>
+    void serialize(Archive &archive)
+    {
+        m_slow.serialize(archive);
+        m_fast.serialize(archive);
+        archive(m_fast_delta, m_steps, m_fast_steps);
+    }
+
+    /// @brief Performs one integration step.
+    ///
+    /// @tparam System The type of the multirate system.
+    ///
+    /// @param system The system, providing the slow and the fast parts of its derivative.
+    /// @param x The state of the system, which will be updated after this step.
+    /// @param t The current time.
+    /// @param dt The time step to use for the integration.
+    template <class System>
+    void do_step(System &&system, state_type &x, const time_type t, const time_type dt)
+    {
+        using system_type = std::remove_reference_t<System>;
+        static_assert(
+            detail::is_multirate_v<system_type, state_type, time_type>,
+            "The system must provide the slow and the fast parts of its derivative (see multirate.hpp).");
+
+        // Advance the slow variables, with the fast ones frozen.
+        detail::multirate_slow_part<system_type> slow(system);
+        std::copy(x.begin(), x.end(), m_x.begin());
+        m_slow.do_step(slow, m_x, t, dt);
+        time_type step = dt;
+        if constexpr (is_adaptive_stepper) {
+            step = m_slow.get_last_time_delta();
+        }
+        // The rate of the slow variables, exactly zero for the fast ones.
+        const time_type inverse = time_type(1) / step;
+        for (std::size_t i = 0; i < x.size(); ++i) {
+            m_rate[i] = (m_x[i] - x[i]) * inverse;
+        }
+        // Sub-cycle the fast variables, with the slow ones moving along the line.
+        detail::multirate_fast_part<system_type, state_type> fast(system, m_rate);
+        const time_type end = t + step;
+        if constexpr (FastStepper::is_adaptive_stepper) {
+            if (!(std::abs(m_fast_delta) > 0)) {
+                m_fast_delta = step / static_cast<time_type>(m_substeps);
+            }
+            for (time_type tf = t; detail::less_with_sign(tf, end, step);) {
+                // Do not step beyond the end of the slow step.
+                const bool last    = !detail::less_eq_with_sign(tf + m_fast_delta, end, step);
+                const time_type hf = last ? (end - tf) : m_fast_delta;
+                m_fast.do_step(fast, x, tf, hf);
+                ++m_fast_steps;
+                const time_type accepted = m_fast.get_last_time_delta();
+                tf                       = (last && !(std::abs(accepted) < std::abs(hf))) ? end : (tf + accepted);
+                // Keep the step-size chosen by the controller, unless it was clamped.
+                if (!last || (std::abs(m_fast.get_time_delta()) < std::abs(m_fast_delta))) {
+                    m_fast_delta = m_fast.get_time_delta();
+                }
+            }
+        } else {
+            const time_type hf = step / static_cast<time_type>(m_substeps);
+            for (unsigned k = 0; k < m_substeps; ++k) {
+                m_fast.do_step(fast, x, t + hf * static_cast<time_type>(k), hf);
+                ++m_fast_steps;
+            }
+        }
+        // Restore the slow variables computed by the slow stepper, removing the rounding of the sub-cycles.
+        for (std::size_t i = 0; i < x.size(); ++i) {
+            if (std::abs(m_rate[i]) > 0) {
+                x[i] = m_x[i];
+            }
+        }
+        ++m_steps;
+    }
+
+private:
+    /// The stepper advancing the slow variables.
+    slow_stepper_type m_slow;
+    /// The stepper sub-cycling the fast variables.
+    fast_stepper_type m_fast;
+    /// The state advanced by the slow stepper.
+    state_type m_x;
+    /// The rate of the slow variables, during the last step.
+    state_type m_rate;
+    /// The number of fast steps for each slow step.
+    unsigned m_substeps;
+    /// The step-size of the adaptive fast stepper, kept between the steps.
+    time_type m_fast_delta;
+    /// The number of steps.
+    unsigned long m_steps;
+    /// The number of fast steps.
+    unsigned long m_fast_steps;
+};
+
+} // namespace numint
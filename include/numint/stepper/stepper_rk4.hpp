@@ -5,8 +5,8 @@
 
 #pragma once
 
-#include "numint/detail/it_algebra.hpp"
 #include "numint/detail/type_traits.hpp"
+#include "numint/vec_expr.hpp"
 
 namespace numint
 {
@@ -74,10 +74,26 @@ public:
         }
     }
 
+    /// @brief Discards the data cached from the previous steps (e.g., after a discontinuity of the system).
+    /// @details The stepper does not carry any data between the steps.
+    void reset()
+    {
+        // Nothing to do.
+    }
+
     /// @brief Returns the number of steps executed by the stepper so far.
     /// @return The number of integration steps executed.
     constexpr auto steps() const { return m_steps; }
 
+    /// @brief Saves, or restores, the state carried by the stepper between the steps (see `numint/checkpoint.hpp`).
+    /// @tparam Archive The type of the archive.
+    /// @param archive The archive.
+    template <class Archive>
+    void serialize(Archive &archive)
+    {
+        archive(m_steps);
+    }
+
     /// @brief Performs a single integration step using the fourth-order Runge-Kutta method.
     /// @tparam System The type of the system representing the differential equations.
     /// @param system The system to integrate.
@@ -97,38 +113,55 @@ public:
         //      m_dxdt1 = f(x, t);
         std::forward<System>(system)(x, m_dxdt1, t);
 
+        // Take the rest of the step from that slope.
+        this->do_step(std::forward<System>(system), x, m_dxdt1, t, dt);
+    }
+
+    /// @brief Performs a single integration step, starting from the slope at the beginning of the interval.
+    /// @details It lets the caller reuse a derivative it already evaluated
+    /// (e.g., the multistep methods, which keep it in their history).
+    /// @tparam System The type of the system representing the differential equations.
+    /// @param system The system to integrate.
+    /// @param x The initial state vector.
+    /// @param dxdt The derivative at the initial state, i.e., f(x, t).
+    /// @param t The initial time.
+    /// @param dt The time step for integration.
+    template <class System>
+    constexpr void
+    do_step(System &&system, state_type &x, const state_type &dxdt, const time_type t, const time_type dt) noexcept
+    {
         // Update temporary state using the slope at the beginning and move halfway forward:
-        //      m_x(t + dt * 0.5) = x(t) + m_dxdt1 * dt * 0.5;
-        detail::it_algebra::sum_operation(
-            m_x.begin(), m_x.end(), std::multiplies<>(), 1.0, x.begin(), 0.5 * dt, m_dxdt1.begin());
+        //      m_x(t + dt * 0.5) = x(t) + dxdt * dt * 0.5;
+        numint::assign(m_x, numint::vec(x) + (dt / 2) * numint::vec(dxdt));
 
         // Step 2: Calculate the slope at the midpoint of the interval (m_dxdt2):
         //      m_dxdt2 = f(m_x, t + 0.5 * dt);
-        std::forward<System>(system)(m_x, m_dxdt2, t + (0.5 * dt));
+        std::forward<System>(system)(m_x, m_dxdt2, t + (dt / 2));
 
         // Update temporary state using the slope at the midpoint and move halfway forward again:
         //      m_x(t + dt * 0.5) = x(t) + m_dxdt2 * dt * 0.5;
-        detail::it_algebra::sum_operation(
-            m_x.begin(), m_x.end(), std::multiplies<>(), 1.0, x.begin(), 0.5 * dt, m_dxdt2.begin());
+        numint::assign(m_x, numint::vec(x) + (dt / 2) * numint::vec(m_dxdt2));
 
         // Step 3: Calculate another slope at the midpoint of the interval (m_dxdt3):
         //      m_dxdt3 = f(m_x, t + 0.5 * dt);
-        std::forward<System>(system)(m_x, m_dxdt3, t + (0.5 * dt));
+        std::forward<System>(system)(m_x, m_dxdt3, t + (dt / 2));
 
         // Update temporary state using the slope at the midpoint and move to the end of the interval:
         //      m_x(t + dt) = x(t) + m_dxdt3 * dt;
-        detail::it_algebra::sum_operation(
-            m_x.begin(), m_x.end(), std::multiplies<>(), 1.0, x.begin(), dt, m_dxdt3.begin());
+        numint::assign(m_x, numint::vec(x) + dt * numint::vec(m_dxdt3));
 
         // Step 4: Calculate the slope at the end of the interval (m_dxdt4):
         //      m_dxdt4 = f(m_x, t + dt);
         std::forward<System>(system)(m_x, m_dxdt4, t + dt);
 
         // Update each component of the state vector using the weighted average
-        // of the slopes: m_dxdt1, m_dxdt2, m_dxdt3, and m_dxdt4.
-        detail::it_algebra::accumulate_operation(
-            x.begin(), x.end(), std::multiplies<>(), dt * (1. / 6.), m_dxdt1.begin(), dt * (2. / 6.), m_dxdt2.begin(),
-            dt * (2. / 6.), m_dxdt3.begin(), dt * (1. / 6.), m_dxdt4.begin());
+        // of the slopes, in a single pass:
+        //      x(t + dt) = x(t) + dt / 6 * (dxdt + 2 * m_dxdt2 + 2 * m_dxdt3 + m_dxdt4);
+        const time_type dt6 = dt / 6;
+        const time_type dt3 = dt / 3;
+        numint::accumulate(
+            x, dt6 * numint::vec(dxdt) + dt3 * numint::vec(m_dxdt2) + dt3 * numint::vec(m_dxdt3) +
+                   dt6 * numint::vec(m_dxdt4));
 
         // Increase the number of steps.
         ++m_steps;
@@ -0,0 +1,384 @@
+/// @file stepper_ros34pw2.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Rosenbrock-W method ROS34PW2, for stiff systems.
+
+#pragma once
+
+#include "numint/detail/it_algebra.hpp"
+#include "numint/detail/type_traits.hpp"
+#include "numint/linear/dense_lu_solver.hpp"
+#include "numint/vec_expr.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace numint
+{
+
+/// @brief Stepper implementing the ROS34PW2 Rosenbrock-W method (Rang and
+/// Angermann, 2005).
+///
+/// @details Rosenbrock methods are linearly implicit: each of the four stages
+/// requires the solution of a linear system with matrix
+///     (1 / (dt * gamma)) * I - J
+/// which is factorized once per step, and no Newton iteration is needed.
+/// The method is L-stable and stiffly accurate, of order 3, with an
+/// embedded solution of order 2, which is used by `stepper_adaptive` to
+/// control the step-size. Being a W-method, it keeps its order even when J is
+/// only an approximation of the Jacobian, e.g., when it is built by finite
+/// differences. The Jacobian is provided by the system (see
+/// `numint/jacobian.hpp`), or built by finite differences, and it is reused
+/// when a step is retried from the same state.
+///
+/// @tparam State The state vector type.
+/// @tparam Time The datatype used to hold time.
+/// @tparam LinearSolver The linear solver used by the stages.
+template <class State, class Time, class LinearSolver = dense_lu_solver<State>>
+class stepper_ros34pw2
+{
+public:
+    /// @brief Type used for the order of the stepper.
+    using order_type         = unsigned short;
+    /// @brief Type used to keep track of time.
+    using time_type          = Time;
+    /// @brief The state vector type.
+    using state_type         = State;
+    /// @brief Type of value contained in the state vector.
+    using value_type         = typename state_type::value_type;
+    /// @brief Type of the linear solver.
+    using linear_solver_type = LinearSolver;
+
+    /// @brief Indicates whether this is an adaptive stepper.
+    static constexpr bool is_adaptive_stepper = false;
+
+    /// @brief Indicates whether this stepper provides an embedded error estimate.
+    static constexpr bool is_embedded_stepper = true;
+
+    /// @brief Constructs a new stepper.
+    stepper_ros34pw2() = default;
+
+    /// @brief Destructor.
+    ~stepper_ros34pw2() = default;
+
+    /// @brief Copy constructor.
+    /// @param other The logger instance to copy from.
+    stepper_ros34pw2(const stepper_ros34pw2 &other) = delete;
+
+    /// @brief Move constructor.
+    /// @param other The logger instance to move from.
+    stepper_ros34pw2(stepper_ros34pw2 &&other) noexcept = default;
+
+    /// @brief Copy assignment operator.
+    /// @param other The logger instance to copy from.
+    /// @return Reference to the logger instance.
+    auto operator=(const stepper_ros34pw2 &other) -> stepper_ros34pw2 & = delete;
+
+    /// @brief Move assignment operator.
+    /// @param other The logger instance to move from.
+    /// @return Reference to the logger instance.
+    auto operator=(stepper_ros34pw2 &&other) noexcept -> stepper_ros34pw2 & = default;
+
+    /// @brief Returns the order of the stepper.
+    /// @return The order of the main solution, which is 3.
+    constexpr auto order_step() const -> order_type { return 3; }
+
+    /// @brief Returns the order of the embedded solution.
+    /// @return The order of the embedded solution, which is 2.
+    constexpr auto order_error() const -> order_type { return 2; }
+
+    /// @brief Provides access to the linear solver, e.g., to retrieve its statistics.
+    /// @return a reference to the linear solver.
+    constexpr auto linear_solver() -> linear_solver_type & { return m_linear_solver; }
+
+    /// @brief Adjusts the size of the internal state vectors based on a reference.
+    /// @details It also discards the Jacobian, since it might refer to a different system.
+    /// @param reference A reference state vector used for size adjustment.
+    void adjust_size(const state_type &reference)
+    {
+        m_linear_solver.adjust_size(reference);
+        if constexpr (detail::has_resize<state_type>::value) {
+            m_u1.resize(reference.size());
+            m_u2.resize(reference.size());
+            m_u3.resize(reference.size());
+            m_u4.resize(reference.size());
+            m_y.resize(reference.size());
+            m_dxdt.resize(reference.size());
+            m_dfdt.resize(reference.size());
+            m_x_jacobian.resize(reference.size());
+        }
+        m_jacobian_valid = false;
+    }
+
+    /// @brief Discards the data cached from the previous steps (e.g., after a discontinuity of the system).
+    /// @details Unlike `adjust_size`, it keeps the internal state vectors, while
+    /// the Jacobian is evaluated again by the next step.
+    void reset()
+    {
+        m_jacobian_valid = false;
+    }
+
+    /// @brief Returns the number of steps executed by the stepper so far.
+    /// @return The number of integration steps executed.
+    constexpr auto steps() const { return m_steps; }
+
+    /// @brief Saves, or restores, the state carried by the stepper between the steps (see `numint/checkpoint.hpp`).
+    /// @details The Jacobian is not saved, it is evaluated again by the first step after the restore.
+    /// @tparam Archive The type of the archive.
+    /// @param archive The archive.
+    template <class Archive>
+    void serialize(Archive &archive)
+    {
+        archive(m_steps);
+    }
+
+    /// @brief Performs a single integration step.
+    /// @details If the linear system is singular, the state is left untouched.
+    /// @tparam System The type of the system representing the differential equations.
+    /// @param system The system to integrate.
+    /// @param x The initial state vector, replaced with the third-order solution.
+    /// @param t The initial time.
+    /// @param dt The time step for integration.
+    template <class System>
+    void do_step(System &&system, state_type &x, const time_type t, const time_type dt)
+    {
+        if (this->compute_stages(std::forward<System>(system), x, t, dt)) {
+            // Update the state with the third-order solution.
+            detail::it_algebra::accumulate_operation(
+                x.begin(), x.end(), std::multiplies<>(), time_type(m[0]), m_u1.begin(), time_type(m[1]), m_u2.begin(),
+                time_type(m[2]), m_u3.begin(), time_type(m[3]), m_u4.begin());
+        }
+        ++m_steps;
+    }
+
+    /// @brief Performs a single integration step, and provides the embedded solution.
+    /// @details If the linear system is singular, both states are left untouched.
+    /// @tparam System The type of the system representing the differential equations.
+    /// @param system The system to integrate.
+    /// @param x The initial state vector, replaced with the third-order solution.
+    /// @param x_embedded The output state vector, receiving the second-order solution.
+    /// @param t The initial time.
+    /// @param dt The time step for integration.
+    template <class System>
+    void do_step(System &&system, state_type &x, state_type &x_embedded, const time_type t, const time_type dt)
+    {
+        if (this->compute_stages(std::forward<System>(system), x, t, dt)) {
+            // Compute the second-order embedded solution.
+            detail::it_algebra::sum_operation(
+                x_embedded.begin(), x_embedded.end(), std::multiplies<>(), time_type(1), x.begin(), time_type(m_hat[0]),
+                m_u1.begin(), time_type(m_hat[1]), m_u2.begin(), time_type(m_hat[2]), m_u3.begin(), time_type(m_hat[3]),
+                m_u4.begin());
+            // Update the state with the third-order solution.
+            detail::it_algebra::accumulate_operation(
+                x.begin(), x.end(), std::multiplies<>(), time_type(m[0]), m_u1.begin(), time_type(m[1]), m_u2.begin(),
+                time_type(m[2]), m_u3.begin(), time_type(m[3]), m_u4.begin());
+        }
+        ++m_steps;
+    }
+
+    /// @brief Performs a single integration step, and measures the error of the embedded solution.
+    /// @details If the linear system is singular, the state is left untouched,
+    /// and the returned error is infinite, so that the step is rejected.
+    /// @tparam System The type of the system representing the differential equations.
+    /// @tparam Metric The type of the error metric.
+    /// @param system The system to integrate.
+    /// @param x The initial state vector, replaced with the third-order solution.
+    /// @param t The initial time.
+    /// @param dt The time step for integration.
+    /// @param metric The error metric, called as `metric(i, value, error)` for each element of the new state.
+    /// @return The maximum of the error metric over the elements.
+    template <class System, class Metric>
+    auto do_step_with_error(System &&system, state_type &x, const time_type t, const time_type dt, Metric metric)
+        -> value_type
+    {
+        ++m_steps;
+        if (!this->compute_stages(std::forward<System>(system), x, t, dt)) {
+            return std::numeric_limits<value_type>::infinity();
+        }
+        // Update the state with the third-order solution, and measure the error.
+        return numint::assign_max_error(
+            x,
+            numint::vec(x) + m[0] * numint::vec(m_u1) + m[1] * numint::vec(m_u2) + m[2] * numint::vec(m_u3) +
+                m[3] * numint::vec(m_u4),
+            (m[0] - m_hat[0]) * numint::vec(m_u1) + (m[1] - m_hat[1]) * numint::vec(m_u2) +
+                (m[2] - m_hat[2]) * numint::vec(m_u3) + (m[3] - m_hat[3]) * numint::vec(m_u4),
+            metric);
+    }
+
+private:
+    /// @brief The coefficients of the method, in the form which avoids
+    /// matrix-vector products (Hairer and Wanner, Section IV.7).
+    struct tableau {
+        /// Coefficients of the stage arguments.
+        double a[4][4];
+        /// Coefficients of the previous stages, inside the right-hand sides.
+        double c[4][4];
+        /// Coefficients of the third-order solution.
+        double m[4];
+        /// Coefficients of the second-order solution.
+        double m_hat[4];
+        /// The time of each stage, relative to the step-size.
+        double alpha[4];
+        /// The coefficient of the time derivative, for each stage.
+        double gamma[4];
+    };
+
+    /// @brief Transforms the original coefficients of the method.
+    /// @return the transformed coefficients.
+    static constexpr auto make_tableau() -> tableau
+    {
+        // The original coefficients.
+        const double g              = 4.3586652150845900e-01;
+        const double alpha_ij[4][4] = {
+            {0, 0, 0, 0},
+            {8.7173304301691801e-01, 0, 0, 0},
+            {8.4457060015369423e-01, -1.1299064236484185e-01, 0, 0},
+            {0, 0, 1, 0},
+        };
+        const double gamma_ij[4][4] = {
+            {g, 0, 0, 0},
+            {-8.7173304301691801e-01, g, 0, 0},
+            {-9.0338057013044082e-01, 5.4180672388095326e-02, g, 0},
+            {2.4212380706095346e-01, -1.2232505839045147e+00, 5.4526025533510214e-01, g},
+        };
+        const double b[4]     = {2.4212380706095346e-01, -1.2232505839045147e+00, 1.5452602553351020e+00, g};
+        const double b_hat[4] = {3.7810903145819369e-01, -9.6042292212423178e-02, 0.5, 2.1793326075422950e-01};
+
+        // Invert the lower triangular matrix gamma_ij.
+        double inverse[4][4] = {};
+        for (int i = 0; i < 4; ++i) {
+            inverse[i][i] = 1 / gamma_ij[i][i];
+            for (int j = i - 1; j >= 0; --j) {
+                double sum = 0;
+                for (int k = j; k < i; ++k) {
+                    sum += gamma_ij[i][k] * inverse[k][j];
+                }
+                inverse[i][j] = -sum / gamma_ij[i][i];
+            }
+        }
+
+        // Compute the transformed coefficients.
+        tableau result{};
+        for (int i = 0; i < 4; ++i) {
+            for (int j = 0; j < 4; ++j) {
+                for (int k = 0; k < 4; ++k) {
+                    result.a[i][j] += alpha_ij[i][k] * inverse[k][j];
+                }
+                result.c[i][j] = (i == j) ? 0 : -inverse[i][j];
+                result.m[j] += b[i] * inverse[i][j];
+                result.m_hat[j] += b_hat[i] * inverse[i][j];
+                result.alpha[i] += alpha_ij[i][j];
+                result.gamma[i] += gamma_ij[i][j];
+            }
+        }
+        return result;
+    }
+
+    /// @brief The transformed coefficients of the method.
+    static constexpr tableau coefficients = make_tableau();
+    /// @brief The coefficients of the third-order solution.
+    static constexpr const double (&m)[4] = coefficients.m;
+    /// @brief The coefficients of the second-order solution.
+    static constexpr const double (&m_hat)[4] = coefficients.m_hat;
+
+    /// @brief Computes the four stages.
+    /// @tparam System The type of the system representing the differential equations.
+    /// @param system The system to integrate.
+    /// @param x The initial state vector.
+    /// @param t The initial time.
+    /// @param dt The time step for integration.
+    /// @return true if the stages were computed, false if the linear system is singular.
+    template <class System>
+    auto compute_stages(System &&system, const state_type &x, const time_type t, const time_type dt) -> bool
+    {
+        const auto &a = coefficients.a;
+        const auto &c = coefficients.c;
+        const auto &g = coefficients.gamma;
+        const auto &s = coefficients.alpha;
+
+        // Evaluate the derivative, the Jacobian, and the time derivative at
+        // the initial state, unless the step is retried from the same state.
+        if (!m_jacobian_valid || (std::abs(t - m_t_jacobian) > 0) ||
+            !std::equal(x.begin(), x.end(), m_x_jacobian.begin())) {
+            system(x, m_dxdt, t);
+            m_linear_solver.update_jacobian(system, x, m_dxdt, t);
+            // Approximate the time derivative by forward differences.
+            const time_type delta =
+                std::sqrt(std::numeric_limits<time_type>::epsilon()) * std::max(time_type(1), std::abs(t));
+            system(x, m_dfdt, t + delta);
+            detail::it_algebra::sum_operation(
+                m_dfdt.begin(), m_dfdt.end(), std::multiplies<>(), 1 / delta, m_dfdt.begin(), -1 / delta,
+                m_dxdt.begin());
+            std::copy(x.begin(), x.end(), m_x_jacobian.begin());
+            m_t_jacobian     = t;
+            m_jacobian_valid = true;
+        }
+
+        // Factorize the matrix of the stages.
+        if (!m_linear_solver.factorize(static_cast<value_type>(1 / (dt * time_type(g[0]))))) {
+            return false;
+        }
+
+        // Stage 1:
+        //      M * u1 = f(x, t) + gamma1 * dt * df/dt
+        detail::it_algebra::sum_operation(
+            m_u1.begin(), m_u1.end(), std::multiplies<>(), time_type(1), m_dxdt.begin(), time_type(g[0]) * dt,
+            m_dfdt.begin());
+        m_linear_solver.solve(m_u1);
+
+        // Stage 2:
+        //      M * u2 = f(x + a21 * u1, t + alpha2 * dt) + (c21 / dt) * u1 + gamma2 * dt * df/dt
+        detail::it_algebra::sum_operation(
+            m_y.begin(), m_y.end(), std::multiplies<>(), time_type(1), x.begin(), time_type(a[1][0]), m_u1.begin());
+        system(m_y, m_u2, t + time_type(s[1]) * dt);
+        detail::it_algebra::accumulate_operation(
+            m_u2.begin(), m_u2.end(), std::multiplies<>(), time_type(c[1][0]) / dt, m_u1.begin(), time_type(g[1]) * dt,
+            m_dfdt.begin());
+        m_linear_solver.solve(m_u2);
+
+        // Stage 3:
+        //      M * u3 = f(x + a31 * u1 + a32 * u2, t + alpha3 * dt)
+        //             + (c31 * u1 + c32 * u2) / dt + gamma3 * dt * df/dt
+        detail::it_algebra::sum_operation(
+            m_y.begin(), m_y.end(), std::multiplies<>(), time_type(1), x.begin(), time_type(a[2][0]), m_u1.begin(),
+            time_type(a[2][1]), m_u2.begin());
+        system(m_y, m_u3, t + time_type(s[2]) * dt);
+        detail::it_algebra::accumulate_operation(
+            m_u3.begin(), m_u3.end(), std::multiplies<>(), time_type(c[2][0]) / dt, m_u1.begin(),
+            time_type(c[2][1]) / dt, m_u2.begin(), time_type(g[2]) * dt, m_dfdt.begin());
+        m_linear_solver.solve(m_u3);
+
+        // Stage 4:
+        //      M * u4 = f(x + a41 * u1 + a42 * u2 + a43 * u3, t + alpha4 * dt)
+        //             + (c41 * u1 + c42 * u2 + c43 * u3) / dt + gamma4 * dt * df/dt
+        detail::it_algebra::sum_operation(
+            m_y.begin(), m_y.end(), std::multiplies<>(), time_type(1), x.begin(), time_type(a[3][0]), m_u1.begin(),
+            time_type(a[3][1]), m_u2.begin(), time_type(a[3][2]), m_u3.begin());
+        system(m_y, m_u4, t + time_type(s[3]) * dt);
+        detail::it_algebra::accumulate_operation(
+            m_u4.begin(), m_u4.end(), std::multiplies<>(), time_type(c[3][0]) / dt, m_u1.begin(),
+            time_type(c[3][1]) / dt, m_u2.begin(), time_type(c[3][2]) / dt, m_u3.begin(), time_type(g[3]) * dt,
+            m_dfdt.begin());
+        m_linear_solver.solve(m_u4);
+        return true;
+    }
+
+    /// The linear solver.
+    linear_solver_type m_linear_solver;
+    /// The stages.
+    state_type m_u1, m_u2, m_u3, m_u4;
+    /// Support vector for the arguments of the stages.
+    state_type m_y;
+    /// The derivative and the time derivative of the system at the initial state.
+    state_type m_dxdt, m_dfdt;
+    /// The state where the Jacobian was evaluated.
+    state_type m_x_jacobian;
+    /// The time where the Jacobian was evaluated.
+    time_type m_t_jacobian{};
+    /// Whether the Jacobian is valid.
+    bool m_jacobian_valid{false};
+    /// The number of steps of integration.
+    unsigned long m_steps{};
+};
+
+} // namespace numint
@@ -0,0 +1,303 @@
+/// @file stepper_symplectic.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Symplectic steppers for separable Hamiltonian systems: symplectic
+/// Euler, velocity Verlet, and the Yoshida compositions of order 4 and 6.
+
+#pragma once
+
+#include "numint/detail/type_traits.hpp"
+#include "numint/separable.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+namespace numint
+{
+
+namespace detail
+{
+
+/// @brief The coefficients of the symplectic Euler method.
+struct symplectic_euler_scheme {
+    /// @brief The order of the method.
+    static constexpr unsigned short order = 1;
+    /// @brief The fractions of the step of each update of the momenta.
+    static constexpr std::array<double, 1> kicks = {1.};
+    /// @brief The fractions of the step of each update of the coordinates.
+    static constexpr std::array<double, 1> drifts = {1.};
+};
+
+/// @brief The coefficients of the velocity Verlet method.
+struct velocity_verlet_scheme {
+    /// @brief The order of the method.
+    static constexpr unsigned short order = 2;
+    /// @brief The fractions of the step of each update of the momenta.
+    static constexpr std::array<double, 2> kicks = {0.5, 0.5};
+    /// @brief The fractions of the step of each update of the coordinates.
+    static constexpr std::array<double, 2> drifts = {1., 0.};
+};
+
+/// @brief The coefficients of the Yoshida method of order 4, the composition
+/// of three velocity Verlet steps (the "triple jump").
+struct yoshida4_scheme {
+    /// @brief The weights of the composed steps.
+    static constexpr double w1 = 1.3512071919596576340476878089715;
+    /// @brief The weights of the composed steps.
+    static constexpr double w0 = 1. - 2. * w1;
+    /// @brief The order of the method.
+    static constexpr unsigned short order = 4;
+    /// @brief The fractions of the step of each update of the momenta.
+    static constexpr std::array<double, 4> kicks = {w1 / 2, (w1 + w0) / 2, (w0 + w1) / 2, w1 / 2};
+    /// @brief The fractions of the step of each update of the coordinates.
+    static constexpr std::array<double, 4> drifts = {w1, w0, w1, 0.};
+};
+
+/// @brief The coefficients of the Yoshida method of order 6 (solution A),
+/// the composition of seven velocity Verlet steps.
+struct yoshida6_scheme {
+    /// @brief The weights of the composed steps.
+    static constexpr double w1 = -1.17767998417887;
+    /// @brief The weights of the composed steps.
+    static constexpr double w2 = 0.235573213359357;
+    /// @brief The weights of the composed steps.
+    static constexpr double w3 = 0.784513610477560;
+    /// @brief The weights of the composed steps.
+    static constexpr double w0 = 1. - 2. * (w1 + w2 + w3);
+    /// @brief The order of the method.
+    static constexpr unsigned short order = 6;
+    /// @brief The fractions of the step of each update of the momenta.
+    static constexpr std::array<double, 8> kicks = {
+        w3 / 2, (w3 + w2) / 2, (w2 + w1) / 2, (w1 + w0) / 2, (w0 + w1) / 2, (w1 + w2) / 2, (w2 + w3) / 2, w3 / 2};
+    /// @brief The fractions of the step of each update of the coordinates.
+    static constexpr std::array<double, 8> drifts = {w3, w2, w1, w0, w1, w2, w3, 0.};
+};
+
+} // namespace detail
+
+/// @brief Stepper implementing a symplectic splitting method, for separable systems.
+///
+/// @details The state holds the coordinates q in its first half, and the
+/// momenta p in its second half (see `numint/separable.hpp`). Each stage of
+/// the method updates the momenta with the derivative computed from the
+/// coordinates (a kick), and then the coordinates with the derivative
+/// computed from the momenta (a drift). Since each of these updates is the
+/// exact flow of a part of the Hamiltonian, the method is symplectic: for
+/// conservative systems, the energy error stays bounded over arbitrarily long
+/// times, instead of drifting, and much larger steps can be taken than
+/// with the Runge-Kutta methods.
+///
+/// Systems providing the two halves of their derivative separately (see
+/// `make_separable`) only evaluate the half that is needed, while ordinary
+/// systems are evaluated whole. For the separable systems, when the last
+/// drift is followed by a kick, the derivative of the momenta at the end of
+/// the step is reused by the first kick of the next one, as long as the state
+/// is not changed in between. Ordinary systems are evaluated again instead,
+/// since their derivative of the momenta may also depend on the momenta,
+/// which the last kick has changed.
+///
+/// @tparam State The state vector type.
+/// @tparam Time The datatype used to hold time.
+/// @tparam Scheme The coefficients of the method.
+template <class State, class Time, class Scheme>
+class stepper_symplectic
+{
+public:
+    /// @brief Type used for the order of the stepper.
+    using order_type = unsigned short;
+
+    /// @brief Type used to keep track of time.
+    using time_type = Time;
+
+    /// @brief The state vector type.
+    using state_type = State;
+
+    /// @brief Type of value contained in the state vector.
+    using value_type = typename state_type::value_type;
+
+    /// @brief Indicates whether this is an adaptive stepper.
+    static constexpr bool is_adaptive_stepper = false;
+
+    /// @brief Constructs a new stepper.
+    stepper_symplectic() = default;
+
+    /// @brief Destructor.
+    ~stepper_symplectic() = default;
+
+    /// @brief Copy constructor.
+    /// @param other The logger instance to copy from.
+    stepper_symplectic(const stepper_symplectic &other) = delete;
+
+    /// @brief Move constructor.
+    /// @param other The logger instance to move from.
+    stepper_symplectic(stepper_symplectic &&other) noexcept = default;
+
+    /// @brief Copy assignment operator.
+    /// @param other The logger instance to copy from.
+    /// @return Reference to the logger instance.
+    auto operator=(const stepper_symplectic &other) -> stepper_symplectic & = delete;
+
+    /// @brief Move assignment operator.
+    /// @param other The logger instance to move from.
+    /// @return Reference to the logger instance.
+    auto operator=(stepper_symplectic &&other) noexcept -> stepper_symplectic & = default;
+
+    /// @brief Returns the order of the stepper.
+    /// @return The order of the method.
+    constexpr auto order_step() const -> order_type { return Scheme::order; }
+
+    /// @brief Adjusts the size of the internal state vectors based on a reference.
+    /// @param reference A reference state vector used for size adjustment.
+    constexpr void adjust_size(const state_type &reference)
+    {
+        if constexpr (detail::has_resize<state_type>::value) {
+            m_dxdt.resize(reference.size());
+            m_x.resize(reference.size());
+        }
+        m_has_momentum = false;
+    }
+
+    /// @brief Discards the data cached from the previous steps (e.g., after a discontinuity of the system).
+    /// @details The derivative of the momenta, reused by the next step, is evaluated again.
+    void reset()
+    {
+        m_has_momentum = false;
+    }
+
+    /// @brief Returns the number of steps executed by the stepper so far.
+    /// @return The number of integration steps executed.
+    constexpr auto steps() const { return m_steps; }
+
+    /// @brief Saves, or restores, the state carried by the stepper between the steps (see `numint/checkpoint.hpp`).
+    /// @details It includes the derivative of the momenta reused by the next step.
+    /// @tparam Archive The type of the archive.
+    /// @param archive The archive.
+    template <class Archive>
+    void serialize(Archive &archive)
+    {
+        archive(m_steps, m_has_momentum, m_dxdt, m_x, m_time);
+    }
+
+    /// @brief Performs a single integration step.
+    /// @tparam System The type of the system representing the differential equations.
+    /// @param system The system to integrate.
+    /// @param x The initial state vector, coordinates first, then momenta.
+    /// @param t The initial time.
+    /// @param dt The time step for integration.
+    template <class System>
+    void do_step(System &&system, state_type &x, const time_type t, const time_type dt)
+    {
+        const std::size_t half = x.size() / 2;
+
+        // The derivative of the momenta from the previous step is valid only if the state was not changed.
+        if (m_has_momentum && ((std::abs(t - m_time) > 0) || !std::equal(x.begin(), x.end(), m_x.begin()))) {
+            m_has_momentum = false;
+        }
+
+        // The times reached by the coordinates, and by the momenta.
+        time_type t_q = t, t_p = t;
+        for (std::size_t stage = 0; stage < Scheme::kicks.size(); ++stage) {
+            if (std::abs(Scheme::kicks[stage]) > 0) {
+                // Kick: p += b * dt * dp/dt(q).
+                if (!m_has_momentum) {
+                    this->momentum(system, x, t_q);
+                    m_has_momentum = true;
+                }
+                const auto weight = static_cast<value_type>(time_type(Scheme::kicks[stage]) * dt);
+                for (std::size_t i = half; i < x.size(); ++i) {
+                    x[i] += weight * m_dxdt[i];
+                }
+                t_p += time_type(Scheme::kicks[stage]) * dt;
+            }
+            if (std::abs(Scheme::drifts[stage]) > 0) {
+                // Drift: q += a * dt * dq/dt(p).
+                this->coordinate(system, x, t_p);
+                const auto weight = static_cast<value_type>(time_type(Scheme::drifts[stage]) * dt);
+                for (std::size_t i = 0; i < half; ++i) {
+                    x[i] += weight * m_dxdt[i];
+                }
+                t_q += time_type(Scheme::drifts[stage]) * dt;
+                m_has_momentum = false;
+            }
+        }
+
+        // Keep track of the state, to reuse the derivative of the momenta,
+        // which depends only on the coordinates for the separable systems.
+        if constexpr (!detail::is_separable_v<System, state_type, time_type>) {
+            m_has_momentum = false;
+        }
+        if (m_has_momentum) {
+            m_time = t + dt;
+            std::copy(x.begin(), x.end(), m_x.begin());
+        }
+        ++m_steps;
+    }
+
+private:
+    /// @brief Evaluates the derivative of the coordinates, in the first half of m_dxdt.
+    /// @param system The system.
+    /// @param x The state.
+    /// @param t The time.
+    template <class System>
+    void coordinate(System &&system, const state_type &x, time_type t)
+    {
+        if constexpr (detail::is_separable_v<System, state_type, time_type>) {
+            system.coordinate(x, m_dxdt, t);
+        } else {
+            system(x, m_dxdt, t);
+        }
+    }
+
+    /// @brief Evaluates the derivative of the momenta, in the second half of m_dxdt.
+    /// @param system The system.
+    /// @param x The state.
+    /// @param t The time.
+    template <class System>
+    void momentum(System &&system, const state_type &x, time_type t)
+    {
+        if constexpr (detail::is_separable_v<System, state_type, time_type>) {
+            system.momentum(x, m_dxdt, t);
+        } else {
+            system(x, m_dxdt, t);
+        }
+    }
+
+    /// The derivative of the state.
+    state_type m_dxdt{};
+    /// The state at the end of the last step.
+    state_type m_x{};
+    /// The time at the end of the last step.
+    time_type m_time{};
+    /// Whether the second half of m_dxdt holds the derivative of the momenta at the current state.
+    bool m_has_momentum{false};
+    /// The number of steps of integration.
+    uint64_t m_steps{};
+};
+
+/// @brief Stepper implementing the symplectic Euler method (order 1).
+/// @tparam State The state vector type.
+/// @tparam Time The datatype used to hold time.
+template <class State, class Time>
+using stepper_symplectic_euler = stepper_symplectic<State, Time, detail::symplectic_euler_scheme>;
+
+/// @brief Stepper implementing the velocity Verlet method (order 2).
+/// @tparam State The state vector type.
+/// @tparam Time The datatype used to hold time.
+template <class State, class Time>
+using stepper_velocity_verlet = stepper_symplectic<State, Time, detail::velocity_verlet_scheme>;
+
+/// @brief Stepper implementing the Yoshida method of order 4.
+/// @tparam State The state vector type.
+/// @tparam Time The datatype used to hold time.
+template <class State, class Time>
+using stepper_yoshida4 = stepper_symplectic<State, Time, detail::yoshida4_scheme>;
+
+/// @brief Stepper implementing the Yoshida method of order 6.
+/// @tparam State The state vector type.
+/// @tparam Time The datatype used to hold time.
+template <class State, class Time>
+using stepper_yoshida6 = stepper_symplectic<State, Time, detail::yoshida6_scheme>;
+
+} // namespace numint
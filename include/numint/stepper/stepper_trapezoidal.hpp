@@ -68,10 +68,26 @@ public:
         }
     }
 
+    /// @brief Discards the data cached from the previous steps (e.g., after a discontinuity of the system).
+    /// @details The stepper does not carry any data between the steps.
+    void reset()
+    {
+        // Nothing to do.
+    }
+
     /// @brief Returns the number of steps the stepper executed up until now.
     /// @return the number of integration steps.
     constexpr auto steps() const { return m_steps; }
 
+    /// @brief Saves, or restores, the state carried by the stepper between the steps (see `numint/checkpoint.hpp`).
+    /// @tparam Archive The type of the archive.
+    /// @param archive The archive.
+    template <class Archive>
+    void serialize(Archive &archive)
+    {
+        archive(m_steps);
+    }
+
     /// @brief Perform a single integration step using Euler's method.
     /// @tparam System The type of the system representing the differential equations.
     /// @param system the system we are integrating.
@@ -92,7 +108,7 @@ public:
         // Update the state vector using Euler's method:
         //      x(t + dt) = x(t) + (0.5 * dt * dxdt_start) + (0.5 * dt * dxdt_end)
         detail::it_algebra::accumulate_operation(
-            x.begin(), x.end(), std::multiplies<>(), 0.5 * dt, m_dxdt_start.begin(), 0.5 * dt, m_dxdt_end.begin());
+            x.begin(), x.end(), std::multiplies<>(), dt / 2, m_dxdt_start.begin(), dt / 2, m_dxdt_end.begin());
 
         // Increment the number of integration steps.
         ++m_steps;
@@ -0,0 +1,263 @@
+/// @file tableau.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Butcher tableaux of explicit Runge-Kutta methods, used by
+/// `stepper_explicit_rk`.
+///
+/// @details A tableau is a class with the following static constexpr members:
+///
+///     unsigned short order;                                // The order of the method.
+///     std::size_t stages;                                 // The number of stages S.
+///     std::array<double, S> c;                            // The nodes.
+///     std::array<std::array<double, S>, S> a;             // The coefficients of the stages.
+///     std::array<double, S> b;                            // The weights of the solution.
+///
+/// where `a` is strictly lower triangular, since the methods are explicit.
+/// Embedded pairs also provide the weights of the embedded solution, and its
+/// order:
+///
+///     unsigned short order_error;
+///     std::array<double, S> b_hat;
+///
+/// New methods are defined by writing a new tableau, which can be passed to
+/// `stepper_explicit_rk` like the ones below.
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <type_traits>
+
+namespace numint
+{
+
+namespace tableau
+{
+
+/// @brief The Butcher tableau of Euler's method.
+struct euler {
+    /// @brief The order of the method.
+    static constexpr unsigned short order = 1;
+    /// @brief The number of stages.
+    static constexpr std::size_t stages = 1;
+    /// @brief The nodes.
+    static constexpr std::array<double, stages> c = {0.};
+    /// @brief The coefficients of the stages.
+    static constexpr std::array<std::array<double, stages>, stages> a = {{{0.}}};
+    /// @brief The weights of the solution.
+    static constexpr std::array<double, stages> b = {1.};
+};
+
+/// @brief The Butcher tableau of the midpoint method.
+struct midpoint {
+    /// @brief The order of the method.
+    static constexpr unsigned short order = 2;
+    /// @brief The number of stages.
+    static constexpr std::size_t stages = 2;
+    /// @brief The nodes.
+    static constexpr std::array<double, stages> c = {0., 1. / 2.};
+    /// @brief The coefficients of the stages.
+    static constexpr std::array<std::array<double, stages>, stages> a = {{{0., 0.}, {1. / 2., 0.}}};
+    /// @brief The weights of the solution.
+    static constexpr std::array<double, stages> b = {0., 1.};
+};
+
+/// @brief The Butcher tableau of Heun's method (improved Euler).
+struct heun {
+    /// @brief The order of the method.
+    static constexpr unsigned short order = 2;
+    /// @brief The number of stages.
+    static constexpr std::size_t stages = 2;
+    /// @brief The nodes.
+    static constexpr std::array<double, stages> c = {0., 1.};
+    /// @brief The coefficients of the stages.
+    static constexpr std::array<std::array<double, stages>, stages> a = {{{0., 0.}, {1., 0.}}};
+    /// @brief The weights of the solution.
+    static constexpr std::array<double, stages> b = {1. / 2., 1. / 2.};
+};
+
+/// @brief The Butcher tableau of the classic Runge-Kutta 4th order method.
+struct rk4 {
+    /// @brief The order of the method.
+    static constexpr unsigned short order = 4;
+    /// @brief The number of stages.
+    static constexpr std::size_t stages = 4;
+    /// @brief The nodes.
+    static constexpr std::array<double, stages> c = {0., 1. / 2., 1. / 2., 1.};
+    /// @brief The coefficients of the stages.
+    static constexpr std::array<std::array<double, stages>, stages> a = {{
+        {0., 0., 0., 0.},
+        {1. / 2., 0., 0., 0.},
+        {0., 1. / 2., 0., 0.},
+        {0., 0., 1., 0.},
+    }};
+    /// @brief The weights of the solution.
+    static constexpr std::array<double, stages> b = {1. / 6., 1. / 3., 1. / 3., 1. / 6.};
+};
+
+/// @brief The Butcher tableau of the Runge-Kutta 3/8-rule 4th order method.
+struct rk38 {
+    /// @brief The order of the method.
+    static constexpr unsigned short order = 4;
+    /// @brief The number of stages.
+    static constexpr std::size_t stages = 4;
+    /// @brief The nodes.
+    static constexpr std::array<double, stages> c = {0., 1. / 3., 2. / 3., 1.};
+    /// @brief The coefficients of the stages.
+    static constexpr std::array<std::array<double, stages>, stages> a = {{
+        {0., 0., 0., 0.},
+        {1. / 3., 0., 0., 0.},
+        {-1. / 3., 1., 0., 0.},
+        {1., -1., 1., 0.},
+    }};
+    /// @brief The weights of the solution.
+    static constexpr std::array<double, stages> b = {1. / 8., 3. / 8., 3. / 8., 1. / 8.};
+};
+
+/// @brief The Butcher tableau of the Bogacki-Shampine 3(2) embedded pair (FSAL).
+struct bs32 {
+    /// @brief The order of the method.
+    static constexpr unsigned short order = 3;
+    /// @brief The order of the embedded solution.
+    static constexpr unsigned short order_error = 2;
+    /// @brief The number of stages.
+    static constexpr std::size_t stages = 4;
+    /// @brief The nodes.
+    static constexpr std::array<double, stages> c = {0., 1. / 2., 3. / 4., 1.};
+    /// @brief The coefficients of the stages.
+    static constexpr std::array<std::array<double, stages>, stages> a = {{
+        {0., 0., 0., 0.},
+        {1. / 2., 0., 0., 0.},
+        {0., 3. / 4., 0., 0.},
+        {2. / 9., 1. / 3., 4. / 9., 0.},
+    }};
+    /// @brief The weights of the solution.
+    static constexpr std::array<double, stages> b = {2. / 9., 1. / 3., 4. / 9., 0.};
+    /// @brief The weights of the embedded solution.
+    static constexpr std::array<double, stages> b_hat = {7. / 24., 1. / 4., 1. / 3., 1. / 8.};
+};
+
+/// @brief The Butcher tableau of the Cash-Karp 5(4) embedded pair.
+struct cash_karp {
+    /// @brief The order of the method.
+    static constexpr unsigned short order = 5;
+    /// @brief The order of the embedded solution.
+    static constexpr unsigned short order_error = 4;
+    /// @brief The number of stages.
+    static constexpr std::size_t stages = 6;
+    /// @brief The nodes.
+    static constexpr std::array<double, stages> c = {0., 1. / 5., 3. / 10., 3. / 5., 1., 7. / 8.};
+    /// @brief The coefficients of the stages.
+    static constexpr std::array<std::array<double, stages>, stages> a = {{
+        {0., 0., 0., 0., 0., 0.},
+        {1. / 5., 0., 0., 0., 0., 0.},
+        {3. / 40., 9. / 40., 0., 0., 0., 0.},
+        {3. / 10., -9. / 10., 6. / 5., 0., 0., 0.},
+        {-11. / 54., 5. / 2., -70. / 27., 35. / 27., 0., 0.},
+        {1631. / 55296., 175. / 512., 575. / 13824., 44275. / 110592., 253. / 4096., 0.},
+    }};
+    /// @brief The weights of the solution.
+    static constexpr std::array<double, stages> b = {37. / 378., 0., 250. / 621., 125. / 594., 0., 512. / 1771.};
+    /// @brief The weights of the embedded solution.
+    static constexpr std::array<double, stages> b_hat = {
+        2825. / 27648., 0., 18575. / 48384., 13525. / 55296., 277. / 14336., 1. / 4.};
+};
+
+/// @brief The Butcher tableau of the Dormand-Prince 5(4) embedded pair (FSAL).
+struct dopri5 {
+    /// @brief The order of the method.
+    static constexpr unsigned short order = 5;
+    /// @brief The order of the embedded solution.
+    static constexpr unsigned short order_error = 4;
+    /// @brief The number of stages.
+    static constexpr std::size_t stages = 7;
+    /// @brief The nodes.
+    static constexpr std::array<double, stages> c = {0., 1. / 5., 3. / 10., 4. / 5., 8. / 9., 1., 1.};
+    /// @brief The coefficients of the stages.
+    static constexpr std::array<std::array<double, stages>, stages> a = {{
+        {0., 0., 0., 0., 0., 0., 0.},
+        {1. / 5., 0., 0., 0., 0., 0., 0.},
+        {3. / 40., 9. / 40., 0., 0., 0., 0., 0.},
+        {44. / 45., -56. / 15., 32. / 9., 0., 0., 0., 0.},
+        {19372. / 6561., -25360. / 2187., 64448. / 6561., -212. / 729., 0., 0., 0.},
+        {9017. / 3168., -355. / 33., 46732. / 5247., 49. / 176., -5103. / 18656., 0., 0.},
+        {35. / 384., 0., 500. / 1113., 125. / 192., -2187. / 6784., 11. / 84., 0.},
+    }};
+    /// @brief The weights of the solution.
+    static constexpr std::array<double, stages> b = {
+        35. / 384., 0., 500. / 1113., 125. / 192., -2187. / 6784., 11. / 84., 0.};
+    /// @brief The weights of the embedded solution.
+    static constexpr std::array<double, stages> b_hat = {
+        5179. / 57600., 0., 7571. / 16695., 393. / 640., -92097. / 339200., 187. / 2100., 1. / 40.};
+};
+
+} // namespace tableau
+
+namespace detail
+{
+
+/// @brief Checks, at compile time, if a coefficient is zero.
+/// @param value The coefficient.
+/// @return true if the coefficient is zero.
+constexpr auto is_zero_coefficient(double value) -> bool { return !(value < 0) && !(value > 0); }
+
+/// @brief Checks if a tableau provides the weights of an embedded solution.
+/// @tparam T The type of the tableau.
+template <typename T, typename = void>
+struct has_embedded_tableau : std::false_type {
+};
+
+/// @brief Checks if a tableau provides the weights of an embedded solution.
+/// @tparam T The type of the tableau.
+template <typename T>
+struct has_embedded_tableau<T, std::void_t<decltype(T::b_hat), decltype(T::order_error)>> : std::true_type {
+};
+
+/// @brief Helper variable template to check if a tableau provides an embedded solution.
+/// @tparam T The type of the tableau.
+template <typename T>
+constexpr inline bool has_embedded_tableau_v = has_embedded_tableau<T>::value;
+
+/// @brief Checks if a tableau is explicit, i.e., its coefficients are strictly lower triangular.
+/// @tparam T The type of the tableau.
+/// @return true if the tableau is explicit.
+template <typename T>
+constexpr auto is_explicit_tableau() -> bool
+{
+    for (std::size_t i = 0; i < T::stages; ++i) {
+        for (std::size_t j = i; j < T::stages; ++j) {
+            if (!is_zero_coefficient(T::a[i][j])) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/// @brief Checks if the last stage of a tableau is evaluated at the solution,
+/// so that it can be reused as the first stage of the next step (First Same As
+/// Last, FSAL).
+/// @tparam T The type of the tableau.
+/// @return true if the tableau has the FSAL property.
+template <typename T>
+constexpr auto is_fsal_tableau() -> bool
+{
+    constexpr std::size_t last = T::stages - 1;
+    if ((T::stages < 2) || !is_zero_coefficient(T::c[last] - 1.) || !is_zero_coefficient(T::b[last])) {
+        return false;
+    }
+    for (std::size_t j = 0; j < last; ++j) {
+        if (!is_zero_coefficient(T::a[last][j] - T::b[j])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/// @brief Helper variable template to check if a tableau has the FSAL property.
+/// @tparam T The type of the tableau.
+template <typename T>
+constexpr inline bool is_fsal_tableau_v = is_fsal_tableau<T>();
+
+} // namespace detail
+
+} // namespace numint
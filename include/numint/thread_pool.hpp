@@ -0,0 +1,249 @@
+/// @file thread_pool.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief A pool of worker threads, which balances the load by work stealing.
+
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace numint
+{
+
+/// @brief A pool of worker threads, executing the iterations of parallel loops.
+///
+/// @details Each worker owns a queue of iterations. At the beginning of a
+/// loop, the iterations are split in contiguous blocks, one for each worker.
+/// A worker executes the iterations of its own queue from the front, and once
+/// it runs out of them, it steals iterations from the back of the queues of
+/// the other workers. Hence, when iterations have very different costs (e.g.,
+/// trajectories integrated with an adaptive stepper), the workers that finish
+/// early keep helping the others until the whole loop is done.
+///
+/// The threads are created once, and reused by all the loops executed by the
+/// pool. Loops submitted from different threads are executed one at a time,
+/// while the loops nested inside an iteration, hence submitted by a worker of
+/// the same pool, are executed inline by that worker.
+class thread_pool
+{
+public:
+    /// @brief Creates a new pool.
+    /// @param workers The number of worker threads, by default one for each hardware thread.
+    explicit thread_pool(std::size_t workers = std::thread::hardware_concurrency())
+        : m_queues(std::max<std::size_t>(workers, 1U))
+    {
+        m_threads.reserve(m_queues.size());
+        for (std::size_t worker = 0; worker < m_queues.size(); ++worker) {
+            m_threads.emplace_back(&thread_pool::worker_loop, this, worker);
+        }
+    }
+
+    /// @brief Destructor, it waits for the workers to terminate.
+    ~thread_pool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_start.notify_all();
+        for (auto &thread : m_threads) {
+            thread.join();
+        }
+    }
+
+    /// @brief Copy constructor.
+    /// @param other The logger instance to copy from.
+    thread_pool(const thread_pool &other) = delete;
+
+    /// @brief Move constructor.
+    /// @param other The logger instance to move from.
+    thread_pool(thread_pool &&other) noexcept = delete;
+
+    /// @brief Copy assignment operator.
+    /// @param other The logger instance to copy from.
+    /// @return Reference to the logger instance.
+    auto operator=(const thread_pool &other) -> thread_pool & = delete;
+
+    /// @brief Move assignment operator.
+    /// @param other The logger instance to move from.
+    /// @return Reference to the logger instance.
+    auto operator=(thread_pool &&other) noexcept -> thread_pool & = delete;
+
+    /// @brief Returns the number of worker threads.
+    /// @return the number of workers.
+    auto size() const noexcept -> std::size_t { return m_queues.size(); }
+
+    /// @brief Executes the iterations [0, count) on the workers, and waits for their completion.
+    ///
+    /// @details The function is called as `function(worker, index)`, where
+    /// `worker` is the index of the worker executing the iteration, in
+    /// [0, size()), which can be used to access data owned by that worker
+    /// without any synchronization. If an iteration throws, the remaining
+    /// ones are still executed, and the first exception is rethrown here.
+    /// When called by one of the workers (i.e., from inside an iteration), the
+    /// iterations are executed in order by that worker, with its own index,
+    /// since the other workers may be waiting for it to complete.
+    ///
+    /// @tparam Function The type of the function executing one iteration.
+    /// @param count The number of iterations.
+    /// @param function The function executing one iteration.
+    template <class Function>
+    void parallel_for(std::size_t count, Function &&function)
+    {
+        // A nested loop cannot wait for the workers, it runs on the calling one.
+        if (t_pool == this) {
+            std::exception_ptr exception;
+            for (std::size_t index = 0; index < count; ++index) {
+                try {
+                    function(t_worker, index);
+                } catch (...) {
+                    if (!exception) {
+                        exception = std::current_exception();
+                    }
+                }
+            }
+            if (exception) {
+                std::rethrow_exception(exception);
+            }
+            return;
+        }
+        std::lock_guard<std::mutex> submit_lock(m_submit);
+        std::unique_lock<std::mutex> lock(m_mutex);
+        // Split the iterations in contiguous blocks, one for each worker.
+        const std::size_t workers = m_queues.size();
+        for (std::size_t worker = 0; worker < workers; ++worker) {
+            std::lock_guard<std::mutex> queue_lock(m_queues[worker].mutex);
+            const std::size_t first = (count * worker) / workers;
+            const std::size_t last  = (count * (worker + 1)) / workers;
+            for (std::size_t index = first; index < last; ++index) {
+                m_queues[worker].tasks.push_back(index);
+            }
+        }
+        // Wake up the workers.
+        m_job       = std::ref(function);
+        m_running   = workers;
+        m_exception = nullptr;
+        ++m_generation;
+        m_start.notify_all();
+        // Wait for all the workers to finish.
+        m_done.wait(lock, [this] { return m_running == 0; });
+        m_job = nullptr;
+        if (m_exception) {
+            std::rethrow_exception(m_exception);
+        }
+    }
+
+private:
+    /// @brief The queue of iterations owned by a worker.
+    struct alignas(64) task_queue {
+        /// Protects the iterations.
+        std::mutex mutex;
+        /// The iterations still to execute.
+        std::deque<std::size_t> tasks;
+    };
+
+    /// @brief Retrieves the next iteration for the given worker.
+    /// @param worker The index of the worker.
+    /// @param index The retrieved iteration.
+    /// @return true if an iteration was retrieved, false if there are none left.
+    auto next_task(std::size_t worker, std::size_t &index) -> bool
+    {
+        // Take the first iteration from our own queue.
+        {
+            std::lock_guard<std::mutex> lock(m_queues[worker].mutex);
+            if (!m_queues[worker].tasks.empty()) {
+                index = m_queues[worker].tasks.front();
+                m_queues[worker].tasks.pop_front();
+                return true;
+            }
+        }
+        // Steal the last iteration from the queue of another worker.
+        for (std::size_t offset = 1; offset < m_queues.size(); ++offset) {
+            task_queue &victim = m_queues[(worker + offset) % m_queues.size()];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (!victim.tasks.empty()) {
+                index = victim.tasks.back();
+                victim.tasks.pop_back();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /// @brief The loop executed by each worker thread.
+    /// @param worker The index of the worker.
+    void worker_loop(std::size_t worker)
+    {
+        t_pool                 = this;
+        t_worker               = worker;
+        std::size_t generation = 0;
+        for (;;) {
+            std::function<void(std::size_t, std::size_t)> job;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_start.wait(lock, [&] { return m_stop || (m_generation != generation); });
+                if (m_stop) {
+                    return;
+                }
+                generation = m_generation;
+                job        = m_job;
+            }
+            // Execute iterations until there are none left.
+            std::size_t index;
+            while (this->next_task(worker, index)) {
+                try {
+                    job(worker, index);
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    if (!m_exception) {
+                        m_exception = std::current_exception();
+                    }
+                }
+            }
+            // Notify the completion.
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if (--m_running == 0) {
+                    m_done.notify_one();
+                }
+            }
+        }
+    }
+
+    /// The queues of iterations, one for each worker.
+    std::vector<task_queue> m_queues;
+    /// The worker threads.
+    std::vector<std::thread> m_threads;
+    /// Serializes the loops submitted to the pool.
+    std::mutex m_submit;
+    /// Protects the state of the current loop.
+    std::mutex m_mutex;
+    /// Notifies the workers about a new loop, or about termination.
+    std::condition_variable m_start;
+    /// Notifies the completion of the current loop.
+    std::condition_variable m_done;
+    /// The function executing one iteration of the current loop.
+    std::function<void(std::size_t, std::size_t)> m_job;
+    /// The first exception thrown by the current loop.
+    std::exception_ptr m_exception;
+    /// Identifies the current loop.
+    std::size_t m_generation{};
+    /// The number of workers still executing the current loop.
+    std::size_t m_running{};
+    /// Whether the workers must terminate.
+    bool m_stop{false};
+    /// The pool owning the current thread, when it is one of the workers.
+    inline static thread_local const thread_pool *t_pool = nullptr;
+    /// The index of the current thread, when it is one of the workers.
+    inline static thread_local std::size_t t_worker = 0;
+};
+
+} // namespace numint
@@ -0,0 +1,24 @@
+/// @file trace.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Hooks for tracing back-ends (e.g., Tracy, or perf markers) around
+/// the hot paths of the integration.
+///
+/// @details The drivers mark the steps of the stepper, and the calls of the
+/// observer, with `NUMINT_TRACE_SCOPE(name)`, which opens a scope lasting until
+/// the end of the enclosing block. By default the macro expands to nothing, a
+/// back-end is plugged in by defining it before including any header of the
+/// library, e.g., for Tracy:
+///
+///     #include <tracy/Tracy.hpp>
+///     #define NUMINT_TRACE_SCOPE(name) ZoneScopedN(name)
+///
+/// The names are string literals: "numint::do_step", "numint::observer",
+/// and "numint::interpolate".
+
+#pragma once
+
+#ifndef NUMINT_TRACE_SCOPE
+/// @brief Opens a traced scope, lasting until the end of the enclosing block.
+/// @param name The name of the scope, a string literal.
+#define NUMINT_TRACE_SCOPE(name)
+#endif
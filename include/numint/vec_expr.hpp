@@ -0,0 +1,292 @@
+/// @file vec_expr.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Expression templates for linear combinations of state vectors.
+///
+/// @details Linear combinations of states are built lazily, without any
+/// temporary state, and evaluated in a single pass over the elements when
+/// they are assigned:
+///
+///     numint::assign(m_x, numint::vec(x) + (dt * 0.5) * numint::vec(m_dxdt1));
+///
+/// Only the states wrapped by `numint::vec` take part in the expressions,
+/// hence the operators do not interfere with the ones that the user might
+/// have defined for the state types.
+
+#pragma once
+
+#include "numint/detail/it_algebra.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <type_traits>
+#include <utility>
+
+namespace numint
+{
+
+/// @brief Base class of all the expressions.
+/// @tparam Derived The actual expression.
+template <class Derived>
+class vec_expr
+{
+public:
+    /// @brief Returns the actual expression.
+    /// @return a reference to the actual expression.
+    constexpr auto self() const noexcept -> const Derived & { return static_cast<const Derived &>(*this); }
+
+    /// @brief Evaluates the expression at the given position.
+    /// @param i The position.
+    /// @return The value of the expression.
+    constexpr auto operator[](std::size_t i) const noexcept { return this->self()[i]; }
+};
+
+/// @brief An expression referring to a state vector.
+/// @tparam State The state vector type.
+template <class State>
+class vec_terminal : public vec_expr<vec_terminal<State>>
+{
+public:
+    /// @brief Type of value contained in the state vector.
+    using value_type = typename State::value_type;
+
+    /// @brief Creates the expression.
+    /// @param state The state vector it refers to.
+    explicit constexpr vec_terminal(const State &state) noexcept
+        : m_state(state)
+    {
+        // Nothing to do.
+    }
+
+    /// @brief Evaluates the expression at the given position.
+    /// @param i The position.
+    /// @return The element of the state vector.
+    constexpr auto operator[](std::size_t i) const noexcept -> value_type { return m_state[i]; }
+
+private:
+    /// The state vector.
+    const State &m_state;
+};
+
+/// @brief An expression scaled by a scalar.
+/// @tparam Expr The scaled expression.
+template <class Expr>
+class vec_scaled : public vec_expr<vec_scaled<Expr>>
+{
+public:
+    /// @brief Type of the values of the expression.
+    using value_type = typename Expr::value_type;
+
+    /// @brief Creates the expression.
+    /// @param scalar The scalar.
+    /// @param expr The scaled expression.
+    constexpr vec_scaled(value_type scalar, const Expr &expr) noexcept
+        : m_scalar(scalar)
+        , m_expr(expr)
+    {
+        // Nothing to do.
+    }
+
+    /// @brief Evaluates the expression at the given position.
+    /// @param i The position.
+    /// @return The value of the expression.
+    constexpr auto operator[](std::size_t i) const noexcept -> value_type { return m_scalar * m_expr[i]; }
+
+private:
+    /// The scalar.
+    value_type m_scalar;
+    /// The scaled expression.
+    Expr m_expr;
+};
+
+/// @brief The sum, or the difference, of two expressions.
+/// @tparam Lhs The left-hand side expression.
+/// @tparam Rhs The right-hand side expression.
+/// @tparam Subtract Whether the right-hand side is subtracted.
+template <class Lhs, class Rhs, bool Subtract>
+class vec_sum : public vec_expr<vec_sum<Lhs, Rhs, Subtract>>
+{
+public:
+    /// @brief Type of the values of the expression.
+    using value_type = typename Lhs::value_type;
+
+    /// @brief Creates the expression.
+    /// @param lhs The left-hand side expression.
+    /// @param rhs The right-hand side expression.
+    constexpr vec_sum(const Lhs &lhs, const Rhs &rhs) noexcept
+        : m_lhs(lhs)
+        , m_rhs(rhs)
+    {
+        // Nothing to do.
+    }
+
+    /// @brief Evaluates the expression at the given position.
+    /// @param i The position.
+    /// @return The value of the expression.
+    constexpr auto operator[](std::size_t i) const noexcept -> value_type
+    {
+        if constexpr (Subtract) {
+            return m_lhs[i] - m_rhs[i];
+        } else {
+            return m_lhs[i] + m_rhs[i];
+        }
+    }
+
+private:
+    /// The left-hand side expression.
+    Lhs m_lhs;
+    /// The right-hand side expression.
+    Rhs m_rhs;
+};
+
+namespace detail
+{
+
+/// @brief Matches the expressions.
+/// @tparam Derived The actual expression.
+/// @return true, it is only used inside `decltype`.
+template <class Derived>
+auto is_vec_expr_test(const vec_expr<Derived> *) -> std::true_type;
+
+/// @brief Matches any other type.
+/// @return false, it is only used inside `decltype`.
+auto is_vec_expr_test(...) -> std::false_type;
+
+/// @brief Checks if a type is an expression.
+/// @tparam T The type to check.
+template <class T>
+constexpr inline bool is_vec_expr_v = decltype(is_vec_expr_test(std::declval<std::decay_t<T> *>()))::value;
+
+/// @brief Checks if a type can scale the expressions whose values are of the given type.
+/// @details Any type which is not an expression, and which converts to the
+/// values (e.g., the time of the steppers, or an integer literal), scales them,
+/// so that the expressions work for values that are not arithmetic types,
+/// such as the dual numbers and the fixed-point types.
+/// @tparam T The type of the scalar.
+/// @tparam Value The type of the values of the expression.
+template <class T, class Value>
+constexpr inline bool is_vec_scalar_v = !is_vec_expr_v<T> && std::is_convertible_v<const T &, Value>;
+
+} // namespace detail
+
+/// @brief Wraps a state vector, so that it can take part in expressions.
+/// @param state The state vector.
+/// @return The expression referring to the state vector.
+template <class State>
+constexpr auto vec(const State &state) noexcept
+{
+    return vec_terminal<State>(state);
+}
+
+/// @brief Scales an expression.
+/// @param scalar The scalar.
+/// @param expr The expression.
+/// @return The scaled expression.
+template <class T, class Expr, class = std::enable_if_t<detail::is_vec_scalar_v<T, typename Expr::value_type>>>
+constexpr auto operator*(const T &scalar, const vec_expr<Expr> &expr) noexcept
+{
+    return vec_scaled<Expr>(static_cast<typename Expr::value_type>(scalar), expr.self());
+}
+
+/// @brief Scales an expression.
+/// @param expr The expression.
+/// @param scalar The scalar.
+/// @return The scaled expression.
+template <class T, class Expr, class = std::enable_if_t<detail::is_vec_scalar_v<T, typename Expr::value_type>>>
+constexpr auto operator*(const vec_expr<Expr> &expr, const T &scalar) noexcept
+{
+    return vec_scaled<Expr>(static_cast<typename Expr::value_type>(scalar), expr.self());
+}
+
+/// @brief Negates an expression.
+/// @param expr The expression.
+/// @return The negated expression.
+template <class Expr>
+constexpr auto operator-(const vec_expr<Expr> &expr) noexcept
+{
+    return vec_scaled<Expr>(typename Expr::value_type(-1), expr.self());
+}
+
+/// @brief Adds two expressions.
+/// @param lhs The left-hand side expression.
+/// @param rhs The right-hand side expression.
+/// @return The sum of the expressions.
+template <class Lhs, class Rhs>
+constexpr auto operator+(const vec_expr<Lhs> &lhs, const vec_expr<Rhs> &rhs) noexcept
+{
+    return vec_sum<Lhs, Rhs, false>(lhs.self(), rhs.self());
+}
+
+/// @brief Subtracts two expressions.
+/// @param lhs The left-hand side expression.
+/// @param rhs The right-hand side expression.
+/// @return The difference of the expressions.
+template <class Lhs, class Rhs>
+constexpr auto operator-(const vec_expr<Lhs> &lhs, const vec_expr<Rhs> &rhs) noexcept
+{
+    return vec_sum<Lhs, Rhs, true>(lhs.self(), rhs.self());
+}
+
+/// @brief Evaluates an expression, and stores it inside a state vector.
+/// @param y The output state vector.
+/// @param expr The expression, it can refer to `y` itself.
+template <class State, class Expr>
+constexpr void assign(State &y, const vec_expr<Expr> &expr) noexcept
+{
+    const Expr &e       = expr.self();
+    const std::size_t n = y.size();
+    NUMINT_IVDEP
+    for (std::size_t i = 0; i < n; ++i) {
+        y[i] = e[i];
+    }
+}
+
+/// @brief Evaluates an expression, and adds it to a state vector.
+/// @param y The output state vector.
+/// @param expr The expression, it can refer to `y` itself.
+template <class State, class Expr>
+constexpr void accumulate(State &y, const vec_expr<Expr> &expr) noexcept
+{
+    const Expr &e       = expr.self();
+    const std::size_t n = y.size();
+    NUMINT_IVDEP
+    for (std::size_t i = 0; i < n; ++i) {
+        y[i] += e[i];
+    }
+}
+
+/// @brief Evaluates a new value and its error, stores the value, and reduces the error, in a single pass.
+///
+/// @details For each element, it computes the new value and the error
+/// estimate, stores the value inside `y`, and computes `metric(i, value, error)`.
+/// It is used by the embedded steppers to update the state, and to measure
+/// the error of the step, without passing over the states twice.
+///
+/// @param y The output state vector.
+/// @param value The expression of the new value, it can refer to `y` itself.
+/// @param error The expression of the error, it must not refer to `y`.
+/// @param metric The error metric of a single element, called as `metric(i, value, error)`.
+/// @return The maximum of the metric, at least epsilon.
+template <class State, class ValueExpr, class ErrorExpr, class Metric>
+constexpr auto assign_max_error(
+    State &y,
+    const vec_expr<ValueExpr> &value,
+    const vec_expr<ErrorExpr> &error,
+    Metric metric) noexcept -> typename State::value_type
+{
+    using value_type    = typename State::value_type;
+    const ValueExpr &v  = value.self();
+    const ErrorExpr &e  = error.self();
+    const std::size_t n = y.size();
+    // Initialize the value to epsilon, as the other error norms.
+    value_type result(std::numeric_limits<value_type>::epsilon());
+    for (std::size_t i = 0; i < n; ++i) {
+        const value_type yi = v[i];
+        result              = std::max(result, static_cast<value_type>(metric(i, yi, e[i])));
+        y[i]                = yi;
+    }
+    return result;
+}
+
+} // namespace numint